@@ -0,0 +1,603 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "SpirvCache.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Stream/FileStream.h"
+#include "stl/Stream/MemStream.h"
+#include <thread>
+
+namespace FG
+{
+namespace
+{
+	static constexpr uint	CacheFileMagic	= 0x43534746;	// 'FGSC'
+
+/*
+=================================================
+	FMix64
+----
+	final mix from MurmurHash3
+=================================================
+*/
+	ND_ inline uint64_t  FMix64 (uint64_t k)
+	{
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdull;
+		k ^= k >> 33;
+		k *= 0xc4ceb9fe1a85ec53ull;
+		k ^= k >> 33;
+		return k;
+	}
+
+/*
+=================================================
+	WritePOD / ReadPOD
+=================================================
+*/
+	template <typename T>
+	inline void  WritePOD (WStream &stream, const T &value)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		CHECK( stream.Write( &value, BytesU::SizeOf(value) ));
+	}
+
+	template <typename T>
+	ND_ inline bool  ReadPOD (RStream &stream, OUT T &value)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+		return stream.Read( OUT &value, BytesU::SizeOf(value) );
+	}
+
+/*
+=================================================
+	WriteString / ReadString
+=================================================
+*/
+	inline void  WriteString (WStream &stream, StringView str)
+	{
+		WritePOD( stream, uint(str.length()) );
+		CHECK( stream.Write( str ));
+	}
+
+	ND_ inline bool  ReadString (RStream &stream, OUT String &str)
+	{
+		uint	len = 0;
+		CHECK_ERR( ReadPOD( stream, OUT len ));
+		CHECK_ERR( BytesU{len} <= stream.RemainingSize() );
+		return stream.Read( len, OUT str );
+	}
+
+/*
+=================================================
+	WriteID / ReadID
+----
+	write name if it is available to be compatible with optimized IDs
+=================================================
+*/
+	template <typename ID>
+	inline void  WriteID (WStream &stream, const ID &id)
+	{
+		if constexpr( not ID::IsOptimized() )
+		{
+			if ( id.GetName().size() or not id.IsDefined() )
+			{
+				WritePOD( stream, uint8_t(1) );
+				WriteString( stream, id.GetName() );
+				return;
+			}
+		}
+		WritePOD( stream, uint8_t(0) );
+		WritePOD( stream, uint64_t(size_t(id.GetHash())) );
+	}
+
+	template <typename ID>
+	ND_ inline bool  ReadID (RStream &stream, OUT ID &id)
+	{
+		uint8_t	has_name = 0;
+		CHECK_ERR( ReadPOD( stream, OUT has_name ));
+
+		if ( has_name )
+		{
+			String	name;
+			CHECK_ERR( ReadString( stream, OUT name ));
+			id = ID{ StringView{name} };
+		}
+		else
+		{
+			uint64_t	hash = 0;
+			CHECK_ERR( ReadPOD( stream, OUT hash ));
+			id = ID{ HashVal{size_t(hash)} };
+		}
+		return true;
+	}
+
+/*
+=================================================
+	WriteUniform / ReadUniform
+=================================================
+*/
+	inline void  WriteUniform (WStream &stream, const PipelineDescription::Uniform &un)
+	{
+		WritePOD( stream, uint(un.data.index()) );
+		Visit( un.data,
+			[&stream] (const NullUnion &)	{ Unused( stream ); },
+			[&stream] (const auto &data)	{ WritePOD( stream, data ); }
+		);
+		WritePOD( stream, un.index.GLBinding() );
+		WritePOD( stream, un.index.VKBinding() );
+		WritePOD( stream, un.arraySize );
+		WritePOD( stream, un.stageFlags );
+	}
+
+	template <typename T>
+	ND_ inline bool  ReadUniformData (RStream &stream, OUT PipelineDescription::UniformData_t &result)
+	{
+		T	data;
+		CHECK_ERR( ReadPOD( stream, OUT data ));
+		result = data;
+		return true;
+	}
+
+	ND_ inline bool  ReadUniform (RStream &stream, OUT PipelineDescription::Uniform &un)
+	{
+		using PD = PipelineDescription;
+
+		uint	type = 0;
+		CHECK_ERR( ReadPOD( stream, OUT type ));
+
+		switch ( type )
+		{
+			case 1 :	CHECK_ERR( ReadUniformData< PD::Texture >( stream, OUT un.data ));			break;
+			case 2 :	CHECK_ERR( ReadUniformData< PD::Sampler >( stream, OUT un.data ));			break;
+			case 3 :	CHECK_ERR( ReadUniformData< PD::SubpassInput >( stream, OUT un.data ));		break;
+			case 4 :	CHECK_ERR( ReadUniformData< PD::Image >( stream, OUT un.data ));				break;
+			case 5 :	CHECK_ERR( ReadUniformData< PD::UniformBuffer >( stream, OUT un.data ));		break;
+			case 6 :	CHECK_ERR( ReadUniformData< PD::StorageBuffer >( stream, OUT un.data ));		break;
+			case 7 :	CHECK_ERR( ReadUniformData< PD::RayTracingScene >( stream, OUT un.data ));	break;
+			default :	RETURN_ERR( "unknown uniform type" );
+		}
+		STATIC_ASSERT( std::variant_size_v< PD::UniformData_t > == 8 );
+
+		BindingIndex::Index_t	gl_index = 0, vk_index = 0;
+		CHECK_ERR( ReadPOD( stream, OUT gl_index ));
+		CHECK_ERR( ReadPOD( stream, OUT vk_index ));
+		CHECK_ERR( ReadPOD( stream, OUT un.arraySize ));
+		CHECK_ERR( ReadPOD( stream, OUT un.stageFlags ));
+
+		un.index = BindingIndex{ gl_index, vk_index };
+		return true;
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	KeyBuilder::Add
+=================================================
+*/
+	SpirvCache::KeyBuilder&  SpirvCache::KeyBuilder::Add (const void* data, BytesU size)
+	{
+		auto*	bytes = Cast<uint8_t>( data );
+
+		_data.insert( _data.end(), bytes, bytes + size_t(size) );
+		return *this;
+	}
+
+	SpirvCache::KeyBuilder&  SpirvCache::KeyBuilder::Add (StringView str)
+	{
+		AddPOD( uint64_t(str.length()) );
+		return Add( str.data(), BytesU{str.length()} );
+	}
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	constructor
+=================================================
+*/
+	SpirvCache::SpirvCache (StringView folder)
+	{
+	#ifdef FS_HAS_FILESYSTEM
+		FS::path	path{ folder };
+
+		if ( not FS::exists( path ))
+			FS::create_directories( path );
+
+		if ( FS::is_directory( path ))
+			_folder = FS::absolute( path ).make_preferred().string();
+	#else
+		_folder = String{folder};
+	#endif
+	}
+
+/*
+=================================================
+	IsValid
+=================================================
+*/
+	bool  SpirvCache::IsValid ()
+	{
+		EXLOCK( _guard );
+		return not _folder.empty();
+	}
+
+/*
+=================================================
+	_GetFileName
+=================================================
+*/
+	String  SpirvCache::_GetFileName (ArrayView<uint8_t> key)
+	{
+		const Hash_t	hash = _CalcHash( key );
+
+		EXLOCK( _guard );
+
+		String	name = _folder;
+
+		if ( name.size() and not (name.back() == '/' or name.back() == '\\') )
+			name += '/';
+
+		name << ToString<16>( hash[0] ) << '_' << ToString<16>( hash[1] ) << ".spvc";
+		return name;
+	}
+
+/*
+=================================================
+	_CalcHash
+----
+	two 64 bit lanes: FNV-1a and multiplicative hash with different constants,
+	used only for file name, full key is compared in 'Load'
+=================================================
+*/
+	SpirvCache::Hash_t  SpirvCache::_CalcHash (ArrayView<uint8_t> key)
+	{
+		Hash_t	hash {{ 0xcbf29ce484222325ull, 0x84222325cbf29ce4ull }};
+
+		for (auto b : key)
+		{
+			hash[0] = (hash[0] ^ b) * 0x100000001b3ull;
+			hash[1] = ((hash[1] ^ b) * 0x9e3779b97f4a7c15ull) ^ (hash[1] >> 31);
+		}
+		return Hash_t{{ FMix64( hash[0] ), FMix64( hash[1] ^ hash[0] ) }};
+	}
+
+/*
+=================================================
+	Load
+=================================================
+*/
+	bool  SpirvCache::Load (ArrayView<uint8_t> key, ArrayView<String> directories, OUT Array<uint> &spirv, OUT ShaderReflection &reflection)
+	{
+		Array<uint8_t>	data;
+		{
+			FileRStream		file{ _GetFileName( key )};
+
+			if ( not file.IsOpen() )
+				return false;	// cache miss
+
+			CHECK_ERR( file.Read( size_t(file.Size()), OUT data ));
+		}
+		MemRStream	stream{ std::move(data) };
+
+		uint	magic		= 0;
+		uint	version		= 0;
+		uint	key_size	= 0;
+
+		if ( not (ReadPOD( stream, OUT magic ) and ReadPOD( stream, OUT version ) and ReadPOD( stream, OUT key_size )) or
+			 magic		!= CacheFileMagic	or
+			 version	!= Version			or
+			 key_size	!= key.size() )
+			return false;	// file is broken, created by other version or for other key
+
+		// hash collision must not load SPIRV of other shader
+		Key_t	stored_key;
+		if ( not (stream.Read( key_size, OUT stored_key ) and ArrayView<uint8_t>{stored_key} == key) )
+			return false;
+
+		// check dependencies
+		if ( not _CheckIncludedFiles( stream, directories ))
+			return false;
+
+		uint	spirv_size = 0;
+		CHECK_ERR( ReadPOD( stream, OUT spirv_size ));
+		CHECK_ERR( BytesU::SizeOf<uint>() * spirv_size <= stream.RemainingSize() );
+		CHECK_ERR( stream.Read( spirv_size, OUT spirv ));
+
+		CHECK_ERR( _Deserialize( stream, OUT reflection ));
+		CHECK_ERR( stream.RemainingSize() == 0 );
+		return true;
+	}
+
+/*
+=================================================
+	_CheckIncludedFiles
+----
+	returns 'false' if any included file was changed,
+	file is searched in the same order as in 'SpirvCompiler::ShaderIncluder',
+	so new file in previous directory that shadows cached file invalidates entry too.
+=================================================
+*/
+	bool  SpirvCache::_CheckIncludedFiles (RStream &stream, ArrayView<String> directories)
+	{
+		uint	count = 0;
+		CHECK_ERR( ReadPOD( stream, OUT count ));
+
+		for (uint i = 0; i < count; ++i)
+		{
+			String	header_name;
+			String	stored_source;
+			CHECK_ERR( ReadString( stream, OUT header_name ));
+			CHECK_ERR( ReadString( stream, OUT stored_source ));
+
+			String	source;
+			if ( not _FindIncludedFile( directories, header_name, OUT source ) or source != stored_source )
+				return false;
+		}
+		return true;
+	}
+	
+/*
+=================================================
+	_FindIncludedFile
+----
+	returns content of the first file with 'headerName' in 'directories'
+=================================================
+*/
+	bool  SpirvCache::_FindIncludedFile (ArrayView<String> directories, StringView headerName, OUT String &source)
+	{
+		for (auto& folder : directories)
+		{
+		#ifdef FS_HAS_FILESYSTEM
+			FS::path	fpath = FS::path( folder ) / FS::path( headerName );
+
+			if ( not FS::exists( fpath ))
+				continue;
+
+			FileRStream	file{ fpath.make_preferred().string() };
+		#else
+			String	fpath = folder;
+
+			if ( fpath.size() and not (fpath.back() == '/' or fpath.back() == '\\') )
+				fpath += '/';
+
+			fpath += headerName;
+			
+			FileRStream	file{ fpath };
+		#endif
+
+			if ( not file.IsOpen() )
+				continue;
+
+			return file.Read( size_t(file.Size()), OUT source );
+		}
+		return false;
+	}
+
+/*
+=================================================
+	Store
+----
+	entry is written to temporary file and then renamed,
+	so other threads and processes will never read partially written file.
+=================================================
+*/
+	bool  SpirvCache::Store (ArrayView<uint8_t> key, ArrayView<uint> spirv, const ShaderReflection &reflection, const IncludedFiles_t &includedFiles)
+	{
+		MemWStream	stream;
+
+		WritePOD( stream, CacheFileMagic );
+		WritePOD( stream, Version );
+		WritePOD( stream, uint(key.size()) );
+		CHECK( stream.Write( key.data(), ArraySizeOf(key) ));
+
+		WritePOD( stream, uint(includedFiles.size()) );
+		for (auto& file : includedFiles)
+		{
+			WriteString( stream, file.first );
+			WriteString( stream, file.second );
+		}
+
+		WritePOD( stream, uint(spirv.size()) );
+		CHECK( stream.Write( spirv.data(), ArraySizeOf(spirv) ));
+
+		_Serialize( stream, reflection );
+
+		const String	filename	= _GetFileName( key );
+		String			temp_name	= filename;
+		{
+			EXLOCK( _guard );
+			temp_name << '.' << ToString( std::hash<std::thread::id>{}( std::this_thread::get_id() )) << '_' << ToString( ++_tempCounter ) << ".tmp";
+		}
+		{
+			FileWStream	file{ temp_name };
+			CHECK_ERR( file.IsOpen() );
+			CHECK_ERR( file.Write( stream.GetData() ));
+		}
+
+	#ifdef FS_HAS_FILESYSTEM
+		std::error_code	err;
+		FS::rename( FS::path{temp_name}, FS::path{filename}, OUT err );
+
+		if ( err )
+		{
+			FS::remove( FS::path{temp_name}, OUT err );
+			return false;
+		}
+	#else
+		std::remove( filename.c_str() );
+		if ( std::rename( temp_name.c_str(), filename.c_str() ) != 0 )
+		{
+			std::remove( temp_name.c_str() );
+			return false;
+		}
+	#endif
+		return true;
+	}
+
+/*
+=================================================
+	_Serialize
+=================================================
+*/
+	void  SpirvCache::_Serialize (WStream &stream, const ShaderReflection &reflection)
+	{
+		// pipeline layout
+		WritePOD( stream, uint(reflection.layout.descriptorSets.size()) );
+		for (auto& ds : reflection.layout.descriptorSets)
+		{
+			WriteID( stream, ds.id );
+			WritePOD( stream, ds.bindingIndex );
+			WritePOD( stream, uint(ds.uniforms ? ds.uniforms->size() : 0) );
+
+			if ( ds.uniforms )
+			{
+				for (auto& un : *ds.uniforms)
+				{
+					WriteID( stream, un.first );
+					WriteUniform( stream, un.second );
+				}
+			}
+		}
+
+		WritePOD( stream, uint(reflection.layout.pushConstants.size()) );
+		for (auto& pc : reflection.layout.pushConstants)
+		{
+			WriteID( stream, pc.first );
+			WritePOD( stream, pc.second );
+		}
+
+		WritePOD( stream, uint(reflection.specConstants.size()) );
+		for (auto& sc : reflection.specConstants)
+		{
+			WriteID( stream, sc.first );
+			WritePOD( stream, sc.second );
+		}
+
+		// vertex
+		WritePOD( stream, uint64_t(reflection.vertex.supportedTopology.to_ullong()) );
+		WritePOD( stream, uint(reflection.vertex.vertexAttribs.size()) );
+		for (auto& attr : reflection.vertex.vertexAttribs)
+		{
+			WriteID( stream, attr.id );
+			WritePOD( stream, attr.index );
+			WritePOD( stream, attr.type );
+		}
+
+		// fragment
+		WritePOD( stream, uint(reflection.fragment.fragmentOutput.size()) );
+		for (auto& frag : reflection.fragment.fragmentOutput) {
+			WritePOD( stream, frag );
+		}
+		WritePOD( stream, reflection.fragment.earlyFragmentTests );
+
+		WritePOD( stream, reflection.tessellation );
+		WritePOD( stream, reflection.compute );
+		WritePOD( stream, reflection.mesh );
+	}
+
+/*
+=================================================
+	_Deserialize
+=================================================
+*/
+	bool  SpirvCache::_Deserialize (RStream &stream, OUT ShaderReflection &reflection)
+	{
+		using UniformMap_t = PipelineDescription::UniformMap_t;
+
+		// pipeline layout
+		uint	ds_count = 0;
+		CHECK_ERR( ReadPOD( stream, OUT ds_count ));
+		CHECK_ERR( ds_count <= reflection.layout.descriptorSets.capacity() );
+
+		for (uint i = 0; i < ds_count; ++i)
+		{
+			auto&	ds			= reflection.layout.descriptorSets.emplace_back();
+			uint	un_count	= 0;
+
+			CHECK_ERR( ReadID( stream, OUT ds.id ));
+			CHECK_ERR( ReadPOD( stream, OUT ds.bindingIndex ));
+			CHECK_ERR( ReadPOD( stream, OUT un_count ));
+
+			auto	uniforms = MakeShared<UniformMap_t>();
+			uniforms->reserve( un_count );
+
+			for (uint j = 0; j < un_count; ++j)
+			{
+				UniformID						id;
+				PipelineDescription::Uniform	un;
+
+				CHECK_ERR( ReadID( stream, OUT id ));
+				CHECK_ERR( ReadUniform( stream, OUT un ));
+				uniforms->insert_or_assign( id, un );
+			}
+			ds.uniforms = uniforms;
+		}
+
+		uint	pc_count = 0;
+		CHECK_ERR( ReadPOD( stream, OUT pc_count ));
+		CHECK_ERR( pc_count <= reflection.layout.pushConstants.capacity() );
+
+		for (uint i = 0; i < pc_count; ++i)
+		{
+			PushConstantID						id;
+			PipelineDescription::PushConstant	pc;
+
+			CHECK_ERR( ReadID( stream, OUT id ));
+			CHECK_ERR( ReadPOD( stream, OUT pc ));
+			reflection.layout.pushConstants.insert_or_assign( id, pc );
+		}
+
+		uint	sc_count = 0;
+		CHECK_ERR( ReadPOD( stream, OUT sc_count ));
+		CHECK_ERR( sc_count <= reflection.specConstants.capacity() );
+
+		for (uint i = 0; i < sc_count; ++i)
+		{
+			SpecializationID	id;
+			uint				index = 0;
+
+			CHECK_ERR( ReadID( stream, OUT id ));
+			CHECK_ERR( ReadPOD( stream, OUT index ));
+			reflection.specConstants.insert_or_assign( id, index );
+		}
+
+		// vertex
+		uint64_t	topology	= 0;
+		uint		attr_count	= 0;
+		CHECK_ERR( ReadPOD( stream, OUT topology ));
+		CHECK_ERR( ReadPOD( stream, OUT attr_count ));
+		CHECK_ERR( attr_count <= reflection.vertex.vertexAttribs.capacity() );
+
+		reflection.vertex.supportedTopology = ShaderReflection::TopologyBits_t{ topology };
+
+		for (uint i = 0; i < attr_count; ++i)
+		{
+			auto&	attr = reflection.vertex.vertexAttribs.emplace_back();
+			CHECK_ERR( ReadID( stream, OUT attr.id ));
+			CHECK_ERR( ReadPOD( stream, OUT attr.index ));
+			CHECK_ERR( ReadPOD( stream, OUT attr.type ));
+		}
+
+		// fragment
+		uint	frag_count = 0;
+		CHECK_ERR( ReadPOD( stream, OUT frag_count ));
+		CHECK_ERR( frag_count <= reflection.fragment.fragmentOutput.capacity() );
+
+		for (uint i = 0; i < frag_count; ++i) {
+			CHECK_ERR( ReadPOD( stream, OUT reflection.fragment.fragmentOutput.emplace_back() ));
+		}
+		CHECK_ERR( ReadPOD( stream, OUT reflection.fragment.earlyFragmentTests ));
+
+		CHECK_ERR( ReadPOD( stream, OUT reflection.tessellation ));
+		CHECK_ERR( ReadPOD( stream, OUT reflection.compute ));
+		CHECK_ERR( ReadPOD( stream, OUT reflection.mesh ));
+		return true;
+	}
+
+
+}	// FG
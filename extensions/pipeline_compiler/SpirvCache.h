@@ -0,0 +1,90 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Persistent cache for compiled SPIRV and shader reflection.
+	Each entry is stored in separate file, file name is a 128 bit hash of the key.
+	Key contains source code and compilation settings, it is stored in the entry and compared on load,
+	so hash collision only causes a cache miss.
+	Entry contains list of included files with content, on load each file is searched again in the include directories,
+	if any included file has been changed or is shadowed by a file in previous directory then entry is invalid and shader will be recompiled.
+*/
+
+#pragma once
+
+#include "SpirvCompiler.h"
+#include "stl/Stream/Stream.h"
+#include <mutex>
+
+namespace FG
+{
+
+	//
+	// SPIRV Cache
+	//
+
+	class SpirvCache final
+	{
+	// types
+	public:
+		using Key_t		= Array< uint8_t >;
+		using Hash_t	= StaticArray< uint64_t, 2 >;
+
+		//
+		// Key Builder
+		//
+		struct KeyBuilder
+		{
+		// variables
+		private:
+			Key_t	_data;
+
+		// methods
+		public:
+			KeyBuilder& Add (const void* data, BytesU size);
+			KeyBuilder& Add (StringView str);
+
+			template <typename T>
+			KeyBuilder& AddPOD (const T &value)
+			{
+				STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+				return Add( &value, BytesU::SizeOf(value) );
+			}
+
+			ND_ Key_t  Release ()		{ return std::move(_data); }
+		};
+
+		using ShaderReflection	= SpirvCompiler::ShaderReflection;
+		using IncludedFiles_t	= Array< Pair< String, StringView >>;	// header name as in '#include', source
+
+		static constexpr uint	Version	= 3;
+
+
+	// variables
+	private:
+		Mutex		_guard;			// for '_folder' and temporary file names
+		String		_folder;
+		uint		_tempCounter	= 0;
+
+
+	// methods
+	public:
+		explicit SpirvCache (StringView folder);
+
+		ND_ bool  IsValid ();
+
+		bool  Load (ArrayView<uint8_t> key, ArrayView<String> directories, OUT Array<uint> &spirv, OUT ShaderReflection &reflection);
+		bool  Store (ArrayView<uint8_t> key, ArrayView<uint> spirv, const ShaderReflection &reflection, const IncludedFiles_t &includedFiles);
+
+	private:
+		ND_ String  _GetFileName (ArrayView<uint8_t> key);
+
+		ND_ static Hash_t  _CalcHash (ArrayView<uint8_t> key);
+
+		static bool  _CheckIncludedFiles (RStream &stream, ArrayView<String> directories);
+		static bool  _FindIncludedFile (ArrayView<String> directories, StringView headerName, OUT String &source);
+
+		static void  _Serialize (WStream &stream, const ShaderReflection &reflection);
+		static bool  _Deserialize (RStream &stream, OUT ShaderReflection &reflection);
+	};
+
+
+}	// FG
@@ -1,6 +1,7 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "SpirvCompiler.h"
+#include "SpirvCache.h"
 #include "PrivateDefines.h"
 #include "stl/Algorithms/StringUtils.h"
 #include "stl/Algorithms/StringParser.h"
@@ -274,6 +275,35 @@ namespace FG
 		_features.fragmentStoresAndAtomics		 = fragmentStoresAndAtomics;
 	}
 	
+/*
+=================================================
+	SetCache
+=================================================
+*/
+	void  SpirvCompiler::SetCache (const SharedPtr<SpirvCache> &cache)
+	{
+		_cache = cache;
+	}
+
+/*
+=================================================
+	CopySettings
+----
+	copy compilation flags, features and resource limits,
+	compiler state is not copied.
+=================================================
+*/
+	void  SpirvCompiler::CopySettings (const SpirvCompiler &other)
+	{
+		ASSERT( &_directories == &other._directories );
+
+		_compilerFlags		= other._compilerFlags;
+		_features			= other._features;
+		_debugFlags			= other._debugFlags;
+		_builtinResource	= other._builtinResource;
+		_cache				= other._cache;
+	}
+	
 /*
 =================================================
 	_CheckShaderFeatures
@@ -335,22 +365,52 @@ namespace FG
 
 		// compile shader without debug info
 		{
-			ShaderIncluder	includer	{_directories};
-			GLSLangResult	glslang_data;
+			Array<uint>			spirv;
+			SpirvCache::Key_t	cache_key;
+			bool				cached		= false;
 
-			COMP_CHECK_ERR( _ParseGLSL( shaderType, srcShaderFmt, dstShaderFmt, entry, {source.c_str()}, INOUT includer, OUT glslang_data, INOUT log ));
+			if ( _cache )
+			{
+				cache_key	= _CalcCacheKey( shaderType, srcShaderFmt, dstShaderFmt, entry, source );
+				cached		= _cache->Load( cache_key, _directories, OUT spirv, OUT outReflection );
 
-			Array<uint>		spirv;
-			COMP_CHECK_ERR( _CompileSPIRV( glslang_data, OUT spirv, INOUT log ));
+				if ( not cached )
+				{
+					spirv.clear();
+					outReflection = ShaderReflection{};
+				}
+			}
 
-			COMP_CHECK_ERR( _BuildReflection( glslang_data, OUT outReflection ));
-		
-			if ( AllBits( _compilerFlags, EShaderCompilationFlags::ParseAnnotations ))
+			if ( not cached )
 			{
-				_ParseAnnotations( StringView{source}, INOUT outReflection );
+				ShaderIncluder	includer	{_directories};
+				GLSLangResult	glslang_data;
 
-				for (auto& file : includer.GetIncludedFiles()) {
-					_ParseAnnotations( file.second->GetSource(), INOUT outReflection );
+				COMP_CHECK_ERR( _ParseGLSL( shaderType, srcShaderFmt, dstShaderFmt, entry, {source.c_str()}, INOUT includer, OUT glslang_data, INOUT log ));
+
+				COMP_CHECK_ERR( _CompileSPIRV( glslang_data, OUT spirv, INOUT log ));
+
+				COMP_CHECK_ERR( _BuildReflection( glslang_data, OUT outReflection ));
+		
+				if ( AllBits( _compilerFlags, EShaderCompilationFlags::ParseAnnotations ))
+				{
+					_ParseAnnotations( StringView{source}, INOUT outReflection );
+
+					for (auto& file : includer.GetIncludedFiles()) {
+						_ParseAnnotations( file.second->GetSource(), INOUT outReflection );
+					}
+				}
+
+				if ( _cache )
+				{
+					SpirvCache::IncludedFiles_t	included_files;
+
+					for (auto& file : includer.GetIncludedFiles()) {
+						included_files.emplace_back( file.second->headerName, file.second->GetSource() );
+					}
+
+					if ( not _cache->Store( cache_key, spirv, outReflection, included_files ))
+						FG_LOGI( "failed to store shader '"s << debugName << "' in cache" );
 				}
 			}
 
@@ -423,6 +483,38 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	_CalcCacheKey
+----
+	included files are not added here, they are validated by cache.
+	SPIRV target is not added too, it is derived from 'dstShaderFmt' and
+	is updated only in '_ParseGLSL', so here it depends on previous compilation.
+=================================================
+*/
+	SpirvCache::Key_t  SpirvCompiler::_CalcCacheKey (EShader shaderType, EShaderLangFormat srcShaderFmt, EShaderLangFormat dstShaderFmt,
+													 StringView entry, StringView source) const
+	{
+		SpirvCache::KeyBuilder	builder;
+
+		builder.AddPOD( SpirvCache::Version );
+		builder.AddPOD( uint(GLSLANG_PATCH_LEVEL) );
+		builder.AddPOD( UniformID::IsOptimized() );
+
+		builder.AddPOD( shaderType ).AddPOD( srcShaderFmt ).AddPOD( dstShaderFmt );
+		builder.Add( entry ).Add( source );
+
+		builder.AddPOD( _compilerFlags ).AddPOD( _features );
+
+		// skip padding bytes after 'limits'
+		builder.Add( &_builtinResource, BytesU{offsetof( TBuiltInResource, limits )} ).AddPOD( _builtinResource.limits );
+
+		for (auto& dir : _directories) {
+			builder.Add( dir );
+		}
+		return builder.Release();
+	}
+
 /*
 =================================================
 	ConvertShaderType
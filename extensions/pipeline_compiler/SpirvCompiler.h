@@ -21,6 +21,8 @@ namespace glslang
 
 namespace FG
 {
+	class SpirvCache;
+
 
 	//
 	// SPIRV Compiler
@@ -104,6 +106,8 @@ namespace FG
 		EShaderLangFormat			_debugFlags		= Default;
 		TBuiltInResource			_builtinResource;
 
+		SharedPtr<SpirvCache>		_cache;
+
 
 	// methods
 	public:
@@ -118,6 +122,10 @@ namespace FG
 		bool  SetDefaultResourceLimits ();
 		bool  SetCurrentResourceLimits (PhysicalDeviceVk_t physicalDevice);
 
+		void  SetCache (const SharedPtr<SpirvCache> &cache);
+
+		void  CopySettings (const SpirvCompiler &other);
+
 		bool  Compile (EShader shaderType, EShaderLangFormat srcShaderFmt, EShaderLangFormat dstShaderFmt,
 					   NtStringView entry, NtStringView source, StringView debugName,
 					   OUT PipelineDescription::Shader &outShader, OUT ShaderReflection &outReflection, OUT String &log);
@@ -128,6 +136,9 @@ namespace FG
 						  NtStringView entry, ArrayView<const char *> source, INOUT ShaderIncluder &includer,
 						  OUT GLSLangResult &glslangData, INOUT String &log);
 
+		ND_ Array<uint8_t>  _CalcCacheKey (EShader shaderType, EShaderLangFormat srcShaderFmt, EShaderLangFormat dstShaderFmt,
+										   StringView entry, StringView source) const;
+
 		bool  _CompileSPIRV (const GLSLangResult &glslangData, OUT Array<uint> &spirv, INOUT String &log) const;
 		bool  _OptimizeSPIRV (INOUT Array<uint> &spirv, INOUT String &log) const;
 
@@ -2,6 +2,7 @@
 
 #include "VPipelineCompiler.h"
 #include "SpirvCompiler.h"
+#include "SpirvCache.h"
 #include "PrivateDefines.h"
 #include "framegraph/Shared/EnumUtils.h"
 #include "framegraph/Shared/EnumToString.h"
@@ -15,6 +16,48 @@
 namespace FG
 {
 
+	//
+	// Scoped SPIRV Compiler
+	//
+	class VPipelineCompiler::ScopedSpirvCompiler final
+	{
+	// variables
+	private:
+		VPipelineCompiler&	_owner;
+		SpirvCompilerPtr	_compiler;
+
+	// methods
+	public:
+		explicit ScopedSpirvCompiler (VPipelineCompiler &owner) : _owner{owner}
+		{
+			{
+				EXLOCK( _owner._compilerPoolGuard );
+
+				if ( _owner._compilerPool.size() )
+				{
+					_compiler = std::move( _owner._compilerPool.back() );
+					_owner._compilerPool.pop_back();
+				}
+			}
+
+			if ( not _compiler )
+				_compiler.reset( new SpirvCompiler{ _owner._directories });
+
+			// settings may be changed since last usage
+			_compiler->CopySettings( *_owner._spirvCompiler );
+		}
+
+		~ScopedSpirvCompiler ()
+		{
+			EXLOCK( _owner._compilerPoolGuard );
+			_owner._compilerPool.push_back( std::move(_compiler) );
+		}
+
+		ND_ SpirvCompiler*  operator -> ()		{ return _compiler.get(); }
+	};
+//-----------------------------------------------------------------------------
+
+
 /*
 =================================================
 	constructor
@@ -98,6 +141,9 @@ namespace FG
 	VPipelineCompiler::~VPipelineCompiler ()
 	{
 		ReleaseShaderCache();
+
+		EXLOCK( _compilerPoolGuard );
+		_compilerPool.clear();
 	}
 	
 /*
@@ -165,6 +211,32 @@ namespace FG
 		_directories.push_back( std::move(file_path) );
 	}
 
+/*
+=================================================
+	SetCacheDirectory
+----
+	compiled SPIRV and reflection will be stored in this folder
+	and reused until source, include files or settings are changed.
+	empty path disables cache.
+=================================================
+*/
+	bool VPipelineCompiler::SetCacheDirectory (StringView path)
+	{
+		EXLOCK( _lock );
+
+		if ( path.empty() )
+		{
+			_spirvCompiler->SetCache( null );
+			return true;
+		}
+
+		auto	cache = MakeShared<SpirvCache>( path );
+		CHECK_ERR( cache->IsValid() );
+
+		_spirvCompiler->SetCache( cache );
+		return true;
+	}
+
 /*
 =================================================
 	ReleaseUnusedShaders
@@ -173,7 +245,7 @@ namespace FG
 	void VPipelineCompiler::ReleaseUnusedShaders ()
 	{
 	#ifdef FG_ENABLE_VULKAN
-		EXLOCK( _lock );
+		EXLOCK( _shaderCacheGuard );
 
 		if ( _vkLogicalDevice == VK_NULL_HANDLE )
 			return;
@@ -204,7 +276,7 @@ namespace FG
 	void VPipelineCompiler::ReleaseShaderCache ()
 	{
 	#ifdef FG_ENABLE_VULKAN
-		EXLOCK( _lock );
+		EXLOCK( _shaderCacheGuard );
 
 		if ( _vkLogicalDevice == VK_NULL_HANDLE )
 			return;
@@ -812,7 +884,9 @@ namespace FG
 */
 	bool VPipelineCompiler::Compile (INOUT MeshPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
-		EXLOCK( _lock );
+		SHAREDLOCK( _lock );
+		ScopedSpirvCompiler		spirv_compiler{ *this };
+
 		ASSERT( IsSupported( ppln, dstFormat ));
 
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -838,7 +912,7 @@ namespace FG
 				String							log;
 				PipelineDescription::Shader		new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
+				if ( not spirv_compiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
 												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
 												  OUT new_shader, OUT reflection, OUT log ))
 				{
@@ -898,7 +972,9 @@ namespace FG
 */
 	bool VPipelineCompiler::Compile (INOUT RayTracingPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
-		EXLOCK( _lock );
+		SHAREDLOCK( _lock );
+		ScopedSpirvCompiler		spirv_compiler{ *this };
+
 		ASSERT( IsSupported( ppln, dstFormat ));
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -924,7 +1000,7 @@ namespace FG
 				String								log;
 				RayTracingPipelineDesc::RTShader	new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.second.shaderType, iter->first, spirv_format, (*shader_data)->GetEntry(),
+				if ( not spirv_compiler->Compile( shader.second.shaderType, iter->first, spirv_format, (*shader_data)->GetEntry(),
 												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
 												  OUT new_shader, OUT reflection, OUT log ))
 				{
@@ -975,7 +1051,9 @@ namespace FG
 */
 	bool VPipelineCompiler::Compile (INOUT GraphicsPipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
-		EXLOCK( _lock );
+		SHAREDLOCK( _lock );
+		ScopedSpirvCompiler		spirv_compiler{ *this };
+
 		ASSERT( IsSupported( ppln, dstFormat ));
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -1001,7 +1079,7 @@ namespace FG
 				String							log;
 				PipelineDescription::Shader		new_shader;
 
-				if ( not _spirvCompiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
+				if ( not spirv_compiler->Compile( shader.first, iter->first, spirv_format, (*shader_data)->GetEntry(),
 												  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
 												  OUT new_shader, OUT reflection, OUT log ))
 				{
@@ -1065,7 +1143,9 @@ namespace FG
 */
 	bool VPipelineCompiler::Compile (INOUT ComputePipelineDesc &ppln, EShaderLangFormat dstFormat)
 	{
-		EXLOCK( _lock );
+		SHAREDLOCK( _lock );
+		ScopedSpirvCompiler		spirv_compiler{ *this };
+
 		ASSERT( IsSupported( ppln, dstFormat ));
 		
 		const bool					create_module	= ((dstFormat & EShaderLangFormat::_StorageFormatMask) == EShaderLangFormat::ShaderModule);
@@ -1085,7 +1165,7 @@ namespace FG
 			String							log;
 			ComputePipelineDesc				new_ppln;
 
-			if ( not _spirvCompiler->Compile( EShader::Compute, iter->first, spirv_format, (*shader_data)->GetEntry(),
+			if ( not spirv_compiler->Compile( EShader::Compute, iter->first, spirv_format, (*shader_data)->GetEntry(),
 											  (*shader_data)->GetData(), (*shader_data)->GetDebugName(),
 											  OUT new_ppln._shader, OUT reflection, OUT log ))
 			{
@@ -1137,6 +1217,7 @@ namespace FG
 														 (sh_iter->first & EShaderLangFormat::_VersionModeFlagsMask);
 					
 					// search in existing shader modules
+					EXLOCK( _shaderCacheGuard );
 					auto	spv_data	= *spv_data_ptr;
 					auto	iter		= _shaderCache.find( spv_data );
 
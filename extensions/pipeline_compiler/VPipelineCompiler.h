@@ -30,18 +30,27 @@ namespace FG
 
 		using ShaderCache_t		= HashMap< BinaryShaderData, VkShaderPtr >;
 		using ShaderDataMap_t	= PipelineDescription::ShaderDataMap_t;
+		using SpirvCompilerPtr	= UniquePtr< class SpirvCompiler >;
+		using CompilerPool_t	= Array< SpirvCompilerPtr >;
+
+		class ScopedSpirvCompiler;
 
 
 	// variables
 	private:
-		Mutex								_lock;
+		SharedMutex							_lock;					// exclusive lock for settings, shared lock for compilation
 		Array< String >						_directories;
-		UniquePtr< class SpirvCompiler >	_spirvCompiler;
-		ShaderCache_t						_shaderCache;
+		SpirvCompilerPtr					_spirvCompiler;			// contains settings only, used as prototype for '_compilerPool'
 		EShaderCompilationFlags				_compilerFlags			= Default;
+		
+		Mutex								_compilerPoolGuard;
+		CompilerPool_t						_compilerPool;			// free compilers, each compiling thread takes one
+
+		Mutex								_shaderCacheGuard;
+		ShaderCache_t						_shaderCache;
 
 		DEBUG_ONLY(
-			HashCollisionCheck<>			_hashCollisionCheck;	// for uniforms and descriptor sets
+			HashCollisionCheck<SharedMutex>	_hashCollisionCheck;	// for uniforms and descriptor sets
 		)
 
 		// immutable:
@@ -60,11 +69,12 @@ namespace FG
 
 		bool SetCompilationFlags (EShaderCompilationFlags flags);
 		void AddDirectory (StringView path);
+		bool SetCacheDirectory (StringView path);
 		
 		// set debug flags for all shaders
 		void SetDebugFlags (EShaderLangFormat flags);
 
-		ND_ EShaderCompilationFlags  GetCompilationFlags ()		{ EXLOCK( _lock );  return _compilerFlags; }
+		ND_ EShaderCompilationFlags  GetCompilationFlags ()		{ SHAREDLOCK( _lock );  return _compilerFlags; }
 
 		void ReleaseUnusedShaders ();
 		void ReleaseShaderCache ();
@@ -7,8 +7,40 @@
 #include "scene/Math/Sphere.h"
 #include "scene/Math/Camera.h"
 
+#if defined(__AVX__)
+#	include <immintrin.h>
+#	define FG_FRUSTUM_CULLING_AVX
+#endif
+#if defined(__SSE__) or defined(_M_X64) or (defined(_M_IX86_FP) and (_M_IX86_FP >= 1))
+#	include <xmmintrin.h>
+#	define FG_FRUSTUM_CULLING_SSE
+#endif
+
 namespace FGC
 {
+namespace _fgc_hidden_
+{
+	struct FrustumPlanesSoA
+	{
+		float	nx [6];
+		float	ny [6];
+		float	nz [6];
+		float	dist [6];
+	};
+	
+	// 'boxes' - array of { min.xyz, max.xyz },
+	// returns index of the first box that is not processed
+	inline size_t  FrustumCullAABB_Scalar (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits);
+
+#ifdef FG_FRUSTUM_CULLING_SSE
+	inline size_t  FrustumCullAABB_SSE (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits);
+#endif
+#ifdef FG_FRUSTUM_CULLING_AVX
+	inline size_t  FrustumCullAABB_AVX (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits);
+#endif
+
+}	// _fgc_hidden_
+
 
 	//
 	// Frustum
@@ -74,6 +106,9 @@ namespace FGC
 		ND_ bool IsVisible (const Vec3_t &point) const;
 		ND_ bool IsVisible (const FrustumTempl<T> &) const;
 
+		// batch version, bit 'i' in 'visibleBits' is set if 'boxes[i]' translated by 'offset' is visible
+			void GetVisibility (ArrayView<AxisAlignedBoundingBox<T>> boxes, const Vec3_t &offset, OUT Array<uint64_t> &visibleBits) const;
+
 		// experimental
 			void Test (const AxisAlignedBoundingBox<T> &, OUT bool &isVisible, OUT float &detailLevel) const;
 
@@ -212,6 +247,62 @@ namespace FGC
 		return inside;
 	}
 	
+/*
+=================================================
+	GetVisibility (AABB array)
+----
+	translation is added to the plane distance:
+	dot( n, p + offset ) + d == dot( n, p ) + (d + dot( n, offset ))
+=================================================
+*/
+	template <typename T>
+	inline void  FrustumTempl<T>::GetVisibility (ArrayView<AxisAlignedBoundingBox<T>> boxes, const Vec3_t &offset, OUT Array<uint64_t> &visibleBits) const
+	{
+		ASSERT( _initialized );
+
+		visibleBits.clear();
+		visibleBits.resize( (boxes.size() + 63) / 64, 0 );
+
+		if ( boxes.empty() )
+			return;
+
+		if constexpr( IsSameTypes< T, float >)
+		{
+			STATIC_ASSERT( sizeof(AxisAlignedBoundingBox<T>) == sizeof(float) * 6 );
+
+			_fgc_hidden_::FrustumPlanesSoA	planes;
+			for (size_t i = 0; i < _planes.size(); ++i)
+			{
+				auto&	plane	= _planes[i];
+				planes.nx[i]	= plane.norm.x;
+				planes.ny[i]	= plane.norm.y;
+				planes.nz[i]	= plane.norm.z;
+				planes.dist[i]	= plane.dist + dot( plane.norm, offset );
+			}
+
+			const float*	data	= &boxes.data()->min.x;
+			size_t			first	= 0;
+
+			#if defined(FG_FRUSTUM_CULLING_AVX)
+				first = _fgc_hidden_::FrustumCullAABB_AVX( planes, data, first, boxes.size(), _err, visibleBits.data() );
+			#endif
+			#if defined(FG_FRUSTUM_CULLING_SSE)
+				first = _fgc_hidden_::FrustumCullAABB_SSE( planes, data, first, boxes.size(), _err, visibleBits.data() );
+			#endif
+			first = _fgc_hidden_::FrustumCullAABB_Scalar( planes, data, first, boxes.size(), _err, visibleBits.data() );
+			ASSERT( first == boxes.size() );
+		}
+		else
+		{
+			for (size_t i = 0; i < boxes.size(); ++i)
+			{
+				auto	bbox = boxes[i];
+				bbox.Move( offset );
+				visibleBits[i >> 6] |= (uint64_t(IsVisible( bbox )) << (i & 63));
+			}
+		}
+	}
+
 /*
 =================================================
 	Test (AABB)
@@ -409,4 +500,135 @@ namespace FGC
 	}
 
 
+
+namespace _fgc_hidden_
+{
+/*
+=================================================
+	FrustumCullAABB_Scalar
+=================================================
+*/
+	inline size_t  FrustumCullAABB_Scalar (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits)
+	{
+		for (size_t i = first; i < count; ++i)
+		{
+			const float*	box		= boxes + i*6;
+			bool			inside	= true;
+
+			for (uint p = 0; p < CountOf(planes.dist); ++p)
+			{
+				const float	d = Max( box[0] * planes.nx[p], box[3] * planes.nx[p] ) +
+								Max( box[1] * planes.ny[p], box[4] * planes.ny[p] ) +
+								Max( box[2] * planes.nz[p], box[5] * planes.nz[p] ) +
+								planes.dist[p];
+				inside &= (d > -err);
+			}
+			bits[i >> 6] |= (uint64_t(inside) << (i & 63));
+		}
+		return count;
+	}
+	
+/*
+=================================================
+	FrustumCullAABB_SSE
+----
+	4 boxes per iteration
+=================================================
+*/
+#ifdef FG_FRUSTUM_CULLING_SSE
+	inline size_t  FrustumCullAABB_SSE (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits)
+	{
+		ASSERT( (first & 3) == 0 );
+
+		__m128	nx [6], ny [6], nz [6], dist [6];
+		for (uint p = 0; p < CountOf(nx); ++p)
+		{
+			nx[p]	= _mm_set1_ps( planes.nx[p] );
+			ny[p]	= _mm_set1_ps( planes.ny[p] );
+			nz[p]	= _mm_set1_ps( planes.nz[p] );
+			dist[p]	= _mm_set1_ps( planes.dist[p] );
+		}
+
+		const __m128	neg_err	= _mm_set1_ps( -err );
+		size_t			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const float*	box		= boxes + i*6;
+			const __m128	min_x	= _mm_setr_ps( box[0], box[ 6], box[12], box[18] );
+			const __m128	min_y	= _mm_setr_ps( box[1], box[ 7], box[13], box[19] );
+			const __m128	min_z	= _mm_setr_ps( box[2], box[ 8], box[14], box[20] );
+			const __m128	max_x	= _mm_setr_ps( box[3], box[ 9], box[15], box[21] );
+			const __m128	max_y	= _mm_setr_ps( box[4], box[10], box[16], box[22] );
+			const __m128	max_z	= _mm_setr_ps( box[5], box[11], box[17], box[23] );
+			__m128			inside	= _mm_cmpeq_ps( neg_err, neg_err );
+
+			for (uint p = 0; p < CountOf(nx); ++p)
+			{
+				__m128	d = _mm_max_ps( _mm_mul_ps( min_x, nx[p] ), _mm_mul_ps( max_x, nx[p] ));
+				d = _mm_add_ps( d, _mm_max_ps( _mm_mul_ps( min_y, ny[p] ), _mm_mul_ps( max_y, ny[p] )));
+				d = _mm_add_ps( d, _mm_max_ps( _mm_mul_ps( min_z, nz[p] ), _mm_mul_ps( max_z, nz[p] )));
+				d = _mm_add_ps( d, dist[p] );
+				inside = _mm_and_ps( inside, _mm_cmpgt_ps( d, neg_err ));
+			}
+
+			// 4 bits never cross 64 bit boundary
+			bits[i >> 6] |= (uint64_t(_mm_movemask_ps( inside )) << (i & 63));
+		}
+		return i;
+	}
+#endif	// FG_FRUSTUM_CULLING_SSE
+	
+/*
+=================================================
+	FrustumCullAABB_AVX
+----
+	8 boxes per iteration
+=================================================
+*/
+#ifdef FG_FRUSTUM_CULLING_AVX
+	inline size_t  FrustumCullAABB_AVX (const FrustumPlanesSoA &planes, const float *boxes, size_t first, size_t count, float err, uint64_t *bits)
+	{
+		ASSERT( (first & 7) == 0 );
+
+		__m256	nx [6], ny [6], nz [6], dist [6];
+		for (uint p = 0; p < CountOf(nx); ++p)
+		{
+			nx[p]	= _mm256_set1_ps( planes.nx[p] );
+			ny[p]	= _mm256_set1_ps( planes.ny[p] );
+			nz[p]	= _mm256_set1_ps( planes.nz[p] );
+			dist[p]	= _mm256_set1_ps( planes.dist[p] );
+		}
+
+		const __m256	neg_err	= _mm256_set1_ps( -err );
+		size_t			i		= first;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const float*	box		= boxes + i*6;
+			const __m256	min_x	= _mm256_setr_ps( box[0], box[ 6], box[12], box[18], box[24], box[30], box[36], box[42] );
+			const __m256	min_y	= _mm256_setr_ps( box[1], box[ 7], box[13], box[19], box[25], box[31], box[37], box[43] );
+			const __m256	min_z	= _mm256_setr_ps( box[2], box[ 8], box[14], box[20], box[26], box[32], box[38], box[44] );
+			const __m256	max_x	= _mm256_setr_ps( box[3], box[ 9], box[15], box[21], box[27], box[33], box[39], box[45] );
+			const __m256	max_y	= _mm256_setr_ps( box[4], box[10], box[16], box[22], box[28], box[34], box[40], box[46] );
+			const __m256	max_z	= _mm256_setr_ps( box[5], box[11], box[17], box[23], box[29], box[35], box[41], box[47] );
+			__m256			inside	= _mm256_cmp_ps( neg_err, neg_err, _CMP_EQ_OQ );
+
+			for (uint p = 0; p < CountOf(nx); ++p)
+			{
+				__m256	d = _mm256_max_ps( _mm256_mul_ps( min_x, nx[p] ), _mm256_mul_ps( max_x, nx[p] ));
+				d = _mm256_add_ps( d, _mm256_max_ps( _mm256_mul_ps( min_y, ny[p] ), _mm256_mul_ps( max_y, ny[p] )));
+				d = _mm256_add_ps( d, _mm256_max_ps( _mm256_mul_ps( min_z, nz[p] ), _mm256_mul_ps( max_z, nz[p] )));
+				d = _mm256_add_ps( d, dist[p] );
+				inside = _mm256_and_ps( inside, _mm256_cmp_ps( d, neg_err, _CMP_GT_OQ ));
+			}
+
+			// 8 bits never cross 64 bit boundary
+			bits[i >> 6] |= (uint64_t(_mm256_movemask_ps( inside )) << (i & 63));
+		}
+		return i;
+	}
+#endif	// FG_FRUSTUM_CULLING_AVX
+
+}	// _fgc_hidden_
 }	// FGC
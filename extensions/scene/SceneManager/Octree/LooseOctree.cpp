@@ -0,0 +1,377 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "scene/SceneManager/Octree/LooseOctree.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	Create
+=================================================
+*/
+	bool  LooseOctree::Create (const AABB &worldBounds, uint maxDepth)
+	{
+		CHECK_ERR( maxDepth < 32 );
+
+		Clear();
+
+		const vec3	half	= worldBounds.HalfExtent();
+		Node&		root	= _nodes.emplace_back();
+
+		root.center		= worldBounds.Center();
+		root.halfSize	= Max( half.x, half.y, half.z, 1.0e-4f );
+		_maxDepth		= maxDepth;
+		return true;
+	}
+	
+/*
+=================================================
+	Clear
+=================================================
+*/
+	void  LooseOctree::Clear ()
+	{
+		_nodes.clear();
+		_objects.clear();
+		_freeBlocks.clear();
+		_freeObject		= UMax;
+		_objectCount	= 0;
+		_maxDepth		= 0;
+	}
+	
+/*
+=================================================
+	Insert
+=================================================
+*/
+	LooseOctree::ObjectID  LooseOctree::Insert (const AABB &bounds)
+	{
+		CHECK_ERR( _nodes.size(), UMax );
+
+		ObjectID	id;
+		if ( _freeObject != UMax )
+		{
+			id			= _freeObject;
+			_freeObject	= _objects[id].next;
+		}
+		else
+		{
+			id = uint(_objects.size());
+			_objects.emplace_back();
+		}
+
+		_objects[id]		= Object{};
+		_objects[id].bounds	= bounds;
+
+		_Link( id, _FindNode( bounds ));
+		++_objectCount;
+		return id;
+	}
+	
+/*
+=================================================
+	Move
+----
+	object is linked to the new node before the old node is released,
+	so the path to the new node can't be released
+=================================================
+*/
+	bool  LooseOctree::Move (ObjectID id, const AABB &bounds)
+	{
+		CHECK_ERR( IsValid( id ));
+
+		const uint	old_node	= _objects[id].node;
+		const uint	new_node	= _FindNode( bounds );
+
+		_objects[id].bounds = bounds;
+
+		if ( old_node == new_node )
+			return true;
+
+		_Unlink( id );
+		_Link( id, new_node );
+		_ReleaseEmptyNodes( old_node );
+		return true;
+	}
+	
+/*
+=================================================
+	Remove
+=================================================
+*/
+	bool  LooseOctree::Remove (ObjectID id)
+	{
+		CHECK_ERR( IsValid( id ));
+
+		const uint	node_idx = _objects[id].node;
+
+		_Unlink( id );
+		_ReleaseEmptyNodes( node_idx );
+
+		_objects[id].node	= UMax;
+		_objects[id].next	= _freeObject;
+		_freeObject			= id;
+
+		--_objectCount;
+		return true;
+	}
+
+/*
+=================================================
+	Cull
+----
+	nodes are tested by loose bounds,
+	objects from all visible nodes are tested in a single batch
+=================================================
+*/
+	void  LooseOctree::Cull (const Frustum &frustum, const vec3 &offset, OUT Array<ObjectID> &visible) const
+	{
+		visible.clear();
+
+		if ( _objectCount == 0 )
+			return;
+
+		Array<uint>			stack;
+		Array<ObjectID>		candidates;
+		Array<AABB>			bounds;
+		Array<uint64_t>		visible_bits;
+
+		stack.reserve( _maxDepth * 8 + 1 );
+
+		// root node is not tested because it contains objects that are outside of the root bounds
+		stack.push_back( 0 );
+
+		for (; not stack.empty();)
+		{
+			const Node&	node = _nodes[ stack.back() ];
+			stack.pop_back();
+
+			for (uint obj = node.firstObject; obj != UMax; obj = _objects[obj].next)
+			{
+				candidates.push_back( obj );
+				bounds.push_back( _objects[obj].bounds );
+			}
+
+			if ( node.children == UMax )
+				continue;
+
+			for (uint i = 0; i < 8; ++i)
+			{
+				const Node&	child = _nodes[ node.children + i ];
+
+				if ( child.objectCount == 0 )
+					continue;
+
+				AABB	bbox = _GetLooseBounds( child );
+				bbox.Move( offset );
+
+				if ( frustum.IsVisible( bbox ))
+					stack.push_back( node.children + i );
+			}
+		}
+
+		frustum.GetVisibility( bounds, offset, OUT visible_bits );
+
+		for (size_t word = 0; word < visible_bits.size(); ++word)
+		for (uint64_t bits = visible_bits[word]; bits; bits &= (bits - 1))
+		{
+			visible.push_back( candidates[ (word << 6) + size_t(BitScanForward( bits )) ]);
+		}
+	}
+
+/*
+=================================================
+	_FindNode
+----
+	returns the deepest node where object is inside the loose bounds,
+	creates nodes if needed
+=================================================
+*/
+	uint  LooseOctree::_FindNode (const AABB &bounds)
+	{
+		const vec3	center	= bounds.Center();
+		const vec3	half	= bounds.HalfExtent();
+		const float	radius	= Max( half.x, half.y, half.z );
+
+		// outside of the root bounds
+		{
+			const Node&	root = _nodes[0];
+
+			if ( Abs( center.x - root.center.x ) > root.halfSize or
+				 Abs( center.y - root.center.y ) > root.halfSize or
+				 Abs( center.z - root.center.z ) > root.halfSize )
+				return 0;
+		}
+
+		uint	node_idx = 0;
+
+		for (uint depth = 0; depth < _maxDepth; ++depth)
+		{
+			// center is inside the child tight bounds, so object must not be greater than difference between loose and tight bounds
+			if ( radius > _nodes[node_idx].halfSize * 0.5f * (LooseFactor - 1.0f) )
+				break;
+
+			if ( _nodes[node_idx].children == UMax )
+				_Subdivide( node_idx );
+
+			const Node&	node = _nodes[node_idx];
+
+			node_idx = node.children + (center.x >= node.center.x ? 1 : 0) +
+									   (center.y >= node.center.y ? 2 : 0) +
+									   (center.z >= node.center.z ? 4 : 0);
+		}
+		return node_idx;
+	}
+	
+/*
+=================================================
+	_GetLooseBounds
+=================================================
+*/
+	AABB  LooseOctree::_GetLooseBounds (const Node &node) const
+	{
+		const vec3	half = vec3{ node.halfSize * LooseFactor };
+		AABB		result;
+
+		result.min = node.center - half;
+		result.max = node.center + half;
+		return result;
+	}
+
+/*
+=================================================
+	_Link
+=================================================
+*/
+	void  LooseOctree::_Link (ObjectID id, uint nodeIdx)
+	{
+		Object&	obj		= _objects[id];
+		Node&	node	= _nodes[nodeIdx];
+
+		obj.node	= nodeIdx;
+		obj.prev	= UMax;
+		obj.next	= node.firstObject;
+
+		if ( obj.next != UMax )
+			_objects[obj.next].prev = id;
+
+		node.firstObject = id;
+
+		for (uint n = nodeIdx; n != UMax; n = _nodes[n].parent) {
+			++_nodes[n].objectCount;
+		}
+	}
+	
+/*
+=================================================
+	_Unlink
+----
+	empty nodes are not released here
+=================================================
+*/
+	void  LooseOctree::_Unlink (ObjectID id)
+	{
+		Object&	obj		= _objects[id];
+		Node&	node	= _nodes[obj.node];
+
+		if ( obj.prev != UMax )
+			_objects[obj.prev].next = obj.next;
+		else
+		{
+			ASSERT( node.firstObject == id );
+			node.firstObject = obj.next;
+		}
+
+		if ( obj.next != UMax )
+			_objects[obj.next].prev = obj.prev;
+
+		for (uint n = obj.node; n != UMax; n = _nodes[n].parent)
+		{
+			ASSERT( _nodes[n].objectCount > 0 );
+			--_nodes[n].objectCount;
+		}
+
+		obj.prev = obj.next = UMax;
+	}
+
+/*
+=================================================
+	_Subdivide
+=================================================
+*/
+	void  LooseOctree::_Subdivide (uint nodeIdx)
+	{
+		ASSERT( _nodes[nodeIdx].children == UMax );
+
+		uint	first;
+		if ( _freeBlocks.size() )
+		{
+			first = _freeBlocks.back();
+			_freeBlocks.pop_back();
+		}
+		else
+		{
+			first = uint(_nodes.size());
+			_nodes.resize( _nodes.size() + 8 );
+		}
+
+		Node&		parent	= _nodes[nodeIdx];
+		const float	half	= parent.halfSize * 0.5f;
+
+		for (uint i = 0; i < 8; ++i)
+		{
+			Node&	child = _nodes[first + i];
+
+			child			= Node{};
+			child.center	= parent.center + vec3{ (i & 1 ? half : -half), (i & 2 ? half : -half), (i & 4 ? half : -half) };
+			child.halfSize	= half;
+			child.parent	= nodeIdx;
+		}
+
+		parent.children = first;
+	}
+	
+/*
+=================================================
+	_ReleaseEmptyNodes
+----
+	finds the top empty node in the parent chain and releases its children
+=================================================
+*/
+	void  LooseOctree::_ReleaseEmptyNodes (uint nodeIdx)
+	{
+		uint	top = UMax;
+
+		for (uint n = nodeIdx; n != UMax and _nodes[n].objectCount == 0; n = _nodes[n].parent) {
+			top = n;
+		}
+
+		if ( top != UMax )
+			_ReleaseChildren( top );
+	}
+	
+/*
+=================================================
+	_ReleaseChildren
+=================================================
+*/
+	void  LooseOctree::_ReleaseChildren (uint nodeIdx)
+	{
+		const uint	first = _nodes[nodeIdx].children;
+
+		if ( first == UMax )
+			return;
+
+		for (uint i = 0; i < 8; ++i)
+		{
+			ASSERT( _nodes[first + i].objectCount == 0 );
+			_ReleaseChildren( first + i );
+		}
+
+		_nodes[nodeIdx].children = UMax;
+		_freeBlocks.push_back( first );
+	}
+
+
+}	// FG
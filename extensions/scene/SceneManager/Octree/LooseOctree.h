@@ -0,0 +1,99 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Loose octree with loose factor 2.
+
+	Object is placed into the deepest node whose half size is not less than object half extent,
+	node is selected by object center, so object is always inside the loose bounds of the node.
+	Objects that are too big or outside of the root bounds are stored in the root node.
+
+	Nodes are stored in a single array, 8 children of a node are allocated as a contiguous block,
+	objects of a node are linked into intrusive list, so insert, move and remove
+	don't allocate memory if there are free slots.
+*/
+
+#pragma once
+
+#include "scene/Common.h"
+#include "scene/Math/Frustum.h"
+
+namespace FG
+{
+
+	//
+	// Loose Octree
+	//
+
+	class LooseOctree final
+	{
+	// types
+	public:
+		using ObjectID	= uint;		// index in '_objects'
+
+	private:
+		static constexpr float	LooseFactor	= 2.0f;
+
+		struct Node
+		{
+			vec3		center;
+			float		halfSize		= 0.0f;		// tight bounds, loose bounds are 'center +- halfSize * LooseFactor'
+			uint		parent			= UMax;
+			uint		children		= UMax;		// index of the first of 8 nodes in '_nodes'
+			uint		firstObject		= UMax;		// in '_objects'
+			uint		objectCount		= 0;		// in this node and all child nodes
+		};
+
+		struct Object
+		{
+			AABB		bounds;
+			uint		node		= UMax;		// UMax if slot is free
+			uint		prev		= UMax;		// in '_objects'
+			uint		next		= UMax;		// in '_objects', also used for free list
+		};
+
+
+	// variables
+	private:
+		Array< Node >		_nodes;
+		Array< Object >		_objects;
+		Array< uint >		_freeBlocks;			// first node of unused 8-node block
+		uint				_freeObject		= UMax;
+		uint				_objectCount	= 0;
+		uint				_maxDepth		= 0;
+
+
+	// methods
+	public:
+		LooseOctree () {}
+
+		bool  Create (const AABB &worldBounds, uint maxDepth = 8);
+		void  Clear ();
+
+		ND_ ObjectID  Insert (const AABB &bounds);
+			bool	  Move (ObjectID id, const AABB &bounds);
+			bool	  Remove (ObjectID id);
+
+		// returns visible objects, bounds are translated by 'offset' before test
+		void  Cull (const Frustum &frustum, const vec3 &offset, OUT Array<ObjectID> &visible) const;
+
+		ND_ bool		IsValid (ObjectID id)	const	{ return id < _objects.size() and _objects[id].node != UMax; }
+		ND_ AABB const&	GetBounds (ObjectID id)	const	{ ASSERT( IsValid( id )); return _objects[id].bounds; }
+		ND_ uint		ObjectCount ()			const	{ return _objectCount; }
+		ND_ size_t		NodeCount ()			const	{ return _nodes.size() - _freeBlocks.size() * 8; }
+
+		// returns max object index + 1
+		ND_ size_t		Capacity ()				const	{ return _objects.size(); }
+
+
+	private:
+		ND_ uint  _FindNode (const AABB &bounds);
+		ND_ AABB  _GetLooseBounds (const Node &node) const;
+
+		void  _Link (ObjectID id, uint nodeIdx);
+		void  _Unlink (ObjectID id);
+		void  _Subdivide (uint nodeIdx);
+		void  _ReleaseEmptyNodes (uint nodeIdx);
+		void  _ReleaseChildren (uint nodeIdx);
+	};
+
+
+}	// FG
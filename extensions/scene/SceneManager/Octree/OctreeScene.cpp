@@ -0,0 +1,321 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "scene/SceneManager/Octree/OctreeScene.h"
+#include "scene/Renderer/ScenePreRender.h"
+#include "scene/Renderer/RenderQueue.h"
+#include "scene/Renderer/IRenderTechnique.h"
+
+namespace FG
+{
+/*
+=================================================
+	constructor
+=================================================
+*/
+	OctreeScene::OctreeScene () :
+		_dirtyRange{ UMax, 0 }
+	{
+	}
+	
+/*
+=================================================
+	Create
+=================================================
+*/
+	bool OctreeScene::Create (const CommandBuffer &cmdbuf, const IntermScenePtr &scene, const ImageCachePtr &imageCache, const Transform &initialTransform, uint maxDepth)
+	{
+		CHECK_ERR( cmdbuf and scene and imageCache );
+
+		Destroy( cmdbuf->GetFrameGraph() );
+
+		CHECK_ERR( _sceneModels.Create( cmdbuf, scene, imageCache ));
+		CHECK_ERR( _ConvertHierarchy( scene, initialTransform, maxDepth ));
+		return true;
+	}
+	
+/*
+=================================================
+	Destroy
+=================================================
+*/
+	void OctreeScene::Destroy (const FrameGraph &fg)
+	{
+		CHECK_ERRV( fg );
+
+		_octree.Clear();
+		_instances.clear();
+		_transforms.clear();
+		_dirtyRange = uint2{ UMax, 0 };
+		_modelInfos.clear();
+		_sceneModels.Destroy( fg );
+
+		fg->ReleaseResource( _perInstanceBuffer );
+	}
+
+/*
+=================================================
+	Build
+=================================================
+*/
+	bool OctreeScene::Build (const CommandBuffer &cmdbuf, const RenderTechniquePtr &renTech)
+	{
+		CHECK_ERR( cmdbuf and renTech );
+
+		auto	fg = renTech->GetFrameGraph();
+
+		// upload all transformations
+		if ( _transforms.size() )
+			_dirtyRange = uint2{ 0, uint(_transforms.size()) };
+
+		CHECK_ERR( Update( cmdbuf ));
+		CHECK_ERR( _sceneModels.Build( fg, renTech, _perInstanceBuffer ));
+		return true;
+	}
+	
+/*
+=================================================
+	PreDraw
+=================================================
+*/
+	void OctreeScene::PreDraw (const CameraInfo &, ScenePreRender &preRender) const
+	{
+		preRender.AddScene( shared_from_this() );
+	}
+
+/*
+=================================================
+	Draw
+=================================================
+*/
+	void OctreeScene::Draw (RenderQueue &queue) const
+	{
+		const auto&	camera		= queue.GetCamera();
+		const auto&	camera_pos	= camera.camera.transform.position;
+
+		SceneModels::DrawBatches_t	batches;
+		Array< InstanceID >			visible;
+
+		// hierarchical frustum culling
+		_octree.Cull( camera.frustum, camera_pos, OUT visible );
+
+		for (auto inst_idx : visible)
+		{
+			auto&	info	= _modelInfos[ _instances[ inst_idx ].modelIndex ];
+			AABB	bbox	= _octree.GetBounds( inst_idx );
+			bbox.Move( camera_pos );
+
+			_sceneModels.AddDrawCommands( camera, info.lodRange, bbox, inst_idx, INOUT batches );
+		}
+
+		_sceneModels.Draw( queue, batches );
+	}
+	
+/*
+=================================================
+	AddInstance
+=================================================
+*/
+	bool OctreeScene::AddInstance (uint modelIndex, const Transform &transform, OUT InstanceID &id)
+	{
+		CHECK_ERR( modelIndex < _modelInfos.size() );
+
+		AABB	bbox = _modelInfos[ modelIndex ].boundingBox;
+		bbox.Transform( transform );
+
+		id = _octree.Insert( bbox );
+		CHECK_ERR( id != UMax );
+
+		if ( id >= _instances.size() )
+		{
+			_instances.resize( id + 1 );
+			_transforms.resize( id + 1 );
+		}
+
+		_instances[id].modelIndex	= modelIndex;
+		_transforms[id]				= transform;
+		_dirtyRange					= uint2{ Min( _dirtyRange.x, id ), Max( _dirtyRange.y, id + 1 )};
+
+		_boundingBox.Add( bbox );
+		return true;
+	}
+	
+/*
+=================================================
+	MoveInstance
+=================================================
+*/
+	bool OctreeScene::MoveInstance (InstanceID id, const Transform &transform)
+	{
+		CHECK_ERR( _octree.IsValid( id ));
+
+		AABB	bbox = _modelInfos[ _instances[id].modelIndex ].boundingBox;
+		bbox.Transform( transform );
+
+		CHECK_ERR( _octree.Move( id, bbox ));
+
+		_transforms[id]	= transform;
+		_dirtyRange		= uint2{ Min( _dirtyRange.x, id ), Max( _dirtyRange.y, id + 1 )};
+
+		_boundingBox.Add( bbox );
+		return true;
+	}
+	
+/*
+=================================================
+	RemoveInstance
+=================================================
+*/
+	bool OctreeScene::RemoveInstance (InstanceID id)
+	{
+		CHECK_ERR( _octree.Remove( id ));
+
+		_instances[id] = Instance{};
+		return true;
+	}
+	
+/*
+=================================================
+	Update
+----
+	uploads transformations that was changed since last call
+=================================================
+*/
+	bool OctreeScene::Update (const CommandBuffer &cmdbuf)
+	{
+		CHECK_ERR( cmdbuf );
+		CHECK_ERR( _UpdateBufferSize( cmdbuf->GetFrameGraph() ));
+
+		if ( _dirtyRange.x >= _dirtyRange.y )
+			return true;
+
+		const auto	transforms = ArrayView<Transform>{ _transforms }.section( _dirtyRange.x, _dirtyRange.y - _dirtyRange.x );
+
+		CHECK_ERR( cmdbuf->AddTask( UpdateBuffer{}.SetBuffer( _perInstanceBuffer ).AddData( transforms, SizeOf<Transform> * _dirtyRange.x )));
+
+		_dirtyRange = uint2{ UMax, 0 };
+		return true;
+	}
+	
+/*
+=================================================
+	_UpdateBufferSize
+----
+	recreates buffer if it is too small for all instances,
+	new buffer is bound to the models and all transformations will be uploaded
+=================================================
+*/
+	bool OctreeScene::_UpdateBufferSize (const FrameGraph &fg)
+	{
+		const uint	count		= Max( 1u, uint(_transforms.size()) );
+		BytesU		old_size;
+
+		if ( _perInstanceBuffer )
+		{
+			old_size = fg->GetDescription( _perInstanceBuffer ).size;
+
+			if ( SizeOf<Transform> * count <= old_size )
+				return true;
+
+			fg->ReleaseResource( INOUT _perInstanceBuffer );
+		}
+
+		// grow exponentially to avoid reallocation on each added instance
+		const BytesU	new_size = Max( SizeOf<Transform> * count, old_size * 2, SizeOf<Transform> * 256 );
+
+		_perInstanceBuffer = fg->CreateBuffer( BufferDesc{ new_size, EBufferUsage::Storage | EBufferUsage::TransferDst }, Default, "PerInstanceBuffer" );
+		CHECK_ERR( _perInstanceBuffer );
+
+		_sceneModels.SetPerInstanceBuffer( _perInstanceBuffer );
+
+		if ( _transforms.size() )
+			_dirtyRange = uint2{ 0, uint(_transforms.size()) };
+
+		return true;
+	}
+
+/*
+=================================================
+	_CreateModel
+=================================================
+*/
+	bool OctreeScene::_CreateModel (const IntermScenePtr &scene, const IntermScene::ModelData &modelData, OUT uint &modelIndex)
+	{
+		ModelInfo	info;
+		CHECK_ERR( _sceneModels.AddModel( scene, modelData, OUT info.lodRange, OUT info.boundingBox ));
+
+		modelIndex = uint(_modelInfos.size());
+		_modelInfos.push_back( info );
+		return true;
+	}
+
+/*
+=================================================
+	_ConvertHierarchy
+----
+	octree is created for the bounds of the source scene,
+	instances that will be added outside of these bounds are stored in the root node
+=================================================
+*/
+	bool OctreeScene::_ConvertHierarchy (const IntermScenePtr &scene, const Transform &initialTransform, uint maxDepth)
+	{
+		Array<Pair< uint, Transform >>	instances;
+
+		Array<Pair< IntermScene::SceneNode const*, Transform >>	stack;
+		stack.emplace_back( &scene->GetRoot(), initialTransform );
+
+		for (; not stack.empty();)
+		{
+			const auto	node		= stack.back();
+			const auto	transform	= node.second + node.first->localTransform;
+
+			for (auto& data : node.first->data)
+			{
+				CHECK_ERR( Visit( data,
+								  [&] (const IntermScene::ModelData &m)
+								  {
+									  uint	model_idx;
+									  if ( not _CreateModel( scene, m, OUT model_idx ))
+										  return false;
+
+									  instances.emplace_back( model_idx, transform );
+									  return true;
+								  },
+								  [] (const NullUnion &)	{ return false; }
+							));
+			}
+			
+			stack.pop_back();
+			for (auto& n : node.first->nodes) {
+				stack.emplace_back( &n, transform );
+			}
+		}
+
+		// calculate scene bounds
+		Optional<AABB>	bbox;
+		for (auto& inst : instances)
+		{
+			AABB	inst_bbox = _modelInfos[ inst.first ].boundingBox;
+			inst_bbox.Transform( inst.second );
+
+			if ( bbox.has_value() )
+				bbox->Add( inst_bbox );
+			else
+				bbox = inst_bbox;
+		}
+
+		_boundingBox = bbox.value_or( AABB{} );
+		CHECK_ERR( _octree.Create( _boundingBox, maxDepth ));
+
+		_instances.reserve( instances.size() );
+		_transforms.reserve( instances.size() );
+
+		for (auto& inst : instances)
+		{
+			InstanceID	id;
+			CHECK_ERR( AddInstance( inst.first, inst.second, OUT id ));
+		}
+		return true;
+	}
+
+
+}	// FG
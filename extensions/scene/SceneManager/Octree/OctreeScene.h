@@ -1,8 +1,18 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Scene hierarchy for large scenes.
+	Instances are stored in the loose octree, only instances in visible nodes are tested.
+
+	Instances can be added, moved and removed between frames,
+	call 'Update' to upload changed transformations before drawing.
+	These methods are not thread safe and must not be called during 'Draw'.
+*/
 
 #pragma once
 
-#include "scene/DefaultSceneManager/ISceneHierarchy.h"
+#include "scene/SceneManager/ISceneHierarchy.h"
+#include "scene/SceneManager/Octree/LooseOctree.h"
+#include "scene/SceneManager/Resources/SceneModels.h"
 
 namespace FG
 {
@@ -13,6 +23,67 @@ namespace FG
 
 	class OctreeScene final : public ISceneHierarchy
 	{
+	// types
+	public:
+		using InstanceID	= LooseOctree::ObjectID;
+
+	private:
+		struct Instance
+		{
+			uint			modelIndex		= UMax;		// in '_modelInfos'
+		};
+
+		// all layers and detail levels of the source model
+		struct ModelInfo
+		{
+			AABB			boundingBox;				// in local space
+			uint2			lodRange;					// in 'SceneModels::_modelLODs'
+		};
+
+
+	// variables
+	private:
+		LooseOctree				_octree;
+		AABB					_boundingBox;		// may be greater than actual bounds
+
+		Array< Instance >		_instances;			// same indices as in '_octree'
+		Array< Transform >		_transforms;		// same indices as in '_octree', copied to '_perInstanceBuffer'
+		uint2					_dirtyRange;		// range of instances that must be uploaded
+
+		Array< ModelInfo >		_modelInfos;
+		SceneModels				_sceneModels;
+		BufferID				_perInstanceBuffer;	// storage buffer, grows when new instances are added
+
+
+	// methods
+	public:
+		OctreeScene ();
+
+		bool Create (const CommandBuffer &, const IntermScenePtr &, const ImageCachePtr &, const Transform & = Default, uint maxDepth = 8);
+		void Destroy (const FrameGraph &) override;
+
+		bool Build (const CommandBuffer &, const RenderTechniquePtr &) override;
+		void PreDraw (const CameraInfo &, ScenePreRender &) const override;
+		void Draw (RenderQueue &) const override;
+
+		AABB  CalculateBoundingVolume () const override		{ return _boundingBox; }
+
+		// instances of the models from source scene
+		bool AddInstance (uint modelIndex, const Transform &, OUT InstanceID &);
+		bool MoveInstance (InstanceID, const Transform &);
+		bool RemoveInstance (InstanceID);
+
+		// upload changed transformations
+		bool Update (const CommandBuffer &);
+
+		ND_ uint  GetModelCount ()		const	{ return uint(_modelInfos.size()); }
+		ND_ uint  GetInstanceCount ()	const	{ return _octree.ObjectCount(); }
+
+
+	private:
+		bool _UpdateBufferSize (const FrameGraph &);
+		bool _ConvertHierarchy (const IntermScenePtr &, const Transform &, uint maxDepth);
+		bool _CreateModel (const IntermScenePtr &, const IntermScene::ModelData &, OUT uint &modelIndex);
 	};
 
 
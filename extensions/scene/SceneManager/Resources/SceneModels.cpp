@@ -0,0 +1,424 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "scene/SceneManager/Resources/SceneModels.h"
+#include "scene/SceneManager/IImageCache.h"
+#include "scene/Renderer/RenderQueue.h"
+#include "scene/Renderer/IRenderTechnique.h"
+#include "scene/Loader/Intermediate/IntermMesh.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	Create
+=================================================
+*/
+	bool SceneModels::Create (const CommandBuffer &cmdbuf, const IntermScenePtr &scene, const ImageCachePtr &imageCache)
+	{
+		CHECK_ERR( cmdbuf and scene and imageCache );
+
+		Destroy( cmdbuf->GetFrameGraph() );
+
+		CHECK_ERR( _ConvertMeshes( cmdbuf, scene ));
+		CHECK_ERR( _ConvertMaterials( cmdbuf, scene, imageCache ));
+		return true;
+	}
+	
+/*
+=================================================
+	Destroy
+=================================================
+*/
+	void SceneModels::Destroy (const FrameGraph &fg)
+	{
+		CHECK_ERRV( fg );
+
+		_modelLODs.clear();
+		_models.clear();
+		_meshes.clear();
+		_materials.clear();
+		_vertexAttribs.clear();
+
+		fg->ReleaseResource( _vertexBuffer );
+		fg->ReleaseResource( _indexBuffer );
+		fg->ReleaseResource( _materialsUB );
+	}
+
+/*
+=================================================
+	Build
+=================================================
+*/
+	bool SceneModels::Build (const FrameGraph &fg, const RenderTechniquePtr &renTech, RawBufferID perInstanceBuffer)
+	{
+		CHECK_ERR( fg and renTech and perInstanceBuffer );
+
+		auto		source_id = renTech->GetShaderBuilder()->CacheFileSource( "Scene/simple_scene.glsl" );
+
+		SamplerID	sampler = fg->CreateSampler( SamplerDesc{}.SetAddressMode( EAddressMode::Repeat )
+															  .SetFilter( EFilter::Linear, EFilter::Linear, EMipmapFilter::Linear ));
+		CHECK_ERR( sampler );
+
+		for (auto& model : _models)
+		{
+			auto&	mesh = _meshes[ model.meshID ];
+			auto&	mtr  = _materials[ model.materialID ];
+
+			CHECK_ERR( mesh.attribsIndex != UMax );
+
+			ShaderCache::GraphicsPipelineInfo	info;
+			info.attribs		= _vertexAttribs[mesh.attribsIndex];
+			info.textures		= mtr.textureBits;
+			info.detailLevel	= EDetailLevel::High;
+			info.sourceIDs.push_back( source_id );
+
+			if ( not renTech->GetPipeline( model.layer, info, OUT model.pipeline ))
+				continue;
+
+			CHECK_ERR( fg->InitPipelineResources( model.pipeline, DescriptorSetID{"PerObject"}, OUT model.resources ));
+
+			if ( mtr.albedoTex )
+				model.resources.BindTexture( UniformID{"un_AlbedoTex"}, mtr.albedoTex, sampler );
+
+			if ( mtr.specularTex )
+				model.resources.BindTexture( UniformID{"un_SpecularTex"}, mtr.specularTex, sampler );
+
+			if ( mtr.roughtnessTex )
+				model.resources.BindTexture( UniformID{"un_RoughtnessTex"}, mtr.roughtnessTex, sampler );
+
+			if ( mtr.metallicTex )
+				model.resources.BindTexture( UniformID{"un_MetallicTex"}, mtr.metallicTex, sampler );
+
+			model.resources.BindBuffer( UniformID{"PerInstanceSSB"}, perInstanceBuffer );
+			//model.resources.BindBuffer( UniformID{"MaterialsUB"}, _materialsUB );
+		}
+
+		Unused( sampler.Release() );
+		return true;
+	}
+	
+/*
+=================================================
+	SetPerInstanceBuffer
+----
+	rebind buffer with transformations after it was recreated
+=================================================
+*/
+	void SceneModels::SetPerInstanceBuffer (RawBufferID perInstanceBuffer)
+	{
+		for (auto& model : _models)
+		{
+			if ( model.pipeline )
+				model.resources.BindBuffer( UniformID{"PerInstanceSSB"}, perInstanceBuffer );
+		}
+	}
+
+/*
+=================================================
+	AddModel
+=================================================
+*/
+	bool SceneModels::AddModel (const IntermScenePtr &scene, const IntermScene::ModelData &modelData, OUT uint2 &lodRange, OUT AABB &boundingBox)
+	{
+		lodRange.x = uint(_modelLODs.size());
+		
+		// find all layers
+		LayerBits		layers;
+		for (auto& level : modelData.levels) 
+		{
+			if ( level.first and level.second )
+				layers |= level.second->GetRenderLayers();
+		}
+
+		Optional<AABB>	bbox;
+
+		for (size_t i = 0; i < layers.size(); ++i)
+		{
+			ModelLevel	lod;
+			lod.layer	= ERenderLayer(i);
+
+			for (size_t j = 0; j < lod.levels.size(); ++j)
+			{
+				if ( j >= modelData.levels.size()		or
+					 not modelData.levels[j].first		or
+					 not modelData.levels[j].second		or
+					 not modelData.levels[j].second->GetRenderLayers()[i] )
+				{
+					lod.levels[j] = UMax;
+					continue;
+				}
+
+				lod.levels[j] = uint(_models.size());
+
+				Model		model;
+				model.meshID	 = scene->GetIndexOfMesh( modelData.levels[j].first );
+				model.materialID = scene->GetIndexOfMaterial( modelData.levels[j].second );
+				model.layer		 = ERenderLayer(i);
+				_models.push_back( model );
+				
+				if ( bbox.has_value() )
+					bbox->Add( _meshes[model.meshID].boundingBox );
+				else
+					bbox = _meshes[model.meshID].boundingBox;
+			}
+
+			_modelLODs.push_back( lod );
+		}
+		
+		lodRange.y	= uint(_modelLODs.size());
+		boundingBox	= bbox.value_or( AABB{} );
+		ASSERT( lodRange.y > lodRange.x );
+		return true;
+	}
+	
+/*
+=================================================
+	AddDrawCommands
+=================================================
+*/
+	void SceneModels::AddDrawCommands (const CameraInfo &camera, const uint2 &lodRange, const AABB &boundingBox, uint instanceIndex, INOUT DrawBatches_t &batches) const
+	{
+		const float	inv_range	= 1.0f / camera.visibilityRange[1];
+		const uint	min_detail	= uint(camera.detailRange.min);
+
+		// calc detail level
+		auto	sphere	= boundingBox.ToOuterSphere();
+		float	dist	= Max( 0.0f, length( sphere.center ) - sphere.radius ) * inv_range;
+		auto	detail	= EDetailLevel(Max( min_detail, uint(mix( float(camera.detailRange.min), float(camera.detailRange.max), dist ) + 0.5f) ));
+
+		if ( detail > camera.detailRange.max )
+			return;	// detail level is too small
+
+		for (uint i = lodRange.x; i < lodRange.y; ++i)
+		{
+			auto&	lod			= _modelLODs[i];
+			uint	model_idx	= UMax;
+
+			// if level is not present then use nearest level with higher detail
+			for (uint lvl = uint(detail) + 1; model_idx == UMax and lvl-- > min_detail;) {
+				model_idx = lod.levels[lvl];
+			}
+
+			if ( model_idx == UMax					or
+				 not camera.layers[uint(lod.layer)] or
+				 not _models[ model_idx ].pipeline )
+				continue;
+
+			auto&	model	= _models[ model_idx ];
+			auto&	mesh	= _meshes[ model.meshID ];
+
+			DrawBatch*	batch = null;
+			for (auto& b : batches)
+			{
+				if ( b.pipeline == model.pipeline and b.attribsIndex == mesh.attribsIndex and b.topology == mesh.topology and
+					 b.cullMode == mesh.cullMode and b.layer == lod.layer )
+				{
+					batch = &b;
+					break;
+				}
+			}
+
+			if ( not batch )
+			{
+				batch				= &batches.emplace_back();
+				batch->pipeline		= model.pipeline;
+				batch->attribsIndex	= mesh.attribsIndex;
+				batch->topology		= mesh.topology;
+				batch->cullMode		= mesh.cullMode;
+				batch->layer		= lod.layer;
+			}
+
+			auto&	cmd = batch->commands.emplace_back();
+			cmd.indexCount		= mesh.indexCount;
+			cmd.firstIndex		= mesh.firstIndex;
+			cmd.vertexOffset	= int(mesh.vertexOffset);
+
+			batch->resources.push_back( &model.resources );
+			batch->pushConstants.push_back( uint2{model.materialID, instanceIndex} );
+		}
+	}
+	
+/*
+=================================================
+	Draw
+=================================================
+*/
+	void SceneModels::Draw (RenderQueue &queue, ArrayView<DrawBatch> batches) const
+	{
+		for (auto& batch : batches)
+		{
+			DrawIndexedBatch	draw_task;
+			draw_task.pipeline		= batch.pipeline;
+			draw_task.vertexInput	= _vertexAttribs[batch.attribsIndex]->GetVertexInput();
+			draw_task.vertexInput.Bind( Default, _vertexStride, 0 );
+
+			draw_task.AddVertexBuffer( Default, _vertexBuffer )
+					 .SetIndexBuffer( _indexBuffer, 0_b, _indexType )
+					 .SetTopology( batch.topology ).SetCullMode( batch.cullMode )
+					 .SetCommands( batch.commands )
+					 .SetPerDrawResources( DescriptorSetID{"PerObject"}, batch.resources )
+					 .SetPerDrawPushConstants( PushConstantID{"VSPushConst"}, ArrayView<uint2>{ batch.pushConstants });
+
+			queue.Draw( batch.layer, draw_task );
+		}
+	}
+
+/*
+=================================================
+	_ConvertMeshes
+=================================================
+*/
+	bool SceneModels::_ConvertMeshes (const CommandBuffer &cmdbuf, const IntermScenePtr &scene)
+	{
+		HashMap< VertexAttributesPtr, size_t >	attribs;
+
+		FrameGraph	fg = cmdbuf->GetFrameGraph();
+
+		BytesU	vert_stride, idx_stride;
+		for (auto& src : scene->GetMeshes())
+		{
+			vert_stride	= Max( vert_stride, src.first->GetVertexStride() );
+			idx_stride	= Max( idx_stride,  src.first->GetIndexStride() );
+		}
+
+		BytesU	vert_size, idx_size;
+		for (auto& src : scene->GetMeshes())
+		{
+			vert_size = AlignToLarger( vert_size + ArraySizeOf(src.first->GetVertices()), vert_stride );
+			idx_size  = AlignToLarger( idx_size  + ArraySizeOf(src.first->GetIndices()),  idx_stride  );
+
+			src.first->CalcAABB();
+			attribs.insert({ src.first->GetAttribs(), attribs.size() });
+		}
+
+		_vertexBuffer	= fg->CreateBuffer( BufferDesc{ vert_size, EBufferUsage::Vertex | EBufferUsage::TransferDst });
+		_indexBuffer	= fg->CreateBuffer( BufferDesc{ idx_size,  EBufferUsage::Index  | EBufferUsage::TransferDst });
+		_indexType		= EIndex::UInt;
+
+		vert_size = idx_size = 0_b;
+		_meshes.resize( scene->GetMeshes().size() );
+
+		Task	last_task;
+		for (auto& src : scene->GetMeshes())
+		{
+			Mesh&	dst = _meshes[ src.second ];
+
+			dst.boundingBox		= src.first->GetAABB().value();
+			dst.attribsIndex	= uint(attribs.find( src.first->GetAttribs() )->second);
+			dst.topology		= src.first->GetTopology();
+			dst.vertexOffset	= uint(vert_size / vert_stride);
+			dst.firstIndex		= uint(idx_size / idx_stride);
+			dst.indexCount		= uint(src.first->GetIndexCount());
+
+			// copy vertices
+			{
+				RawBufferID	id;
+				BytesU		offset;
+				void*		dst_ptr	= null;
+				BytesU		size	= src.first->GetVertexCount() * vert_stride;
+				const void*	src_ptr	= src.first->GetVertices().data();
+
+				CHECK_ERR( cmdbuf->AllocBuffer( size, vert_stride, OUT id, OUT offset, OUT dst_ptr ));
+
+				for (size_t i = 0, cnt = src.first->GetVertexCount(); i < cnt; ++i)
+				{
+					std::memcpy( dst_ptr, src_ptr, size_t(src.first->GetVertexStride()) );
+					src_ptr	+= src.first->GetVertexStride();
+					dst_ptr	+= vert_stride;
+				}
+
+				last_task = cmdbuf->AddTask( CopyBuffer{}.From( id ).To( _vertexBuffer ).AddRegion( offset, vert_size, size ).DependsOn( last_task ));
+			}
+
+			// copy indices
+			{
+				RawBufferID	id;
+				BytesU		offset;
+				void*		dst_ptr	= null;
+				BytesU		size	= src.first->GetIndexCount() * idx_stride;
+				const void*	src_ptr	= src.first->GetIndices().data();
+
+				CHECK_ERR( cmdbuf->AllocBuffer( size, idx_stride, OUT id, OUT offset, OUT dst_ptr ));
+
+				for (size_t i = 0, cnt = src.first->GetIndexCount(); i < cnt; ++i)
+				{
+					std::memcpy( dst_ptr, src_ptr, size_t(src.first->GetIndexStride()) );
+					src_ptr	+= src.first->GetIndexStride();
+					dst_ptr	+= idx_stride;
+				}
+
+				last_task = cmdbuf->AddTask( CopyBuffer{}.From( id ).To( _indexBuffer ).AddRegion( offset, idx_size, size ).DependsOn( last_task ));
+			}
+
+			vert_size = AlignToLarger( vert_size + ArraySizeOf(src.first->GetVertices()), vert_stride );
+			idx_size  = AlignToLarger( idx_size  + ArraySizeOf(src.first->GetIndices()),  idx_stride  );
+
+			if ( src.first == scene->GetMeshes().begin()->first )
+				_boundingBox = dst.boundingBox;
+			else
+				_boundingBox.Add( dst.boundingBox );
+
+			CHECK( src.first->GetIndexType() == _indexType );
+		}
+
+		_vertexStride = vert_stride;
+		_vertexAttribs.resize( attribs.size() );
+
+		for (auto& src : attribs) {
+			_vertexAttribs[src.second] = src.first;
+		}
+
+		return true;
+	}
+	
+/*
+=================================================
+	_ConvertMaterials
+=================================================
+*/
+	bool SceneModels::_ConvertMaterials (const CommandBuffer &cmdbuf, const IntermScenePtr &scene, const ImageCachePtr &imageCache)
+	{
+		using MtrTexture = IntermMaterial::MtrTexture;
+
+		_materials.resize( scene->GetMaterials().size() );
+
+		for (auto& src : scene->GetMaterials())
+		{
+			CHECK_ERR( src.first->GetRenderLayers() != Default );
+
+			auto&		settings = src.first->GetSettings();
+			Material&	dst		 = _materials[ src.second ];
+
+			dst.dataID = uint(_materials.size());
+
+			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.albedo ))
+			{
+				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.albedoTex ));
+				dst.textureBits |= ETextureType::Albedo;
+			}
+
+			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.specular ))
+			{
+				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.specularTex ));
+				dst.textureBits |= ETextureType::Specular;
+			}
+
+			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.roughtness ))
+			{
+				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.roughtnessTex ));
+				dst.textureBits |= ETextureType::Roughtness;
+			}
+
+			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.metallic ))
+			{
+				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.metallicTex ));
+				dst.textureBits |= ETextureType::Metallic;
+			}
+		}
+
+		return true;
+	}
+
+
+}	// FG
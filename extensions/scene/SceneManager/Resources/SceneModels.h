@@ -0,0 +1,136 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Meshes, materials and models converted from intermediate scene.
+	Used by scene hierarchies that draw models with 'Scene/simple_scene.glsl',
+	hierarchy only stores instances and makes culling.
+*/
+
+#pragma once
+
+#include "scene/Loader/Intermediate/IntermScene.h"
+#include "scene/Math/AABB.h"
+
+namespace FG
+{
+
+	//
+	// Scene Models
+	//
+
+	class SceneModels final
+	{
+	// types
+	public:
+		// draw calls with the same pipeline and render states are merged into single task
+		struct DrawBatch
+		{
+			RawGPipelineID						pipeline;
+			uint								attribsIndex	= UMax;		// in '_vertexAttribs'
+			EPrimitive							topology		= Default;
+			ECullMode							cullMode		= Default;
+			ERenderLayer						layer			= Default;
+
+			Array< DrawIndexedBatch::DrawCmd >	commands;
+			Array< PipelineResources const* >	resources;
+			Array< uint2 >						pushConstants;
+		};
+
+		using DrawBatches_t		= Array< DrawBatch >;
+
+	private:
+		struct Model
+		{
+			RawGPipelineID		pipeline;
+			PipelineResources	resources;
+			uint				materialID		= UMax;		// in '_materials'
+			uint				meshID			= UMax;		// in '_meshes'
+			ERenderLayer		layer			= Default;
+
+			Model () {}
+		};
+
+		struct Mesh
+		{
+			AABB			boundingBox;
+			EPrimitive		topology		= Default;
+			ECullMode		cullMode		= Default;
+			uint			attribsIndex	= UMax;		// in '_vertexAttribs'
+			uint			patchSize		= 0;		// for tessellation
+			uint			vertexOffset	= 0;
+			uint			indexCount		= 0;
+			uint			firstIndex		= 0;
+		};
+
+		struct Material
+		{
+			RawImageID		albedoTex;
+			RawImageID		specularTex;
+			RawImageID		roughtnessTex;
+			RawImageID		metallicTex;
+			ETextureType	textureBits		= Default;
+			uint			dataID			= UMax;		// in '_materialsUB'
+		};
+
+		using ModelLevels_t	= StaticArray< uint, uint(EDetailLevel::_Count) >;
+
+		struct ModelLevel
+		{
+			ModelLevels_t	levels;				// in '_models'
+			ERenderLayer	layer	= Default;
+		};
+
+		using VertexAttribs_t	= Array< VertexAttributesPtr >;
+		using DetailLevels_t	= Array< ModelLevel >;
+
+
+	// variables
+	private:
+		AABB					_boundingBox;		// bounds of all meshes
+
+		DetailLevels_t			_modelLODs;
+		Array< Model >			_models;
+		Array< Mesh >			_meshes;
+		Array< Material >		_materials;
+
+		VertexAttribs_t			_vertexAttribs;
+		BufferID				_vertexBuffer;
+		BufferID				_indexBuffer;
+		BufferID				_materialsUB;
+		BytesU					_vertexStride;
+		EIndex					_indexType		= Default;
+
+
+	// methods
+	public:
+		SceneModels () {}
+
+		bool Create (const CommandBuffer &, const IntermScenePtr &, const ImageCachePtr &);
+		void Destroy (const FrameGraph &);
+
+		// create pipelines and descriptor sets with new render technique
+		// 'perInstanceBuffer' is a storage buffer with transformations, indexed by instance
+		bool Build (const FrameGraph &, const RenderTechniquePtr &, RawBufferID perInstanceBuffer);
+
+		// must be called when buffer with transformations was recreated after 'Build'
+		void SetPerInstanceBuffer (RawBufferID perInstanceBuffer);
+
+		// add all layers and detail levels of the source model,
+		// returns range in '_modelLODs' and bounding box in local space
+		bool AddModel (const IntermScenePtr &, const IntermScene::ModelData &, OUT uint2 &lodRange, OUT AABB &boundingBox);
+
+		// select detail level and add draw commands of visible instance,
+		// bounding box must be relative to the camera position
+		void AddDrawCommands (const CameraInfo &, const uint2 &lodRange, const AABB &boundingBox, uint instanceIndex, INOUT DrawBatches_t &) const;
+
+		void Draw (RenderQueue &, ArrayView<DrawBatch>) const;
+
+		ND_ AABB const&  GetBoundingBox () const	{ return _boundingBox; }
+
+
+	private:
+		bool _ConvertMeshes (const CommandBuffer &, const IntermScenePtr &);
+		bool _ConvertMaterials (const CommandBuffer &, const IntermScenePtr &, const ImageCachePtr &);
+	};
+
+
+}	// FG
@@ -1,18 +1,12 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
 
 #include "scene/SceneManager/Simple/SimpleScene.h"
-#include "scene/SceneManager/IImageCache.h"
 #include "scene/Renderer/ScenePreRender.h"
 #include "scene/Renderer/RenderQueue.h"
 #include "scene/Renderer/IRenderTechnique.h"
-#include "scene/Loader/Intermediate/IntermMesh.h"
 
 namespace FG
 {
-namespace {
-	static constexpr uint		max_instance_count = 1 << 10;
-}
-
 /*
 =================================================
 	constructor
@@ -33,8 +27,7 @@ namespace {
 
 		Destroy( cmdbuf->GetFrameGraph() );
 
-		CHECK_ERR( _ConvertMeshes( cmdbuf, scene ));
-		CHECK_ERR( _ConvertMaterials( cmdbuf, scene, imageCache ));
+		CHECK_ERR( _sceneModels.Create( cmdbuf, scene, imageCache ));
 		CHECK_ERR( _ConvertHierarchy( scene, initialTransform ));
 		return true;
 	}
@@ -49,16 +42,10 @@ namespace {
 		CHECK_ERRV( fg );
 
 		_instances.clear();
-		_modelLODs.clear();
-		_models.clear();
-		_meshes.clear();
-		_materials.clear();
-		_vertexAttribs.clear();
+		_instanceBounds.clear();
+		_sceneModels.Destroy( fg );
 
-		fg->ReleaseResource( _vertexBuffer );
-		fg->ReleaseResource( _indexBuffer );
-		fg->ReleaseResource( _perInstanceUB );
-		fg->ReleaseResource( _materialsUB );
+		fg->ReleaseResource( _perInstanceBuffer );
 	}
 
 /*
@@ -73,7 +60,7 @@ namespace {
 		auto	fg = renTech->GetFrameGraph();
 
 		CHECK_ERR( _UpdatePerObjectUniforms( fg ));
-		CHECK_ERR( _BuildModels( fg, renTech ));
+		CHECK_ERR( _sceneModels.Build( fg, renTech, _perInstanceBuffer ));
 		return true;
 	}
 	
@@ -95,61 +82,25 @@ namespace {
 	void SimpleScene::Draw (RenderQueue &queue) const
 	{
 		const auto&	camera		= queue.GetCamera();
-		//const auto&	camera_pos	= camera.camera.transform.position;
-		const float	inv_range	= 1.0f / camera.visibilityRange[1];
-		const int	first_layer	= BitScanForward( camera.layers.to_ulong() );
-		const int	last_layer	= BitScanReverse( camera.layers.to_ulong() );
-
-		for (size_t inst_idx = 0; inst_idx < _instances.size(); ++inst_idx)
-		{
-			auto&	inst = _instances[ inst_idx ];
-			
-			/*AABB	bbox = inst.boundingBox;
-			bbox.Move( camera_pos );
-
-			// frustum culling
-			if ( not camera.frustum.IsVisible( bbox ))
-				continue;
+		const auto&	camera_pos	= camera.camera.transform.position;
 
-			// calc detail level
-			auto	sphere	= bbox.ToOuterSphere();
-			float	dist	= Max( 0.0f, length( sphere.center ) - sphere.radius ) * inv_range;
-			auto	detail	= EDetailLevel(Max( uint(camera.detailRange.min), uint(mix( float(camera.detailRange.min), float(camera.detailRange.max), dist ) + 0.5f) ));
+		SceneModels::DrawBatches_t	batches;
+		Array< uint64_t >			visible_bits;
 
-			if ( detail > camera.detailRange.max )
-				continue;	// detail level is too small*/
+		// frustum culling
+		camera.frustum.GetVisibility( _instanceBounds, camera_pos, OUT visible_bits );
 
-			auto	detail	= EDetailLevel::High;
-
-			for (uint i = inst.index; i < inst.lastIndex; ++i)
-			{
-				auto&	lod			= _modelLODs[i];
-				uint	model_idx	= lod.levels[uint(detail)];
-
-				if ( model_idx == UMax					or
-					 not camera.layers[uint(lod.layer)] or
-					 not _models[ model_idx ].pipeline )
-					continue;
-
-				auto&	model	= _models[ model_idx ];
-				auto&	mesh	= _meshes[ model.meshID ];
-				//auto&	mtr		= _materials[ model.materialID ];
-
-				DrawIndexed		draw_task;
-				draw_task.pipeline		= model.pipeline;
-				draw_task.vertexInput	= _vertexAttribs[mesh.attribsIndex]->GetVertexInput();
-				draw_task.vertexInput.Bind( Default, _vertexStride, 0 );
-
-				draw_task.AddVertexBuffer( Default, _vertexBuffer )
-						 .SetIndexBuffer( _indexBuffer, 0_b, _indexType )
-						 .SetTopology( mesh.topology ).SetCullMode( mesh.cullMode )
-						 .Draw( mesh.indexCount, 1, mesh.firstIndex, mesh.vertexOffset )
-						 .AddResources( DescriptorSetID{"PerObject"}, &model.resources )
-						 .AddPushConstant( PushConstantID{"VSPushConst"}, uint2{model.materialID, uint(inst_idx)} );
+		for (size_t word = 0; word < visible_bits.size(); ++word)
+		for (uint64_t bits = visible_bits[word]; bits; bits &= (bits - 1))
+		{
+			const size_t	inst_idx	= (word << 6) + size_t(BitScanForward( bits ));
+			AABB			bbox		= _instanceBounds[ inst_idx ];
+			bbox.Move( camera_pos );
 
-				queue.Draw( lod.layer, draw_task );
-			}
+			_sceneModels.AddDrawCommands( camera, _instances[ inst_idx ].lodRange, bbox, uint(inst_idx), INOUT batches );
 		}
+
+		_sceneModels.Draw( queue, batches );
 	}
 	
 /*
@@ -159,24 +110,22 @@ namespace {
 */
 	bool SimpleScene::_UpdatePerObjectUniforms (const FrameGraph &fg)
 	{
-		CHECK_ERR( _instances.size() <= max_instance_count );
-
-		const BytesU	size = SizeOf<Transform> * max_instance_count;
+		const BytesU	size = SizeOf<Transform> * Max( 1u, uint(_instances.size()) );
 
-		if ( _perInstanceUB and size > fg->GetDescription( _perInstanceUB ).size )
+		if ( _perInstanceBuffer and size > fg->GetDescription( _perInstanceBuffer ).size )
 		{
-			fg->ReleaseResource( INOUT _perInstanceUB );
+			fg->ReleaseResource( INOUT _perInstanceBuffer );
 		}
 
-		if ( not _perInstanceUB )
+		if ( not _perInstanceBuffer )
 		{
-			_perInstanceUB = fg->CreateBuffer( BufferDesc{ size, EBufferUsage::Uniform }, MemoryDesc{ EMemoryType::HostWrite }, "PerInstanceUB" );
-			CHECK_ERR( _perInstanceUB );
+			_perInstanceBuffer = fg->CreateBuffer( BufferDesc{ size, EBufferUsage::Storage }, MemoryDesc{ EMemoryType::HostWrite }, "PerInstanceBuffer" );
+			CHECK_ERR( _perInstanceBuffer );
 		}
 		
 		BytesU	mapped_size = size;
 		void*	mapped_ptr	= null;
-		CHECK_ERR( fg->MapBufferRange( _perInstanceUB, 0_b, INOUT mapped_size, OUT mapped_ptr ));
+		CHECK_ERR( fg->MapBufferRange( _perInstanceBuffer, 0_b, INOUT mapped_size, OUT mapped_ptr ));
 
 		for (size_t i = 0; i < _instances.size(); ++i)
 		{
@@ -187,214 +136,6 @@ namespace {
 		return true;
 	}
 	
-/*
-=================================================
-	_BuildModels
-=================================================
-*/
-	bool SimpleScene::_BuildModels (const FrameGraph &fg, const RenderTechniquePtr &renTech)
-	{
-		auto		source_id = renTech->GetShaderBuilder()->CacheFileSource( "Scene/simple_scene.glsl" );
-
-		SamplerID	sampler = fg->CreateSampler( SamplerDesc{}.SetAddressMode( EAddressMode::Repeat )
-															  .SetFilter( EFilter::Linear, EFilter::Linear, EMipmapFilter::Linear ));
-		CHECK_ERR( sampler );
-
-		for (auto& model : _models)
-		{
-			auto&	mesh = _meshes[ model.meshID ];
-			auto&	mtr  = _materials[ model.materialID ];
-
-			CHECK_ERR( mesh.attribsIndex != UMax );
-
-			ShaderCache::GraphicsPipelineInfo	info;
-			info.attribs		= _vertexAttribs[mesh.attribsIndex];
-			info.textures		= mtr.textureBits;
-			info.detailLevel	= EDetailLevel::High;
-			info.sourceIDs.push_back( source_id );
-			info.constants.emplace_back( "MAX_INSTANCE_COUNT", max_instance_count );
-
-			if ( not renTech->GetPipeline( model.layer, info, OUT model.pipeline ))
-				continue;
-
-			CHECK_ERR( fg->InitPipelineResources( model.pipeline, DescriptorSetID{"PerObject"}, OUT model.resources ));
-
-			if ( mtr.albedoTex )
-				model.resources.BindTexture( UniformID{"un_AlbedoTex"}, mtr.albedoTex, sampler );
-
-			if ( mtr.specularTex )
-				model.resources.BindTexture( UniformID{"un_SpecularTex"}, mtr.specularTex, sampler );
-
-			if ( mtr.roughtnessTex )
-				model.resources.BindTexture( UniformID{"un_RoughtnessTex"}, mtr.roughtnessTex, sampler );
-
-			if ( mtr.metallicTex )
-				model.resources.BindTexture( UniformID{"un_MetallicTex"}, mtr.metallicTex, sampler );
-
-			model.resources.BindBuffer( UniformID{"PerInstanceUB"}, _perInstanceUB );
-			//model.resources.BindBuffer( UniformID{"MaterialsUB"}, _materialsUB );
-		}
-
-		Unused( sampler.Release() );
-		return true;
-	}
-
-/*
-=================================================
-	_ConvertMeshes
-=================================================
-*/
-	bool SimpleScene::_ConvertMeshes (const CommandBuffer &cmdbuf, const IntermScenePtr &scene)
-	{
-		HashMap< VertexAttributesPtr, size_t >	attribs;
-
-		FrameGraph	fg = cmdbuf->GetFrameGraph();
-
-		BytesU	vert_stride, idx_stride;
-		for (auto& src : scene->GetMeshes())
-		{
-			vert_stride	= Max( vert_stride, src.first->GetVertexStride() );
-			idx_stride	= Max( idx_stride,  src.first->GetIndexStride() );
-		}
-
-		BytesU	vert_size, idx_size;
-		for (auto& src : scene->GetMeshes())
-		{
-			vert_size = AlignToLarger( vert_size + ArraySizeOf(src.first->GetVertices()), vert_stride );
-			idx_size  = AlignToLarger( idx_size  + ArraySizeOf(src.first->GetIndices()),  idx_stride  );
-
-			src.first->CalcAABB();
-			attribs.insert({ src.first->GetAttribs(), attribs.size() });
-		}
-
-		_vertexBuffer	= fg->CreateBuffer( BufferDesc{ vert_size, EBufferUsage::Vertex | EBufferUsage::TransferDst });
-		_indexBuffer	= fg->CreateBuffer( BufferDesc{ idx_size,  EBufferUsage::Index  | EBufferUsage::TransferDst });
-		_indexType		= EIndex::UInt;
-
-		vert_size = idx_size = 0_b;
-		_meshes.resize( scene->GetMeshes().size() );
-
-		Task	last_task;
-		for (auto& src : scene->GetMeshes())
-		{
-			Mesh&	dst = _meshes[ src.second ];
-
-			dst.boundingBox		= src.first->GetAABB().value();
-			dst.attribsIndex	= uint(attribs.find( src.first->GetAttribs() )->second);
-			dst.topology		= src.first->GetTopology();
-			dst.vertexOffset	= uint(vert_size / vert_stride);
-			dst.firstIndex		= uint(idx_size / idx_stride);
-			dst.indexCount		= uint(src.first->GetIndexCount());
-
-			// copy vertices
-			{
-				RawBufferID	id;
-				BytesU		offset;
-				void*		dst_ptr	= null;
-				BytesU		size	= src.first->GetVertexCount() * vert_stride;
-				const void*	src_ptr	= src.first->GetVertices().data();
-
-				CHECK_ERR( cmdbuf->AllocBuffer( size, vert_stride, OUT id, OUT offset, OUT dst_ptr ));
-
-				for (size_t i = 0, cnt = src.first->GetVertexCount(); i < cnt; ++i)
-				{
-					std::memcpy( dst_ptr, src_ptr, size_t(src.first->GetVertexStride()) );
-					src_ptr	+= src.first->GetVertexStride();
-					dst_ptr	+= vert_stride;
-				}
-
-				last_task = cmdbuf->AddTask( CopyBuffer{}.From( id ).To( _vertexBuffer ).AddRegion( offset, vert_size, size ).DependsOn( last_task ));
-			}
-
-			// copy indices
-			{
-				RawBufferID	id;
-				BytesU		offset;
-				void*		dst_ptr	= null;
-				BytesU		size	= src.first->GetIndexCount() * idx_stride;
-				const void*	src_ptr	= src.first->GetIndices().data();
-
-				CHECK_ERR( cmdbuf->AllocBuffer( size, idx_stride, OUT id, OUT offset, OUT dst_ptr ));
-
-				for (size_t i = 0, cnt = src.first->GetIndexCount(); i < cnt; ++i)
-				{
-					std::memcpy( dst_ptr, src_ptr, size_t(src.first->GetIndexStride()) );
-					src_ptr	+= src.first->GetIndexStride();
-					dst_ptr	+= idx_stride;
-				}
-
-				last_task = cmdbuf->AddTask( CopyBuffer{}.From( id ).To( _indexBuffer ).AddRegion( offset, idx_size, size ).DependsOn( last_task ));
-			}
-
-			vert_size = AlignToLarger( vert_size + ArraySizeOf(src.first->GetVertices()), vert_stride );
-			idx_size  = AlignToLarger( idx_size  + ArraySizeOf(src.first->GetIndices()),  idx_stride  );
-
-			if ( src.first == scene->GetMeshes().begin()->first )
-				_boundingBox = dst.boundingBox;
-			else
-				_boundingBox.Add( dst.boundingBox );
-
-			CHECK( src.first->GetIndexType() == _indexType );
-		}
-
-		_vertexStride = vert_stride;
-		_vertexAttribs.resize( attribs.size() );
-
-		for (auto& src : attribs) {
-			_vertexAttribs[src.second] = src.first;
-		}
-
-		return true;
-	}
-	
-/*
-=================================================
-	_ConvertMaterials
-=================================================
-*/
-	bool SimpleScene::_ConvertMaterials (const CommandBuffer &cmdbuf, const IntermScenePtr &scene, const ImageCachePtr &imageCache)
-	{
-		using MtrTexture = IntermMaterial::MtrTexture;
-
-		_materials.resize( scene->GetMaterials().size() );
-
-		for (auto& src : scene->GetMaterials())
-		{
-			CHECK_ERR( src.first->GetRenderLayers() != Default );
-
-			auto&		settings = src.first->GetSettings();
-			Material&	dst		 = _materials[ src.second ];
-
-			dst.dataID = uint(_materials.size());
-
-			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.albedo ))
-			{
-				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.albedoTex ));
-				dst.textureBits |= ETextureType::Albedo;
-			}
-
-			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.specular ))
-			{
-				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.specularTex ));
-				dst.textureBits |= ETextureType::Specular;
-			}
-
-			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.roughtness ))
-			{
-				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.roughtnessTex ));
-				dst.textureBits |= ETextureType::Roughtness;
-			}
-
-			if ( auto* tex = UnionGetIf<MtrTexture>( &settings.metallic ))
-			{
-				CHECK_ERR( imageCache->CreateImage( cmdbuf, tex->image, true, OUT dst.metallicTex ));
-				dst.textureBits |= ETextureType::Metallic;
-			}
-		}
-
-		return true;
-	}
-	
 /*
 =================================================
 	_CreateMesh
@@ -402,58 +143,14 @@ namespace {
 */
 	bool SimpleScene::_CreateMesh (const Transform &transform, const IntermScenePtr &scene, const IntermScene::ModelData &modelData)
 	{
-		Instance		inst;
-		inst.index		= uint(_modelLODs.size());
-		inst.transform	= transform;
-		
-		// find all layers
-		LayerBits		layers;
-		for (auto& level : modelData.levels) 
-		{
-			if ( level.first and level.second )
-				layers |= level.second->GetRenderLayers();
-		}
-
-		Optional<AABB>	bbox;
-
-		for (size_t i = 0; i < layers.size(); ++i)
-		{
-			ModelLevel	lod;
-			lod.layer	= ERenderLayer(i);
+		Instance	inst;
+		AABB		bbox;
+		inst.transform = transform;
 
-			for (size_t j = 0; j < lod.levels.size(); ++j)
-			{
-				if ( j >= modelData.levels.size()		or
-					 not modelData.levels[j].first		or
-					 not modelData.levels[j].second		or
-					 not modelData.levels[j].second->GetRenderLayers()[i] )
-				{
-					lod.levels[j] = UMax;
-					continue;
-				}
-
-				lod.levels[j] = uint(_models.size());
-
-				Model		model;
-				model.meshID	 = scene->GetIndexOfMesh( modelData.levels[j].first );
-				model.materialID = scene->GetIndexOfMaterial( modelData.levels[j].second );
-				model.layer		 = ERenderLayer(i);
-				_models.push_back( model );
-				
-				if ( bbox.has_value() )
-					bbox->Add( _meshes[model.meshID].boundingBox );
-				else
-					bbox = _meshes[model.meshID].boundingBox;
-			}
-
-			_modelLODs.push_back( lod );
-		}
-		
-		inst.boundingBox = bbox.value_or( AABB{} ).Transform( inst.transform );
-		inst.lastIndex	 = uint(_modelLODs.size());
-		ASSERT( inst.lastIndex > inst.index );
+		CHECK_ERR( _sceneModels.AddModel( scene, modelData, OUT inst.lodRange, OUT bbox ));
 
 		_instances.push_back( inst );
+		_instanceBounds.push_back( bbox.Transform( inst.transform ));
 		return true;
 	}
 
@@ -465,6 +162,7 @@ namespace {
 	bool SimpleScene::_ConvertHierarchy (const IntermScenePtr &scene, const Transform &initialTransform)
 	{
 		_instances.reserve( 128 );
+		_instanceBounds.reserve( 128 );
 
 		Array<Pair< IntermScene::SceneNode const*, Transform >>	stack;
 		stack.emplace_back( &scene->GetRoot(), initialTransform );
@@ -7,8 +7,8 @@
 		float	scale;
 	};
 
-	layout(set=0, binding=0, std140) uniform PerInstanceUB {
-		ObjectTransform		transforms [MAX_INSTANCE_COUNT];
+	layout(set=0, binding=0, std430) readonly buffer PerInstanceSSB {
+		ObjectTransform		transforms[];
 	} perInstance;
 
 	layout(push_constant, std140) uniform VSPushConst {
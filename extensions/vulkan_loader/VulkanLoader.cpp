@@ -62,7 +62,8 @@ namespace {
 	{
 		VulkanLib *		lib = Singleton< VulkanLib >();
 		
-		if ( lib->module and lib->refCounter > 0 )
+		// library may be already loaded or replaced by custom implementation
+		if ( lib->refCounter > 0 )
 		{
 			++lib->refCounter;
 			return true;
@@ -137,6 +138,47 @@ namespace {
 		return true;
 	}
 	
+/*
+=================================================
+	Initialize
+----
+	use custom implementation instead of system library,
+	for example 'VulkanNullDevice'.
+	must be externally synchronized!
+=================================================
+*/
+	bool VulkanLoader::Initialize (PFN_vkGetInstanceProcAddr getInstanceProcAddr)
+	{
+		VulkanLib *		lib = Singleton< VulkanLib >();
+
+		CHECK_ERR( getInstanceProcAddr );
+
+		if ( lib->refCounter > 0 )
+		{
+			CHECK_ERR( lib->module == null and _var_vkGetInstanceProcAddr == getInstanceProcAddr );
+			++lib->refCounter;
+			return true;
+		}
+
+		const auto	Load =	[getInstanceProcAddr] (OUT auto& outResult, const char *procName, auto dummy)
+							{
+								using FN = decltype(dummy);
+								FN	result = BitCast<FN>( getInstanceProcAddr( null, procName ));
+								outResult = result ? result : dummy;
+							};
+
+		++lib->refCounter;
+
+#		define VKLOADER_STAGE_GETADDRESS
+#		 include "vk_loader/fn_vulkan_lib.h"
+#		undef  VKLOADER_STAGE_GETADDRESS
+
+		ASSERT( _var_vkCreateInstance != &Dummy_vkCreateInstance );
+		ASSERT( _var_vkGetInstanceProcAddr != &Dummy_vkGetInstanceProcAddr );
+
+		return true;
+	}
+
 /*
 =================================================
 	LoadInstance
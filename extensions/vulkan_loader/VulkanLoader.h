@@ -108,6 +108,7 @@ namespace FGC
 		VulkanLoader () = delete;
 
 		ND_ static bool  Initialize (NtStringView libName = {});
+		ND_ static bool  Initialize (PFN_vkGetInstanceProcAddr getInstanceProcAddr);
 		ND_ static bool  LoadInstance (VkInstance instance);
 			static void  Unload ();
 		
@@ -0,0 +1,849 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VulkanNullDevice.h"
+#include "stl/Algorithms/ArrayUtils.h"
+#include "stl/Algorithms/Cast.h"
+#include "stl/Containers/ArrayView.h"
+#include "stl/Math/Math.h"
+#include <atomic>
+#include <cstring>
+
+namespace FGC
+{
+namespace
+{
+
+	// implemented functions
+#	define VKNULL_IMPL_FUNCS( _visit_ ) \
+		_visit_( vkCreateInstance ) \
+		_visit_( vkEnumerateInstanceExtensionProperties ) \
+		_visit_( vkEnumerateInstanceLayerProperties ) \
+		_visit_( vkEnumerateInstanceVersion ) \
+		_visit_( vkGetInstanceProcAddr ) \
+		_visit_( vkGetDeviceProcAddr ) \
+		_visit_( vkEnumeratePhysicalDevices ) \
+		_visit_( vkGetPhysicalDeviceProperties ) \
+		_visit_( vkGetPhysicalDeviceFeatures ) \
+		_visit_( vkGetPhysicalDeviceMemoryProperties ) \
+		_visit_( vkGetPhysicalDeviceQueueFamilyProperties ) \
+		_visit_( vkGetPhysicalDeviceFormatProperties ) \
+		_visit_( vkGetPhysicalDeviceImageFormatProperties ) \
+		_visit_( vkEnumerateDeviceExtensionProperties ) \
+		_visit_( vkEnumerateDeviceLayerProperties ) \
+		_visit_( vkCreateDevice ) \
+		_visit_( vkGetDeviceQueue ) \
+		_visit_( vkAllocateMemory ) \
+		_visit_( vkFreeMemory ) \
+		_visit_( vkMapMemory ) \
+		_visit_( vkCreateBuffer ) \
+		_visit_( vkDestroyBuffer ) \
+		_visit_( vkGetBufferMemoryRequirements ) \
+		_visit_( vkCreateImage ) \
+		_visit_( vkDestroyImage ) \
+		_visit_( vkGetImageMemoryRequirements ) \
+		_visit_( vkGetQueryPoolResults ) \
+		_visit_( vkGetPipelineCacheData ) \
+		_visit_( vkAllocateCommandBuffers ) \
+		_visit_( vkAllocateDescriptorSets ) \
+		_visit_( vkCreateGraphicsPipelines ) \
+		_visit_( vkCreateComputePipelines ) \
+		_visit_( vkCmdDraw ) \
+
+	// functions that returns new handle
+#	define VKNULL_CREATE_FUNCS( _visit_ ) \
+		_visit_( vkCreateBufferView ) \
+		_visit_( vkCreateImageView ) \
+		_visit_( vkCreateSampler ) \
+		_visit_( vkCreateFence ) \
+		_visit_( vkCreateSemaphore ) \
+		_visit_( vkCreateEvent ) \
+		_visit_( vkCreateQueryPool ) \
+		_visit_( vkCreateShaderModule ) \
+		_visit_( vkCreatePipelineCache ) \
+		_visit_( vkCreatePipelineLayout ) \
+		_visit_( vkCreateDescriptorSetLayout ) \
+		_visit_( vkCreateDescriptorPool ) \
+		_visit_( vkCreateRenderPass ) \
+		_visit_( vkCreateFramebuffer ) \
+		_visit_( vkCreateCommandPool ) \
+
+	// functions that do nothing and returns VK_SUCCESS if result is required
+#	define VKNULL_NOOP_FUNCS( _visit_ ) \
+		_visit_( vkDestroyInstance ) \
+		_visit_( vkDestroyDevice ) \
+		_visit_( vkDeviceWaitIdle ) \
+		_visit_( vkQueueSubmit ) \
+		_visit_( vkQueueWaitIdle ) \
+		_visit_( vkUnmapMemory ) \
+		_visit_( vkFlushMappedMemoryRanges ) \
+		_visit_( vkInvalidateMappedMemoryRanges ) \
+		_visit_( vkBindBufferMemory ) \
+		_visit_( vkBindImageMemory ) \
+		_visit_( vkDestroyBufferView ) \
+		_visit_( vkDestroyImageView ) \
+		_visit_( vkDestroySampler ) \
+		_visit_( vkDestroyFence ) \
+		_visit_( vkResetFences ) \
+		_visit_( vkGetFenceStatus ) \
+		_visit_( vkWaitForFences ) \
+		_visit_( vkDestroySemaphore ) \
+		_visit_( vkDestroyEvent ) \
+		_visit_( vkSetEvent ) \
+		_visit_( vkResetEvent ) \
+		_visit_( vkDestroyQueryPool ) \
+		_visit_( vkDestroyShaderModule ) \
+		_visit_( vkDestroyPipelineCache ) \
+		_visit_( vkMergePipelineCaches ) \
+		_visit_( vkDestroyPipeline ) \
+		_visit_( vkDestroyPipelineLayout ) \
+		_visit_( vkDestroyDescriptorSetLayout ) \
+		_visit_( vkDestroyDescriptorPool ) \
+		_visit_( vkResetDescriptorPool ) \
+		_visit_( vkFreeDescriptorSets ) \
+		_visit_( vkUpdateDescriptorSets ) \
+		_visit_( vkDestroyRenderPass ) \
+		_visit_( vkDestroyFramebuffer ) \
+		_visit_( vkDestroyCommandPool ) \
+		_visit_( vkResetCommandPool ) \
+		_visit_( vkFreeCommandBuffers ) \
+		_visit_( vkBeginCommandBuffer ) \
+		_visit_( vkEndCommandBuffer ) \
+		_visit_( vkResetCommandBuffer ) \
+		_visit_( vkCmdBindPipeline ) \
+		_visit_( vkCmdSetViewport ) \
+		_visit_( vkCmdSetScissor ) \
+		_visit_( vkCmdSetStencilCompareMask ) \
+		_visit_( vkCmdSetStencilWriteMask ) \
+		_visit_( vkCmdSetStencilReference ) \
+		_visit_( vkCmdBindDescriptorSets ) \
+		_visit_( vkCmdBindIndexBuffer ) \
+		_visit_( vkCmdBindVertexBuffers ) \
+		_visit_( vkCmdDrawIndexed ) \
+		_visit_( vkCmdDrawIndirect ) \
+		_visit_( vkCmdDrawIndexedIndirect ) \
+		_visit_( vkCmdDispatch ) \
+		_visit_( vkCmdDispatchIndirect ) \
+		_visit_( vkCmdCopyBuffer ) \
+		_visit_( vkCmdCopyImage ) \
+		_visit_( vkCmdBlitImage ) \
+		_visit_( vkCmdCopyBufferToImage ) \
+		_visit_( vkCmdCopyImageToBuffer ) \
+		_visit_( vkCmdUpdateBuffer ) \
+		_visit_( vkCmdFillBuffer ) \
+		_visit_( vkCmdClearColorImage ) \
+		_visit_( vkCmdClearDepthStencilImage ) \
+		_visit_( vkCmdClearAttachments ) \
+		_visit_( vkCmdResolveImage ) \
+		_visit_( vkCmdSetEvent ) \
+		_visit_( vkCmdResetEvent ) \
+		_visit_( vkCmdWaitEvents ) \
+		_visit_( vkCmdPipelineBarrier ) \
+		_visit_( vkCmdResetQueryPool ) \
+		_visit_( vkCmdWriteTimestamp ) \
+		_visit_( vkCmdPushConstants ) \
+		_visit_( vkCmdBeginRenderPass ) \
+		_visit_( vkCmdNextSubpass ) \
+		_visit_( vkCmdEndRenderPass ) \
+		_visit_( vkCmdExecuteCommands ) \
+
+
+	enum class ENullFn : uint
+	{
+	#	define VKNULL_ENUM( _name_ )	_name_,
+		VKNULL_IMPL_FUNCS( VKNULL_ENUM )
+		VKNULL_CREATE_FUNCS( VKNULL_ENUM )
+		VKNULL_NOOP_FUNCS( VKNULL_ENUM )
+	#	undef VKNULL_ENUM
+		_Count
+	};
+
+	static constexpr VkDeviceSize	NullMemAlignment	= 256;
+	static constexpr uint			NullQueueFamily		= 0;
+	static constexpr uint			NullMemTypeCount	= 3;	// device local, host coherent, host cached
+
+	// dispatchable handles must be a valid pointers
+	static uint64_t			s_NullInstance			= 0;
+	static uint64_t			s_NullPhysicalDevice	= 0;
+	static uint64_t			s_NullDevice			= 0;
+	static uint64_t			s_NullQueue				= 0;
+
+	static Atomic<uint64_t>	s_HandleCounter			{0};
+	static Atomic<uint64_t>	s_CallCounts[ uint(ENullFn::_Count) ];
+
+	static Atomic<bool>					s_DrawLogEnabled	{false};
+	static Mutex						s_DrawLogGuard;
+	static VulkanNullDevice::DrawLog_t	s_DrawLog;
+
+	struct NullMemory
+	{
+		void *			mapped	= null;
+	};
+
+	struct NullResource		// buffer or image
+	{
+		VkDeviceSize	size	= 0;
+	};
+
+/*
+=================================================
+	NewHandle
+----
+	unique handle, it is never dereferenced
+=================================================
+*/
+	template <typename H>
+	ND_ inline H  NewHandle ()
+	{
+		const uint64_t	id = (s_HandleCounter.fetch_add( 1, memory_order_relaxed ) + 1) * 16;
+
+		if constexpr( IsPointer<H> )
+			return reinterpret_cast<H>( size_t(id) );
+		else
+			return H(id);
+	}
+
+/*
+=================================================
+	ToHandle / FromHandle
+----
+	non-dispatchable handle is a pointer type on 64 bit platforms and 'uint64_t' on 32 bit
+=================================================
+*/
+	template <typename H, typename T>
+	ND_ inline H  ToHandle (T* ptr)
+	{
+		if constexpr( IsPointer<H> )
+			return reinterpret_cast<H>( ptr );
+		else
+			return H(size_t( ptr ));
+	}
+
+	template <typename T, typename H>
+	ND_ inline T*  FromHandle (H handle)
+	{
+		if constexpr( IsPointer<H> )
+			return reinterpret_cast<T*>( handle );
+		else
+			return reinterpret_cast<T*>( size_t( handle ));
+	}
+
+	template <typename H>
+	ND_ inline H  DispatchableHandle (uint64_t &obj)
+	{
+		return reinterpret_cast<H>( &obj );
+	}
+
+/*
+=================================================
+	CopyProperties
+----
+	implements the common 'count + array' query pattern
+=================================================
+*/
+	template <typename T>
+	ND_ inline VkResult  CopyProperties (ArrayView<T> src, INOUT uint32_t* count, OUT T* dst)
+	{
+		if ( dst == null )
+		{
+			*count = uint32_t(src.size());
+			return VK_SUCCESS;
+		}
+
+		const uint32_t	n = Min( *count, uint32_t(src.size()) );
+		for (uint32_t i = 0; i < n; ++i) {
+			dst[i] = src[i];
+		}
+		*count = n;
+		return n < src.size() ? VK_INCOMPLETE : VK_SUCCESS;
+	}
+//-----------------------------------------------------------------------------
+
+
+
+	VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL  Null_vkGetInstanceProcAddr (VkInstance, const char* name);
+
+	VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL  Null_vkGetDeviceProcAddr (VkDevice, const char* name)
+	{
+		return Null_vkGetInstanceProcAddr( VK_NULL_HANDLE, name );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateInstance (const VkInstanceCreateInfo*, const VkAllocationCallbacks*, VkInstance* instance)
+	{
+		*instance = DispatchableHandle<VkInstance>( s_NullInstance );
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumerateInstanceExtensionProperties (const char*, uint32_t* count, VkExtensionProperties* props)
+	{
+		return CopyProperties<VkExtensionProperties>( {}, INOUT count, OUT props );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumerateInstanceLayerProperties (uint32_t* count, VkLayerProperties* props)
+	{
+		return CopyProperties<VkLayerProperties>( {}, INOUT count, OUT props );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumerateInstanceVersion (uint32_t* apiVersion)
+	{
+		*apiVersion = VK_API_VERSION_1_0;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumeratePhysicalDevices (VkInstance, uint32_t* count, VkPhysicalDevice* devices)
+	{
+		const VkPhysicalDevice	gpu = DispatchableHandle<VkPhysicalDevice>( s_NullPhysicalDevice );
+		return CopyProperties<VkPhysicalDevice>( {gpu}, INOUT count, OUT devices );
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetPhysicalDeviceProperties (VkPhysicalDevice, VkPhysicalDeviceProperties* props)
+	{
+		std::memset( props, 0, sizeof(*props) );
+
+		props->apiVersion		= VK_API_VERSION_1_0;
+		props->driverVersion	= 1;
+		props->deviceType		= VK_PHYSICAL_DEVICE_TYPE_CPU;
+		std::strncpy( props->deviceName, "FrameGraph Null Device", sizeof(props->deviceName)-1 );
+
+		auto&	lim = props->limits;
+		lim.maxImageDimension1D						= 16384;
+		lim.maxImageDimension2D						= 16384;
+		lim.maxImageDimension3D						= 2048;
+		lim.maxImageDimensionCube					= 16384;
+		lim.maxImageArrayLayers						= 2048;
+		lim.maxTexelBufferElements					= 1u << 27;
+		lim.maxUniformBufferRange					= 1u << 16;
+		lim.maxStorageBufferRange					= 1u << 30;
+		lim.maxPushConstantsSize					= 256;
+		lim.maxMemoryAllocationCount				= 1u << 20;
+		lim.maxSamplerAllocationCount				= 1u << 12;
+		lim.bufferImageGranularity					= 1;
+		lim.sparseAddressSpaceSize					= 1ull << 40;
+		lim.maxBoundDescriptorSets					= 8;
+		lim.maxPerStageDescriptorSamplers			= 1u << 20;
+		lim.maxPerStageDescriptorUniformBuffers		= 1u << 20;
+		lim.maxPerStageDescriptorStorageBuffers		= 1u << 20;
+		lim.maxPerStageDescriptorSampledImages		= 1u << 20;
+		lim.maxPerStageDescriptorStorageImages		= 1u << 20;
+		lim.maxPerStageDescriptorInputAttachments	= 8;
+		lim.maxPerStageResources					= 1u << 20;
+		lim.maxDescriptorSetSamplers				= 1u << 20;
+		lim.maxDescriptorSetUniformBuffers			= 1u << 20;
+		lim.maxDescriptorSetUniformBuffersDynamic	= 8;
+		lim.maxDescriptorSetStorageBuffers			= 1u << 20;
+		lim.maxDescriptorSetStorageBuffersDynamic	= 8;
+		lim.maxDescriptorSetSampledImages			= 1u << 20;
+		lim.maxDescriptorSetStorageImages			= 1u << 20;
+		lim.maxDescriptorSetInputAttachments		= 8;
+		lim.maxVertexInputAttributes				= 32;
+		lim.maxVertexInputBindings					= 32;
+		lim.maxVertexInputAttributeOffset			= 2047;
+		lim.maxVertexInputBindingStride				= 2048;
+		lim.maxVertexOutputComponents				= 128;
+		lim.maxTessellationGenerationLevel			= 64;
+		lim.maxTessellationPatchSize				= 32;
+		lim.maxGeometryShaderInvocations			= 32;
+		lim.maxGeometryOutputVertices				= 256;
+		lim.maxFragmentInputComponents				= 128;
+		lim.maxFragmentOutputAttachments			= 8;
+		lim.maxFragmentCombinedOutputResources		= 1u << 20;
+		lim.maxComputeSharedMemorySize				= 1u << 15;
+		lim.maxComputeWorkGroupCount[0]				= 65535;
+		lim.maxComputeWorkGroupCount[1]				= 65535;
+		lim.maxComputeWorkGroupCount[2]				= 65535;
+		lim.maxComputeWorkGroupInvocations			= 1024;
+		lim.maxComputeWorkGroupSize[0]				= 1024;
+		lim.maxComputeWorkGroupSize[1]				= 1024;
+		lim.maxComputeWorkGroupSize[2]				= 64;
+		lim.maxDrawIndexedIndexValue				= ~0u;
+		lim.maxDrawIndirectCount					= ~0u;
+		lim.maxSamplerLodBias						= 16.0f;
+		lim.maxSamplerAnisotropy					= 16.0f;
+		lim.maxViewports							= 16;
+		lim.maxViewportDimensions[0]				= 16384;
+		lim.maxViewportDimensions[1]				= 16384;
+		lim.viewportBoundsRange[0]					= -32768.0f;
+		lim.viewportBoundsRange[1]					= 32767.0f;
+		lim.minMemoryMapAlignment					= 64;
+		lim.minTexelBufferOffsetAlignment			= NullMemAlignment;
+		lim.minUniformBufferOffsetAlignment			= NullMemAlignment;
+		lim.minStorageBufferOffsetAlignment			= NullMemAlignment;
+		lim.maxFramebufferWidth						= 16384;
+		lim.maxFramebufferHeight					= 16384;
+		lim.maxFramebufferLayers					= 2048;
+		lim.framebufferColorSampleCounts			= VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+		lim.framebufferDepthSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.framebufferStencilSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.framebufferNoAttachmentsSampleCounts	= lim.framebufferColorSampleCounts;
+		lim.maxColorAttachments						= 8;
+		lim.sampledImageColorSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.sampledImageIntegerSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.sampledImageDepthSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.sampledImageStencilSampleCounts			= lim.framebufferColorSampleCounts;
+		lim.storageImageSampleCounts				= lim.framebufferColorSampleCounts;
+		lim.maxSampleMaskWords						= 1;
+		lim.timestampComputeAndGraphics				= VK_TRUE;
+		lim.timestampPeriod							= 1.0f;
+		lim.maxClipDistances						= 8;
+		lim.maxCullDistances						= 8;
+		lim.maxCombinedClipAndCullDistances			= 8;
+		lim.optimalBufferCopyOffsetAlignment		= 1;
+		lim.optimalBufferCopyRowPitchAlignment		= 1;
+		lim.nonCoherentAtomSize						= NullMemAlignment;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetPhysicalDeviceFeatures (VkPhysicalDevice, VkPhysicalDeviceFeatures* features)
+	{
+		// all features are supported
+		STATIC_ASSERT( sizeof(*features) % sizeof(VkBool32) == 0 );
+
+		VkBool32*	flags = reinterpret_cast<VkBool32*>( features );
+		for (size_t i = 0; i < sizeof(*features) / sizeof(VkBool32); ++i) {
+			flags[i] = VK_TRUE;
+		}
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetPhysicalDeviceMemoryProperties (VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* props)
+	{
+		std::memset( props, 0, sizeof(*props) );
+
+		props->memoryHeapCount			= 2;
+		props->memoryHeaps[0].size		= 8ull << 30;
+		props->memoryHeaps[0].flags		= VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+		props->memoryHeaps[1].size		= 8ull << 30;
+		props->memoryHeaps[1].flags		= 0;
+
+		props->memoryTypeCount			= NullMemTypeCount;
+		props->memoryTypes[0]			= { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+		props->memoryTypes[1]			= { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+		props->memoryTypes[2]			= { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetPhysicalDeviceQueueFamilyProperties (VkPhysicalDevice, uint32_t* count, VkQueueFamilyProperties* props)
+	{
+		VkQueueFamilyProperties	family = {};
+		family.queueFlags			= VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+		family.queueCount			= 1;
+		family.timestampValidBits	= 64;
+		family.minImageTransferGranularity = { 1, 1, 1 };
+
+		Unused( CopyProperties<VkQueueFamilyProperties>( {family}, INOUT count, OUT props ));
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetPhysicalDeviceFormatProperties (VkPhysicalDevice, VkFormat format, VkFormatProperties* props)
+	{
+		const VkFormatFeatureFlags	all_features = (format != VK_FORMAT_UNDEFINED ? ~VkFormatFeatureFlags(0) : 0);
+
+		props->linearTilingFeatures		= all_features;
+		props->optimalTilingFeatures	= all_features;
+		props->bufferFeatures			= all_features;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkGetPhysicalDeviceImageFormatProperties (VkPhysicalDevice, VkFormat format, VkImageType, VkImageTiling, VkImageUsageFlags,
+																				  VkImageCreateFlags, VkImageFormatProperties* props)
+	{
+		if ( format == VK_FORMAT_UNDEFINED )
+			return VK_ERROR_FORMAT_NOT_SUPPORTED;
+
+		props->maxExtent		= { 16384, 16384, 2048 };
+		props->maxMipLevels		= 15;
+		props->maxArrayLayers	= 2048;
+		props->sampleCounts		= VK_SAMPLE_COUNT_1_BIT | VK_SAMPLE_COUNT_2_BIT | VK_SAMPLE_COUNT_4_BIT | VK_SAMPLE_COUNT_8_BIT;
+		props->maxResourceSize	= 1ull << 40;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumerateDeviceExtensionProperties (VkPhysicalDevice, const char*, uint32_t* count, VkExtensionProperties* props)
+	{
+	#ifdef VK_NV_ray_tracing
+		// required to create scratch buffers for acceleration structures, ray tracing commands are ignored
+		static const VkExtensionProperties	extensions[] = {
+			{ VK_NV_RAY_TRACING_EXTENSION_NAME, VK_NV_RAY_TRACING_SPEC_VERSION }
+		};
+		return CopyProperties<VkExtensionProperties>( extensions, INOUT count, OUT props );
+	#else
+		return CopyProperties<VkExtensionProperties>( {}, INOUT count, OUT props );
+	#endif
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkEnumerateDeviceLayerProperties (VkPhysicalDevice, uint32_t* count, VkLayerProperties* props)
+	{
+		return CopyProperties<VkLayerProperties>( {}, INOUT count, OUT props );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateDevice (VkPhysicalDevice, const VkDeviceCreateInfo*, const VkAllocationCallbacks*, VkDevice* device)
+	{
+		*device = DispatchableHandle<VkDevice>( s_NullDevice );
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetDeviceQueue (VkDevice, uint32_t familyIndex, uint32_t, VkQueue* queue)
+	{
+		ASSERT( familyIndex == NullQueueFamily );
+		Unused( familyIndex );
+		*queue = DispatchableHandle<VkQueue>( s_NullQueue );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkAllocateMemory (VkDevice, const VkMemoryAllocateInfo* info, const VkAllocationCallbacks*, VkDeviceMemory* memory)
+	{
+		if ( info->memoryTypeIndex >= NullMemTypeCount )
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		auto*	mem = new NullMemory{};
+
+		// device local memory is never accessed, so only host visible memory is allocated
+		if ( info->memoryTypeIndex != 0 )
+		{
+			mem->mapped = std::malloc( size_t(info->allocationSize) );
+
+			if ( mem->mapped == null )
+			{
+				delete mem;
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+			}
+		}
+
+		*memory = ToHandle<VkDeviceMemory>( mem );
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkFreeMemory (VkDevice, VkDeviceMemory memory, const VkAllocationCallbacks*)
+	{
+		if ( auto* mem = FromHandle<NullMemory>( memory ))
+		{
+			std::free( mem->mapped );
+			delete mem;
+		}
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkMapMemory (VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkMemoryMapFlags, void** data)
+	{
+		auto*	mem = FromHandle<NullMemory>( memory );
+
+		if ( mem == null or mem->mapped == null )
+			return VK_ERROR_MEMORY_MAP_FAILED;
+
+		*data = static_cast<uint8_t*>( mem->mapped ) + offset;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateBuffer (VkDevice, const VkBufferCreateInfo* info, const VkAllocationCallbacks*, VkBuffer* buffer)
+	{
+		*buffer = ToHandle<VkBuffer>( new NullResource{ info->size });
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkDestroyBuffer (VkDevice, VkBuffer buffer, const VkAllocationCallbacks*)
+	{
+		delete FromHandle<NullResource>( buffer );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateImage (VkDevice, const VkImageCreateInfo* info, const VkAllocationCallbacks*, VkImage* image)
+	{
+		// approximate size, 16 bytes per texel is enough for any format
+		VkDeviceSize	size = VkDeviceSize(info->extent.width) * info->extent.height * info->extent.depth *
+							   info->arrayLayers * uint(info->samples) * 16;
+
+		if ( info->mipLevels > 1 )
+			size += size / 3;
+
+		*image = ToHandle<VkImage>( new NullResource{ size });
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkDestroyImage (VkDevice, VkImage image, const VkAllocationCallbacks*)
+	{
+		delete FromHandle<NullResource>( image );
+	}
+
+	void  GetNullMemoryRequirements (const NullResource* res, VkMemoryRequirements* req)
+	{
+		req->size			= AlignToLarger( res ? Max( res->size, 1ull ) : 1ull, NullMemAlignment );
+		req->alignment		= NullMemAlignment;
+		req->memoryTypeBits	= (1u << NullMemTypeCount) - 1;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetBufferMemoryRequirements (VkDevice, VkBuffer buffer, VkMemoryRequirements* req)
+	{
+		GetNullMemoryRequirements( FromHandle<NullResource>( buffer ), OUT req );
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkGetImageMemoryRequirements (VkDevice, VkImage image, VkMemoryRequirements* req)
+	{
+		GetNullMemoryRequirements( FromHandle<NullResource>( image ), OUT req );
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkGetQueryPoolResults (VkDevice, VkQueryPool, uint32_t, uint32_t, size_t dataSize, void* data, VkDeviceSize, VkQueryResultFlags)
+	{
+		// all timestamps are zero
+		std::memset( data, 0, dataSize );
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkGetPipelineCacheData (VkDevice, VkPipelineCache, size_t* dataSize, void*)
+	{
+		*dataSize = 0;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkAllocateCommandBuffers (VkDevice, const VkCommandBufferAllocateInfo* info, VkCommandBuffer* cmdBuffers)
+	{
+		for (uint i = 0; i < info->commandBufferCount; ++i) {
+			cmdBuffers[i] = NewHandle<VkCommandBuffer>();
+		}
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkAllocateDescriptorSets (VkDevice, const VkDescriptorSetAllocateInfo* info, VkDescriptorSet* descSets)
+	{
+		for (uint i = 0; i < info->descriptorSetCount; ++i) {
+			descSets[i] = NewHandle<VkDescriptorSet>();
+		}
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateGraphicsPipelines (VkDevice, VkPipelineCache, uint32_t count, const VkGraphicsPipelineCreateInfo*,
+																   const VkAllocationCallbacks*, VkPipeline* pipelines)
+	{
+		for (uint i = 0; i < count; ++i) {
+			pipelines[i] = NewHandle<VkPipeline>();
+		}
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL  Null_vkCreateComputePipelines (VkDevice, VkPipelineCache, uint32_t count, const VkComputePipelineCreateInfo*,
+																  const VkAllocationCallbacks*, VkPipeline* pipelines)
+	{
+		for (uint i = 0; i < count; ++i) {
+			pipelines[i] = NewHandle<VkPipeline>();
+		}
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL  Null_vkCmdDraw (VkCommandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+	{
+		if ( not s_DrawLogEnabled.load( memory_order_relaxed ))
+			return;
+
+		EXLOCK( s_DrawLogGuard );
+		s_DrawLog.push_back({ vertexCount, instanceCount, firstVertex, firstInstance });
+	}
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	NullCreateFn
+----
+	vkCreate* (device, createInfo, allocator, handle)
+=================================================
+*/
+	template <typename T>
+	struct NullCreateFn;
+
+	template <typename CreateInfo, typename H>
+	struct NullCreateFn< VkResult (VKAPI_PTR *) (VkDevice, const CreateInfo*, const VkAllocationCallbacks*, H*) >
+	{
+		static VKAPI_ATTR VkResult VKAPI_CALL  Call (VkDevice, const CreateInfo*, const VkAllocationCallbacks*, H* handle)
+		{
+			*handle = NewHandle<H>();
+			return VK_SUCCESS;
+		}
+	};
+
+/*
+=================================================
+	NullNoOpFn
+=================================================
+*/
+	template <typename T>
+	struct NullNoOpFn;
+
+	template <typename R, typename ...Args>
+	struct NullNoOpFn< R (VKAPI_PTR *) (Args...) >
+	{
+		static VKAPI_ATTR R VKAPI_CALL  Call (Args...)
+		{
+			if constexpr( not std::is_void_v<R> )
+				return R{};
+		}
+	};
+
+/*
+=================================================
+	CountedFn
+----
+	increments call counter and calls implementation
+=================================================
+*/
+	template <ENullFn Fn, typename T, T Impl>
+	struct CountedFn;
+
+	template <ENullFn Fn, typename R, typename ...Args, R (VKAPI_PTR *Impl) (Args...)>
+	struct CountedFn< Fn, R (VKAPI_PTR *) (Args...), Impl >
+	{
+		static VKAPI_ATTR R VKAPI_CALL  Call (Args ...args)
+		{
+			s_CallCounts[ uint(Fn) ].fetch_add( 1, memory_order_relaxed );
+			return Impl( args... );
+		}
+	};
+
+/*
+=================================================
+	NullFunctions
+=================================================
+*/
+	struct NullFnInfo
+	{
+		StringView			name;
+		PFN_vkVoidFunction	fn;
+	};
+
+	ND_ inline ArrayView<NullFnInfo>  NullFunctions ()
+	{
+	#	define VKNULL_IMPL( _name_ )		NullFnInfo{ #_name_, reinterpret_cast<PFN_vkVoidFunction>( &CountedFn< ENullFn::_name_, PFN_##_name_, &Null_##_name_ >::Call )},
+	#	define VKNULL_CREATE( _name_ )		NullFnInfo{ #_name_, reinterpret_cast<PFN_vkVoidFunction>( &CountedFn< ENullFn::_name_, PFN_##_name_, &NullCreateFn< PFN_##_name_ >::Call >::Call )},
+	#	define VKNULL_NOOP( _name_ )		NullFnInfo{ #_name_, reinterpret_cast<PFN_vkVoidFunction>( &CountedFn< ENullFn::_name_, PFN_##_name_, &NullNoOpFn< PFN_##_name_ >::Call >::Call )},
+
+		static const NullFnInfo	functions[] = {
+			VKNULL_IMPL_FUNCS( VKNULL_IMPL )
+			VKNULL_CREATE_FUNCS( VKNULL_CREATE )
+			VKNULL_NOOP_FUNCS( VKNULL_NOOP )
+		};
+		STATIC_ASSERT( CountOf(functions) == uint(ENullFn::_Count) );
+
+	#	undef VKNULL_IMPL
+	#	undef VKNULL_CREATE
+	#	undef VKNULL_NOOP
+
+		return functions;
+	}
+
+/*
+=================================================
+	Null_vkGetInstanceProcAddr
+----
+	returns null for unsupported functions, so loader will use dummy function instead.
+	linear search is fast enough, this function is used only when loading functions.
+=================================================
+*/
+	VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL  Null_vkGetInstanceProcAddr (VkInstance, const char* name)
+	{
+		const StringView	fn_name{ name };
+
+		for (auto& info : NullFunctions())
+		{
+			if ( info.name == fn_name )
+				return info.fn;
+		}
+		return null;
+	}
+
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+
+/*
+=================================================
+	GetInstanceProcAddr
+=================================================
+*/
+	PFN_vkGetInstanceProcAddr  VulkanNullDevice::GetInstanceProcAddr ()
+	{
+		return &CountedFn< ENullFn::vkGetInstanceProcAddr, PFN_vkGetInstanceProcAddr, &Null_vkGetInstanceProcAddr >::Call;
+	}
+
+/*
+=================================================
+	GetCallCount
+=================================================
+*/
+	uint64_t  VulkanNullDevice::GetCallCount (StringView fnName)
+	{
+		auto	functions = NullFunctions();
+
+		for (size_t i = 0; i < functions.size(); ++i)
+		{
+			if ( functions[i].name == fnName )
+				return s_CallCounts[i].load( memory_order_relaxed );
+		}
+		return 0;
+	}
+
+/*
+=================================================
+	GetTotalCallCount
+=================================================
+*/
+	uint64_t  VulkanNullDevice::GetTotalCallCount ()
+	{
+		uint64_t	total = 0;
+
+		for (auto& cnt : s_CallCounts) {
+			total += cnt.load( memory_order_relaxed );
+		}
+		return total;
+	}
+
+/*
+=================================================
+	GetCallCounts
+=================================================
+*/
+	void  VulkanNullDevice::GetCallCounts (OUT CallCounts_t &result)
+	{
+		auto	functions = NullFunctions();
+
+		result.clear();
+
+		for (size_t i = 0; i < functions.size(); ++i)
+		{
+			const uint64_t	cnt = s_CallCounts[i].load( memory_order_relaxed );
+
+			if ( cnt > 0 )
+				result.emplace_back( functions[i].name, cnt );
+		}
+	}
+
+/*
+=================================================
+	ResetCallCounts
+=================================================
+*/
+	void  VulkanNullDevice::ResetCallCounts ()
+	{
+		for (auto& cnt : s_CallCounts) {
+			cnt.store( 0, memory_order_relaxed );
+		}
+	}
+
+/*
+=================================================
+	SetDrawLogEnabled
+=================================================
+*/
+	void  VulkanNullDevice::SetDrawLogEnabled (bool enabled)
+	{
+		EXLOCK( s_DrawLogGuard );
+		s_DrawLog.clear();
+		s_DrawLogEnabled.store( enabled, memory_order_relaxed );
+	}
+
+/*
+=================================================
+	GetDrawLog
+----
+	returns draw calls in recording order and clears log
+=================================================
+*/
+	void  VulkanNullDevice::GetDrawLog (OUT DrawLog_t &result)
+	{
+		EXLOCK( s_DrawLogGuard );
+		result.clear();
+		std::swap( result, s_DrawLog );
+	}
+
+
+}	// FGC
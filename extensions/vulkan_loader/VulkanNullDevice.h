@@ -0,0 +1,59 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	CPU-only Vulkan implementation that does nothing.
+	Used to measure CPU side of the frame graph without GPU and driver.
+
+	All handles are fake, host visible memory is allocated in system memory,
+	all commands are ignored, fences and queries are always signaled.
+	Each call is counted, so it can be used to check how many Vulkan calls are generated.
+	Arguments of 'vkCmdDraw' can be logged to check the order in which draw calls are recorded.
+
+	Usage:
+		VulkanLoader::Initialize( VulkanNullDevice::GetInstanceProcAddr() );
+		then create instance and device as usual.
+*/
+
+#pragma once
+
+#include "VulkanLoader.h"
+
+namespace FGC
+{
+
+	//
+	// Vulkan Null Device
+	//
+
+	struct VulkanNullDevice final
+	{
+	// types
+		using CallCounts_t	= Array< Pair< StringView, uint64_t >>;		// function name, number of calls
+
+		struct DrawCall
+		{
+			uint	vertexCount		= 0;
+			uint	instanceCount	= 0;
+			uint	firstVertex		= 0;
+			uint	firstInstance	= 0;
+		};
+		using DrawLog_t		= Array< DrawCall >;
+
+	// methods
+		VulkanNullDevice () = delete;
+
+		ND_ static PFN_vkGetInstanceProcAddr  GetInstanceProcAddr ();
+
+		ND_ static uint64_t  GetCallCount (StringView fnName);
+		ND_ static uint64_t  GetTotalCallCount ();
+
+			// returns only functions that was called at least once
+			static void  GetCallCounts (OUT CallCounts_t &result);
+			static void  ResetCallCounts ();
+
+			// clears log and enables or disables logging of 'vkCmdDraw' arguments
+			static void  SetDrawLogEnabled (bool enabled);
+			static void  GetDrawLog (OUT DrawLog_t &result);
+	};
+
+
+}	// FGC
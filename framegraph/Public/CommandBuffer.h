@@ -37,12 +37,15 @@ namespace FG
 		EQueueType		queueType	= EQueueType::Graphics;
 		EDebugFlags		debugFlags	= Default;
 		StringView		name;
+		bool			asyncPipelineCompilation	= false;	// missing graphics pipeline instances will be compiled in background,
+																// draw call is skipped or uses fallback pipeline until compilation is complete.
 		
 				 CommandBufferDesc () {}
 		explicit CommandBufferDesc (EQueueType type) : queueType{type} {}
 
-		CommandBufferDesc&  SetDebugFlags (EDebugFlags value)	{ debugFlags = value;  return *this; }
-		CommandBufferDesc&  SetDebugName (StringView value)		{ name = value;  return *this; }
+		CommandBufferDesc&  SetDebugFlags (EDebugFlags value)				{ debugFlags = value;  return *this; }
+		CommandBufferDesc&  SetDebugName (StringView value)					{ name = value;  return *this; }
+		CommandBufferDesc&  SetAsyncPipelineCompilation (bool value)		{ asyncPipelineCompilation = value;  return *this; }
 	};
 
 
@@ -87,6 +90,14 @@ namespace FG
 		// Buffer may be in immutable or mutable state, immutable state disables barrier placement that increases performance on CPU.
 		virtual void		AcquireBuffer (RawBufferID id, bool makeMutable) = 0;
 
+		// Creates image that can be used only in current command buffer, it will be released after execution.
+		// Memory is bound after task graph is sorted, transient resources with non-overlapping lifetimes share the same memory.
+		// Image content is undefined before first use and discarded after last use in this command buffer.
+		ND_ virtual RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName = Default) = 0;
+
+		// Creates buffer that can be used only in current command buffer, same as 'CreateTransientImage'.
+		ND_ virtual RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName = Default) = 0;
+
 	// tasks //
 		virtual Task		AddTask (const SubmitRenderPass &) = 0;
 		virtual Task		AddTask (const DispatchCompute &) = 0;
@@ -138,6 +149,7 @@ namespace FG
 		// Add task to the render pass.
 		virtual void		AddTask (LogicalPassID, const DrawVertices &) = 0;
 		virtual void		AddTask (LogicalPassID, const DrawIndexed &) = 0;
+		virtual void		AddTask (LogicalPassID, const DrawIndexedBatch &) = 0;
 		virtual void		AddTask (LogicalPassID, const DrawVerticesIndirect &) = 0;
 		virtual void		AddTask (LogicalPassID, const DrawIndexedIndirect &) = 0;
 		virtual void		AddTask (LogicalPassID, const DrawVerticesIndirectCount &) = 0;
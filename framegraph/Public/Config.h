@@ -74,6 +74,10 @@ namespace FG
 	static constexpr unsigned	FG_MaxBlitRegions			= 8;
 	static constexpr unsigned	FG_MaxResolveRegions		= 8;
 	static constexpr unsigned	FG_MaxDrawCommands			= 4;
+	static constexpr unsigned	FG_SplitBarrierMinDistance	= 8;	// min number of tasks between producer and consumer to use event instead of pipeline barrier, 0 - disabled
+
+	// resource cache
+	static constexpr unsigned	FG_CacheEvictionSubmits		= 256;	// default value for 'IFrameGraph::SetCacheEvictionSubmits'
 
 
 }	// FG
@@ -12,6 +12,7 @@ namespace FG
 		LogTasks						= 1 << 0,	// 
 		LogBarriers						= 1 << 1,	//
 		LogResourceUsage				= 1 << 2,	// 
+		LogSplitBarriers				= 1 << 4,	// add 'vkCmdSetEvent' and 'vkCmdWaitEvents' placement to the task list
 
 		VisTasks						= 1 << 10,
 		VisDrawTasks					= 1 << 11,
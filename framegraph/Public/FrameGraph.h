@@ -16,6 +16,7 @@
 #include "framegraph/Public/RenderPassDesc.h"
 #include "framegraph/Public/PipelineResources.h"
 #include "framegraph/Public/FGEnums.h"
+#include "stl/Stream/Stream.h"
 
 namespace FG
 {
@@ -38,6 +39,7 @@ namespace FG
 		using OnExternalImageReleased_t		= std::function< void (const ExternalImage_t &) >;
 		using OnExternalBufferReleased_t	= std::function< void (const ExternalBuffer_t &) >;
 		using ShaderDebugCallback_t			= std::function< void (StringView taskName, StringView shaderName, EShaderStages, ArrayView<String> output) >;
+		using UploadCallback_t				= std::function< void () >;
 
 	//-----------------------------------------------------
 	// statistics
@@ -45,8 +47,11 @@ namespace FG
 		struct RenderingStatistics
 		{
 			uint		descriptorBinds				= 0;
+			uint		skippedBinds				= 0;	// descriptor set, vertex and index buffer bindings that are skipped because same state is already bound
 			uint		pushConstants				= 0;
 			uint		pipelineBarriers			= 0;
+			uint		eliminatedBarriers			= 0;	// redundant barriers and barriers merged with other barriers for adjacent subresources
+			uint		splitBarriers				= 0;	// barriers that are committed with 'vkCmdWaitEvents' instead of 'vkCmdPipelineBarrier'
 			uint		transferOps					= 0;
 
 			uint		indexBufferBindings			= 0;
@@ -57,6 +62,7 @@ namespace FG
 			uint64_t	primitiveCount				= 0;	// sum of primitives
 			uint		graphicsPipelineBindings	= 0;
 			uint		dynamicStateChanges			= 0;
+			uint		secondaryCommandBuffers		= 0;	// recorded in parallel with 'RenderPassDesc::useSecondaryCmdbuf'
 
 			uint		dispatchCalls				= 0;
 			uint		computePipelineBindings		= 0;
@@ -64,10 +70,13 @@ namespace FG
 			uint		rayTracingPipelineBindings	= 0;
 			uint		traceRaysCalls				= 0;
 			uint		buildASCalls				= 0;
+			uint		rtSceneUpdates				= 0;	// top level acceleration structures that are updated instead of rebuilding
+			uint		rtInstanceUploads			= 0;	// number of instances that are copied to the instance buffer
 
 			// for command buffers
 			Nanoseconds	gpuTime						{0};	// for (currentFrame - ringBufferSize)
 			Nanoseconds	cpuTime						{0};	// for (currentFrame - ringBufferSize)
+			BytesU		taskMemory;							// used memory in linear allocator for tasks, render passes and copied task data
 
 			Nanoseconds submitingTime				{0};
 			Nanoseconds waitingTime					{0};
@@ -78,6 +87,29 @@ namespace FG
 			uint		newGraphicsPipelineCount	= 0;
 			uint		newComputePipelineCount		= 0;
 			uint		newRayTracingPipelineCount	= 0;
+
+			// for 'CommandBufferDesc::asyncPipelineCompilation'
+			uint		pendingPipelineInstances	= 0;	// number of instances that are compiling in background
+			uint		compiledPipelineInstances	= 0;	// number of instances that are compiled in background
+			uint		stalledPipelineInstances	= 0;	// number of draw calls that are skipped or used fallback pipeline
+
+			// for 'ICommandBuffer::CreateTransientImage' and 'ICommandBuffer::CreateTransientBuffer'
+			BytesU		transientResourceMemory;			// total size of transient resources
+			BytesU		transientHeapMemory;				// allocated memory, less than 'transientResourceMemory' when memory is reused
+
+			// cached samplers, render passes, framebuffers, descriptor sets and other
+			uint		cacheHits					= 0;
+			uint		cacheMisses					= 0;
+			uint		cacheEvictions				= 0;	// number of resources that was not used during 'SetCacheEvictionSubmits' submits
+
+			// pooled scratch and instance buffers for building ray tracing acceleration structures
+			uint		rtBufferAllocations			= 0;	// number of sub-allocations
+			uint		rtBufferCreations			= 0;	// number of created buffers, less than 'rtBufferAllocations' when buffers are reused
+			BytesU		rtBufferHighWaterMark;				// max memory that is used by single command batch
+
+			// for 'IFrameGraph::EnqueueUpload'
+			BytesU		uploadedSize;						// size of queued data that was uploaded in command buffers
+			BytesU		pendingUploadSize;					// size of data that is waiting in the upload queue
 		};
 
 		struct Statistics
@@ -246,6 +278,21 @@ namespace FG
 					bool			MapBufferRange (RawBufferID id, BytesU offset, INOUT BytesU &size, OUT T* &data);
 			virtual bool			MapBufferRange (RawBufferID id, BytesU offset, INOUT BytesU &size, OUT void* &data) = 0;
 
+			// Cached framebuffers and descriptor sets that are not used during this number of submits will be destroyed, 0 - disabled.
+			// Default value is 'FG_CacheEvictionSubmits'.
+			virtual void			SetCacheEvictionSubmits (uint submits) = 0;
+
+
+		// pipeline cache //
+
+			// Merge previously saved pipeline cache into the internal cache.
+			// Returns 'false' if data was created on another device or driver version, in this case cache is not changed.
+			// Call it before creating pipelines, command buffers that are already in use will get new cache at next 'Begin'.
+			virtual bool			LoadPipelineCache (RStream &stream) = 0;
+
+			// Write pipeline cache merged from all command buffers.
+			virtual bool			SavePipelineCache (WStream &stream) = 0;
+
 
 		// frame execution //
 		
@@ -255,6 +302,16 @@ namespace FG
 			// Compile framegraph for current command buffer and append it to the pending command buffer queue (that are waiting for submitting to GPU).
 			virtual bool			Execute (INOUT CommandBuffer &) = 0;
 
+			// Add upload to the queue, data is split into rows, slices or buffer ranges and recorded in the next 'Execute' calls,
+			// each command buffer uploads not more than the budget, so large uploads don't overflow staging buffers.
+			// Source data must be valid and resource must not be used until 'callback' is called, it is called when all data is on the GPU side.
+			virtual bool			EnqueueUpload (const UpdateBuffer &, UploadCallback_t &&callback = {}) = 0;
+			virtual bool			EnqueueUpload (const UpdateImage &, UploadCallback_t &&callback = {}) = 0;
+
+			// Set max size of queued data that is uploaded in single command buffer,
+			// only command buffers of 'queue' type are used for uploading.
+			virtual void			SetUploadBudget (BytesU bytesPerCommandBuffer, EQueueType queue = EQueueType::Graphics) = 0;
+
 			// Wait until all commands complete execution on the GPU or until time runs out.
 			virtual bool			Wait (ArrayView<CommandBuffer> commands, Nanoseconds timeout = MaxTimeout) = 0;
 
@@ -125,6 +125,7 @@ namespace _fg_hidden_
 		ColorBuffers_t			colorBuffers;
 		DynamicStates			dynamicStates;
 		DebugMode				debugMode;
+		float					sortDepth	= 0.0f;		// (optional) used for front to back sorting, see 'RenderPassDesc::sortDrawTasks'
 			
 
 	// methods
@@ -162,6 +163,8 @@ namespace _fg_hidden_
 		TaskType&  SetRasterizerDiscard (bool value);
 		TaskType&  SetFrontFaceCCW (bool value);
 
+		TaskType&  SetSortDepth (float value);
+
 		template <typename ValueType>
 		TaskType&  AddPushConstant (const PushConstantID &id, const ValueType &value)	{ return AddPushConstant( id, AddressOf(value), SizeOf<ValueType> ); }
 		TaskType&  AddPushConstant (const PushConstantID &id, const void *ptr, BytesU size);
@@ -186,6 +189,8 @@ namespace _fg_hidden_
 
 	// variables
 		RawGPipelineID			pipeline;
+		RawGPipelineID			fallbackPipeline;		// used while 'pipeline' is compiling in background, must be compatible with draw call resources,
+														// see 'CommandBufferDesc::asyncPipelineCompilation'
 		
 		VertexInputState		vertexInput;
 		Buffers_t				vertexBuffers;
@@ -200,6 +205,7 @@ namespace _fg_hidden_
 
 		TaskType&  SetTopology (EPrimitive value)					{ topology = value;  return static_cast<TaskType &>( *this ); }
 		TaskType&  SetPipeline (RawGPipelineID ppln)				{ ASSERT( ppln );  pipeline = ppln;  return static_cast<TaskType &>( *this ); }
+		TaskType&  SetFallbackPipeline (RawGPipelineID ppln)		{ ASSERT( ppln );  fallbackPipeline = ppln;  return static_cast<TaskType &>( *this ); }
 
 		TaskType&  SetVertexInput (const VertexInputState &value)	{ vertexInput = value;  return static_cast<TaskType &>( *this ); }
 		TaskType&  SetPrimitiveRestartEnabled (bool value)			{ primitiveRestart = value;  return static_cast<TaskType &>( *this ); }
@@ -294,6 +300,83 @@ namespace _fg_hidden_
 
 
 
+	
+	//
+	// Draw Indexed Vertices Batch
+	//
+	//	All draw commands share pipeline, vertex input, vertex and index buffers and render states,
+	//	only descriptor set and push constant may be changed per draw.
+	//	Per draw data is stored as struct of arrays, arrays are copied in 'AddTask',
+	//	so memory may be released after that.
+	//
+	struct DrawIndexedBatch final : _fg_hidden_::BaseDrawVertices<DrawIndexedBatch>
+	{
+	// types
+		using DrawCmd	= DrawIndexed::DrawCmd;
+
+
+	// variables
+		RawBufferID								indexBuffer;
+		BytesU									indexBufferOffset;
+		EIndex									indexType		= Default;
+
+		ArrayView< DrawCmd >					commands;
+
+		DescriptorSetID							perDrawDescSetId;
+		ArrayView< PipelineResources const* >	perDrawResources;		// empty or one per draw command, dynamic offsets are not supported
+
+		PushConstantID							perDrawPushConstId;
+		Bytes<uint16_t>							perDrawPushConstSize;
+		ArrayView< uint8_t >					perDrawPushConstants;	// empty or 'perDrawPushConstSize' bytes per draw command
+
+
+	// methods
+		DrawIndexedBatch () :
+			BaseDrawVertices<DrawIndexedBatch>{ "DrawIndexedBatch", ColorScheme::Draw } {}
+
+		DrawIndexedBatch&  SetIndexBuffer (RawBufferID ib, BytesU off, EIndex type)
+		{
+			ASSERT( ib );
+			indexBuffer			= ib;
+			indexBufferOffset	= off;
+			indexType			= type;
+			return *this;
+		}
+
+		DrawIndexedBatch&  SetCommands (ArrayView<DrawCmd> value)
+		{
+			commands = value;
+			return *this;
+		}
+
+		DrawIndexedBatch&  SetPerDrawResources (const DescriptorSetID &id, ArrayView<PipelineResources const*> value)
+		{
+			ASSERT( id.IsDefined() );
+			perDrawDescSetId	= id;
+			perDrawResources	= value;
+			return *this;
+		}
+
+		template <typename T>
+		DrawIndexedBatch&  SetPerDrawPushConstants (const PushConstantID &id, ArrayView<T> value)
+		{
+			STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+			return SetPerDrawPushConstants( id, value.data(), SizeOf<T>, value.size() );
+		}
+
+		DrawIndexedBatch&  SetPerDrawPushConstants (const PushConstantID &id, const void *ptr, BytesU sizePerDraw, size_t count)
+		{
+			ASSERT( id.IsDefined() );
+			ASSERT( size_t(sizePerDraw) <= FG_MaxPushConstantsSize );
+			perDrawPushConstId		= id;
+			perDrawPushConstSize	= Bytes<uint16_t>{sizePerDraw};
+			perDrawPushConstants	= ArrayView<uint8_t>{ Cast<uint8_t>(ptr), size_t(sizePerDraw) * count };
+			return *this;
+		}
+	};
+
+
+
 	//
 	// Draw Vertices indirect
 	//
@@ -858,6 +941,14 @@ namespace _fg_hidden_
 		dynamicStates.hasFrontFaceCCW = true;
 		return static_cast<TaskType &>( *this );
 	}
+	
+	template <typename TaskType>
+	inline TaskType&  BaseDrawCall<TaskType>::SetSortDepth (float value)
+	{
+		ASSERT( value >= 0.0f );
+		sortDepth = value;
+		return static_cast<TaskType &>( *this );
+	}
 
 	template <typename TaskType>
 	inline TaskType&  BaseDrawCall<TaskType>::AddPushConstant (const PushConstantID &id, const void *ptr, BytesU size)
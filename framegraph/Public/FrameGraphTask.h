@@ -664,10 +664,21 @@ namespace FG
 	struct UpdateBuffer final : _fg_hidden_::BaseTask<UpdateBuffer>
 	{
 	// types
+
+		// Writes 'size' bytes of source data starting from 'offset' directly into the mapped staging memory.
+		// Called from 'AddTask' one or more times, so the source may be decompressed or read part by part.
+		using DataWriter_t	= std::function< void (void* dst, BytesU offset, BytesU size) >;
+
 		struct Region
 		{
 			BytesU				offset;
 			ArrayView<uint8_t>	data;
+			BytesU				size;		// only for 'writer'
+			DataWriter_t		writer;		// used instead of 'data'
+
+			Region () {}
+			Region (BytesU offset, ArrayView<uint8_t> data) : offset{offset}, data{data} {}
+			Region (BytesU offset, BytesU size, DataWriter_t &&writer) : offset{offset}, size{size}, writer{std::move(writer)} {}
 		};
 		using Regions_t	= FixedArray< Region, FG_MaxCopyRegions >;
 
@@ -718,6 +729,13 @@ namespace FG
 			regions.emplace_back( bufferOffset, ArrayView{ Cast<uint8_t>(ptr), size_t(size) });
 			return *this;
 		}
+
+		UpdateBuffer&  AddDataWriter (DataWriter_t &&writer, BytesU size, BytesU bufferOffset = 0_b)
+		{
+			ASSERT( writer );
+			regions.emplace_back( bufferOffset, size, std::move(writer) );
+			return *this;
+		}
 	};
 
 
@@ -764,6 +782,10 @@ namespace FG
 	//
 	struct UpdateImage final : _fg_hidden_::BaseTask<UpdateImage>
 	{
+	// types
+		using DataWriter_t	= UpdateBuffer::DataWriter_t;
+
+
 	// variables
 		RawImageID			dstImage;
 		int3				imageOffset;
@@ -774,6 +796,7 @@ namespace FG
 		BytesU				dataSlicePitch;
 		EImageAspect		aspectMask	= EImageAspect::Color;	// must only have a single bit set
 		ArrayView<uint8_t>	data;
+		DataWriter_t		writer;		// used instead of 'data', called for each range of rows or slices
 
 		
 	// methods
@@ -836,6 +859,21 @@ namespace FG
 		{
 			return SetData( ArrayView<uint8_t>{ Cast<uint8_t>(ptr), count*sizeof(T) }, dimension, rowPitch, slicePitch );
 		}
+
+		UpdateImage&  SetDataWriter (DataWriter_t &&value, const uint2 &dimension, BytesU rowPitch = 0_b)
+		{
+			return SetDataWriter( std::move(value), uint3( dimension.x, dimension.y, 0 ), rowPitch );
+		}
+
+		UpdateImage&  SetDataWriter (DataWriter_t &&value, const uint3 &dimension, BytesU rowPitch = 0_b, BytesU slicePitch = 0_b)
+		{
+			ASSERT( value );
+			writer			= std::move(value);
+			imageSize		= dimension;
+			dataRowPitch	= rowPitch;
+			dataSlicePitch	= slicePitch;
+			return *this;
+		}
 	};
 
 
@@ -1052,6 +1090,11 @@ namespace FG
 	//
 	// Build Ray Tracing Scene
 	//
+	//	If scene is created with 'ERayTracingFlags::AllowUpdate' and instances use the same geometries
+	//	as in the previous build, then acceleration structure is updated in place and only changed instances are uploaded.
+	//	Command buffer with the previous build of this scene must be submitted before the next build is executed,
+	//	otherwise update will be applied to the acceleration structure that has never been built.
+	//
 	struct BuildRayTracingScene final : _fg_hidden_::BaseTask<BuildRayTracingScene>
 	{
 	// types
@@ -27,6 +27,9 @@ namespace FG
 		using LoadRGBA32uFun_t	= void (*) (ArrayView<T>, OUT RGBA32u &);
 		using LoadRGBA32iFun_t	= void (*) (ArrayView<T>, OUT RGBA32i &);
 
+		// decodes 'count' pixels that are tightly packed in 'row'
+		using LoadRowRGBA32fFun_t	= void (*) (const T* row, uint count, OUT RGBA32f *dst);
+
 
 	// variables
 	private:
@@ -39,6 +42,8 @@ namespace FG
 		LoadRGBA32fFun_t	_loadF4			= null;
 		LoadRGBA32uFun_t	_loadU4			= null;
 		LoadRGBA32iFun_t	_loadI4			= null;
+		LoadRowRGBA32fFun_t	_loadRowF4		= null;		// optimized row loader, may be null
+		bool				_isUNorm8x4		= false;	// pixels can be copied as RGBA8u without conversion
 
 
 	// methods
@@ -115,6 +120,24 @@ namespace FG
 			return _loadI4( GetPixel( point ), OUT col );
 		}
 
+
+		// Decode 'count' pixels of the single row starting from 'point'.
+		// Channels are in the same order as in 'Load', BGRA formats are not swizzled.
+		void LoadRow (const uint3 &point, uint count, OUT RGBA32f *dst) const;
+		void LoadRow (const uint3 &point, uint count, OUT RGBA8u *dst) const;
+
+		void LoadRow (uint y, uint z, OUT Array<RGBA32f> &row) const;
+		void LoadRow (uint y, uint z, OUT Array<RGBA8u> &row) const;
+
+
+		// Decode region into tightly packed array, rows and slices are placed sequentially.
+		bool ConvertTo (const uint3 &offset, const uint3 &size, OUT Array<RGBA32f> &result) const;
+		bool ConvertTo (const uint3 &offset, const uint3 &size, OUT Array<RGBA8u> &result) const;
+
+		bool ConvertTo (OUT Array<RGBA32f> &result) const	{ return ConvertTo( uint3{}, _dimension, OUT result ); }
+		bool ConvertTo (OUT Array<RGBA8u> &result) const	{ return ConvertTo( uint3{}, _dimension, OUT result ); }
+
+
 		/*void Load (const uint3 &point, OUT RGBA32f &col) const
 		{
 			ASSERT( _isFloatFormat );
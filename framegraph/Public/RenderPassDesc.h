@@ -61,7 +61,11 @@ namespace FG
 		PipelineResourceSet			perPassResources;	// this resources will be added for all draw tasks
 
 
-		//bool						useSecondaryCmdbuf	= false;	// CPU optimization
+		bool						useSecondaryCmdbuf	= false;	// CPU optimization, draw tasks will be recorded in parallel into secondary command buffers
+		bool						sortDrawTasks		= false;	// GPU optimization, draw tasks will be sorted by pipeline, resources and 'sortDepth' to reduce state changes,
+																	// ignored if render pass contains custom draw tasks or if any draw task uses blending, logic op,
+																	// stencil writes, disabled depth test or depth write, or compare op other than 'Less' and 'Greater'
+																	// (equal depth values must not depend on draw order)
 
 		//bool						parallelExecution	= true;		// (optimization) if 'false' all draw and compute tasks will be executed in initial order
 		//bool						canBeMerged			= true;		// (optimization) g-buffer render passes can be merged, but don't merge conditional passes
@@ -159,6 +163,9 @@ namespace FG
 		
 		RenderPassDesc&  AddResources (const DescriptorSetID &id, const PipelineResources *res);
 		RenderPassDesc&  AddResources (const DescriptorSetID &id, PipelineResources &res)	{ return AddResources( id, &res ); }
+
+		RenderPassDesc&  SetSecondaryCmdbufEnabled (bool value);
+		RenderPassDesc&  SetDrawTaskSortingEnabled (bool value);
 	};
 
 
@@ -544,6 +551,28 @@ namespace FG
 		perPassResources.insert({ id, res });
 		return *this;
 	}
+	
+/*
+=================================================
+	SetSecondaryCmdbufEnabled
+=================================================
+*/
+	inline RenderPassDesc&  RenderPassDesc::SetSecondaryCmdbufEnabled (bool value)
+	{
+		useSecondaryCmdbuf = value;
+		return *this;
+	}
+	
+/*
+=================================================
+	SetDrawTaskSortingEnabled
+=================================================
+*/
+	inline RenderPassDesc&  RenderPassDesc::SetDrawTaskSortingEnabled (bool value)
+	{
+		sortDrawTasks = value;
+		return *this;
+	}
 
 
 }	// FG
@@ -50,7 +50,7 @@ namespace FG
 		HostRead		= 1 << 0,
 		HostWrite		= 1 << 1,
 		Dedicated		= 1 << 2,		// force to use dedicated allocation
-		//AllowAliasing	= 1 << 3,		// 
+		AllowAliasing	= 1 << 3,		// memory is allocated in shared heap and may be reused by other transient resources, see 'ICommandBuffer::CreateTransientImage'
 		//Sparse		= 1 << 4,
 		_Last,
 	};
@@ -13,8 +13,11 @@ namespace FG
 	inline void MergeRenderStatistic (const IFrameGraph::RenderingStatistics &src, INOUT IFrameGraph::RenderingStatistics &dst)
 	{
 		dst.descriptorBinds				+= src.descriptorBinds;
+		dst.skippedBinds				+= src.skippedBinds;
 		dst.pushConstants				+= src.pushConstants;
 		dst.pipelineBarriers			+= src.pipelineBarriers;
+		dst.eliminatedBarriers			+= src.eliminatedBarriers;
+		dst.splitBarriers				+= src.splitBarriers;
 		dst.transferOps					+= src.transferOps;
 
 		dst.indexBufferBindings			+= src.indexBufferBindings;
@@ -25,6 +28,7 @@ namespace FG
 		dst.primitiveCount				+= src.primitiveCount;
 		dst.graphicsPipelineBindings	+= src.graphicsPipelineBindings;
 		dst.dynamicStateChanges			+= src.dynamicStateChanges;
+		dst.secondaryCommandBuffers		+= src.secondaryCommandBuffers;
 		
 		dst.dispatchCalls				+= src.dispatchCalls;
 		dst.computePipelineBindings		+= src.computePipelineBindings;
@@ -32,9 +36,12 @@ namespace FG
 		dst.rayTracingPipelineBindings	+= src.rayTracingPipelineBindings;
 		dst.traceRaysCalls				+= src.traceRaysCalls;
 		dst.buildASCalls				+= src.buildASCalls;
+		dst.rtSceneUpdates				+= src.rtSceneUpdates;
+		dst.rtInstanceUploads			+= src.rtInstanceUploads;
 
 		dst.gpuTime						+= src.gpuTime;
 		dst.cpuTime						+= src.cpuTime;
+		dst.taskMemory					+= src.taskMemory;
 	}
 	
 /*
@@ -47,6 +54,24 @@ namespace FG
 		dst.newComputePipelineCount		+= src.newComputePipelineCount;
 		dst.newGraphicsPipelineCount	+= src.newGraphicsPipelineCount;
 		dst.newRayTracingPipelineCount	+= src.newRayTracingPipelineCount;
+
+		dst.pendingPipelineInstances	 = Max( dst.pendingPipelineInstances, src.pendingPipelineInstances );
+		dst.compiledPipelineInstances	+= src.compiledPipelineInstances;
+		dst.stalledPipelineInstances	+= src.stalledPipelineInstances;
+
+		dst.transientResourceMemory		+= src.transientResourceMemory;
+		dst.transientHeapMemory			+= src.transientHeapMemory;
+
+		dst.cacheHits					+= src.cacheHits;
+		dst.cacheMisses					+= src.cacheMisses;
+		dst.cacheEvictions				+= src.cacheEvictions;
+
+		dst.rtBufferAllocations			+= src.rtBufferAllocations;
+		dst.rtBufferCreations			+= src.rtBufferCreations;
+		dst.rtBufferHighWaterMark		 = Max( dst.rtBufferHighWaterMark, src.rtBufferHighWaterMark );
+
+		dst.uploadedSize				+= src.uploadedSize;
+		dst.pendingUploadSize			 = Max( dst.pendingUploadSize, src.pendingUploadSize );
 	}
 
 /*
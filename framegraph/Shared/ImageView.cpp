@@ -2,6 +2,28 @@
 
 #include "Public/ImageView.h"
 
+#if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and (_M_IX86_FP >= 2))
+#	include <emmintrin.h>
+#	define FG_IMAGEVIEW_SSE2
+#endif
+
+// AVX2 and F16C kernels are compiled for any x86 target and are selected in runtime,
+// so compiler flags like '-mavx2' or '/arch:AVX2' are not required.
+#if defined(FG_IMAGEVIEW_SSE2) and (defined(COMPILER_MSVC) or defined(COMPILER_GCC) or defined(COMPILER_CLANG))
+#	include <immintrin.h>
+#	define FG_IMAGEVIEW_AVX2
+#	define FG_IMAGEVIEW_F16C
+#	ifdef COMPILER_MSVC
+#		include <intrin.h>
+#		define FG_IMAGEVIEW_TARGET_AVX2
+#		define FG_IMAGEVIEW_TARGET_F16C
+#	else
+#		include <cpuid.h>
+#		define FG_IMAGEVIEW_TARGET_AVX2		__attribute__((target( "avx2" )))
+#		define FG_IMAGEVIEW_TARGET_F16C		__attribute__((target( "avx,f16c" )))
+#	endif
+#endif
+
 namespace FG
 {
 namespace {
@@ -28,39 +50,131 @@ namespace {
 	
 /*
 =================================================
-	ToFloat
+	UnpackSmallFloat
+----
+	unsigned float with 5 bit exponent,
+	used for half float and for packed 11 and 10 bit floats.
 =================================================
 */
-	inline float  HalfBits::ToFloat () const
+	template <uint MantissaBits>
+	forceinline float  UnpackSmallFloat (uint exponent, uint mantissa)
 	{
+		// zero or denormal
+		if ( exponent == 0 )
+			return float(mantissa) * (1.0f / float(1u << (14 + MantissaBits)));
+
 		FloatBits	f;
-		f.s = s;
-		f.e = e + (127 - 15);
-		f.m = m << (23-10);
+		f.m = mantissa << (23 - MantissaBits);
+		f.e = (exponent == 31 ? 255 : exponent + (127 - 15));	// inf and nan
+		return BitCast<float>(f);
+	}
 
-		float	result;
-		std::memcpy( OUT &result, &f, sizeof(result) );
-		return result;
+/*
+=================================================
+	ToFloat
+=================================================
+*/
+	inline float  HalfBits::ToFloat () const
+	{
+		const float	result = UnpackSmallFloat<10>( e, m );
+		return s ? -result : result;
 	}
 }
 //-----------------------------------------------------------------------------
 
 
 
+/*
+=================================================
+	GetCpuFeatures
+----
+	AVX registers must be enabled by OS, this is checked with 'xgetbv'.
+=================================================
+*/
+	struct CpuFeatures
+	{
+		bool	avx2	= false;
+		bool	f16c	= false;
+	};
+
+	ND_ static CpuFeatures  DetectCpuFeatures ()
+	{
+		CpuFeatures		result;
+
+	#ifdef FG_IMAGEVIEW_AVX2
+		uint	leaf1[4] = {};	// eax, ebx, ecx, edx
+		uint	leaf7[4] = {};
+
+	 #ifdef COMPILER_MSVC
+		int		info[4] = {};
+		__cpuid( OUT info, 0 );
+		const uint	max_leaf = uint(info[0]);
+
+		__cpuid( OUT info, 1 );
+		std::memcpy( OUT leaf1, info, sizeof(leaf1) );
+
+		if ( max_leaf >= 7 ) {
+			__cpuidex( OUT info, 7, 0 );
+			std::memcpy( OUT leaf7, info, sizeof(leaf7) );
+		}
+	 #else
+		const uint	max_leaf = __get_cpuid_max( 0, null );
+
+		__cpuid( 1, leaf1[0], leaf1[1], leaf1[2], leaf1[3] );
+
+		if ( max_leaf >= 7 )
+			__cpuid_count( 7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3] );
+	 #endif
+
+		const bool	osxsave	= (leaf1[2] & (1u << 27));
+		const bool	avx		= (leaf1[2] & (1u << 28));
+		bool		os_avx	= false;
+
+		if ( osxsave and avx )
+		{
+		 #ifdef COMPILER_MSVC
+			const uint64_t	xcr0 = _xgetbv( 0 );
+		 #else
+			uint	eax, edx;
+			__asm__ volatile( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+			const uint64_t	xcr0 = (uint64_t(edx) << 32) | eax;
+		 #endif
+			os_avx = ((xcr0 & 6) == 6);		// SSE and AVX state
+		}
+
+		result.f16c	= os_avx and (leaf1[2] & (1u << 29));
+		result.avx2	= os_avx and (leaf7[1] & (1u << 5));
+	#endif
+
+		return result;
+	}
+
+	ND_ static CpuFeatures const&  GetCpuFeatures ()
+	{
+		static const CpuFeatures	features = DetectCpuFeatures();
+		return features;
+	}
+
 /*
 =================================================
 	ScaleUNorm
 =================================================
 */
+	template <uint Bits>
+	static constexpr float	UNormScale = 1.0f / float((1ull << Bits) - 1);
+
 	template <uint Bits>
 	forceinline float ScaleUNorm (uint value)
 	{
 		STATIC_ASSERT( Bits <= 32 );
 
-		FloatBits	f;
-		f.e	= 127 + Bits;
-
-		return float(value) / BitCast<float>(f);
+		if constexpr ( Bits == 0 )
+		{
+			(void)(value);
+			return 0.0f;
+		}
+		else
+			return float(value) * UNormScale<Bits>;
 	}
 
 /*
@@ -231,37 +345,513 @@ namespace {
 	{
 		struct RGBBits
 		{
-			// Blue //
-			uint	b_m	: 5;
-			uint	b_e	: 5;
-			// Green //
-			uint	g_m	: 6;
-			uint	g_e	: 5;
 			// Red //
 			uint	r_m	: 6;
 			uint	r_e	: 5;
+			// Green //
+			uint	g_m	: 6;
+			uint	g_e	: 5;
+			// Blue //
+			uint	b_m	: 5;
+			uint	b_e	: 5;
 		};
 		STATIC_ASSERT( sizeof(RGBBits)*8 == (11+11+10) );
 
 		RGBBits	bits;
 		std::memcpy( &bits, pixel.data(), sizeof(bits) );
 
-		FloatBits	f;
-		
-		f.m = bits.r_m << (23-6);
-		f.e = bits.r_e + (127 - 15);
-		result.r = BitCast<float>(f);
+		result.r = UnpackSmallFloat<6>( bits.r_e, bits.r_m );
+		result.g = UnpackSmallFloat<6>( bits.g_e, bits.g_m );
+		result.b = UnpackSmallFloat<5>( bits.b_e, bits.b_m );
+		result.a = 1.0f;
+	}
 
-		f.m = bits.g_m << (23-6);
-		f.e = bits.g_e + (127 - 15);
-		result.g = BitCast<float>(f);
+//-----------------------------------------------------------------------------
 
-		f.m = bits.b_m << (23-5);
-		f.e = bits.b_e + (127 - 15);
-		result.b = BitCast<float>(f);
 
-		result.a = 1.0f;
+
+/*
+=================================================
+	LoadRow_Scalar
+----
+	used for the remaining pixels when SIMD is not available or
+	the number of pixels is not a multiple of the vector size.
+=================================================
+*/
+	template <void (*LoadFn)(ArrayView<ImageView::T>, OUT RGBA32f &), uint BytesPerPixel>
+	static void LoadRow_Scalar (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		for (uint i = first; i < count; ++i) {
+			LoadFn( ArrayView<ImageView::T>{ row + i * BytesPerPixel, BytesPerPixel }, OUT dst[i] );
+		}
+	}
+
+/*
+=================================================
+	StoreUNorm8x4_Scalar
+=================================================
+*/
+	static void StoreUNorm8x4_Scalar (const RGBA32f *src, uint first, uint count, OUT RGBA8u *dst)
+	{
+		for (uint i = first; i < count; ++i)
+		{
+			for (uint c = 0; c < 4; ++c)
+			{
+				const float	x = src[i][c];
+				const float	v = (x > 0.0f ? (x < 1.0f ? x : 1.0f) : 0.0f);	// nan is converted to zero
+
+				dst[i][c] = uint8_t(v * 255.0f + 0.5f);
+			}
+		}
 	}
+//-----------------------------------------------------------------------------
+
+
+#ifdef FG_IMAGEVIEW_SSE2
+/*
+=================================================
+	UnpackSmallFloat_SSE2
+----
+	same as 'UnpackSmallFloat', but exponent and mantissa
+	are packed into the lower bits of each element.
+=================================================
+*/
+	template <uint MantissaBits>
+	forceinline __m128  UnpackSmallFloat_SSE2 (const __m128i &bits)
+	{
+		const __m128i	exp_mask	= _mm_set1_epi32( 0x1F << 23 );
+		const __m128	denorm		= _mm_castsi128_ps( _mm_set1_epi32( 113 << 23 ));
+
+		__m128i		o		= _mm_slli_epi32( bits, 23 - MantissaBits );
+		__m128i		e		= _mm_and_si128( o, exp_mask );
+		__m128i		is_inf	= _mm_cmpeq_epi32( e, exp_mask );
+		__m128		is_den	= _mm_castsi128_ps( _mm_cmpeq_epi32( e, _mm_setzero_si128() ));
+
+		o = _mm_add_epi32( o, _mm_set1_epi32( (127 - 15) << 23 ));
+		o = _mm_add_epi32( o, _mm_and_si128( is_inf, _mm_set1_epi32( (128 - 16) << 23 )));
+
+		// denormal is calculated as '(1 + m) * 2^-14 - 2^-14'
+		__m128		den		= _mm_sub_ps( _mm_castsi128_ps( _mm_add_epi32( o, _mm_set1_epi32( 1 << 23 ))), denorm );
+
+		return _mm_or_ps( _mm_and_ps( is_den, den ), _mm_andnot_ps( is_den, _mm_castsi128_ps( o )));
+	}
+
+/*
+=================================================
+	UnpackHalf_SSE2
+----
+	half floats must be in the lower 16 bits of each element
+=================================================
+*/
+	forceinline __m128  UnpackHalf_SSE2 (const __m128i &bits)
+	{
+		__m128i		sign	= _mm_slli_epi32( _mm_and_si128( bits, _mm_set1_epi32( 0x8000 )), 16 );
+		__m128		value	= UnpackSmallFloat_SSE2<10>( _mm_and_si128( bits, _mm_set1_epi32( 0x7FFF )));
+
+		return _mm_or_ps( value, _mm_castsi128_ps( sign ));
+	}
+
+/*
+=================================================
+	StoreR32f_SSE2
+----
+	stores 4 pixels as (x, 0, 0, 0)
+=================================================
+*/
+	forceinline void  StoreR32f_SSE2 (const __m128 &value, OUT RGBA32f *dst)
+	{
+		const __m128	zero = _mm_setzero_ps();
+
+		_mm_storeu_ps( dst[0].data(), _mm_move_ss( zero, value ));
+		_mm_storeu_ps( dst[1].data(), _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(1,1,1,1) )));
+		_mm_storeu_ps( dst[2].data(), _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(2,2,2,2) )));
+		_mm_storeu_ps( dst[3].data(), _mm_move_ss( zero, _mm_shuffle_ps( value, value, _MM_SHUFFLE(3,3,3,3) )));
+	}
+
+/*
+=================================================
+	LoadRowUNorm8x4_SSE2
+=================================================
+*/
+	static uint LoadRowUNorm8x4_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m128i	zero	= _mm_setzero_si128();
+		const __m128	scale	= _mm_set1_ps( UNormScale<8> );
+		uint			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	v	= _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*4 ));
+			__m128i	lo	= _mm_unpacklo_epi8( v, zero );
+			__m128i	hi	= _mm_unpackhi_epi8( v, zero );
+
+			_mm_storeu_ps( dst[i+0].data(), _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero )), scale ));
+			_mm_storeu_ps( dst[i+1].data(), _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero )), scale ));
+			_mm_storeu_ps( dst[i+2].data(), _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero )), scale ));
+			_mm_storeu_ps( dst[i+3].data(), _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero )), scale ));
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowHalf4_SSE2
+=================================================
+*/
+	static uint LoadRowHalf4_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m128i	zero	= _mm_setzero_si128();
+		uint			i		= first;
+
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128i	v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*8 ));
+
+			_mm_storeu_ps( dst[i+0].data(), UnpackHalf_SSE2( _mm_unpacklo_epi16( v, zero )));
+			_mm_storeu_ps( dst[i+1].data(), UnpackHalf_SSE2( _mm_unpackhi_epi16( v, zero )));
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowR11G11B10F_SSE2
+=================================================
+*/
+	static uint LoadRowR11G11B10F_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m128i	mask	= _mm_set1_epi32( 0x7FF );
+		uint			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	v	= _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*4 ));
+			__m128	r	= UnpackSmallFloat_SSE2<6>( _mm_and_si128( v, mask ));
+			__m128	g	= UnpackSmallFloat_SSE2<6>( _mm_and_si128( _mm_srli_epi32( v, 11 ), mask ));
+			__m128	b	= UnpackSmallFloat_SSE2<5>( _mm_srli_epi32( v, 22 ));
+			__m128	a	= _mm_set1_ps( 1.0f );
+
+			_MM_TRANSPOSE4_PS( r, g, b, a );
+
+			_mm_storeu_ps( dst[i+0].data(), r );
+			_mm_storeu_ps( dst[i+1].data(), g );
+			_mm_storeu_ps( dst[i+2].data(), b );
+			_mm_storeu_ps( dst[i+3].data(), a );
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowDepth16_SSE2
+=================================================
+*/
+	static uint LoadRowDepth16_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m128i	zero	= _mm_setzero_si128();
+		const __m128	scale	= _mm_set1_ps( UNormScale<16> );
+		uint			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	v = _mm_unpacklo_epi16( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( row + i*2 )), zero );
+
+			StoreR32f_SSE2( _mm_mul_ps( _mm_cvtepi32_ps( v ), scale ), OUT dst + i );
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowDepth24_SSE2
+=================================================
+*/
+	static uint LoadRowDepth24_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m128i	mask	= _mm_set1_epi32( 0xFFFFFF );
+		const __m128	scale	= _mm_set1_ps( UNormScale<24> );
+		uint			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	v = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*4 )), mask );
+
+			StoreR32f_SSE2( _mm_mul_ps( _mm_cvtepi32_ps( v ), scale ), OUT dst + i );
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowDepth32F_SSE2
+=================================================
+*/
+	static uint LoadRowDepth32F_SSE2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			StoreR32f_SSE2( _mm_loadu_ps( reinterpret_cast<const float *>( row + i*4 )), OUT dst + i );
+		}
+		return i;
+	}
+
+/*
+=================================================
+	StoreUNorm8x4_SSE2
+=================================================
+*/
+	static uint StoreUNorm8x4_SSE2 (const RGBA32f *src, uint first, uint count, OUT RGBA8u *dst)
+	{
+		const __m128	zero	= _mm_setzero_ps();
+		const __m128	one		= _mm_set1_ps( 1.0f );
+		const __m128	scale	= _mm_set1_ps( 255.0f );
+		const __m128	half	= _mm_set1_ps( 0.5f );
+		uint			i		= first;
+
+		// '_mm_max_ps' returns second argument if first is nan
+		const auto	ToUNorm = [&] (const RGBA32f &col) {
+			return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _mm_min_ps( _mm_max_ps( _mm_loadu_ps( col.data() ), zero ), one ), scale ), half ));
+		};
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	c01	= _mm_packs_epi32( ToUNorm( src[i+0] ), ToUNorm( src[i+1] ));
+			__m128i	c23	= _mm_packs_epi32( ToUNorm( src[i+2] ), ToUNorm( src[i+3] ));
+
+			_mm_storeu_si128( reinterpret_cast<__m128i *>( dst + i ), _mm_packus_epi16( c01, c23 ));
+		}
+		return i;
+	}
+#endif	// FG_IMAGEVIEW_SSE2
+//-----------------------------------------------------------------------------
+
+
+#ifdef FG_IMAGEVIEW_AVX2
+/*
+=================================================
+	UnpackSmallFloat_AVX2
+=================================================
+*/
+	template <uint MantissaBits>
+	FG_IMAGEVIEW_TARGET_AVX2 forceinline __m256  UnpackSmallFloat_AVX2 (const __m256i &bits)
+	{
+		const __m256i	exp_mask	= _mm256_set1_epi32( 0x1F << 23 );
+		const __m256	denorm		= _mm256_castsi256_ps( _mm256_set1_epi32( 113 << 23 ));
+
+		__m256i		o		= _mm256_slli_epi32( bits, 23 - MantissaBits );
+		__m256i		e		= _mm256_and_si256( o, exp_mask );
+		__m256i		is_inf	= _mm256_cmpeq_epi32( e, exp_mask );
+		__m256		is_den	= _mm256_castsi256_ps( _mm256_cmpeq_epi32( e, _mm256_setzero_si256() ));
+
+		o = _mm256_add_epi32( o, _mm256_set1_epi32( (127 - 15) << 23 ));
+		o = _mm256_add_epi32( o, _mm256_and_si256( is_inf, _mm256_set1_epi32( (128 - 16) << 23 )));
+
+		__m256		den		= _mm256_sub_ps( _mm256_castsi256_ps( _mm256_add_epi32( o, _mm256_set1_epi32( 1 << 23 ))), denorm );
+
+		return _mm256_blendv_ps( _mm256_castsi256_ps( o ), den, is_den );
+	}
+
+/*
+=================================================
+	LoadRowUNorm8x4_AVX2
+=================================================
+*/
+	FG_IMAGEVIEW_TARGET_AVX2
+	static uint LoadRowUNorm8x4_AVX2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m256	scale	= _mm256_set1_ps( UNormScale<8> );
+		uint			i		= first;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i	v	= _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*4 ));
+			__m256i	p01	= _mm256_cvtepu8_epi32( v );
+			__m256i	p23	= _mm256_cvtepu8_epi32( _mm_unpackhi_epi64( v, v ));
+
+			_mm256_storeu_ps( dst[i+0].data(), _mm256_mul_ps( _mm256_cvtepi32_ps( p01 ), scale ));
+			_mm256_storeu_ps( dst[i+2].data(), _mm256_mul_ps( _mm256_cvtepi32_ps( p23 ), scale ));
+		}
+		return i;
+	}
+
+/*
+=================================================
+	LoadRowR11G11B10F_AVX2
+=================================================
+*/
+	FG_IMAGEVIEW_TARGET_AVX2
+	static uint LoadRowR11G11B10F_AVX2 (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		const __m256i	mask	= _mm256_set1_epi32( 0x7FF );
+		uint			i		= first;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i	v	= _mm256_loadu_si256( reinterpret_cast<const __m256i *>( row + i*4 ));
+			__m256	r	= UnpackSmallFloat_AVX2<6>( _mm256_and_si256( v, mask ));
+			__m256	g	= UnpackSmallFloat_AVX2<6>( _mm256_and_si256( _mm256_srli_epi32( v, 11 ), mask ));
+			__m256	b	= UnpackSmallFloat_AVX2<5>( _mm256_srli_epi32( v, 22 ));
+			__m256	a	= _mm256_set1_ps( 1.0f );
+
+			// transpose 4x4 in each 128 bit lane, then store lanes
+			__m256	rg_lo	= _mm256_unpacklo_ps( r, g );
+			__m256	rg_hi	= _mm256_unpackhi_ps( r, g );
+			__m256	ba_lo	= _mm256_unpacklo_ps( b, a );
+			__m256	ba_hi	= _mm256_unpackhi_ps( b, a );
+			__m256	p04		= _mm256_shuffle_ps( rg_lo, ba_lo, _MM_SHUFFLE(1,0,1,0) );
+			__m256	p15		= _mm256_shuffle_ps( rg_lo, ba_lo, _MM_SHUFFLE(3,2,3,2) );
+			__m256	p26		= _mm256_shuffle_ps( rg_hi, ba_hi, _MM_SHUFFLE(1,0,1,0) );
+			__m256	p37		= _mm256_shuffle_ps( rg_hi, ba_hi, _MM_SHUFFLE(3,2,3,2) );
+
+			_mm256_storeu_ps( dst[i+0].data(), _mm256_permute2f128_ps( p04, p15, 0x20 ));
+			_mm256_storeu_ps( dst[i+2].data(), _mm256_permute2f128_ps( p26, p37, 0x20 ));
+			_mm256_storeu_ps( dst[i+4].data(), _mm256_permute2f128_ps( p04, p15, 0x31 ));
+			_mm256_storeu_ps( dst[i+6].data(), _mm256_permute2f128_ps( p26, p37, 0x31 ));
+		}
+		return i;
+	}
+#endif	// FG_IMAGEVIEW_AVX2
+//-----------------------------------------------------------------------------
+
+
+#ifdef FG_IMAGEVIEW_F16C
+/*
+=================================================
+	LoadRowHalf4_F16C
+=================================================
+*/
+	FG_IMAGEVIEW_TARGET_F16C
+	static uint LoadRowHalf4_F16C (const ImageView::T* row, uint first, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = first;
+
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128i	v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + i*8 ));
+
+			_mm256_storeu_ps( dst[i].data(), _mm256_cvtph_ps( v ));
+		}
+		return i;
+	}
+#endif	// FG_IMAGEVIEW_F16C
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	LoadRowUNorm8x4
+=================================================
+*/
+	static void LoadRowUNorm8x4 (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_AVX2
+		if ( GetCpuFeatures().avx2 )
+			i = LoadRowUNorm8x4_AVX2( row, i, count, OUT dst );
+	#endif
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowUNorm8x4_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadUNorm<8,8,8,8>, 4 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	LoadRowHalf4
+=================================================
+*/
+	static void LoadRowHalf4 (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_F16C
+		if ( GetCpuFeatures().f16c )
+			i = LoadRowHalf4_F16C( row, i, count, OUT dst );
+	#endif
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowHalf4_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadFloat<16,16,16,16>, 8 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	LoadRowR11G11B10F
+=================================================
+*/
+	static void LoadRowR11G11B10F (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_AVX2
+		if ( GetCpuFeatures().avx2 )
+			i = LoadRowR11G11B10F_AVX2( row, i, count, OUT dst );
+	#endif
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowR11G11B10F_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadFloat_11_11_10, 4 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	LoadRowDepth16
+=================================================
+*/
+	static void LoadRowDepth16 (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowDepth16_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadUNorm<16,0,0,0>, 2 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	LoadRowDepth24
+----
+	24 bit depth in the lower bits of 32 bit value
+=================================================
+*/
+	static void LoadRowDepth24 (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowDepth24_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadUNorm<24,0,0,0>, 4 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	LoadRowDepth32F
+=================================================
+*/
+	static void LoadRowDepth32F (const ImageView::T* row, uint count, OUT RGBA32f *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = LoadRowDepth32F_SSE2( row, i, count, OUT dst );
+	#endif
+		LoadRow_Scalar< &ReadFloat<32,0,0,0>, 4 >( row, i, count, OUT dst );
+	}
+
+/*
+=================================================
+	StoreUNorm8x4
+=================================================
+*/
+	static void StoreUNorm8x4 (const RGBA32f *src, uint count, OUT RGBA8u *dst)
+	{
+		uint	i = 0;
+	#ifdef FG_IMAGEVIEW_SSE2
+		i = StoreUNorm8x4_SSE2( src, i, count, OUT dst );
+	#endif
+		StoreUNorm8x4_Scalar( src, i, count, OUT dst );
+	}
+//-----------------------------------------------------------------------------
+
 
 /*
 =================================================
@@ -360,6 +950,8 @@ namespace {
 								   null);
 				_loadI4			= &ReadInt<8,8,8,8>;
 				_loadU4			= &ReadUInt<8,8,8,8>;
+				_isUNorm8x4		= (_format == EPixelFormat::RGBA8_UNorm or _format == EPixelFormat::BGRA8_UNorm);
+				_loadRowF4		= (_isUNorm8x4 ? &LoadRowUNorm8x4 : null);
 				break;
 
 			case EPixelFormat::R16_SNorm :
@@ -467,12 +1059,14 @@ namespace {
 				ASSERT( aspect == Default or aspect == EImageAspect::Color );
 				_bitsPerPixel	= 4*16;
 				_loadF4			= &ReadFloat<16,16,16,16>;
+				_loadRowF4		= &LoadRowHalf4;
 				break;
 
 			case EPixelFormat::RGB_11_11_10F :
 				ASSERT( aspect == Default or aspect == EImageAspect::Color );
 				_bitsPerPixel	= 11 + 11 + 10;
 				_loadF4			= &ReadFloat_11_11_10;
+				_loadRowF4		= &LoadRowR11G11B10F;
 				break;
 
 			case EPixelFormat::R32F :
@@ -500,17 +1094,52 @@ namespace {
 				break;
 
 			case EPixelFormat::Depth16 :
+				ASSERT( aspect == Default or aspect == EImageAspect::Depth );
+				_bitsPerPixel	= 16;
+				_loadF4			= &ReadUNorm<16,0,0,0>;
+				_loadRowF4		= &LoadRowDepth16;
+				break;
+
 			case EPixelFormat::Depth24 :
+				ASSERT( aspect == Default or aspect == EImageAspect::Depth );
+				_bitsPerPixel	= 32;	// upper 8 bits are undefined
+				_loadF4			= &ReadUNorm<24,0,0,0>;
+				_loadRowF4		= &LoadRowDepth24;
+				break;
+
 			case EPixelFormat::Depth32F :
 				ASSERT( aspect == Default or aspect == EImageAspect::Depth );
-				ASSERT(false);
+				_bitsPerPixel	= 32;
+				_loadF4			= &ReadFloat<32,0,0,0>;
+				_loadRowF4		= &LoadRowDepth32F;
 				break;
 
+			// depth and stencil are copied to buffer separately, see 'Copying Data Between Buffers and Images' in vulkan spec.
 			case EPixelFormat::Depth16_Stencil8	:
 			case EPixelFormat::Depth24_Stencil8 :
 			case EPixelFormat::Depth32F_Stencil8 :
 				ASSERT( aspect == Default or aspect == EImageAspect::Depth or aspect == EImageAspect::Stencil );
-				ASSERT(false);
+				if ( aspect == EImageAspect::Stencil ) {
+					_bitsPerPixel	= 8;
+					_loadU4			= &ReadUInt<8,0,0,0>;
+				}
+				else
+				if ( _format == EPixelFormat::Depth16_Stencil8 ) {
+					_bitsPerPixel	= 16;
+					_loadF4			= &ReadUNorm<16,0,0,0>;
+					_loadRowF4		= &LoadRowDepth16;
+				}
+				else
+				if ( _format == EPixelFormat::Depth24_Stencil8 ) {
+					_bitsPerPixel	= 32;
+					_loadF4			= &ReadUNorm<24,0,0,0>;
+					_loadRowF4		= &LoadRowDepth24;
+				}
+				else {
+					_bitsPerPixel	= 32;
+					_loadF4			= &ReadFloat<32,0,0,0>;
+					_loadRowF4		= &LoadRowDepth32F;
+				}
 				break;
 
 			case EPixelFormat::sRGB8 :
@@ -529,6 +1158,8 @@ namespace {
 				_loadF4			= &ReadUNorm<8,8,8,8>;
 				_loadI4			= &ReadInt<8,8,8,8>;
 				_loadU4			= &ReadUInt<8,8,8,8>;
+				_isUNorm8x4		= true;
+				_loadRowF4		= &LoadRowUNorm8x4;
 				break;
 				
 			case EPixelFormat::BC1_RGB8_UNorm :
@@ -596,4 +1227,108 @@ namespace {
 		END_ENUM_CHECKS();
 	}
 
+/*
+=================================================
+	LoadRow
+=================================================
+*/
+	void ImageView::LoadRow (const uint3 &point, uint count, OUT RGBA32f *dst) const
+	{
+		ASSERT( _loadF4 );
+		ASSERT( point.x + count <= _dimension.x );
+
+		const size_t	bpp		= (_bitsPerPixel + 7) / 8;
+		const auto		row		= GetRow( point.y, point.z ).section( (point.x * _bitsPerPixel) / 8, count * bpp );
+		ASSERT( row.size() == count * bpp );
+
+		if ( _loadRowF4 )
+			return _loadRowF4( row.data(), count, OUT dst );
+
+		for (uint i = 0; i < count; ++i) {
+			_loadF4( row.section( i * bpp, bpp ), OUT dst[i] );
+		}
+	}
+
+	void ImageView::LoadRow (const uint3 &point, uint count, OUT RGBA8u *dst) const
+	{
+		ASSERT( point.x + count <= _dimension.x );
+
+		if ( _isUNorm8x4 )
+		{
+			const auto	row = GetRow( point.y, point.z ).section( point.x * sizeof(RGBA8u), count * sizeof(RGBA8u) );
+			ASSERT( row.size() == count * sizeof(RGBA8u) );
+
+			std::memcpy( OUT dst, row.data(), size_t(ArraySizeOf(row)) );
+			return;
+		}
+
+		// decode small blocks to keep them in the cache
+		StaticArray< RGBA32f, 64 >	temp;
+
+		for (uint i = 0; i < count; i += uint(temp.size()))
+		{
+			const uint	cnt = Min( count - i, uint(temp.size()) );
+
+			LoadRow( uint3{ point.x + i, point.y, point.z }, cnt, OUT temp.data() );
+			StoreUNorm8x4( temp.data(), cnt, OUT dst + i );
+		}
+	}
+
+	void ImageView::LoadRow (uint y, uint z, OUT Array<RGBA32f> &row) const
+	{
+		row.resize( _dimension.x );
+		LoadRow( uint3{ 0, y, z }, _dimension.x, OUT row.data() );
+	}
+
+	void ImageView::LoadRow (uint y, uint z, OUT Array<RGBA8u> &row) const
+	{
+		row.resize( _dimension.x );
+		LoadRow( uint3{ 0, y, z }, _dimension.x, OUT row.data() );
+	}
+
+/*
+=================================================
+	ConvertRegion
+=================================================
+*/
+	template <typename Color>
+	static void ConvertRegion (const ImageView &view, const uint3 &offset, const uint3 &size, OUT Array<Color> &result)
+	{
+		result.resize( size_t(size.x) * size.y * size.z );
+
+		Color*	dst = result.data();
+
+		for (uint z = 0; z < size.z; ++z)
+		{
+			for (uint y = 0; y < size.y; ++y)
+			{
+				view.LoadRow( uint3{ offset.x, offset.y + y, offset.z + z }, size.x, OUT dst );
+				dst += size.x;
+			}
+		}
+	}
+
+/*
+=================================================
+	ConvertTo
+=================================================
+*/
+	bool ImageView::ConvertTo (const uint3 &offset, const uint3 &size, OUT Array<RGBA32f> &result) const
+	{
+		CHECK_ERR( _loadF4 );
+		CHECK_ERR( All( offset + size <= _dimension ));
+
+		ConvertRegion( *this, offset, size, OUT result );
+		return true;
+	}
+
+	bool ImageView::ConvertTo (const uint3 &offset, const uint3 &size, OUT Array<RGBA8u> &result) const
+	{
+		CHECK_ERR( _loadF4 or _isUNorm8x4 );
+		CHECK_ERR( All( offset + size <= _dimension ));
+
+		ConvertRegion( *this, offset, size, OUT result );
+		return true;
+	}
+
 }	// FG
@@ -36,6 +36,14 @@ namespace FG
 		{
 			res._SetCachedID( id );
 		}
+
+		template <typename Fn>
+		static void ForEachUniform (const PipelineResources &res, Fn&& fn)
+		{
+			SHAREDLOCK( res._drCheck );
+			if ( res._dataPtr )
+				res._dataPtr->ForEachUniform( fn );
+		}
 	};
 
 
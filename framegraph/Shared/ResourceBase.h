@@ -41,7 +41,7 @@ namespace FG
 		mutable Atomic<int>		_refCounter	= 0;
 
 		// cached resource may be deleted if reference counter is 1 and last usage was a long ago
-		//mutable Atomic<uint>	_lastUsage	= 0;
+		mutable Atomic<uint>	_lastUsage	= 0;
 
 
 	// methods
@@ -69,6 +69,26 @@ namespace FG
 		{
 			return _refCounter.fetch_sub( refCount, memory_order_relaxed ) == refCount;
 		}
+
+		// returns 'false' if reference counter is zero and resource is going to be destroyed
+		ND_ bool TryAddRef () const
+		{
+			int	expected = _refCounter.load( memory_order_relaxed );
+			for (; expected > 0 and not _refCounter.compare_exchange_weak( INOUT expected, expected + 1, memory_order_relaxed );) {}
+			return expected > 0;
+		}
+
+		// returns 'true' if only one reference was alive, after that 'TryAddRef' will fail
+		ND_ bool TryReleaseLastRef () const
+		{
+			int	expected = 1;
+			return _refCounter.compare_exchange_strong( INOUT expected, 0, memory_order_relaxed );
+		}
+
+		void SetLastUsage (uint submitIndex) const
+		{
+			_lastUsage.store( submitIndex, memory_order_relaxed );
+		}
 		
 
 		ND_ bool			IsCreated ()		const	{ return _GetState() == EState::Created; }
@@ -76,7 +96,7 @@ namespace FG
 
 		ND_ InstanceID_t	GetInstanceID ()	const	{ return InstanceID_t(_instanceId.load( memory_order_relaxed )); }
 		ND_ int				GetRefCount ()		const	{ return _refCounter.load( memory_order_relaxed ); }
-		//ND_ uint			GetLastUsage ()		const	{ return _lastUsage.load( memory_order_relaxed ); }
+		ND_ uint			GetLastUsage ()		const	{ return _lastUsage.load( memory_order_relaxed ); }
 
 		ND_ ResType&		Data ()						{ return _data; }
 		ND_ ResType const&	Data ()				const	{ return _data; }
@@ -345,7 +345,7 @@ namespace FG
 				barrier.srcQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
 				barrier.dstQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
 
-				barrierMngr.AddBufferBarrier( src.stages, dst.stages, barrier );
+				barrierMngr.AddBufferBarrier( src.stages, dst.stages, src.index, barrier );
 
 				if ( debugger ) {
 					debugger->AddBufferBarrier( _bufferData.get(), src.index, dst.index, src.stages, dst.stages, 0, barrier );
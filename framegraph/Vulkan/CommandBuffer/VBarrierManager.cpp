@@ -0,0 +1,289 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VBarrierManager.h"
+
+namespace FG
+{
+namespace
+{
+	static constexpr VkAccessFlags	ReadOnlyAccessMask =
+		VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+		VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+		VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+		VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_HOST_READ_BIT | VK_ACCESS_MEMORY_READ_BIT;
+
+/*
+=================================================
+	IsReadOnly
+----
+	unknown access flags are treated as write access
+=================================================
+*/
+	ND_ inline bool  IsReadOnly (VkAccessFlags access)
+	{
+		return (access & ~ReadOnlyAccessMask) == 0;
+	}
+
+/*
+=================================================
+	IsRedundant
+----
+	read-after-read without layout transition and queue ownership transfer
+=================================================
+*/
+	ND_ inline bool  IsRedundant (const VkImageMemoryBarrier &barrier)
+	{
+		return	barrier.oldLayout			== barrier.newLayout			and
+				barrier.srcQueueFamilyIndex	== barrier.dstQueueFamilyIndex	and
+				IsReadOnly( barrier.srcAccessMask )							and
+				IsReadOnly( barrier.dstAccessMask );
+	}
+
+	ND_ inline bool  IsRedundant (const VkBufferMemoryBarrier &barrier)
+	{
+		return	barrier.srcQueueFamilyIndex	== barrier.dstQueueFamilyIndex	and
+				IsReadOnly( barrier.srcAccessMask )							and
+				IsReadOnly( barrier.dstAccessMask );
+	}
+
+/*
+=================================================
+	IsCompatible
+----
+	barriers that differ only by subresource range
+=================================================
+*/
+	ND_ inline bool  IsCompatible (const VkImageMemoryBarrier &lhs, const VkImageMemoryBarrier &rhs)
+	{
+		return	lhs.image						== rhs.image					and
+				lhs.oldLayout					== rhs.oldLayout				and
+				lhs.newLayout					== rhs.newLayout				and
+				lhs.srcAccessMask				== rhs.srcAccessMask			and
+				lhs.dstAccessMask				== rhs.dstAccessMask			and
+				lhs.srcQueueFamilyIndex			== rhs.srcQueueFamilyIndex		and
+				lhs.dstQueueFamilyIndex			== rhs.dstQueueFamilyIndex		and
+				lhs.subresourceRange.aspectMask	== rhs.subresourceRange.aspectMask;
+	}
+
+	ND_ inline bool  IsCompatible (const VkBufferMemoryBarrier &lhs, const VkBufferMemoryBarrier &rhs)
+	{
+		return	lhs.buffer				== rhs.buffer				and
+				lhs.srcAccessMask		== rhs.srcAccessMask		and
+				lhs.dstAccessMask		== rhs.dstAccessMask		and
+				lhs.srcQueueFamilyIndex	== rhs.srcQueueFamilyIndex	and
+				lhs.dstQueueFamilyIndex	== rhs.dstQueueFamilyIndex;
+	}
+
+/*
+=================================================
+	MergeRange
+----
+	merges [rhsBase, rhsBase + rhsCount) into [base, base + count)
+	if ranges are overlapped or adjacent and 'rhsBase >= base'
+=================================================
+*/
+	ND_ inline bool  MergeRange (INOUT uint &base, INOUT uint &count, uint rhsBase, uint rhsCount)
+	{
+		if ( count == VK_REMAINING_MIP_LEVELS or rhsCount == VK_REMAINING_MIP_LEVELS )
+			return base == rhsBase and count == rhsCount;
+
+		if ( rhsBase > base + count )
+			return false;
+
+		count = Max( base + count, rhsBase + rhsCount ) - base;
+		return true;
+	}
+
+	ND_ inline bool  MergeImageBarrier (INOUT VkImageMemoryBarrier &dst, const VkImageMemoryBarrier &src)
+	{
+		if ( not IsCompatible( dst, src ))
+			return false;
+
+		auto&		dr = dst.subresourceRange;
+		auto const&	sr = src.subresourceRange;
+
+		// same mipmap range, contiguous array layers
+		if ( dr.baseMipLevel == sr.baseMipLevel and dr.levelCount == sr.levelCount )
+			return MergeRange( INOUT dr.baseArrayLayer, INOUT dr.layerCount, sr.baseArrayLayer, sr.layerCount );
+
+		// same array layers, contiguous mipmap range
+		if ( dr.baseArrayLayer == sr.baseArrayLayer and dr.layerCount == sr.layerCount )
+			return MergeRange( INOUT dr.baseMipLevel, INOUT dr.levelCount, sr.baseMipLevel, sr.levelCount );
+
+		return false;
+	}
+
+	ND_ inline bool  MergeBufferBarrier (INOUT VkBufferMemoryBarrier &dst, const VkBufferMemoryBarrier &src)
+	{
+		if ( not IsCompatible( dst, src ))
+			return false;
+
+		if ( dst.size == VK_WHOLE_SIZE )
+			return src.offset >= dst.offset;
+
+		if ( src.offset > dst.offset + dst.size )
+			return false;
+
+		dst.size = (src.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : Max( dst.offset + dst.size, src.offset + src.size ) - dst.offset);
+		return true;
+	}
+	
+/*
+=================================================
+	MergeImageBarriers
+=================================================
+*/
+	inline void  MergeImageBarriers (INOUT Array<VkImageMemoryBarrier> &barriers)
+	{
+		if ( barriers.empty() )
+			return;
+
+		auto	end = std::remove_if( barriers.begin(), barriers.end(), [] (auto& b) { return IsRedundant( b ); });
+
+		std::sort( barriers.begin(), end, [] (auto& lhs, auto& rhs)
+				  {
+					  auto&	lr = lhs.subresourceRange;
+					  auto&	rr = rhs.subresourceRange;
+					  return	lhs.image			!= rhs.image			? lhs.image			< rhs.image			:
+								lhs.oldLayout		!= rhs.oldLayout		? lhs.oldLayout		< rhs.oldLayout		:
+								lhs.newLayout		!= rhs.newLayout		? lhs.newLayout		< rhs.newLayout		:
+								lhs.srcAccessMask	!= rhs.srcAccessMask	? lhs.srcAccessMask	< rhs.srcAccessMask	:
+								lhs.dstAccessMask	!= rhs.dstAccessMask	? lhs.dstAccessMask	< rhs.dstAccessMask	:
+								lr.aspectMask		!= rr.aspectMask		? lr.aspectMask		< rr.aspectMask		:
+								lr.baseMipLevel		!= rr.baseMipLevel		? lr.baseMipLevel	< rr.baseMipLevel	:
+																			  lr.baseArrayLayer	< rr.baseArrayLayer;
+				  });
+
+		auto	dst = barriers.begin();
+		for (auto src = dst + 1; src < end; ++src)
+		{
+			if ( not MergeImageBarrier( INOUT *dst, *src ))
+				*(++dst) = *src;
+		}
+		barriers.erase( (dst == end ? dst : dst + 1), barriers.end() );
+	}
+	
+/*
+=================================================
+	MergeBufferBarriers
+=================================================
+*/
+	inline void  MergeBufferBarriers (INOUT Array<VkBufferMemoryBarrier> &barriers)
+	{
+		if ( barriers.empty() )
+			return;
+
+		auto	end = std::remove_if( barriers.begin(), barriers.end(), [] (auto& b) { return IsRedundant( b ); });
+
+		std::sort( barriers.begin(), end, [] (auto& lhs, auto& rhs)
+				  {
+					  return	lhs.buffer			!= rhs.buffer			? lhs.buffer		< rhs.buffer		:
+								lhs.srcAccessMask	!= rhs.srcAccessMask	? lhs.srcAccessMask	< rhs.srcAccessMask	:
+								lhs.dstAccessMask	!= rhs.dstAccessMask	? lhs.dstAccessMask	< rhs.dstAccessMask	:
+																			  lhs.offset		< rhs.offset;
+				  });
+
+		auto	dst = barriers.begin();
+		for (auto src = dst + 1; src < end; ++src)
+		{
+			if ( not MergeBufferBarrier( INOUT *dst, *src ))
+				*(++dst) = *src;
+		}
+		barriers.erase( (dst == end ? dst : dst + 1), barriers.end() );
+	}
+}	// namespace
+//-----------------------------------------------------------------------------
+
+
+/*
+=================================================
+	MergeBarriers
+----
+	all barriers are committed in single 'vkCmdPipelineBarrier' call,
+	so they can be reordered.
+=================================================
+*/
+	uint  VBarrierManager::MergeBarriers ()
+	{
+		const size_t	count = _imageBarriers.size() + _bufferBarriers.size();
+
+		MergeImageBarriers( INOUT _imageBarriers );
+		MergeBufferBarriers( INOUT _bufferBarriers );
+
+		return uint(count - _imageBarriers.size() - _bufferBarriers.size());
+	}
+
+/*
+=================================================
+	_AddSplitBarrier
+----
+	returns 'true' if producer task has set the event and
+	there are enough tasks between producer and consumer to hide event latency.
+=================================================
+*/
+	bool  VBarrierManager::_AddSplitBarrier (VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, ExeOrderIndex srcIndex)
+	{
+		if ( _split.available.empty()											or
+			 srcIndex == ExeOrderIndex::Initial									or
+			 uint(srcIndex) + FG_SplitBarrierMinDistance > uint(_split.currentIndex) )
+			return false;
+
+		auto	iter = std::lower_bound( _split.available.begin(), _split.available.end(), srcIndex,
+										 [] (auto& lhs, ExeOrderIndex rhs) { return lhs.index < rhs; });
+
+		if ( iter == _split.available.end() or iter->index != srcIndex )
+			return false;
+
+		// event doesn't cover all producer stages
+		if ( not AllBits( iter->stages, srcStageMask ))
+			return false;
+
+		bool	found = false;
+		for (auto& ev : _split.pending) {
+			found |= (ev.event == iter->event);
+		}
+
+		if ( not found )
+		{
+			_split.pending.push_back( *iter );
+			_split.pendingEvents.push_back( iter->event );
+			_split.srcStageMask |= iter->stages;		// must be same as in 'vkCmdSetEvent'
+		}
+
+		_split.dstStageMask |= dstStageMask;
+		return true;
+	}
+
+/*
+=================================================
+	_CommitSplitBarriers
+=================================================
+*/
+	void  VBarrierManager::_CommitSplitBarriers (const VDevice &dev, VkCommandBuffer cmd, INOUT Statistic_t &stat)
+	{
+		if ( _split.pending.empty() )
+			return;
+
+		const size_t	count = _split.imageBarriers.size() + _split.bufferBarriers.size();
+
+		MergeImageBarriers( INOUT _split.imageBarriers );
+		MergeBufferBarriers( INOUT _split.bufferBarriers );
+
+		stat.eliminatedBarriers	+= uint(count - _split.imageBarriers.size() - _split.bufferBarriers.size());
+		stat.splitBarriers		+= uint(_split.imageBarriers.size() + _split.bufferBarriers.size());
+
+		dev.vkCmdWaitEvents( cmd, uint(_split.pendingEvents.size()), _split.pendingEvents.data(),
+							 _split.srcStageMask, _split.dstStageMask,
+							 0, null,
+							 uint(_split.bufferBarriers.size()), _split.bufferBarriers.data(),
+							 uint(_split.imageBarriers.size()), _split.imageBarriers.data() );
+
+		_split.pending.clear();
+		_split.pendingEvents.clear();
+		_split.imageBarriers.clear();
+		_split.bufferBarriers.clear();
+		_split.srcStageMask = _split.dstStageMask = 0;
+	}
+
+
+}	// FG
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "framegraph/Public/FrameGraph.h"
 #include "VDevice.h"
 
 namespace FG
@@ -14,10 +15,22 @@ namespace FG
 	class VBarrierManager final
 	{
 	// types
+	public:
+		using Statistic_t				= IFrameGraph::RenderingStatistics;
+
+		struct SplitEvent
+		{
+			VkEvent					event	= VK_NULL_HANDLE;
+			VkPipelineStageFlags	stages	= 0;
+			ExeOrderIndex			index	= ExeOrderIndex::Initial;	// task after which event is set
+		};
+
 	private:
 		// TODO: custom allocator
 		using ImageMemoryBarriers_t		= Array< VkImageMemoryBarrier >;
 		using BufferMemoryBarriers_t	= Array< VkBufferMemoryBarrier >;
+		using SplitEvents_t				= Array< SplitEvent >;
+		using VkEvents_t				= Array< VkEvent >;
 
 
 	// variables
@@ -30,6 +43,18 @@ namespace FG
 		VkPipelineStageFlags		_dstStageMask		= 0;
 		VkDependencyFlags			_dependencyFlags	= 0;
 
+		// split barriers
+		struct {
+			SplitEvents_t				available;			// events that was set in current command buffer, sorted by index
+			SplitEvents_t				pending;			// events that will be waited in next commit
+			VkEvents_t					pendingEvents;
+			ImageMemoryBarriers_t		imageBarriers;
+			BufferMemoryBarriers_t		bufferBarriers;
+			VkPipelineStageFlags		srcStageMask		= 0;
+			VkPipelineStageFlags		dstStageMask		= 0;
+			ExeOrderIndex				currentIndex		= ExeOrderIndex::Initial;
+		}							_split;
+
 
 	// methods
 	public:
@@ -43,8 +68,12 @@ namespace FG
 		}
 
 
-		void Commit (const VDevice &dev, VkCommandBuffer cmd)
+		void Commit (const VDevice &dev, VkCommandBuffer cmd, INOUT Statistic_t &stat)
 		{
+			_CommitSplitBarriers( dev, cmd, INOUT stat );
+
+			stat.eliminatedBarriers += MergeBarriers();
+
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
 			if ( mem_count or _bufferBarriers.size() or _imageBarriers.size() )
@@ -53,13 +82,18 @@ namespace FG
 										  mem_count, &_memoryBarrier,
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
-				ClearBarriers();
+				++stat.pipelineBarriers;
 			}
+			ClearBarriers();
 		}
 		
 
-		void ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+		void ForceCommit (const VDevice &dev, VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, INOUT Statistic_t &stat)
 		{
+			_CommitSplitBarriers( dev, cmd, INOUT stat );
+
+			stat.eliminatedBarriers += MergeBarriers();
+
 			const uint	mem_count = !!(_memoryBarrier.srcAccessMask | _memoryBarrier.dstAccessMask);
 
 			_srcStageMask |= srcStage;
@@ -71,11 +105,48 @@ namespace FG
 										  mem_count, &_memoryBarrier,
 										  uint(_bufferBarriers.size()), _bufferBarriers.data(),
 										  uint(_imageBarriers.size()), _imageBarriers.data() );
+				++stat.pipelineBarriers;
 				ClearBarriers();
 			}
 		}
 
 
+		// removes read-after-read barriers without layout transition and merges barriers for adjacent subresources,
+		// returns number of removed barriers.
+		uint MergeBarriers ();
+
+		ND_ ArrayView<VkImageMemoryBarrier>		GetImageBarriers ()		const	{ return _imageBarriers; }
+		ND_ ArrayView<VkBufferMemoryBarrier>	GetBufferBarriers ()	const	{ return _bufferBarriers; }
+		
+		ND_ ArrayView<VkImageMemoryBarrier>		GetSplitImageBarriers ()	const	{ return _split.imageBarriers; }
+		ND_ ArrayView<VkBufferMemoryBarrier>	GetSplitBufferBarriers ()	const	{ return _split.bufferBarriers; }
+		ND_ ArrayView<SplitEvent>				GetPendingEvents ()			const	{ return _split.pending; }
+
+
+		// index of the task that will be recorded next, used to calculate distance between producer and consumer
+		void SetExecutionOrder (ExeOrderIndex index)
+		{
+			_split.currentIndex = index;
+		}
+
+
+		// event must be set by 'vkCmdSetEvent' after all commands of the task 'index'
+		void AddEvent (VkEvent event, VkPipelineStageFlags stages, ExeOrderIndex index)
+		{
+			ASSERT( _split.available.empty() or _split.available.back().index < index );
+			_split.available.push_back({ event, stages, index });
+		}
+
+
+		// events can not be waited in another command buffer
+		void ClearEvents ()
+		{
+			ASSERT( _split.pending.empty() );
+			_split.available.clear();
+			_split.currentIndex = ExeOrderIndex::Initial;
+		}
+
+
 		void ClearBarriers ()
 		{
 			_imageBarriers.clear();
@@ -97,6 +168,19 @@ namespace FG
 
 			_bufferBarriers.push_back( barrier );
 		}
+
+
+		// barrier may be replaced by 'vkCmdWaitEvents' if producer is far enough
+		void AddBufferBarrier (VkPipelineStageFlags			srcStageMask,
+							   VkPipelineStageFlags			dstStageMask,
+							   ExeOrderIndex				srcIndex,
+							   const VkBufferMemoryBarrier	&barrier)
+		{
+			if ( _AddSplitBarrier( srcStageMask, dstStageMask, srcIndex ))
+				_split.bufferBarriers.push_back( barrier );
+			else
+				AddBufferBarrier( srcStageMask, dstStageMask, barrier );
+		}
 		
 
 		void AddImageBarrier (VkPipelineStageFlags			srcStageMask,
@@ -112,6 +196,20 @@ namespace FG
 		}
 
 
+		// barrier may be replaced by 'vkCmdWaitEvents' if producer is far enough
+		void AddImageBarrier (VkPipelineStageFlags			srcStageMask,
+							  VkPipelineStageFlags			dstStageMask,
+							  VkDependencyFlags				dependencyFlags,
+							  ExeOrderIndex					srcIndex,
+							  const VkImageMemoryBarrier	&barrier)
+		{
+			if ( dependencyFlags == 0 and _AddSplitBarrier( srcStageMask, dstStageMask, srcIndex ))
+				_split.imageBarriers.push_back( barrier );
+			else
+				AddImageBarrier( srcStageMask, dstStageMask, dependencyFlags, barrier );
+		}
+
+
 		void AddMemoryBarrier (VkPipelineStageFlags		srcStageMask,
 							   VkPipelineStageFlags		dstStageMask,
 							   const VkMemoryBarrier	&barrier)
@@ -122,6 +220,11 @@ namespace FG
 			_memoryBarrier.srcAccessMask |= barrier.srcAccessMask;
 			_memoryBarrier.dstAccessMask |= barrier.dstAccessMask;
 		}
+
+
+	private:
+		bool _AddSplitBarrier (VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, ExeOrderIndex srcIndex);
+		void _CommitSplitBarriers (const VDevice &dev, VkCommandBuffer cmd, INOUT Statistic_t &stat);
 	};
 
 }	// FG
@@ -48,14 +48,18 @@ namespace FG
 
 		ASSERT( _dependencies.empty() );
 		ASSERT( _batch.commands.empty() );
+		ASSERT( _batch.secondaryCommands.empty() );
 		ASSERT( _batch.signalSemaphores.empty() );
 		ASSERT( _batch.waitSemaphores.empty() );
 		ASSERT( _staging.hostToDevice.empty() );
 		ASSERT( _staging.deviceToHost.empty() );
 		ASSERT( _staging.onBufferLoadedEvents.empty() );
 		ASSERT( _staging.onImageLoadedEvents.empty() );
+		ASSERT( _staging.onUploadedEvents.empty() );
 		ASSERT( _resourcesToRelease.empty() );
 		ASSERT( _swapchains.empty() );
+		ASSERT( _events.empty() );
+		ASSERT( _rtBuffers.empty() );
 		ASSERT( _shaderDebugger.buffers.empty() );
 		ASSERT( _shaderDebugger.modes.empty() );
 		ASSERT( _submitted == null );
@@ -144,6 +148,19 @@ namespace FG
 		_batch.commands.push_back( cmd, pool );
 	}
 	
+/*
+=================================================
+	AddSecondaryCommandBuffer
+=================================================
+*/
+	void  VCmdBatch::AddSecondaryCommandBuffer (VkCommandBuffer cmd, const VCommandPool *pool)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( GetState() < EState::Submitted );
+
+		_batch.secondaryCommands.emplace_back( cmd, pool );
+	}
+	
 /*
 =================================================
 	AddDependency
@@ -406,7 +423,14 @@ namespace FG
 				pool->RecyclePrimary( _batch.commands.get<0>()[i] );
 		}
 
+		for (auto& [cmd, pool] : _batch.secondaryCommands)
+		{
+			if ( pool )
+				pool->RecycleSecondary( cmd );
+		}
+
 		_batch.commands.clear();
+		_batch.secondaryCommands.clear();
 		_batch.signalSemaphores.clear();
 		_batch.waitSemaphores.clear();
 	}
@@ -490,6 +514,13 @@ namespace FG
 			ev.callback( ImageView{ data_parts, ev.imageSize, ev.rowPitch, ev.slicePitch, ev.format, ev.aspect });
 		}
 		_staging.onImageLoadedEvents.clear();
+		
+
+		// trigger upload events
+		for (auto& cb : _staging.onUploadedEvents) {
+			cb();
+		}
+		_staging.onUploadedEvents.clear();
 
 
 		// release resources
@@ -521,9 +552,7 @@ namespace FG
 		auto&	rm  = _frameGraph.GetResourceManager();
 
 		// release descriptor sets
-		for (auto& ds : _shaderDebugger.descCache) {
-			rm.GetDescriptorManager().DeallocDescriptorSet( ds.second );
-		}
+		rm.GetDescriptorManager().ReleaseLocalPools( INOUT _shaderDebugger.descPools );
 		_shaderDebugger.descCache.clear();
 
 		// process shader debug output
@@ -650,6 +679,9 @@ namespace FG
 			}
 		}
 		_resourcesToRelease.clear();
+
+		rm.ReleaseEvents( INOUT _events );
+		rm.ReleaseRayTracingBuffers( INOUT _rtBuffers );
 	}
 	
 /*
@@ -798,6 +830,46 @@ namespace FG
 		_readyToDelete.clear();
 	}
 
+/*
+=================================================
+	AllocRayTracingBuffer
+----
+	sub-allocates range in the last acquired buffer,
+	new buffer is acquired only if there is not enough space.
+=================================================
+*/
+	bool  VCmdBatch::AllocRayTracingBuffer (BytesU size, BytesU align, OUT RawBufferID &buffer, OUT BytesU &offset)
+	{
+		EXLOCK( _drCheck );
+		ASSERT( align > 0_b );
+
+		_statistic.resources.rtBufferAllocations ++;
+
+		if ( _rtBuffers.size() )
+		{
+			auto&	last	= _rtBuffers.back();
+			BytesU	off		= AlignToLarger( last.size, align );
+
+			if ( off + size <= last.capacity )
+			{
+				last.size	= off + size;
+				buffer		= last.bufferId;
+				offset		= off;
+				return true;
+			}
+		}
+
+		RayTracingBuffer	buf;
+		CHECK_ERR( _frameGraph.GetResourceManager().AcquireRayTracingBuffer( size, OUT buf.bufferId, OUT buf.capacity ));
+
+		buf.size	= size;
+		buffer		= buf.bufferId;
+		offset		= 0_b;
+
+		_rtBuffers.push_back( buf );
+		return true;
+	}
+
 /*
 =================================================
 	_GetWritable
@@ -846,7 +918,10 @@ namespace FG
 		if ( not suitable )
 		{
 			ASSERT( dstMinSize < stagingbuf_size );
-			CHECK_ERR( staging_buffers.size() < staging_buffers.capacity() );
+
+			// staging memory is exhausted, caller decides if it is an error
+			if ( staging_buffers.size() == staging_buffers.capacity() )
+				return false;
 
 			VResourceManager&	rm = _frameGraph.GetResourceManager();
 			
@@ -1009,6 +1084,41 @@ namespace FG
 		_staging.onImageLoadedEvents.push_back( std::move(ev) );
 		return true;
 	}
+
+/*
+=================================================
+	AddDataUploadedEvent
+=================================================
+*/
+	bool  VCmdBatch::AddDataUploadedEvent (UploadCallback_t &&cb)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( cb );
+
+		_staging.onUploadedEvents.push_back( std::move(cb) );
+		return true;
+	}
+	
+/*
+=================================================
+	GetAvailableStagingSize
+----
+	returns size of host to device staging memory that is not used in this batch,
+	including staging buffers that are not allocated yet.
+=================================================
+*/
+	BytesU  VCmdBatch::GetAvailableStagingSize () const
+	{
+		SHAREDLOCK( _drCheck );
+
+		const auto&		staging_buffers	= _staging.hostToDevice;
+		BytesU			result			= _frameGraph.GetResourceManager().GetHostWriteBufferSize() * (staging_buffers.capacity() - staging_buffers.size());
+
+		for (auto& buf : staging_buffers) {
+			result += (buf.IsFull() ? 0_b : buf.capacity - buf.size);
+		}
+		return result;
+	}
 //-----------------------------------------------------------------------------
 
 	
@@ -1413,17 +1523,14 @@ namespace FG
 
 		if ( iter != _shaderDebugger.descCache.end() )
 		{
-			descSet = iter->second.first;
+			descSet = iter->second;
 			return true;
 		}
 
 		// allocate descriptor set
 		{
-			VDescriptorSetLayout::DescriptorSet	ds;
-			CHECK_ERR( rm.GetDescriptorManager().AllocDescriptorSet( layout->Handle(), OUT ds ));
-
-			descSet = ds.first;
-			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, ds );
+			CHECK_ERR( rm.GetDescriptorManager().AllocLocalDescriptorSet( layout->Handle(), INOUT _shaderDebugger.descPools, OUT descSet ));
+			_shaderDebugger.descCache.insert_or_assign( {storageBuffer, layout_id}, descSet );
 		}
 
 		// update descriptor set
@@ -4,7 +4,7 @@
 
 #include "framegraph/Public/CommandBuffer.h"
 #include "framegraph/Public/FrameGraph.h"
-#include "VDescriptorSetLayout.h"
+#include "VDescriptorManager.h"
 #include "VLocalDebugger.h"
 #include "VCommandPool.h"
 #include "stl/Containers/FixedTupleArray.h"
@@ -116,6 +116,8 @@ namespace FG
 		static constexpr uint	MaxBufferParts	= 3;
 		static constexpr uint	MaxImageParts	= 4;
 
+		using UploadCallback_t	= IFrameGraph::UploadCallback_t;
+
 		struct StagingBuffer
 		{
 		// variables
@@ -141,6 +143,15 @@ namespace FG
 		};
 
 
+		// device local buffer for acceleration structure building, used as scratch and instance buffer
+		struct RayTracingBuffer
+		{
+			RawBufferID			bufferId;
+			BytesU				capacity;
+			BytesU				size;
+		};
+
+
 		struct OnBufferDataLoadedEvent
 		{
 		// types
@@ -223,7 +234,7 @@ namespace FG
 
 		using StorageBuffers_t		= Array< StorageBuffer >;
 		using DebugModes_t			= Array< DebugMode >;
-		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VDescriptorSetLayout::DescriptorSet >;
+		using DescriptorCache_t		= HashMap< Pair<RawBufferID, RawDescriptorSetLayoutID>, VkDescriptorSet >;
 		using ShaderDebugCallback_t	= IFrameGraph::ShaderDebugCallback_t;
 		
 
@@ -239,6 +250,7 @@ namespace FG
 
 		static constexpr uint		MaxBatchItems = 8;
 		using CmdBuffers_t			= FixedTupleArray< MaxBatchItems, VkCommandBuffer, VCommandPool const* >;
+		using SecondaryCmdBuffers_t	= Array<Pair< VkCommandBuffer, VCommandPool const* >>;
 		using SignalSemaphores_t	= FixedArray< VkSemaphore, MaxBatchItems >;
 		using WaitSemaphores_t		= FixedTupleArray< MaxBatchItems, VkSemaphore, VkPipelineStageFlags >;
 		
@@ -275,6 +287,7 @@ namespace FG
 		// command batch data
 		struct {
 			CmdBuffers_t						commands;
+			SecondaryCmdBuffers_t				secondaryCommands;	// executed from 'commands', must be recycled after submission
 			SignalSemaphores_t					signalSemaphores;
 			WaitSemaphores_t					waitSemaphores;
 		}									_batch;
@@ -285,18 +298,22 @@ namespace FG
 			FixedArray< StagingBuffer, 8 >		deviceToHost;	// CPU read, GPU write
 			Array< OnBufferDataLoadedEvent >	onBufferLoadedEvents;
 			Array< OnImageDataLoadedEvent >		onImageLoadedEvents;
+			Array< UploadCallback_t >			onUploadedEvents;		// for 'IFrameGraph::EnqueueUpload'
 		}									_staging;
 
 		// resources
 		ResourceMap_t						_resourcesToRelease;
 		Swapchains_t						_swapchains;
 		VkResourceArray_t					_readyToDelete;
+		Array< VkEvent >					_events;		// used for split barriers
+		Array< RayTracingBuffer >			_rtBuffers;		// scratch and instance buffers, returned to the resource manager on complete
 
 		// shader debugger
 		struct {
 			StorageBuffers_t					buffers;
 			DebugModes_t						modes;
 			DescriptorCache_t					descCache;
+			VDescriptorManager::LocalPools_t	descPools;		// descriptor sets are released with pools
 			BytesU								bufferAlign;
 			const BytesU						bufferSize		= 64_Mb;
 		}									_shaderDebugger;
@@ -334,6 +351,7 @@ namespace FG
 		void  WaitSemaphore (VkSemaphore sem, VkPipelineStageFlags stage);
 		void  PushFrontCommandBuffer (VkCommandBuffer, const VCommandPool *);
 		void  PushBackCommandBuffer (VkCommandBuffer, const VCommandPool *);
+		void  AddSecondaryCommandBuffer (VkCommandBuffer, const VCommandPool *);
 		void  AddDependency (VCmdBatch *);
 		void  DestroyPostponed (VkObjectType type, uint64_t handle);
 	
@@ -357,6 +375,11 @@ namespace FG
 		bool  AddPendingLoad (BytesU srcOffset, BytesU srcTotalSize, BytesU srcPitch, OUT RawBufferID &dstBuffer, OUT OnImageDataLoadedEvent::Range &range);
 		bool  AddDataLoadedEvent (OnImageDataLoadedEvent &&);
 		bool  AddDataLoadedEvent (OnBufferDataLoadedEvent &&);
+		bool  AddDataUploadedEvent (UploadCallback_t &&);
+		ND_ BytesU  GetAvailableStagingSize () const;
+
+		// ray tracing //
+		bool  AllocRayTracingBuffer (BytesU size, BytesU align, OUT RawBufferID &buffer, OUT BytesU &offset);
 
 		ND_ StringView				GetName ()						const	{ SHAREDLOCK( _drCheck );  return _debugName; }
 		ND_ EQueueType				GetQueueType ()					const	{ SHAREDLOCK( _drCheck );  return _queueType; }
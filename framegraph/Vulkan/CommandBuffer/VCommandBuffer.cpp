@@ -2,6 +2,9 @@
 
 #include "VCommandBuffer.h"
 #include "VTaskGraph.hpp"
+#include "VTransientMemoryPacker.h"
+#include "Shared/PipelineResourcesHelper.h"
+#include "stl/Algorithms/StringUtils.h"
 
 namespace FG
 {
@@ -40,10 +43,17 @@ namespace {
 		EXLOCK( _drCheck );
 		CHECK( _state == EState::Initial );
 
-		for (auto& q : _perQueue) {
-			q.Destroy( GetDevice() );
+		for (auto& q : _perQueue)
+		{
+			q.primary.Destroy( GetDevice() );
+
+			for (auto& pool : q.secondary) {
+				pool.Destroy( GetDevice() );
+			}
 		}
 		_perQueue.clear();
+
+		_pipelineCache.Deinitialize( GetDevice() );
 	}
 
 /*
@@ -60,8 +70,11 @@ namespace {
 		_batch			= batch;
 		_dbgFullBarriers= AllBits( desc.debugFlags, EDebugFlags::FullBarrier );
 		_dbgQueueSync	= AllBits( desc.debugFlags, EDebugFlags::QueueSync );
+		_asyncPipelines	= desc.asyncPipelineCompilation;
 		_state			= EState::Recording;
 		_queueIndex		= queue->familyIndex;
+		_splitBarriers	= (FG_SplitBarrierMinDistance > 0) and (not _dbgFullBarriers) and
+						  AnyBits( queue->familyFlags, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT );
 		
 		// create command pool
 		{
@@ -69,15 +82,18 @@ namespace {
 
 			_perQueue.resize( Max( _perQueue.size(), index+1 ));
 			
-			auto&	pool = _perQueue[index];
+			auto&	q = _perQueue[index];
 
-			if ( not pool.IsCreated() )
+			if ( not q.primary.IsCreated() )
 			{
-				CHECK_ERR( pool.Create( GetDevice(), queue ));
+				CHECK_ERR( q.primary.Create( GetDevice(), queue ));
+				q.queue = queue;
 			}
 		}
 		
 		_batch->OnBegin( desc );
+
+		CHECK_ERR( _instance.InitPipelineCache( INOUT _pipelineCache, INOUT _pplnCacheVersion ));
 		
 		// setup local debugger
 		const EDebugFlags	debugger_flags = desc.debugFlags & ~CmdDebugFlags;
@@ -110,6 +126,8 @@ namespace {
 		
 		const auto	start_time = TimePoint_t::clock::now();
 
+		_RecordUploads();
+
 		_state = EState::Compiling;
 
 		CHECK_ERR( _BuildCommandBuffers() );
@@ -118,9 +136,12 @@ namespace {
 			_debugger->End( _batch->GetName(), _batch->GetDependencies(), _indexInPool, OUT &_batch->_debugDump, OUT &_batch->_debugGraph );
 
 		CHECK_ERR( _batch->OnBaked( INOUT _rm.resourceMap ));
+		CHECK( _instance.MergePipelineCache( _pipelineCache ));
 		
 		_taskGraph.OnDiscardMemory();
 		_AfterCompilation();
+
+		EditStatistic().renderer.taskMemory += _mainAllocator.UsedSize();
 		_mainAllocator.Discard();
 		
 		EditStatistic().renderer.cpuTime += TimePoint_t::clock::now() - start_time;
@@ -155,6 +176,8 @@ namespace {
 			}
 		}
 		_rm.logicalRenderPassCount = 0;
+
+		_ResetTransientResources();
 	}
 
 /*
@@ -198,7 +221,7 @@ namespace {
 		
 		// create command buffer
 		{
-			auto&	pool = _perQueue[ uint(_queueIndex) ];
+			auto&	pool = _perQueue[ uint(_queueIndex) ].primary;
 			
 			cmd = pool.AllocPrimary( dev );
 			_batch->PushBackCommandBuffer( cmd, &pool );
@@ -221,7 +244,7 @@ namespace {
 		}
 
 		// commit image layout transition and other
-		_barrierMngr.Commit( dev, cmd );
+		_barrierMngr.Commit( dev, cmd, INOUT EditStatistic().renderer );
 
 		CHECK( _ProcessTasks( cmd ));
 
@@ -235,7 +258,7 @@ namespace {
 			_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, barrier );
 
 			_FlushLocalResourceStates( ExeOrderIndex::Final, _barrierMngr, GetDebugger() );
-			_barrierMngr.ForceCommit( dev, cmd, dev.GetAllWritableStages(), dev.GetAllReadableStages() );
+			_barrierMngr.ForceCommit( dev, cmd, dev.GetAllWritableStages(), dev.GetAllReadableStages(), INOUT EditStatistic().renderer );
 		}
 
 		// end
@@ -246,6 +269,61 @@ namespace {
 		return true;
 	}
 	
+/*
+=================================================
+	AllocSecondary
+----
+	allocates secondary command buffer from pool,
+	each pool must be used only by one thread at a time.
+=================================================
+*/
+	VkCommandBuffer  VCommandBuffer::AllocSecondary (uint poolIndex)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _state == EState::Compiling, VK_NULL_HANDLE );
+		CHECK_ERR( poolIndex < MaxSecondaryPools, VK_NULL_HANDLE );
+
+		auto&	q		= _perQueue[ uint(_queueIndex) ];
+		auto&	pool	= q.secondary[ poolIndex ];
+
+		if ( not pool.IsCreated() )
+		{
+			CHECK_ERR( pool.Create( GetDevice(), q.queue, "Secondary_"s << ToString(poolIndex) ), VK_NULL_HANDLE );
+		}
+
+		VkCommandBuffer	cmd = pool.AllocSecondary( GetDevice() );
+		CHECK_ERR( cmd, VK_NULL_HANDLE );
+
+		_batch->AddSecondaryCommandBuffer( cmd, &pool );
+		return cmd;
+	}
+	
+/*
+=================================================
+	AcquireEvent
+----
+	event is owned by batch and will be returned to the pool when batch complete execution
+=================================================
+*/
+	bool  VCommandBuffer::AcquireEvent (OUT VkEvent &event)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( GetResourceManager().AcquireEvent( OUT event ));
+
+		_batch->_events.push_back( event );
+		return true;
+	}
+
+/*
+=================================================
+	GetWorkerPool
+=================================================
+*/
+	ThreadPool&  VCommandBuffer::GetWorkerPool ()
+	{
+		return _instance.GetWorkerPool();
+	}
+
 /*
 =================================================
 	VTaskProcessor::Run
@@ -253,13 +331,35 @@ namespace {
 */
 	forceinline void  VTaskProcessor::Run (VTask node)
 	{
+		// record deferred commands before any other task
+		if ( _deferredGeometryBuilds.size() and not VTaskGraph<VTaskProcessor>::IsTypeOf<BuildRayTracingGeometry>( node ))
+			_FlushGeometryBuilds();
+
 		// reset states
-		_currTask = node;
+		_currTask		= node;
+		_currTaskStages	= 0;
 		
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddTask( _currTask );
 
+		if ( _splitBarriers )
+			_fgThread.GetBarrierManager().SetExecutionOrder( node->ExecutionOrder() );
+
 		node->Process( this );
+
+		// event can't be set inside render pass
+		if ( _splitBarriers and not _renderPassActive )
+			_SetSplitEvent();
+	}
+	
+/*
+=================================================
+	VTaskProcessor::Flush
+=================================================
+*/
+	forceinline void  VTaskProcessor::Flush ()
+	{
+		_FlushGeometryBuilds();
 	}
 
 /*
@@ -270,53 +370,70 @@ namespace {
 	bool  VCommandBuffer::_ProcessTasks (VkCommandBuffer cmd)
 	{
 		VTaskProcessor	processor{ *this, cmd };
-		uint			visitor_id		= 1;
 		ExeOrderIndex	exe_order_index	= ExeOrderIndex::First;
+		const size_t	task_count		= _taskGraph.Count();
 
-		TempTaskArray_t		pending{ GetAllocator() };
-		pending.reserve( 128 );
-		pending.assign( _taskGraph.Entries().begin(), _taskGraph.Entries().end() );
+		if ( task_count == 0 )
+			return true;
+
+		// Kahn's algorithm: each task is added to the queue exactly once, when the last of its inputs has been processed,
+		// so the queue never exceeds the task count and the whole graph is processed in linear time.
+		VTask*	queue	= GetAllocator().Alloc< VTask >( task_count );
+		size_t	tail	= 0;
 
-		for (uint k = 0; k < 10 and not pending.empty(); ++k)
+		for (auto node : _taskGraph.Entries())
 		{
-			for (size_t i = 0; i < pending.size();)
-			{
-				auto	node = pending[i];
-				
-				if ( node->VisitorID() == visitor_id ) {
-					++i;
-					continue;
-				}
+			ASSERT( node->PendingInputs() == 0 );
+			queue[tail++] = node;
+		}
 
-				// wait for input
-				bool	input_processed = true;
+		for (size_t head = 0; head < tail; ++head)
+		{
+			VTask	node = queue[head];
 
-				for (auto in_node : node->Inputs())
-				{
-					if ( in_node->VisitorID() != visitor_id ) {
-						input_processed = false;
-						break;
-					}
-				}
+			node->SetExecutionOrder( ++exe_order_index );
 
-				if ( not input_processed ) {
-					++i;
-					continue;
+			for (auto out_node : node->Outputs())
+			{
+				if ( out_node->ResolveInput() )
+				{
+					ASSERT( tail < task_count );
+					queue[tail++] = out_node;
 				}
+			}
+		}
 
-				node->SetVisitorID( visitor_id );
-				node->SetExecutionOrder( ++exe_order_index );
-				
-				processor.Run( node );
+		CHECK_ERR( tail == task_count );
 
-				for (auto out_node : node->Outputs())
-				{
-					pending.push_back( out_node );
-				}
+		// execution order is known, so memory for transient resources can be allocated
+		if ( _transient.resources.size() )
+			CHECK_ERR( _BindTransientMemory() );
+		
+		const auto&	aliasing_barriers	= _transient.aliasingBarriers;
+		size_t		barrier_idx			= 0;
 
-				pending.erase( pending.begin()+i );
+		for (size_t i = 0; i < task_count; ++i)
+		{
+			VTask	node = queue[i];
+			
+			// memory was used by another transient resource
+			if ( barrier_idx < aliasing_barriers.size() and aliasing_barriers[barrier_idx] == node->ExecutionOrder() )
+			{
+				processor.Flush();
+
+				VkMemoryBarrier	barrier = {};
+				barrier.sType			= VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+				barrier.srcAccessMask	= VK_ACCESS_MEMORY_WRITE_BIT;
+				barrier.dstAccessMask	= VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+				_barrierMngr.AddMemoryBarrier( VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, barrier );
+				++barrier_idx;
 			}
+
+			processor.Run( node );
 		}
+
+		processor.Flush();
+		_barrierMngr.ClearEvents();
 		return true;
 	}
 //-----------------------------------------------------------------------------
@@ -413,7 +530,8 @@ namespace {
 		CHECK_ERR( _state == EState::Recording or _state == EState::Compiling );
 
 		BytesU	buf_size;
-		return _batch->GetWritable( size, 1_b, align, size, OUT buffer, OUT offset, OUT buf_size, OUT mapped );
+		CHECK_ERR( _batch->GetWritable( size, 1_b, align, size, OUT buffer, OUT offset, OUT buf_size, OUT mapped ));
+		return true;
 	}
 
 /*
@@ -448,6 +566,62 @@ namespace {
 		}
 	}
 
+/*
+=================================================
+	CreateTransientImage
+=================================================
+*/
+	RawImageID  VCommandBuffer::CreateTransientImage (const ImageDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+
+		auto&		dev		= GetDevice();
+		auto&		rm		= GetResourceManager();
+		RawImageID	id		= rm.CreateImage( desc, MemoryDesc{ EMemoryType::AllowAliasing }, Default, Default, dbgName );
+		CHECK_ERR( id );
+
+		// image will be destroyed when command buffer execution is complete
+		ReleaseResource( id );
+
+		TransientResource	res;
+		res.image = id;
+		dev.vkGetImageMemoryRequirements( dev.GetVkDevice(), rm.GetResource( id )->Handle(), OUT &res.memReq );
+
+		auto*	image = ToLocal( id );
+		CHECK_ERR( image );
+		image->SetTransient();
+
+		_transient.resources.push_back( res );
+		return id;
+	}
+	
+/*
+=================================================
+	CreateTransientBuffer
+=================================================
+*/
+	RawBufferID  VCommandBuffer::CreateTransientBuffer (const BufferDesc &desc, StringView dbgName)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( _IsRecording() );
+		
+		auto&		dev		= GetDevice();
+		auto&		rm		= GetResourceManager();
+		RawBufferID	id		= rm.CreateBuffer( desc, MemoryDesc{ EMemoryType::AllowAliasing }, Default, dbgName );
+		CHECK_ERR( id );
+		
+		// buffer will be destroyed when command buffer execution is complete
+		ReleaseResource( id );
+		
+		TransientResource	res;
+		res.buffer = id;
+		dev.vkGetBufferMemoryRequirements( dev.GetVkDevice(), rm.GetResource( id )->Handle(), OUT &res.memReq );
+
+		_transient.resources.push_back( res );
+		return id;
+	}
+
 /*
 =================================================
 	AddTask (SubmitRenderPass)
@@ -462,6 +636,9 @@ namespace {
 		// TODO: add scale to shader timemap
 
 		auto	rp_task = _taskGraph.Add( *this, task );
+		CHECK_ERR( rp_task );
+
+		_ResolveTransientUsage( *rp_task->GetLogicalPass(), rp_task );
 		
 		if ( AllBits( _shaderDbg.timemapStages, EShaderStages::Fragment ) and _shaderDbg.timemapIndex != Default )
 		{
@@ -697,11 +874,15 @@ namespace {
 /*
 =================================================
 	_AddUpdateBufferTask
+----
+	if 'recordedSize' is not null then staging memory exhaustion is not an error,
+	only the data that was written to staging buffers is copied and its size is returned.
 =================================================
 */
-	Task  VCommandBuffer::_AddUpdateBufferTask (const UpdateBuffer &task)
+	Task  VCommandBuffer::_AddUpdateBufferTask (const UpdateBuffer &task, OUT BytesU *recordedSize)
 	{
 		CopyBuffer		copy;
+		BytesU			recorded;
 		copy.taskName	= task.taskName;
 		copy.debugColor	= task.debugColor;
 		copy.depends	= task.depends;
@@ -710,11 +891,21 @@ namespace {
 		// copy to staging buffer
 		for (auto& reg : task.regions)
 		{
-			for (BytesU readn; readn < ArraySizeOf(reg.data);)
+			const BytesU	reg_size = reg.writer ? reg.size : ArraySizeOf(reg.data);
+
+			for (BytesU readn; readn < reg_size;)
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StorePartialData( reg.data, readn, OUT src_buffer, OUT off, OUT size ));
+
+				if ( not _StorePartialData( reg.data, reg.writer, reg_size, readn, OUT src_buffer, OUT off, OUT size ))
+				{
+					if ( not recordedSize )
+						RETURN_ERR( "staging memory is exhausted" );
+
+					*recordedSize = recorded;
+					return copy.regions.empty() ? null : AddTask( copy );
+				}
 			
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -727,13 +918,61 @@ namespace {
 				copy.AddRegion( off, reg.offset + readn, size );
 
 				readn		  += size;
+				recorded	  += size;
 				copy.srcBuffer = src_buffer;
 			}
 		}
 
+		if ( recordedSize )
+			*recordedSize = recorded;
+
 		return AddTask( copy );
 	}
 	
+/*
+=================================================
+	_RecordUploads
+----
+	records parts of the queued uploads, see 'IFrameGraph::EnqueueUpload'.
+	When staging memory is exhausted the part is recorded partially and
+	unrecorded data is returned to the queue, so it is never written twice.
+=================================================
+*/
+	void  VCommandBuffer::_RecordUploads ()
+	{
+		auto&							rm = _instance.GetResourceManager();
+		VResourceManager::UploadParts_t	parts;
+
+		rm.AcquireUploads( _batch->GetQueueType(), _batch->GetAvailableStagingSize(), OUT parts );
+
+		for (size_t i = 0; i < parts.size(); ++i)
+		{
+			auto&	part = parts[i];
+			BytesU	recorded;
+
+			Visit( part.task,
+				[&] (const UpdateBuffer &t)	{ Unused( _AddUpdateBufferTask( t, OUT &recorded )); },
+				[&] (const UpdateImage &t)	{ Unused( _AddUpdateImageTask( t, OUT &recorded )); },
+				[] (const NullUnion &)		{});
+
+			EditStatistic().resources.uploadedSize += recorded;
+
+			// part reference is released when this batch is completed,
+			// callback is called and resource is released by the last completed part of the request
+			if ( recorded > 0 )
+				CHECK( _batch->AddDataUploadedEvent( [&rm, state = part.state] () { rm.CompleteUpload( state ); }));
+
+			if ( recorded < part.size )
+			{
+				// staging memory is exhausted, remaining data will be uploaded in the next command buffers
+				part.recorded = recorded;
+				parts.erase( parts.begin(), parts.begin() + i );
+				rm.ReturnUploads( INOUT parts );
+				return;
+			}
+		}
+	}
+
 /*
 =================================================
 	AddTask (UpdateImage)
@@ -754,9 +993,11 @@ namespace {
 /*
 =================================================
 	_AddUpdateImageTask
+----
+	see '_AddUpdateBufferTask', recorded size is an offset in the source data.
 =================================================
 */
-	Task  VCommandBuffer::_AddUpdateImageTask (const UpdateImage &task)
+	Task  VCommandBuffer::_AddUpdateImageTask (const UpdateImage &task, OUT BytesU *recordedSize)
 	{
 		CHECK_ERR( task.dstImage );
 		ImageDesc const&	img_desc = AcquireTemporary( task.dstImage )->Description();
@@ -774,7 +1015,7 @@ namespace {
 		const BytesU	slice_pitch		= Max( task.dataSlicePitch, min_slice_pitch );
 		const BytesU	total_size		= image_size.z > 1 ? slice_pitch * image_size.z : min_slice_pitch;
 
-		CHECK_ERR( total_size == ArraySizeOf(task.data) );
+		CHECK_ERR( task.writer or total_size == ArraySizeOf(task.data) );
 
 		const BytesU		min_size	= _instance.GetResourceManager().GetHostWriteBufferSize() / 4;
 		const uint			row_length	= CheckCast<uint>((row_pitch * block_dim.x * 8) / block_size);
@@ -797,7 +1038,14 @@ namespace {
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( task.data, readn, slice_pitch, total_size, OUT src_buffer, OUT off, OUT size ));
+				if ( not _StoreImageData( task.data, task.writer, total_size, readn, slice_pitch, total_size, OUT src_buffer, OUT off, OUT size ))
+				{
+					if ( not recordedSize )
+						RETURN_ERR( "staging memory is exhausted" );
+
+					*recordedSize = readn;
+					return copy.regions.empty() ? null : AddTask( copy );
+				}
 				
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -827,14 +1075,21 @@ namespace {
 		// copy to staging buffer row by row
 		for (uint slice = 0; slice < image_size.z; ++slice)
 		{
-			uint				y_offset	= 0;
-			ArrayView<uint8_t>	data		= task.data.section( size_t(slice * slice_pitch), size_t(slice_pitch) );
+			uint			y_offset	= 0;
+			const BytesU	slice_end	= Min( slice_pitch * (slice + 1), total_size );
 
-			for (BytesU readn; readn < ArraySizeOf(data);)
+			for (BytesU readn = slice_pitch * slice; readn < slice_end;)
 			{
 				RawBufferID		src_buffer;
 				BytesU			off, size;
-				CHECK_ERR( _StoreImageData( data, readn, row_pitch * block_dim.y, total_size, OUT src_buffer, OUT off, OUT size ));
+				if ( not _StoreImageData( task.data, task.writer, slice_end, readn, row_pitch * block_dim.y, total_size, OUT src_buffer, OUT off, OUT size ))
+				{
+					if ( not recordedSize )
+						RETURN_ERR( "staging memory is exhausted" );
+
+					*recordedSize = readn;
+					return copy.regions.empty() ? null : AddTask( copy );
+				}
 				
 				if ( copy.srcBuffer and src_buffer != copy.srcBuffer )
 				{
@@ -861,6 +1116,9 @@ namespace {
 			CHECK( y_offset == image_size.y );
 		}
 
+		if ( recordedSize )
+			*recordedSize = total_size;
+
 		return AddTask( copy );
 	}
 	
@@ -1114,6 +1372,28 @@ namespace {
 		return false;
 	}
 	
+/*
+=================================================
+	_AllocRayTracingBuffer
+----
+	scratch and instance buffers are sub-allocated from pooled buffers,
+	ranges are released when command batch complete execution.
+=================================================
+*/
+	bool  VCommandBuffer::_AllocRayTracingBuffer (BytesU size, BytesU align, OUT const VLocalBuffer* &outBuffer, OUT VkDeviceSize &outOffset)
+	{
+		RawBufferID		buffer;
+		BytesU			offset;
+		CHECK_ERR( _batch->AllocRayTracingBuffer( size, align, OUT buffer, OUT offset ));
+
+		outBuffer	= ToLocal( buffer );
+		outOffset	= VkDeviceSize(offset);
+		CHECK_ERR( outBuffer );
+
+		ASSERT( AllBits( outBuffer->Description().usage, EBufferUsage::RayTracing ));
+		return true;
+	}
+
 /*
 =================================================
 	AddTask (UpdateRayTracingShaderTable)
@@ -1164,14 +1444,9 @@ namespace {
 		as_info.accelerationStructure	= geom->Handle();
 		GetDevice().vkGetAccelerationStructureMemoryRequirementsNV( GetDevice().GetVkDevice(), &as_info, OUT &mem_req );
 
-		// TODO: virtual buffer or buffer cache
-		BufferID	buf = _instance.CreateBuffer( BufferDesc{ BytesU(mem_req.memoryRequirements.size), EBufferUsage::RayTracing }, Default, "ScratchBuffer" );
-		CHECK_ERR( buf );
-
-		result->_scratchBuffer = ToLocal( buf.Get() );
-		ReleaseResource( buf.Release() );
-		
-		ASSERT( AllBits( result->_scratchBuffer->Description().usage, EBufferUsage::RayTracing ));
+		CHECK_ERR( _AllocRayTracingBuffer( BytesU(mem_req.memoryRequirements.size), BytesU(mem_req.memoryRequirements.alignment),
+										   OUT result->_scratchBuffer, OUT result->_scratchBufferOffset ));
+		result->_scratchBufferSize = mem_req.memoryRequirements.size;
 		
 		result->_geometryCount	= task.triangles.size() + task.aabbs.size();
 		result->_geometry		= _mainAllocator.Alloc<VkGeometryNV>( result->_geometryCount );
@@ -1342,6 +1617,10 @@ namespace {
 
 		result->_rtScene = scene;
 
+		const auto*	scene_data		= scene->ToGlobal();
+		const bool	allow_update	= AllBits( scene->GetFlags(), ERayTracingFlags::AllowUpdate );
+		const uint	inst_count		= CheckCast<uint>(task.instances.size());
+		
 		VkMemoryRequirements2								mem_req	= {};
 		VkAccelerationStructureMemoryRequirementsInfoNV		as_info	= {};
 		as_info.sType					= VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_INFO_NV;
@@ -1349,47 +1628,62 @@ namespace {
 		as_info.accelerationStructure	= scene->Handle();
 		GetDevice().vkGetAccelerationStructureMemoryRequirementsNV( GetDevice().GetVkDevice(), &as_info, OUT &mem_req );
 		
-		MemoryDesc	mem;
-		mem.type	= EMemoryType::Default;
-		mem.req		= VulkanMemRequirements{ mem_req.memoryRequirements.memoryTypeBits, CheckCast<uint>(mem_req.memoryRequirements.alignment) };
+		VkDeviceSize	scratch_size	= mem_req.memoryRequirements.size;
+		VkDeviceSize	scratch_align	= mem_req.memoryRequirements.alignment;
 
-		// TODO: virtual buffer or buffer cache
-		BufferID	scratch_buf = _instance.CreateBuffer( BufferDesc{ BytesU(mem_req.memoryRequirements.size), EBufferUsage::RayTracing }, mem, "ScratchBuffer" );
-		CHECK_ERR( scratch_buf );
+		// build or update will be selected when task is processed, so scratch buffer must be enough for both
+		if ( allow_update )
+		{
+			as_info.type = VK_ACCELERATION_STRUCTURE_MEMORY_REQUIREMENTS_TYPE_UPDATE_SCRATCH_NV;
+			GetDevice().vkGetAccelerationStructureMemoryRequirementsNV( GetDevice().GetVkDevice(), &as_info, OUT &mem_req );
 
-		result->_scratchBuffer = ToLocal( scratch_buf.Get() );
-		ReleaseResource( scratch_buf.Release() );
-		
-		// TODO: virtual buffer or buffer cache
-		BufferID	instance_buf = _instance.CreateBuffer( BufferDesc{ ArraySizeOf(task.instances), EBufferUsage::TransferDst | EBufferUsage::RayTracing }, mem, "InstanceBuffer" );
-		CHECK_ERR( instance_buf );
+			scratch_size	= Max( scratch_size, mem_req.memoryRequirements.size );
+			scratch_align	= Max( scratch_align, mem_req.memoryRequirements.alignment );
+		}
 
-		result->_instanceBuffer = ToLocal( instance_buf.Get() );
-		ReleaseResource( instance_buf.Release() );
+		CHECK_ERR( _AllocRayTracingBuffer( BytesU(scratch_size), BytesU(scratch_align), OUT result->_scratchBuffer, OUT result->_scratchBufferOffset ));
+		result->_scratchBufferSize = scratch_size;
 
-		VkGeometryInstance*  vk_instances;
-		CHECK_ERR( _AllocStorage<VkGeometryInstance>( task.instances.size(), OUT result->_instanceStagingBuffer, OUT result->_instanceStagingBufferOffset, OUT vk_instances ));
-		
-		ASSERT( AllBits( result->_scratchBuffer->Description().usage, EBufferUsage::RayTracing ));
-		ASSERT( AllBits( result->_instanceBuffer->Description().usage, EBufferUsage::RayTracing ));
-
-		// sort instances by ID
-		Array<uint>	sorted;		// TODO: use temporary allocator
-		sorted.resize( task.instances.size() );
-		for (size_t i = 0; i < sorted.size(); ++i) { sorted[i] = uint(i); }
-		std::sort( sorted.begin(), sorted.end(), [inst = &task.instances] (auto lhs, auto rhs) { return (*inst)[lhs].instanceId < (*inst)[rhs].instanceId; });
-
-		result->_rtGeometries			= _mainAllocator.Alloc< VLocalRTGeometry const *>( task.instances.size() );
-		result->_instances				= _mainAllocator.Alloc< VFgTask<BuildRayTracingScene>::Instance >( task.instances.size() );
-		result->_instanceCount			= CheckCast<uint>(task.instances.size());
+		// instance data will be compared with previous data, so only changed instances are uploaded
+		VkGeometryInstance*  vk_instances = null;
+
+		if ( allow_update )
+		{
+			result->_instanceBuffer	= ToLocal( scene_data->InstanceBuffer() );
+			vk_instances			= _mainAllocator.Alloc< VkGeometryInstance >( inst_count );
+			CHECK_ERR( result->_instanceBuffer and vk_instances );
+		}
+		else
+		{
+			// instance data must be aligned to 16 bytes
+			CHECK_ERR( _AllocRayTracingBuffer( SizeOf<VkGeometryInstance> * inst_count, 16_b, OUT result->_instanceBuffer, OUT result->_instanceBufferOffset ));
+
+			auto&	copy = result->_instanceCopies.emplace_back();
+			copy.size	 = sizeof(VkGeometryInstance) * inst_count;
+			CHECK_ERR( _AllocStorage<VkGeometryInstance>( inst_count, OUT copy.srcBuffer, OUT copy.srcOffset, OUT vk_instances ));
+		}
+
+		// sort instances by ID, in most cases instances are already sorted
+		uint*	sorted = _mainAllocator.Alloc< uint >( inst_count );
+		CHECK_ERR( sorted or inst_count == 0 );
+
+		for (uint i = 0; i < inst_count; ++i) { sorted[i] = i; }
+
+		const auto	InstanceLess = [inst = &task.instances] (uint lhs, uint rhs) { return (*inst)[lhs].instanceId < (*inst)[rhs].instanceId; };
+
+		if ( not std::is_sorted( sorted, sorted + inst_count, InstanceLess ))
+			std::sort( sorted, sorted + inst_count, InstanceLess );
+
+		result->_rtGeometries			= _mainAllocator.Alloc< VLocalRTGeometry const *>( inst_count );
+		result->_instances				= _mainAllocator.Alloc< VFgTask<BuildRayTracingScene>::Instance >( inst_count );
+		result->_instanceCount			= inst_count;
 		result->_hitShadersPerInstance	= Max( 1u, task.hitShadersPerInstance );
 
-		for (size_t i = 0; i < task.instances.size(); ++i)
+		for (uint i = 0; i < inst_count; ++i)
 		{
-			uint	idx  = sorted[i];
-			auto&	src  = task.instances[i];
-			auto&	dst  = vk_instances[idx];
-			auto&	blas = result->_rtGeometries[idx];
+			auto&	src  = task.instances[ sorted[i] ];
+			auto&	dst  = vk_instances[i];
+			auto&	blas = result->_rtGeometries[i];
 
 			ASSERT( src.instanceId.IsDefined() );
 			ASSERT( src.geometryId );
@@ -1407,10 +1701,36 @@ namespace {
 			dst.instanceOffset	= result->_maxHitShaderCount;
 			dst.flags			= VEnumCast( src.flags );
 			
-			PlacementNew<VFgTask<BuildRayTracingScene>::Instance>( result->_instances + idx, src.instanceId, src.geometryId, uint(dst.instanceOffset) );
+			PlacementNew<VFgTask<BuildRayTracingScene>::Instance>( result->_instances + i, src.instanceId, src.geometryId, uint(dst.instanceOffset) );
 
 			result->_maxHitShaderCount += (blas->MaxGeometryCount() * result->_hitShadersPerInstance);
 		}
+
+		// upload changed instances.
+		// instance buffer content is committed when task is processed, if another build of this scene
+		// was processed after recording then dirty ranges are outdated and all instances will be uploaded.
+		if ( allow_update )
+		{
+			std::vector< uint2, StdLinearAllocator<uint2> >	dirty_ranges{ _mainAllocator };
+
+			const uint	generation	= scene_data->FindDirtyInstances( ArrayView{ vk_instances, inst_count }, OUT dirty_ranges );
+			auto&		full		= result->_fullInstanceCopy;
+
+			full.size = sizeof(VkGeometryInstance) * inst_count;
+			CHECK_ERR( _StoreData( vk_instances, BytesU(full.size), 16_b, OUT full.srcBuffer, OUT full.srcOffset ));
+
+			for (auto& range : dirty_ranges)
+			{
+				auto&	copy = result->_instanceCopies.emplace_back();
+				copy.srcBuffer	= full.srcBuffer;
+				copy.srcOffset	= full.srcOffset + sizeof(VkGeometryInstance) * range.x;
+				copy.dstOffset	= sizeof(VkGeometryInstance) * range.x;
+				copy.size		= sizeof(VkGeometryInstance) * (range.y - range.x);
+			}
+
+			result->_vkInstances		= vk_instances;
+			result->_instanceGeneration	= generation;
+		}
 		
 		GetResourceManager().CheckTask( task );
 
@@ -1485,6 +1805,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVertices,
 						VTaskProcessor::Visit2_DrawVertices );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1506,6 +1828,31 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexed,
 						VTaskProcessor::Visit2_DrawIndexed );
+
+		AttachTransientUsage( *rp );
+	}
+	
+/*
+=================================================
+	AddTask (DrawIndexedBatch)
+=================================================
+*/
+	void  VCommandBuffer::AddTask (LogicalPassID renderPass, const DrawIndexedBatch &task)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERRV( _IsRecording() );
+		ASSERT( task.commands.size() );
+		ASSERT( task.pipeline );
+		
+		auto *	rp  = ToLocal( renderPass );
+		CHECK_ERRV( rp );
+
+		rp->AddTask< VFgDrawTask<DrawIndexedBatch> >(
+						*this, task,
+						VTaskProcessor::Visit1_DrawIndexedBatch,
+						VTaskProcessor::Visit2_DrawIndexedBatch );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1529,6 +1876,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshes,
 						VTaskProcessor::Visit2_DrawMeshes );
+
+		AttachTransientUsage( *rp );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1555,6 +1904,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVerticesIndirect,
 						VTaskProcessor::Visit2_DrawVerticesIndirect );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1577,6 +1928,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexedIndirect,
 						VTaskProcessor::Visit2_DrawIndexedIndirect );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1599,6 +1952,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawVerticesIndirectCount,
 						VTaskProcessor::Visit2_DrawVerticesIndirectCount );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1621,6 +1976,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawIndexedIndirectCount,
 						VTaskProcessor::Visit2_DrawIndexedIndirectCount );
+
+		AttachTransientUsage( *rp );
 	}
 
 /*
@@ -1644,6 +2001,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshesIndirect,
 						VTaskProcessor::Visit2_DrawMeshesIndirect );
+
+		AttachTransientUsage( *rp );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1671,6 +2030,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_DrawMeshesIndirectCount,
 						VTaskProcessor::Visit2_DrawMeshesIndirectCount );
+
+		AttachTransientUsage( *rp );
 	#else
 		Unused( renderPass, task );
 		ASSERT( !"mesh shader is not supported" );
@@ -1695,6 +2056,8 @@ namespace {
 						*this, task,
 						VTaskProcessor::Visit1_CustomDraw,
 						VTaskProcessor::Visit2_CustomDraw );
+
+		AttachTransientUsage( *rp );
 	}
 	
 /*
@@ -1735,6 +2098,7 @@ namespace {
 		}
 
 		_rm.logicalRenderPassCount = Max( uint(index)+1, _rm.logicalRenderPassCount );
+		AttachTransientUsage( data.Data() );
 
 		return LogicalPassID( index, 0 );
 	}
@@ -1926,16 +2290,16 @@ namespace {
 	_ToLocal
 =================================================
 */
-	template <typename ID, typename Res, typename MainPool, size_t MC>
-	inline Res const*  VCommandBuffer::_ToLocal (ID id, INOUT LocalResPool<Res,MainPool,MC> &localRes, StringView msg)
+	template <typename ID, typename Res, typename MainPool, size_t CS>
+	inline Res const*  VCommandBuffer::_ToLocal (ID id, INOUT LocalResPool<Res,MainPool,CS> &localRes, StringView msg)
 	{
 		EXLOCK( _drCheck );
 		CHECK_ERR( _state == EState::Recording or _state == EState::Compiling );
 
-		if ( id.Index() >= localRes.toLocal.size() )
+		if ( id.Index() >= localRes.toLocal.capacity() )
 			return null;
 
-		Index_t&	local = localRes.toLocal[ id.Index() ];
+		Index_t		local = localRes.toLocal[ id.Index() ];
 
 		if ( local != UMax )
 		{
@@ -1949,6 +2313,7 @@ namespace {
 			return null;
 
 		CHECK_ERR( localRes.pool.Assign( OUT local ));
+		localRes.toLocal( id.Index() ) = local;
 
 		auto&	data = localRes.pool[ local ];
 		Replace( data );
@@ -1956,11 +2321,11 @@ namespace {
 		if ( not data.Create( res ))
 		{
 			localRes.pool.Unassign( local );
+			localRes.toLocal( id.Index() ) = UMax;
 			RETURN_ERR( msg );
 		}
 
-		localRes.maxLocalIndex  = Max( uint(local)+1, localRes.maxLocalIndex );
-		localRes.maxGlobalIndex = Max( uint(id.Index())+1, localRes.maxGlobalIndex );
+		localRes.maxLocalIndex = Max( uint(local)+1, localRes.maxLocalIndex );
 
 		return &(data.Data());
 	}
@@ -1972,12 +2337,22 @@ namespace {
 */
 	VLocalBuffer const*  VCommandBuffer::ToLocal (RawBufferID id)
 	{
-		return _ToLocal( id, _rm.buffers, "failed when creating local buffer" );
+		auto*	result = _ToLocal( id, _rm.buffers, "failed when creating local buffer" );
+
+		if ( _transient.resources.size() and _IsRecording() )
+			_AddTransientUsage( id );
+
+		return result;
 	}
 
 	VLocalImage const*  VCommandBuffer::ToLocal (RawImageID id)
 	{
-		return _ToLocal( id, _rm.images, "failed when creating local image" );
+		auto*	result = _ToLocal( id, _rm.images, "failed when creating local image" );
+		
+		if ( _transient.resources.size() and _IsRecording() )
+			_AddTransientUsage( id );
+
+		return result;
 	}
 	
 #ifdef VK_NV_ray_tracing
@@ -2010,36 +2385,268 @@ namespace {
 */
 	void  VCommandBuffer::_ResetLocalRemaping ()
 	{
-		std::memset( _rm.images.toLocal.data(), ~0u, sizeof(Index_t)*_rm.images.maxGlobalIndex );
-		std::memset( _rm.buffers.toLocal.data(), ~0u, sizeof(Index_t)*_rm.buffers.maxGlobalIndex );
-		_rm.images.maxGlobalIndex	= 0;
-		_rm.buffers.maxGlobalIndex	= 0;
+		_rm.images.toLocal.Clear();
+		_rm.buffers.toLocal.Clear();
 		
 		#ifdef VK_NV_ray_tracing
-		std::memset( _rm.rtScenes.toLocal.data(), ~0u, sizeof(Index_t)*_rm.rtScenes.maxGlobalIndex );
-		std::memset( _rm.rtGeometries.toLocal.data(), ~0u, sizeof(Index_t)*_rm.rtGeometries.maxGlobalIndex );
-		_rm.rtScenes.maxGlobalIndex		= 0;
-		_rm.rtGeometries.maxGlobalIndex	= 0;
+		_rm.rtScenes.toLocal.Clear();
+		_rm.rtGeometries.toLocal.Clear();
 		#endif
 	}
 //-----------------------------------------------------------------------------
 
+
+/*
+=================================================
+	CreateDescriptorSet
+----
+	descriptor set that contains transient resources
+	will be created when memory is bound.
+=================================================
+*/
+	void  VCommandBuffer::CreateDescriptorSet (const PipelineResources &desc, OUT VPipelineResources const* &result)
+	{
+		if ( _transient.resources.size() and _AddTransientUsage( desc ))
+		{
+			result = null;
+			_transient.descriptorSets.emplace_back( desc, &result );
+			return;
+		}
+
+		result = CreateDescriptorSet( desc );
+	}
+	
+/*
+=================================================
+	CopyDescriptorSet
+=================================================
+*/
+	void  VCommandBuffer::CopyDescriptorSet (VPipelineResources const* const& src, OUT VPipelineResources const* &dst)
+	{
+		dst = src;
+
+		if ( src == null and _transient.descriptorSets.size() )
+			_transient.descriptorSetCopies.emplace_back( &src, &dst );
+	}
+
+/*
+=================================================
+	_AddTransientUsage
+=================================================
+*/
+	template <typename ID>
+	void  VCommandBuffer::_AddTransientUsage (ID id)
+	{
+		for (size_t i = 0; i < _transient.resources.size(); ++i)
+		{
+			auto&	res = _transient.resources[i];
+
+			if constexpr( IsSameTypes< ID, RawImageID >) {
+				if ( res.image != id ) continue;
+			} else {
+				if ( res.buffer != id ) continue;
+			}
+
+			if ( std::find( _transient.pending.begin(), _transient.pending.end(), uint(i) ) == _transient.pending.end() )
+				_transient.pending.push_back( uint(i) );
+			return;
+		}
+	}
+	
+	bool  VCommandBuffer::_AddTransientUsage (const PipelineResources &desc)
+	{
+		const size_t	count = _transient.pending.size();
+		
+		const auto	AddImages = [this] (auto& un) {
+			for (uint i = 0; i < un.elementCount; ++i) { _AddTransientUsage( un.elements[i].imageId ); }
+		};
+		const auto	AddBuffers = [this] (auto& un) {
+			for (uint i = 0; i < un.elementCount; ++i) { _AddTransientUsage( un.elements[i].bufferId ); }
+		};
+
+		PipelineResourcesHelper::ForEachUniform( desc, [&] (const UniformID &, const auto &un)
+			{
+				using T = std::remove_cv_t<std::remove_reference_t< decltype(un) >>;
+
+				if constexpr( IsSameTypes< T, PipelineResources::Image > or IsSameTypes< T, PipelineResources::Texture >)
+					AddImages( un );
+				else
+				if constexpr( IsSameTypes< T, PipelineResources::Buffer > or IsSameTypes< T, PipelineResources::TexelBuffer >)
+					AddBuffers( un );
+			});
+
+		return _transient.pending.size() > count;
+	}
+	
+/*
+=================================================
+	_ResolveTransientUsage
+=================================================
+*/
+	void  VCommandBuffer::_ResolveTransientUsage (const VLogicalRenderPass &logicalPass, VTask task)
+	{
+		for (auto& usage : _transient.usages)
+		{
+			if ( usage.pass == &logicalPass )
+				usage.task = task;
+		}
+	}
+
+/*
+=================================================
+	_BindTransientMemory
+----
+	calculates lifetime of transient resources,
+	resources with non-overlapping lifetimes are packed into shared heaps.
+=================================================
+*/
+	bool  VCommandBuffer::_BindTransientMemory ()
+	{
+		auto&	rm		= GetResourceManager();
+		auto&	stat	= EditStatistic().resources;
+
+		for (auto& usage : _transient.usages)
+		{
+			// draw tasks in not submitted render pass are not executed
+			if ( not usage.task )
+				continue;
+
+			auto&				res	= _transient.resources[ usage.index ];
+			const ExeOrderIndex	idx	= usage.task->ExecutionOrder();
+
+			res.first	= (idx < res.first ? idx : res.first);
+			res.last	= (idx > res.last  ? idx : res.last);
+		}
+
+		// group resources by memory type, images and buffers use different heaps to avoid 'bufferImageGranularity' restrictions
+		Array<uint>		order;
+		order.reserve( _transient.resources.size() );
+
+		for (size_t i = 0; i < _transient.resources.size(); ++i)
+		{
+			auto&	res = _transient.resources[i];
+
+			// unused resource must be bound too, it may be used in descriptor set
+			if ( res.first == ExeOrderIndex::Unknown )
+				res.first = res.last = ExeOrderIndex::Initial;
+
+			order.push_back( uint(i) );
+		}
+
+		std::sort( order.begin(), order.end(), [this] (uint lhs, uint rhs)
+				  {
+					  auto&	l = _transient.resources[lhs];
+					  auto&	r = _transient.resources[rhs];
+					  return	bool(l.image) != bool(r.image)						? bool(l.image) < bool(r.image) :
+								l.memReq.memoryTypeBits != r.memReq.memoryTypeBits	? l.memReq.memoryTypeBits < r.memReq.memoryTypeBits :
+																					  lhs < rhs;
+				  });
+
+		VTransientMemoryPacker	packer;
+
+		for (size_t i = 0; i < order.size();)
+		{
+			auto&	first_res	= _transient.resources[ order[i] ];
+			size_t	count		= 0;
+
+			packer.Clear();
+
+			for (; i + count < order.size(); ++count)
+			{
+				auto&	res = _transient.resources[ order[i + count] ];
+
+				if ( bool(res.image) != bool(first_res.image) or res.memReq.memoryTypeBits != first_res.memReq.memoryTypeBits )
+					break;
+
+				Unused( packer.Add( BytesU(res.memReq.size), BytesU(res.memReq.alignment), res.first, res.last ));
+			}
+
+			packer.Pack();
+
+			VkMemoryRequirements	heap_req = {};
+			heap_req.size			= VkDeviceSize(packer.TotalSize());
+			heap_req.alignment		= VkDeviceSize(packer.MaxAlignment());
+			heap_req.memoryTypeBits	= first_res.memReq.memoryTypeBits;
+
+			RawMemoryID		heap = rm.CreateMemory( heap_req, MemoryDesc{}, "TransientHeap" );
+			CHECK_ERR( heap );
+
+			// heap will be released when command buffer execution is complete
+			ReleaseResource( heap );
+
+			for (uint j = 0; j < count; ++j)
+			{
+				auto&	res = _transient.resources[ order[i + j] ];
+
+				if ( res.image ) {
+					CHECK_ERR( rm.BindAliasedMemory( res.image, heap, packer.Offset(j), packer.Size(j) ));
+				} else {
+					CHECK_ERR( rm.BindAliasedMemory( res.buffer, heap, packer.Offset(j), packer.Size(j) ));
+				}
+
+				if ( packer.IsAliased(j) )
+					_transient.aliasingBarriers.push_back( res.first );
+			}
+
+			stat.transientResourceMemory	+= packer.RequiredSize();
+			stat.transientHeapMemory		+= packer.TotalSize();
+
+			i += count;
+		}
+
+		auto&	barriers = _transient.aliasingBarriers;
+		std::sort( barriers.begin(), barriers.end() );
+		barriers.erase( std::unique( barriers.begin(), barriers.end() ), barriers.end() );
+
+		// create descriptor sets with transient resources
+		for (auto& ds : _transient.descriptorSets)
+		{
+			*ds.dst = CreateDescriptorSet( ds.desc );
+			CHECK_ERR( *ds.dst );
+		}
+
+		for (auto& copy : _transient.descriptorSetCopies)
+		{
+			*copy.second = *copy.first;
+		}
+		return true;
+	}
+	
+/*
+=================================================
+	_ResetTransientResources
+=================================================
+*/
+	void  VCommandBuffer::_ResetTransientResources ()
+	{
+		_transient.resources.clear();
+		_transient.usages.clear();
+		_transient.pending.clear();
+		_transient.descriptorSets.clear();
+		_transient.descriptorSetCopies.clear();
+		_transient.aliasingBarriers.clear();
+	}
+//-----------------------------------------------------------------------------
+
 	
 /*
 =================================================
 	_StorePartialData
 =================================================
 */
-	bool  VCommandBuffer::_StorePartialData (ArrayView<uint8_t> srcData, const BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
+	bool  VCommandBuffer::_StorePartialData (ArrayView<uint8_t> srcData, const DataWriter_t &writer, const BytesU srcSize, const BytesU srcOffset,
+											 OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
 		// skip blocks less than 1/N of data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
-		const BytesU	min_size	= Min( (src_size + MaxBufferParts-1) / MaxBufferParts, Min( src_size, MinBufferPart ));
+		const BytesU	min_size	= Min( (srcSize + MaxBufferParts-1) / MaxBufferParts, Min( srcSize, MinBufferPart ));
 		void *			ptr			= null;
 
-		if ( _batch->GetWritable( src_size - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
+		if ( _batch->GetWritable( srcSize - srcOffset, 1_b, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
-			MemCopy( ptr, size, srcData.data() + srcOffset, size );
+			if ( writer )
+				writer( ptr, srcOffset, size );
+			else
+				MemCopy( ptr, size, srcData.data() + srcOffset, size );
 			return true;
 		}
 		return false;
@@ -2050,17 +2657,19 @@ namespace {
 	_StoreImageData
 =================================================
 */
-	bool  VCommandBuffer::_StoreImageData (ArrayView<uint8_t> srcData, const BytesU srcOffset, const BytesU srcPitch, const BytesU srcTotalSize,
-										   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
+	bool  VCommandBuffer::_StoreImageData (ArrayView<uint8_t> srcData, const DataWriter_t &writer, const BytesU srcEnd, const BytesU srcOffset,
+										   const BytesU srcPitch, const BytesU srcTotalSize, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size)
 	{
 		// skip blocks less than 1/N of total data size
-		const BytesU	src_size	= ArraySizeOf(srcData);
 		const BytesU	min_size	= Max( (srcTotalSize + MaxImageParts-1) / MaxImageParts, srcPitch );
 		void *			ptr			= null;
 
-		if ( _batch->GetWritable( src_size - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
+		if ( _batch->GetWritable( srcEnd - srcOffset, srcPitch, 16_b, min_size, OUT dstBuffer, OUT dstOffset, OUT size, OUT ptr ))
 		{
-			MemCopy( ptr, size, srcData.data() + srcOffset, size );
+			if ( writer )
+				writer( ptr, srcOffset, size );
+			else
+				MemCopy( ptr, size, srcData.data() + srcOffset, size );
 			return true;
 		}
 		return false;
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "framegraph/Public/FrameGraph.h"
+#include "stl/Containers/PagedIndexArray.h"
 #include "VTaskGraph.h"
 #include "VBarrierManager.h"
 #include "VTaskProcessor.h"
@@ -29,7 +30,6 @@ namespace FG
 			Compiling,
 		};
 
-		using TempTaskArray_t	= std::vector< VTask, StdLinearAllocator<VTask> >;
 		using TaskGraph_t		= VTaskGraph< VTaskProcessor >;
 		using Allocator_t		= LinearAllocator<>;
 		using Statistic_t		= IFrameGraph::Statistics;
@@ -38,32 +38,68 @@ namespace FG
 		using Resource_t		= VCmdBatch::Resource;
 		using ResourceMap_t		= VCmdBatch::ResourceMap_t;
 		using StagingBuffer		= VCmdBatch::StagingBuffer;
+		using DataWriter_t		= UpdateBuffer::DataWriter_t;
 		
 		static constexpr auto	MaxBufferParts	= VCmdBatch::MaxBufferParts;
 		static constexpr auto	MaxImageParts	= VCmdBatch::MaxImageParts;
 		static constexpr auto	MinBufferPart	= 4_Kb;
 
-		using PerQueueArray_t	= FixedArray< VCommandPool, 4 >;
+	public:
+		static constexpr uint	MaxSecondaryPools	= 8;
+
+	private:
+		struct PerQueue
+		{
+			VDeviceQueueInfoPtr								queue;
+			VCommandPool									primary;
+			StaticArray< VCommandPool, MaxSecondaryPools >	secondary;		// one pool per recording thread, created on demand
+		};
+		using PerQueueArray_t	= FixedArray< PerQueue, 4 >;
 		
 		using Index_t			= VResourceManager::Index_t;
 		
 		template <typename T, size_t CS, size_t MC>
 		using PoolTmpl			= ChunkedIndexedPool< ResourceBase<T>, Index_t, CS, MC >;
 		
-		template <typename Res, typename MainPool, size_t MC>
+		template <typename Res, typename MainPool, size_t CS>
 		struct LocalResPool {
-			PoolTmpl< Res, MainPool::capacity()/MC, MC >		pool;
-			StaticArray< Index_t, MainPool::capacity() >		toLocal;
-			uint												maxLocalIndex	= 0;
-			uint												maxGlobalIndex	= uint(MainPool::capacity());
+			PoolTmpl< Res, CS, (MainPool::capacity() + CS-1) / CS >		pool;
+			PagedIndexArray< Index_t, MainPool::capacity() >			toLocal;		// global index to local index
+			uint														maxLocalIndex	= 0;
 		};
 
-		using LocalImages_t			= LocalResPool< VLocalImage,		VResourceManager::ImagePool_t,		16 >;
-		using LocalBuffers_t		= LocalResPool< VLocalBuffer,		VResourceManager::BufferPool_t,		16 >;
-		using LocalRTScenes_t		= LocalResPool< VLocalRTScene,		VResourceManager::RTScenePool_t,	16 >;
-		using LocalRTGeometries_t	= LocalResPool< VLocalRTGeometry,	VResourceManager::RTGeometryPool_t,	16 >;
+		using LocalImages_t			= LocalResPool< VLocalImage,		VResourceManager::ImagePool_t,		512 >;
+		using LocalBuffers_t		= LocalResPool< VLocalBuffer,		VResourceManager::BufferPool_t,		512 >;
+		using LocalRTScenes_t		= LocalResPool< VLocalRTScene,		VResourceManager::RTScenePool_t,	256 >;
+		using LocalRTGeometries_t	= LocalResPool< VLocalRTGeometry,	VResourceManager::RTGeometryPool_t,	256 >;
 		using LogicalRenderPasses_t	= PoolTmpl< VLogicalRenderPass,		1u<<10,								16 >;
 		
+		struct TransientResource
+		{
+			RawImageID				image;
+			RawBufferID				buffer;
+			VkMemoryRequirements	memReq	= {};
+			ExeOrderIndex			first	= ExeOrderIndex::Unknown;
+			ExeOrderIndex			last	= ExeOrderIndex::Initial;
+		};
+
+		struct TransientUsage
+		{
+			uint						index	= UMax;		// in '_transient.resources'
+			VTask						task;
+			VLogicalRenderPass const*	pass	= null;		// task is unknown until render pass is submitted
+		};
+
+		struct DeferredDescriptorSet
+		{
+			PipelineResources				desc;
+			VPipelineResources const**		dst	= null;
+
+			DeferredDescriptorSet (const PipelineResources &desc, VPipelineResources const** dst) : desc{desc}, dst{dst} {}
+		};
+
+		using DescriptorSetCopy_t	= Pair< VPipelineResources const* const*, VPipelineResources const** >;
+
 
 
 	// variables
@@ -77,7 +113,8 @@ namespace FG
 		VFrameGraph &			_instance;
 		const uint				_indexInPool;		// index in VFrameGraph::_cmdBufferPool
 		VBarrierManager			_barrierMngr;
-		VPipelineCache			_pipelineCache;
+		VPipelineCache			_pipelineCache;		// local copy of VFrameGraph::_pipelineCache
+		uint					_pplnCacheVersion	= 0;
 		Debugger_t				_debugger;
 
 		struct {
@@ -98,10 +135,21 @@ namespace FG
 			LogicalRenderPasses_t	logicalRenderPasses;
 			uint					logicalRenderPassCount	= 0;
 		}						_rm;
+
+		struct {
+			Array< TransientResource >		resources;
+			Array< TransientUsage >			usages;
+			Array< uint >					pending;				// resources that are used by currently recording task
+			Array< DeferredDescriptorSet >	descriptorSets;			// created after memory binding
+			Array< DescriptorSetCopy_t >	descriptorSetCopies;	// per-pass descriptor sets that are copied into draw tasks
+			Array< ExeOrderIndex >			aliasingBarriers;		// tasks that are first to use reused memory, sorted
+		}						_transient;
 		
 		PerQueueArray_t			_perQueue;		// TODO: use global command pool manager to minimize memory usage
 		bool					_dbgFullBarriers	= false;
 		bool					_dbgQueueSync		= false;
+		bool					_asyncPipelines		= false;
+		bool					_splitBarriers		= false;	// events are not supported in transfer queue
 
 		DataRaceCheck			_drCheck;
 
@@ -127,6 +175,9 @@ namespace FG
 		void		AcquireImage (RawImageID id, bool makeMutable, bool invalidate) override;
 		void		AcquireBuffer (RawBufferID id, bool makeMutable) override;
 
+		RawImageID	CreateTransientImage (const ImageDesc &desc, StringView dbgName) override;
+		RawBufferID	CreateTransientBuffer (const BufferDesc &desc, StringView dbgName) override;
+
 
 		// tasks //
 		Task		AddTask (const SubmitRenderPass &) override;
@@ -162,6 +213,7 @@ namespace FG
 
 		void		AddTask (LogicalPassID, const DrawVertices &) override;
 		void		AddTask (LogicalPassID, const DrawIndexed &) override;
+		void		AddTask (LogicalPassID, const DrawIndexedBatch &) override;
 		void		AddTask (LogicalPassID, const DrawVerticesIndirect &) override;
 		void		AddTask (LogicalPassID, const DrawIndexedIndirect &) override;
 		void		AddTask (LogicalPassID, const DrawVerticesIndirectCount &) override;
@@ -185,6 +237,11 @@ namespace FG
 		ND_ VLocalRTGeometry const*	ToLocal (RawRTGeometryID id);
 		ND_ VLocalRTScene const*	ToLocal (RawRTSceneID id);
 		ND_ VPipelineResources const* CreateDescriptorSet (const PipelineResources &desc);
+			void					CreateDescriptorSet (const PipelineResources &desc, OUT VPipelineResources const* &result);
+			void					CopyDescriptorSet (VPipelineResources const* const& src, OUT VPipelineResources const* &dst);
+
+			void					AttachTransientUsage (VTask task);
+			void					AttachTransientUsage (const VLogicalRenderPass &);
 
 		
 		ND_ StringView				GetName ()					const	{ EXLOCK( _drCheck );  return _batch->GetName(); }
@@ -203,6 +260,12 @@ namespace FG
 		ND_ EQueueFamily			GetQueueFamily ()			const	{ EXLOCK( _drCheck );  return _queueIndex; }
 		ND_ bool					IsDebugFullBarriers ()		const	{ EXLOCK( _drCheck );  return _dbgFullBarriers; }
 		ND_ bool					IsDebugQueueSync ()			const	{ EXLOCK( _drCheck );  return _dbgQueueSync; }
+		ND_ bool					IsAsyncPipelineCompilation () const	{ EXLOCK( _drCheck );  return _asyncPipelines; }
+		ND_ bool					IsSplitBarriersEnabled ()	const	{ EXLOCK( _drCheck );  return _splitBarriers; }
+		
+		ND_ VkCommandBuffer			AllocSecondary (uint poolIndex);
+		ND_ bool					AcquireEvent (OUT VkEvent &event);
+		ND_ ThreadPool &			GetWorkerPool ();
 
 
 	private:
@@ -210,14 +273,19 @@ namespace FG
 		template <typename T>
 		bool  _AllocStorage (size_t count, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset, OUT T* &ptr);
 		bool  _StoreData (const void *dataPtr, BytesU dataSize, BytesU offsetAlign, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset);
-		bool  _StorePartialData (ArrayView<uint8_t> srcData, BytesU srcOffset, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
-		bool  _StoreImageData (ArrayView<uint8_t> srcData, BytesU srcOffset, BytesU srcPitch, BytesU srcTotalSize,
-							   OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
+		bool  _StorePartialData (ArrayView<uint8_t> srcData, const DataWriter_t &writer, BytesU srcSize, BytesU srcOffset,
+								 OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
+		bool  _StoreImageData (ArrayView<uint8_t> srcData, const DataWriter_t &writer, BytesU srcEnd, BytesU srcOffset, BytesU srcPitch,
+							   BytesU srcTotalSize, OUT RawBufferID &dstBuffer, OUT BytesU &dstOffset, OUT BytesU &size);
+
+	// ray tracing //
+		bool  _AllocRayTracingBuffer (BytesU size, BytesU align, OUT const VLocalBuffer* &buf, OUT VkDeviceSize &offset);
 		
-		ND_ Task  _AddUpdateBufferTask (const UpdateBuffer &);
-		ND_ Task  _AddUpdateImageTask (const UpdateImage &);
+		ND_ Task  _AddUpdateBufferTask (const UpdateBuffer &, OUT BytesU *recordedSize = null);
+		ND_ Task  _AddUpdateImageTask (const UpdateImage &, OUT BytesU *recordedSize = null);
 		ND_ Task  _AddReadBufferTask (const ReadBuffer &);
 		ND_ Task  _AddReadImageTask (const ReadImage &);
+			void  _RecordUploads ();
 
 
 	// task processor //
@@ -227,13 +295,22 @@ namespace FG
 		
 
 	// resource manager //
-		template <typename ID, typename Res, typename MainPool, size_t MC>
-		ND_ Res const*  _ToLocal (ID id, INOUT LocalResPool<Res,MainPool,MC> &, StringView msg);
+		template <typename ID, typename Res, typename MainPool, size_t CS>
+		ND_ Res const*  _ToLocal (ID id, INOUT LocalResPool<Res,MainPool,CS> &, StringView msg);
 
 		void  _FlushLocalResourceStates (ExeOrderIndex, VBarrierManager &, Ptr<VLocalDebugger>);
 		void  _ResetLocalRemaping ();
 
 
+	// transient resources //
+		template <typename ID>
+		void  _AddTransientUsage (ID id);
+		bool  _AddTransientUsage (const PipelineResources &desc);
+		void  _ResolveTransientUsage (const VLogicalRenderPass &, VTask);
+		bool  _BindTransientMemory ();
+		void  _ResetTransientResources ();
+
+
 	// queue //
 		ND_ EQueueUsage	_GetQueueUsage ()	const	{ return EQueueUsage(0) | _batch->GetQueueType(); }
 		ND_ bool		_IsRecording ()		const	{ return _state == EState::Recording; }
@@ -274,5 +351,26 @@ namespace FG
 		return GetResourceManager().CreateDescriptorSet( desc, INOUT _rm.resourceMap );
 	}
 
+/*
+=================================================
+	AttachTransientUsage
+=================================================
+*/
+	inline void  VCommandBuffer::AttachTransientUsage (VTask task)
+	{
+		for (uint idx : _transient.pending) {
+			_transient.usages.push_back({ idx, task, null });
+		}
+		_transient.pending.clear();
+	}
+	
+	inline void  VCommandBuffer::AttachTransientUsage (const VLogicalRenderPass &logicalPass)
+	{
+		for (uint idx : _transient.pending) {
+			_transient.usages.push_back({ idx, null, &logicalPass });
+		}
+		_transient.pending.clear();
+	}
+
 
 }	// FG
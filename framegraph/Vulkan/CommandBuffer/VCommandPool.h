@@ -15,7 +15,8 @@ namespace FG
 	{
 	// types
 	private:
-		using CmdBufPool_t	= FixedArray< VkCommandBuffer, 32 >;
+		using CmdBufPool_t		= FixedArray< VkCommandBuffer, 32 >;
+		using SecondaryPool_t	= Array< VkCommandBuffer >;		// secondary command buffers are allocated per render pass, so count is unbounded
 
 
 	// variables
@@ -24,7 +25,7 @@ namespace FG
 
 		mutable Mutex			_cmdGuard;
 		mutable CmdBufPool_t	_freePrimaries;
-		mutable CmdBufPool_t	_freeSecondaries;
+		mutable SecondaryPool_t	_freeSecondaries;
 		
 		RWDataRaceCheck			_drCheck;
 
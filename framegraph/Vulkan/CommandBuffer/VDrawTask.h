@@ -32,6 +32,7 @@ namespace FG
 		RGBA8u				_debugColor;
 	public:
 		ShaderDbgIndex		debugModeIndex	= Default;
+		mutable uint64_t	sortKey			= 0;		// calculated before recording, see 'VLogicalRenderPass::SortDrawTasks'
 
 
 	// interface
@@ -63,9 +64,10 @@ namespace FG
 
 
 	// variables
-	private:
+	protected:
 		VPipelineResourceSet					_resources;
 
+	private:
 		VertexBuffers_t							_vertexBuffers;
 		VertexOffsets_t							_vbOffsets;
 		VertexStrides_t							_vbStrides;
@@ -75,6 +77,8 @@ namespace FG
 
 	public:
 		VGraphicsPipeline const* const			pipeline;
+		VGraphicsPipeline const* const			fallbackPipeline;
+		const RawGPipelineID					pipelineId;			// required for async compilation
 		const _fg_hidden_::PushConstants_t		pushConstants;
 
 		const VertexInputState					vertexInput;
@@ -84,8 +88,11 @@ namespace FG
 		
 		const EPrimitive						topology;
 		const bool								primitiveRestart;
+		const float								sortDepth;
 
 		mutable VkDescriptorSets_t				descriptorSets;
+		mutable VkPipeline						pipelineHandle	= VK_NULL_HANDLE;	// created before parallel recording
+		mutable VPipelineLayout const*			pipelineLayout	= null;
 		
 
 	// methods
@@ -140,6 +147,35 @@ namespace FG
 
 
 
+	
+	//
+	// Draw Indexed Vertices Batch
+	//
+	template <>
+	class VFgDrawTask< DrawIndexedBatch > final : public VBaseDrawVerticesTask
+	{
+	public:
+	// variables
+		const ArrayView< DrawIndexed::DrawCmd >			commands;
+
+		VLocalBuffer const* const						indexBuffer;
+		const BytesU									indexBufferOffset;
+		const EIndex									indexType;
+
+		const DescriptorSetID							perDrawDescSetId;
+		const ArrayView< VPipelineResources const* >	perDrawResources;
+		mutable uint									perDrawDescSetIndex		= UMax;		// index in 'descriptorSets'
+
+		const PushConstantID							perDrawPushConstId;
+		const Bytes<uint16_t>							perDrawPushConstSize;
+		const ArrayView< uint8_t >						perDrawPushConstants;
+
+	// methods
+		VFgDrawTask (VLogicalRenderPass &rp, VCommandBuffer &cb, const DrawIndexedBatch &task, ProcessFunc_t pass1, ProcessFunc_t pass2);
+	};
+
+
+
 	//
 	// Draw Vertices Indirect
 	//
@@ -235,8 +271,11 @@ namespace FG
 
 		const _fg_hidden_::ColorBuffers_t		colorBuffers;
 		const _fg_hidden_::DynamicStates		dynamicStates;
+		const float								sortDepth;
 
 		mutable VkDescriptorSets_t				descriptorSets;
+		mutable VkPipeline						pipelineHandle	= VK_NULL_HANDLE;	// created before parallel recording
+		mutable VPipelineLayout const*			pipelineLayout	= null;
 
 
 	// methods
@@ -34,7 +34,7 @@ namespace FG
 		Dependencies_t		_outputs;
 		Name_t				_taskName;
 		RGBA8u				_debugColor;
-		uint				_visitorID		= 0;
+		uint				_pendingInputs	= 0;	// number of inputs that are not processed yet, used for topological sorting
 		ExeOrderIndex		_exeOrderIdx	= ExeOrderIndex::Initial;
 
 
@@ -54,6 +54,7 @@ namespace FG
 			for (size_t i = 0; i < task.depends.size(); ++i) {
 				_inputs[i] = Cast<VFrameGraphTask>( task.depends[i] );
 			}
+			_pendingInputs = uint(_inputs.size());
 
 			// validate dependencies
 			DEBUG_ONLY(
@@ -65,16 +66,17 @@ namespace FG
 
 
 	public:
+		ND_ ProcessFunc_t		ProcessFunc ()		const	{ return _processFunc; }
 		ND_ StringView			Name ()				const	{ return _taskName; }
 		ND_ RGBA8u				DebugColor ()		const	{ return _debugColor; }
-		ND_ uint				VisitorID ()		const	{ return _visitorID; }
+		ND_ uint				PendingInputs ()	const	{ return _pendingInputs; }
 		ND_ ExeOrderIndex		ExecutionOrder ()	const	{ return _exeOrderIdx; }
 
 		ND_ ArrayView< VTask >	Inputs ()			const	{ return _inputs; }
 		ND_ ArrayView< VTask >	Outputs ()			const	{ return _outputs; }
 
 			void Attach (VTask output)						{ _outputs.push_back( output ); }
-			void SetVisitorID (uint id)						{ _visitorID = id; }
+		ND_ bool ResolveInput ()							{ ASSERT( _pendingInputs > 0 );  return --_pendingInputs == 0; }
 			void SetExecutionOrder (ExeOrderIndex idx)		{ _exeOrderIdx = idx; }
 
 			void Process (void *visitor)			const	{ ASSERT( _processFunc );  _processFunc( visitor, this ); }
@@ -576,6 +578,8 @@ namespace FG
 	private:
 		VLocalRTGeometry const*		_rtGeometry				= null;
 		VLocalBuffer const*			_scratchBuffer			= null;
+		VkDeviceSize				_scratchBufferOffset	= 0;
+		VkDeviceSize				_scratchBufferSize		= 0;
 		VkGeometryNV *				_geometry				= null;
 		size_t						_geometryCount			= 0;
 		UsableBuffers_t				_usableBuffers;
@@ -589,8 +593,8 @@ namespace FG
 
 		ND_ VLocalRTGeometry const*		RTGeometry ()			const	{ return _rtGeometry; }
 		ND_ VLocalBuffer const*			ScratchBuffer ()		const	{ return _scratchBuffer; }
-		ND_ VkDeviceSize				ScratchBufferOffset ()	const	{ return 0; }
-		ND_ VkDeviceSize				ScratchBufferSize ()	const	{ return VK_WHOLE_SIZE; }
+		ND_ VkDeviceSize				ScratchBufferOffset ()	const	{ return _scratchBufferOffset; }
+		ND_ VkDeviceSize				ScratchBufferSize ()	const	{ return _scratchBufferSize; }
 		ND_ ArrayView<VkGeometryNV>		GetGeometry ()			const	{ return ArrayView{ _geometry, _geometryCount }; }
 		ND_ UsableBuffers_t const&		GetBuffers ()			const	{ return _usableBuffers; }
 	};
@@ -609,13 +613,29 @@ namespace FG
 	public:
 		using Instance	= Tuple< InstanceID, RTGeometryID, uint >;
 
+		// copy from staging buffer to instance buffer
+		struct InstanceCopy
+		{
+			VLocalBuffer const*		srcBuffer	= null;
+			VkDeviceSize			srcOffset	= 0;
+			VkDeviceSize			dstOffset	= 0;	// relative to 'InstanceBufferOffset()'
+			VkDeviceSize			size		= 0;
+		};
+
+	private:
+		using InstanceCopies_t	= std::vector< InstanceCopy, StdLinearAllocator<InstanceCopy> >;
+
 
 	// variables
 	private:
 		VLocalRTScene const*		_rtScene						= null;
 		VLocalBuffer const*			_scratchBuffer					= null;
-		VLocalBuffer const*			_instanceStagingBuffer			= null;
-		VkDeviceSize				_instanceStagingBufferOffset	= 0;
+		VkDeviceSize				_scratchBufferOffset			= 0;
+		VkDeviceSize				_scratchBufferSize				= 0;
+		InstanceCopies_t			_instanceCopies;								// only dirty instances are uploaded
+		InstanceCopy				_fullInstanceCopy;								// used if dirty ranges are outdated
+		VkGeometryInstance const*	_vkInstances					= null;		// not null if task was successfully recorded and scene supports updates
+		uint						_instanceGeneration				= 0;
 		VLocalBuffer const*			_instanceBuffer					= null;
 		VkDeviceSize				_instanceBufferOffset			= 0;
 		VLocalRTGeometry const**	_rtGeometries					= null;
@@ -627,17 +647,19 @@ namespace FG
 
 	// methods
 	public:
-		VFgTask (VCommandBuffer &, const BuildRayTracingScene &task, ProcessFunc_t process) : VFrameGraphTask{task, process} {}
+		VFgTask (VCommandBuffer &cb, const BuildRayTracingScene &task, ProcessFunc_t process);
 		
 		ND_ bool  IsValid () const	{ return true; }
 
 		ND_ VLocalRTScene const*				RTScene ()						const	{ return _rtScene; }
 		ND_ VLocalBuffer const*					ScratchBuffer ()				const	{ return _scratchBuffer; }
-		ND_ VkDeviceSize						ScratchBufferOffset ()			const	{ return 0; }
-		ND_ VkDeviceSize						ScratchBufferSize ()			const	{ return VK_WHOLE_SIZE; }
+		ND_ VkDeviceSize						ScratchBufferOffset ()			const	{ return _scratchBufferOffset; }
+		ND_ VkDeviceSize						ScratchBufferSize ()			const	{ return _scratchBufferSize; }
 
-		ND_ VLocalBuffer const*					InstanceStagingBuffer ()		const	{ return _instanceStagingBuffer; }
-		ND_ VkDeviceSize						InstanceStagingBufferOffset ()	const	{ return _instanceStagingBufferOffset; }
+		ND_ ArrayView<InstanceCopy>				InstanceCopies ()				const	{ return _instanceCopies; }
+		ND_ InstanceCopy const&					FullInstanceCopy ()				const	{ return _fullInstanceCopy; }
+		ND_ ArrayView<VkGeometryInstance>		VkInstances ()					const	{ return ArrayView{ _vkInstances, (_vkInstances ? _instanceCount : 0) }; }
+		ND_ uint								InstanceGeneration ()			const	{ return _instanceGeneration; }
 		ND_ VLocalBuffer const*					InstanceBuffer ()				const	{ return _instanceBuffer; }
 		ND_ VkDeviceSize						InstanceBufferOffset ()			const	{ return _instanceBufferOffset; }
 		ND_ VkDeviceSize						InstanceBufferSize ()			const	{ return _instanceCount * sizeof(VkGeometryInstance); }
@@ -745,6 +767,9 @@ namespace FG
 		ND_ size_t				Count ()		const	{ return _nodes->size(); }
 		ND_ bool				Empty ()		const	{ return _nodes->empty(); }
 
+		template <typename T>
+		ND_ static bool			IsTypeOf (VTask task)	{ return task->ProcessFunc() == &_Visitor<T>; }
+
 
 	private:
 		template <typename T>
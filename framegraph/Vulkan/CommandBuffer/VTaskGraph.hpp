@@ -22,6 +22,7 @@ namespace FG
 		PlacementNew< VFgTask<T> >( OUT ptr, cb, task, &_Visitor<T> );
 		CHECK_ERR( ptr->IsValid() );
 
+		cb.AttachTransientUsage( ptr );
 		_nodes->insert( ptr );
 
 		if ( ptr->Inputs().empty() )
@@ -77,8 +78,8 @@ namespace FG
 		{
 			auto	offsets = src.second->GetDynamicOffsets();
 
-			outResourceSet.resources.emplace_back( src.first, cb.CreateDescriptorSet( *src.second ),
-												   offset_count, CheckCast<uint>(offsets.size()) );
+			outResourceSet.resources.emplace_back( src.first, null, offset_count, CheckCast<uint>(offsets.size()) );
+			cb.CreateDescriptorSet( *src.second, OUT outResourceSet.resources.back().pplnRes );
 			
 			for (size_t i = 0; i < offsets.size(); ++i, ++offset_count) {
 				outResourceSet.dynamicOffsets.push_back( offsets[i] );
@@ -94,7 +95,8 @@ namespace FG
 		{
 			ASSERT( inResourceSet.count( src.descSetId ) == 0 );
 			
-			outResourceSet.resources.emplace_back( src.descSetId, src.pplnRes, src.offsetIndex + base_offset, src.offsetCount );
+			outResourceSet.resources.emplace_back( src.descSetId, null, src.offsetIndex + base_offset, src.offsetCount );
+			cb.CopyDescriptorSet( src.pplnRes, OUT outResourceSet.resources.back().pplnRes );
 		}
 
 		for (auto& src : rp->GetResources().dynamicOffsets)
@@ -128,6 +130,47 @@ namespace FG
 		}
 	}
 
+/*
+=================================================
+	CopyArray
+=================================================
+*/
+	template <typename T>
+	inline ArrayView<T>  CopyArray (VCommandBuffer &cb, ArrayView<T> src)
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<T> );
+
+		if ( src.empty() )
+			return {};
+
+		auto*	ptr = cb.GetAllocator().Alloc< T >( src.size() );
+		std::memcpy( OUT ptr, src.data(), size_t(ArraySizeOf(src)) );
+
+		return { ptr, src.size() };
+	}
+
+/*
+=================================================
+	CreateDescriptorSets
+----
+	dynamic offsets are not supported for per draw resources
+=================================================
+*/
+	inline ArrayView<VPipelineResources const*>  CreateDescriptorSets (VCommandBuffer &cb, ArrayView<PipelineResources const*> src)
+	{
+		if ( src.empty() )
+			return {};
+
+		auto*	ptr = cb.GetAllocator().Alloc< VPipelineResources const* >( src.size() );
+
+		for (size_t i = 0; i < src.size(); ++i)
+		{
+			ASSERT( src[i] and src[i]->GetDynamicOffsets().empty() );
+			cb.CreateDescriptorSet( *src[i], OUT ptr[i] );
+		}
+		return { ptr, src.size() };
+	}
+
 /*
 =================================================
 	CopyScissors
@@ -155,9 +198,12 @@ namespace FG
 	VBaseDrawVerticesTask::VBaseDrawVerticesTask (VLogicalRenderPass &rp, VCommandBuffer &cb, const TaskType &task, ProcessFunc_t pass1, ProcessFunc_t pass2) :
 		IDrawTask{ task, pass1, pass2 },				_vbCount{ uint(task.vertexBuffers.size()) },
 		pipeline{ cb.AcquireTemporary( task.pipeline )},
+		fallbackPipeline{ task.fallbackPipeline ? cb.AcquireTemporary( task.fallbackPipeline ) : null },
+		pipelineId{ task.pipeline },
 		pushConstants{ task.pushConstants },			vertexInput{ task.vertexInput },
 		colorBuffers{ task.colorBuffers },				dynamicStates{ task.dynamicStates },
-		topology{ task.topology },						primitiveRestart{ task.primitiveRestart }
+		topology{ task.topology },						primitiveRestart{ task.primitiveRestart },
+		sortDepth{ task.sortDepth }
 	{
 		CopyScissors( cb, task.scissors, OUT _scissors );
 		CopyDescriptorSets( &rp, cb, task.resources, OUT _resources );
@@ -189,6 +235,38 @@ namespace FG
 		ASSERT( indexBuffer and AllBits( indexBuffer->Description().usage, EBufferUsage::Index ));
 	}
 	
+/*
+=================================================
+	VFgDrawTask< DrawIndexedBatch >
+----
+	per draw data is copied into linear allocator,
+	descriptor set for first draw is added to shared resources,
+	so descriptor set index and barriers are calculated in common way.
+	Descriptor sets with transient resources are created after memory binding,
+	so pointer is copied at the same time.
+=================================================
+*/
+	inline VFgDrawTask<DrawIndexedBatch>::VFgDrawTask (VLogicalRenderPass &rp, VCommandBuffer &cb, const DrawIndexedBatch &task, ProcessFunc_t pass1, ProcessFunc_t pass2) :
+		VBaseDrawVerticesTask{ rp, cb, task, pass1, pass2 },
+		commands{ CopyArray( cb, task.commands )},
+		indexBuffer{ cb.ToLocal( task.indexBuffer )},
+		indexBufferOffset{ task.indexBufferOffset },		indexType{ task.indexType },
+		perDrawDescSetId{ task.perDrawDescSetId },			perDrawResources{ CreateDescriptorSets( cb, task.perDrawResources )},
+		perDrawPushConstId{ task.perDrawPushConstId },		perDrawPushConstSize{ task.perDrawPushConstSize },
+		perDrawPushConstants{ CopyArray( cb, task.perDrawPushConstants )}
+	{
+		ASSERT( indexBuffer and AllBits( indexBuffer->Description().usage, EBufferUsage::Index ));
+		ASSERT( perDrawResources.empty() or perDrawResources.size() == commands.size() );
+		ASSERT( perDrawPushConstants.empty() or perDrawPushConstants.size() == commands.size() * size_t(perDrawPushConstSize) );
+
+		if ( perDrawResources.size() )
+		{
+			ASSERT( task.resources.count( perDrawDescSetId ) == 0 );
+			_resources.resources.emplace_back( perDrawDescSetId, null, uint(_resources.dynamicOffsets.size()), 0u );
+			cb.CopyDescriptorSet( perDrawResources.front(), OUT _resources.resources.back().pplnRes );
+		}
+	}
+	
 /*
 =================================================
 	VFgDrawTask< DrawVerticesIndirect >
@@ -256,7 +334,7 @@ namespace FG
 	inline VBaseDrawMeshes::VBaseDrawMeshes (VLogicalRenderPass &rp, VCommandBuffer &cb, const TaskType &task, ProcessFunc_t pass1, ProcessFunc_t pass2) :
 		IDrawTask{ task, pass1, pass2 },		pipeline{ cb.AcquireTemporary( task.pipeline )},
 		pushConstants{ task.pushConstants },	colorBuffers{ task.colorBuffers },
-		dynamicStates{ task.dynamicStates }
+		dynamicStates{ task.dynamicStates },	sortDepth{ task.sortDepth }
 	{
 		CopyScissors( cb, task.scissors, OUT _scissors );
 		CopyDescriptorSets( &rp, cb, task.resources, OUT _resources );
@@ -777,6 +855,18 @@ namespace FG
 //-----------------------------------------------------------------------------
 
 
+/*
+=================================================
+	VFgTask< BuildRayTracingScene >
+=================================================
+*/
+	inline VFgTask<BuildRayTracingScene>::VFgTask (VCommandBuffer &cb, const BuildRayTracingScene &task, ProcessFunc_t process) :
+		VFrameGraphTask{task, process},
+		_instanceCopies{ cb.GetAllocator() }
+	{}
+//-----------------------------------------------------------------------------
+
+
 /*
 =================================================
 	VFgTask< TraceRays >
@@ -32,7 +32,7 @@ namespace FG
 
 	inline VTaskProcessor::Statistic_t&  VTaskProcessor::Stat () const
 	{
-		return _fgThread.EditStatistic().renderer;
+		return *_stat;
 	}
 
 	inline uint64_t  CalcPrimitiveCount (uint vertCount, EPrimitive topology, uint patchSize)
@@ -57,6 +57,24 @@ namespace FG
 		END_ENUM_CHECKS();
 		return 0;
 	}
+
+	inline uint  BindPointIndex (VkPipelineBindPoint bindPoint)
+	{
+		return bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS ? 0 :
+			   bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE  ? 1 : 2;
+	}
+	
+	// returns high bits of hash multiplied by golden ratio (fibonacci hashing)
+	ND_ inline uint64_t  FoldHash (HashVal hash, uint bits)
+	{
+		return (uint64_t(size_t(hash)) * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+	}
+
+	// positive floats keep order when compared as integers, so high bits are used as logarithmic bucket
+	ND_ inline uint64_t  DepthBucket (float depth, uint bits)
+	{
+		return uint64_t(BitCast<uint>( Max( depth, 0.0f ))) >> (31 - bits);
+	}
 //-----------------------------------------------------------------------------
 
 
@@ -112,14 +130,18 @@ namespace FG
 		bool						_stencilWrite			: 1;
 		bool						_rasterizerDiscard		: 1;
 		bool						_compatibleFragOutput	: 1;
+		bool						_calcSortKeys			: 1;
 
 
 	// methods
 	public:
 		DrawTaskBarriers (VTaskProcessor &tp, const VLogicalRenderPass &);
 
+		void  SetSortKeysEnabled (bool value)	{ _calcSortKeys = value; }
+
 		void  Visit (const VFgDrawTask<FG::DrawVertices> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexed> &task);
+		void  Visit (const VFgDrawTask<FG::DrawIndexedBatch> &task);
 		void  Visit (const VFgDrawTask<FG::DrawMeshes> &task);
 		void  Visit (const VFgDrawTask<FG::DrawVerticesIndirect> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexedIndirect> &task);
@@ -135,6 +157,9 @@ namespace FG
 		template <typename DrawTask>
 		void  _ExtractDescriptorSets (RawPipelineLayoutID layoutId, const DrawTask &task);
 
+		template <typename DrawTask>
+		void  _SetSortKey (const DrawTask &task) const;
+
 		ND_ bool						IsEarlyFragmentTests ()			const	{ return _earlyFragmentTests; }
 		ND_ bool						IsLateFragmentTests ()			const	{ return _lateFragmentTests; }
 		ND_ bool						IsFragmentOutputCompatible ()	const	{ return _compatibleFragOutput; }
@@ -157,14 +182,20 @@ namespace FG
 		VTaskProcessor &					_tp;
 		VFgTask<SubmitRenderPass> const*	_currTask;
 		VkCommandBuffer						_cmdBuffer;
+		const bool							_prepareOnly;					// only create pipelines, used before parallel recording
+		bool								_canRecordInParallel	= true;
 
 
 	// methods
 	public:
-		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd);
+		DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd, bool prepareOnly = false);
+
+		template <typename DrawTask>
+		void  Process (const DrawTask &task);
 
 		void  Visit (const VFgDrawTask<FG::DrawVertices> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexed> &task);
+		void  Visit (const VFgDrawTask<FG::DrawIndexedBatch> &task);
 		void  Visit (const VFgDrawTask<FG::DrawMeshes> &task);
 		void  Visit (const VFgDrawTask<FG::DrawVerticesIndirect> &task);
 		void  Visit (const VFgDrawTask<FG::DrawIndexedIndirect> &task);
@@ -174,9 +205,18 @@ namespace FG
 		void  Visit (const VFgDrawTask<FG::DrawMeshesIndirectCount> &task);
 		void  Visit (const VFgDrawTask<FG::CustomDraw> &task);
 
+		ND_ bool  CanRecordInParallel () const	{ return _canRecordInParallel; }
+
 	private:
+		void  _Prepare (const VBaseDrawVerticesTask &task);
+		void  _Prepare (const VBaseDrawMeshes &task);
+		void  _Prepare (const VFgDrawTask<FG::CustomDraw> &task);
+
 		void  _BindVertexBuffers (ArrayView<VLocalBuffer const*> vertexBuffers, ArrayView<VkDeviceSize> vertexOffsets) const;
 
+		template <typename DrawTask>
+		bool  _BindPipeline (const DrawTask &task, OUT VPipelineLayout const* &layout) const;
+
 		template <typename DrawTask>
 		void  _BindPipelineResources (const VPipelineLayout &layout, const DrawTask &task) const;
 	};
@@ -415,7 +455,7 @@ namespace FG
 		_depthWrite{ _logicalRP.GetDepthState().write },
 		_stencilWrite{ false },
 		_rasterizerDiscard{ _logicalRP.GetRasterizationState().rasterizerDiscard },
-		_compatibleFragOutput{true}
+		_compatibleFragOutput{true},	_calcSortKeys{false}
 	{
 		// invalidate fragment output
 		for (auto& frag : _fragOutput)
@@ -491,6 +531,67 @@ namespace FG
 		_MergePipeline( task.dynamicStates, task.pipeline );
 	}
 	
+/*
+=================================================
+	Visit (DrawIndexedBatch)
+----
+	descriptor set for first draw is added to shared resources in constructor,
+	barriers for other per draw descriptor sets are added here.
+=================================================
+*/
+	inline void  VTaskProcessor::DrawTaskBarriers::Visit (const VFgDrawTask<FG::DrawIndexedBatch> &task)
+	{
+		// update descriptor sets and add pipeline barriers
+		_ExtractDescriptorSets( task.pipeline->GetLayoutID(), task );
+
+		if ( task.perDrawResources.size() )
+		{
+			auto const&					layout	= *_tp._GetResource( task.pipeline->GetLayoutID() );
+			uint						binding	= 0;
+			RawDescriptorSetLayoutID	ds_layout;
+
+			if ( layout.GetDescriptorSetLayout( task.perDrawDescSetId, OUT ds_layout, OUT binding ))
+			{
+				task.perDrawDescSetIndex = binding - layout.GetFirstDescriptorSet();
+				ASSERT( task.perDrawDescSetIndex < task.descriptorSets.size() );
+
+				PipelineResourceBarriers	visitor{ _tp, ArrayView<uint>{} };
+
+				for (size_t i = 1; i < task.perDrawResources.size(); ++i)
+				{
+					ASSERT( ds_layout == task.perDrawResources[i]->GetLayoutID() );
+					task.perDrawResources[i]->ForEachUniform( visitor );
+				}
+			}
+			else
+			{
+				// 'perDrawDescSetIndex' stays invalid and batch will be skipped in 'DrawTaskCommands'
+				FG_LOGE( "per draw descriptor set '"s << task.perDrawDescSetId.GetName() << "' is not found in pipeline layout" );
+			}
+		}
+		
+		// add vertex buffers
+		for (size_t i = 0; i < task.GetVertexBuffers().size(); ++i)
+		{
+			_tp._AddBuffer( task.GetVertexBuffers()[i], EResourceState::VertexBuffer, task.GetVBOffsets()[i], VK_WHOLE_SIZE );
+		}
+
+		// add index buffer, single range for all commands
+		uint	first_index	= UMax;
+		uint	last_index	= 0;
+		for (auto& cmd : task.commands)
+		{
+			first_index	= Min( first_index, cmd.firstIndex );
+			last_index	= Max( last_index, cmd.firstIndex + cmd.indexCount );
+		}
+
+		const VkDeviceSize	index_size	= VkDeviceSize(EIndex_SizeOf( task.indexType ));
+		_tp._AddBuffer( task.indexBuffer, EResourceState::IndexBuffer, VkDeviceSize(task.indexBufferOffset) + index_size * first_index,
+						index_size * (last_index - first_index) );
+		
+		_MergePipeline( task.dynamicStates, task.pipeline );
+	}
+	
 /*
 =================================================
 	Visit (DrawVerticesIndirect)
@@ -693,6 +794,43 @@ namespace FG
 	inline void  VTaskProcessor::DrawTaskBarriers::_ExtractDescriptorSets (RawPipelineLayoutID layoutId, const DrawTask &task)
 	{
 		_tp._ExtractDescriptorSets( *_tp._GetResource( layoutId ), task.GetResources(), OUT task.descriptorSets );
+
+		if ( _calcSortKeys )
+			_SetSortKey( task );
+	}
+
+/*
+=================================================
+	_SetSortKey
+----
+	key layout (from high to low bits):
+		24 bits - pipeline
+		16 bits - descriptor sets
+		12 bits - vertex buffers
+		12 bits - depth bucket
+	hashes are folded, so collisions only reduce efficiency of sorting.
+=================================================
+*/
+	template <typename DrawTask>
+	inline void  VTaskProcessor::DrawTaskBarriers::_SetSortKey (const DrawTask &task) const
+	{
+		HashVal		ds_hash;
+		for (auto& ds : task.descriptorSets) {
+			ds_hash << HashOf( ds );
+		}
+
+		HashVal		vb_hash;
+		if constexpr( std::is_base_of_v< VBaseDrawVerticesTask, DrawTask >)
+		{
+			for (auto* vb : task.GetVertexBuffers()) {
+				vb_hash << HashOf( vb );
+			}
+		}
+
+		task.sortKey = (FoldHash( HashOf( task.pipeline ), 24 ) << 40) |
+					   (FoldHash( ds_hash, 16 ) << 24) |
+					   (FoldHash( vb_hash, 12 ) << 12) |
+					   DepthBucket( task.sortDepth, 12 );
 	}
 
 /*
@@ -729,10 +867,88 @@ namespace FG
 	constructor
 =================================================
 */
-	VTaskProcessor::DrawTaskCommands::DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd) :
-		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd }
+	VTaskProcessor::DrawTaskCommands::DrawTaskCommands (VTaskProcessor &tp, VFgTask<SubmitRenderPass> const* task, VkCommandBuffer cmd, bool prepareOnly) :
+		_tp{ tp },	_currTask{ task },	_cmdBuffer{ cmd },	_prepareOnly{ prepareOnly }
 	{
 	}
+	
+/*
+=================================================
+	Process
+=================================================
+*/
+	template <typename DrawTask>
+	inline void  VTaskProcessor::DrawTaskCommands::Process (const DrawTask &task)
+	{
+		if ( _prepareOnly )
+			_Prepare( task );
+		else
+			Visit( task );
+	}
+	
+/*
+=================================================
+	_Prepare
+----
+	pipeline cache and shader debugger are not thread safe,
+	so pipelines and layouts are resolved in main thread before parallel recording.
+=================================================
+*/
+	void  VTaskProcessor::DrawTaskCommands::_Prepare (const VBaseDrawVerticesTask &task)
+	{
+		if ( task.debugModeIndex != Default )
+		{
+			_canRecordInParallel = false;
+			return;
+		}
+
+		if ( not _tp._GetPipeline( *_currTask->GetLogicalPass(), task, OUT task.pipelineHandle, OUT task.pipelineLayout ) or
+			 not task.pipelineLayout )
+			_canRecordInParallel = false;
+	}
+	
+	void  VTaskProcessor::DrawTaskCommands::_Prepare (const VBaseDrawMeshes &task)
+	{
+		if ( task.debugModeIndex != Default )
+		{
+			_canRecordInParallel = false;
+			return;
+		}
+
+		if ( not _tp._GetPipeline( *_currTask->GetLogicalPass(), task, OUT task.pipelineHandle, OUT task.pipelineLayout ) or
+			 not task.pipelineLayout )
+			_canRecordInParallel = false;
+	}
+	
+	void  VTaskProcessor::DrawTaskCommands::_Prepare (const VFgDrawTask<FG::CustomDraw> &)
+	{
+		// draw context uses frame graph thread
+		_canRecordInParallel = false;
+	}
+
+/*
+=================================================
+	_BindPipeline
+=================================================
+*/
+	template <typename DrawTask>
+	inline bool  VTaskProcessor::DrawTaskCommands::_BindPipeline (const DrawTask &task, OUT VPipelineLayout const* &layout) const
+	{
+		if ( not task.pipelineLayout )
+		{
+			// '_GetPipeline' uses frame graph thread, in worker thread pipeline must be resolved in '_PrepareSecondaryCmdbufs'
+			CHECK_ERR( not _tp._isSecondary );
+			CHECK_ERR( _tp._GetPipeline( *_currTask->GetLogicalPass(), task, OUT task.pipelineHandle, OUT task.pipelineLayout ));
+		}
+
+		// pipeline is compiling in background, draw call is skipped
+		if ( not task.pipelineHandle )
+			return false;
+
+		layout = task.pipelineLayout;
+		_tp._BindPipeline2( *_currTask->GetLogicalPass(), task.pipelineHandle );
+		return true;
+	}
 
 /*
 =================================================
@@ -751,8 +967,7 @@ namespace FG
 			buffers[i] = vertexBuffers[i]->Handle();
 		}
 
-		_tp.vkCmdBindVertexBuffers( _cmdBuffer, 0, uint(buffers.size()), buffers.data(), vertexOffsets.data() );
-		_tp.Stat().vertexBufferBindings ++;
+		_tp._BindVertexBuffers( 0, buffers, vertexOffsets );
 	}
 
 /*
@@ -765,15 +980,8 @@ namespace FG
 	{
 		if ( task.descriptorSets.size() )
 		{
-			_tp.vkCmdBindDescriptorSets( _cmdBuffer,
-										  VK_PIPELINE_BIND_POINT_GRAPHICS,
-										  layout.Handle(),
-										  layout.GetFirstDescriptorSet(),
-										  uint(task.descriptorSets.size()),
-										  task.descriptorSets.data(),
-										  uint(task.GetResources().dynamicOffsets.size()),
-										  task.GetResources().dynamicOffsets.data() );
-			_tp.Stat().descriptorBinds ++;
+			_tp._BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, layout.Handle(), layout.GetFirstDescriptorSet(),
+									 task.descriptorSets, task.GetResources().dynamicOffsets );
 		}
 		
 		if ( task.debugModeIndex != Default )
@@ -784,6 +992,7 @@ namespace FG
 			
 			_tp.vkCmdBindDescriptorSets( _cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout.Handle(), binding, 1, &desc_set, 1, &offset );
 			_tp.Stat().descriptorBinds ++;
+			_tp._ResetDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS );
 		}
 	}
 
@@ -799,7 +1008,7 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout )) return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -829,7 +1038,7 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout )) return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -848,6 +1057,76 @@ namespace FG
 		stat.drawCalls += uint(task.commands.size());
 	}
 	
+/*
+=================================================
+	Visit (DrawIndexedBatch)
+----
+	shared states are bound once, only per draw descriptor set and push constant
+	are changed between draw calls. '_BindDescriptorSets' rebinds only changed set.
+=================================================
+*/
+	inline void  VTaskProcessor::DrawTaskCommands::Visit (const VFgDrawTask<FG::DrawIndexedBatch> &task)
+	{
+		//_tp._CmdDebugMarker( task.GetName() );
+		
+		VPipelineLayout const*	layout	= null;
+		auto&					stat	= _tp.Stat();
+
+		if ( not _BindPipeline( task, OUT layout )) return;
+
+		_BindPipelineResources( *layout, task );
+
+		const bool	per_draw_pc	= task.perDrawPushConstants.size();
+		_tp._PushConstants( *layout, task.pushConstants, uint(per_draw_pc) );
+
+		_BindVertexBuffers( task.GetVertexBuffers(), task.GetVBOffsets() );
+		_tp._SetScissor( *_currTask->GetLogicalPass(), task.GetScissors() );
+		_tp._BindIndexBuffer( task.indexBuffer->Handle(), VkDeviceSize(task.indexBufferOffset), VEnumCast(task.indexType) );
+		_tp._SetDynamicStates( task.dynamicStates );
+
+		const bool			per_draw_ds	= task.perDrawDescSetIndex < task.descriptorSets.size();
+		VkDescriptorSets_t	desc_sets	= task.descriptorSets;
+		
+		CHECK_ERRV( per_draw_ds or task.perDrawResources.empty() );
+		
+		VkShaderStageFlags	pc_stages	= 0;
+		uint				pc_offset	= 0;
+		const uint			pc_size		= uint(task.perDrawPushConstSize);
+
+		if ( per_draw_pc )
+		{
+			auto	iter = layout->GetPushConstants().find( task.perDrawPushConstId );
+			CHECK_ERRV( iter != layout->GetPushConstants().end() );
+			ASSERT( task.perDrawPushConstSize == iter->second.size and "push constant size mismatch" );
+
+			pc_stages	= VEnumCast( iter->second.stageFlags );
+			pc_offset	= uint(iter->second.offset);
+		}
+
+		for (size_t i = 0; i < task.commands.size(); ++i)
+		{
+			auto&	cmd = task.commands[i];
+
+			if ( per_draw_ds )
+			{
+				desc_sets[ task.perDrawDescSetIndex ] = task.perDrawResources[i]->Handle();
+				_tp._BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, layout->Handle(), layout->GetFirstDescriptorSet(),
+										 desc_sets, task.GetResources().dynamicOffsets );
+			}
+
+			if ( per_draw_pc )
+			{
+				_tp.vkCmdPushConstants( _cmdBuffer, layout->Handle(), pc_stages, pc_offset, pc_size, task.perDrawPushConstants.data() + pc_size * i );
+				stat.pushConstants ++;
+			}
+
+			_tp.vkCmdDrawIndexed( _cmdBuffer, cmd.indexCount, cmd.instanceCount, cmd.firstIndex, cmd.vertexOffset, cmd.firstInstance );
+			stat.vertexCount    += uint64_t(cmd.indexCount) * cmd.instanceCount;
+			stat.primitiveCount += CalcPrimitiveCount( uint64_t(cmd.indexCount) * cmd.instanceCount, task.topology, task.pipeline->PatchControlPoints() );
+		}
+		stat.drawCalls += uint(task.commands.size());
+	}
+	
 /*
 =================================================
 	Visit (DrawVerticesIndirect)
@@ -860,7 +1139,7 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout )) return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -895,7 +1174,7 @@ namespace FG
 		VPipelineLayout const*	layout	= null;
 		auto&					stat	= _tp.Stat();
 
-		CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+		if ( not _BindPipeline( task, OUT layout )) return;
 
 		_BindPipelineResources( *layout, task );
 		_tp._PushConstants( *layout, task.pushConstants );
@@ -933,7 +1212,7 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout )) return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -972,7 +1251,7 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout )) return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1013,7 +1292,7 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout )) return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1051,7 +1330,7 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout )) return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1092,7 +1371,7 @@ namespace FG
 			VPipelineLayout const*	layout	= null;
 			auto&					stat	= _tp.Stat();
 
-			CHECK_ERRV( _tp._BindPipeline( *_currTask->GetLogicalPass(), task, OUT layout ));
+			if ( not _BindPipeline( task, OUT layout )) return;
 
 			_BindPipelineResources( *layout, task );
 			_tp._PushConstants( *layout, task.pushConstants );
@@ -1129,6 +1408,9 @@ namespace FG
 		DrawContext	ctx{ _tp, *_currTask->GetLogicalPass() };
 
 		task.callback( task.callbackParam, ctx );
+
+		// bound state may be changed by user
+		_tp._ResetDrawContext();
 	}
 //-----------------------------------------------------------------------------
 	
@@ -1300,8 +1582,7 @@ namespace FG
 		uint						binding;
 		_pplnLayout->GetDescriptorSetLayout( id, OUT ds_layout, OUT binding );
 
-		_tp.vkCmdBindDescriptorSets( _tp._cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pplnLayout->Handle(), binding, 1, &ds, uint(dyn_offs.size()), dyn_offs.data() );
-		_tp.Stat().descriptorBinds ++;
+		_tp._BindDescriptorSets( VK_PIPELINE_BIND_POINT_GRAPHICS, _pplnLayout->Handle(), binding, {ds}, dyn_offs );
 	}
 	
 /*
@@ -1350,8 +1631,7 @@ namespace FG
 			VkBuffer		vk_buf	= buf->Handle();
 			VkDeviceSize	off		{ offset };
 
-			_tp.vkCmdBindVertexBuffers( _tp._cmdBuffer, iter->second.index, 1, &vk_buf, &off );
-			_tp.Stat().vertexBufferBindings ++;
+			_tp._BindVertexBuffers( iter->second.index, {vk_buf}, {off} );
 		}
 	}
 	
@@ -1777,6 +2057,7 @@ namespace FG
 	VTaskProcessor::VTaskProcessor (VCommandBuffer &fgThread, VkCommandBuffer cmd) :
 		_fgThread{ fgThread },
 		_cmdBuffer{ cmd },
+		_stat{ &fgThread.EditStatistic().renderer },
 		_enableDebugUtils{ _fgThread.GetDevice().GetFeatures().debugUtils },
 		_isDefaultScissor{ false },	
 		_perPassStatesUpdated{ false },
@@ -1784,6 +2065,9 @@ namespace FG
 		_drawIndirectCount{ _fgThread.GetDevice().GetFeatures().drawIndirectCount },
 		_meshShaderNV{ _fgThread.GetDevice().GetFeatures().meshShaderNV },
 		_rayTracingNV{ _fgThread.GetDevice().GetFeatures().rayTracingNV },
+		_splitBarriers{ _fgThread.IsSplitBarriersEnabled() },
+		_renderPassActive{ false },
+		_isSecondary{ false },
 		_maxDrawIndirectCount{ _fgThread.GetDevice().GetProperties().properties.limits.maxDrawIndirectCount },
 		#ifdef VK_NV_mesh_shader
 		_maxMeshTaskCount{ _fgThread.GetDevice().GetProperties().meshShaderProperties.maxDrawMeshTasksCount },
@@ -1797,6 +2081,39 @@ namespace FG
 		_CmdPushDebugGroup( "CommandBuffer: "s << (fgThread.GetName().size() ? fgThread.GetName() : ToString<16>( size_t(_cmdBuffer) )), RGBA8u{255} );
 	}
 	
+/*
+=================================================
+	constructor
+----
+	for secondary command buffer recording in worker thread,
+	must not use any method of 'VCommandBuffer' that is protected by data race check.
+=================================================
+*/
+	VTaskProcessor::VTaskProcessor (const VTaskProcessor &primary, VkCommandBuffer secondary, Statistic_t &stat) :
+		_fgThread{ primary._fgThread },
+		_cmdBuffer{ secondary },
+		_stat{ &stat },
+		_enableDebugUtils{ false },		// debug group is pushed in primary command buffer
+		_isDefaultScissor{ false },	
+		_perPassStatesUpdated{ false },
+		_dispatchBase{ primary._dispatchBase },
+		_drawIndirectCount{ primary._drawIndirectCount },
+		_meshShaderNV{ primary._meshShaderNV },
+		_rayTracingNV{ primary._rayTracingNV },
+		_splitBarriers{ false },		// events are set only in primary command buffer
+		_renderPassActive{ false },
+		_isSecondary{ true },
+		_maxDrawIndirectCount{ primary._maxDrawIndirectCount },
+		#ifdef VK_NV_mesh_shader
+		_maxMeshTaskCount{ primary._maxMeshTaskCount },
+		#endif
+		_pendingResourceBarriers{ primary._pendingResourceBarriers.get_allocator() }
+	{
+		ASSERT( _cmdBuffer );
+
+		VulkanDeviceFn_Init( primary );
+	}
+	
 /*
 =================================================
 	destructor
@@ -1819,7 +2136,7 @@ namespace FG
 	
 	void  VTaskProcessor::Visit2_DrawVertices (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawVertices>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawVertices>*>( taskData ));
 	}
 	
 /*
@@ -1834,7 +2151,22 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawIndexed (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawIndexed>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawIndexed>*>( taskData ));
+	}
+	
+/*
+=================================================
+	Visit*_DrawIndexedBatch
+=================================================
+*/
+	void  VTaskProcessor::Visit1_DrawIndexedBatch (void *visitor, void *taskData)
+	{
+		static_cast<DrawTaskBarriers *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawIndexedBatch>*>( taskData ));
+	}
+
+	void  VTaskProcessor::Visit2_DrawIndexedBatch (void *visitor, void *taskData)
+	{
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawIndexedBatch>*>( taskData ));
 	}
 	
 /*
@@ -1849,7 +2181,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawMeshes (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawMeshes>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawMeshes>*>( taskData ));
 	}
 	
 /*
@@ -1864,7 +2196,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawVerticesIndirect (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawVerticesIndirect>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawVerticesIndirect>*>( taskData ));
 	}
 	
 /*
@@ -1879,7 +2211,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawIndexedIndirect (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawIndexedIndirect>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawIndexedIndirect>*>( taskData ));
 	}
 	
 /*
@@ -1894,7 +2226,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawVerticesIndirectCount (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawVerticesIndirectCount>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawVerticesIndirectCount>*>( taskData ));
 	}
 	
 /*
@@ -1909,7 +2241,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawIndexedIndirectCount (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawIndexedIndirectCount>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawIndexedIndirectCount>*>( taskData ));
 	}
 	
 /*
@@ -1924,7 +2256,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawMeshesIndirect (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawMeshesIndirect>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawMeshesIndirect>*>( taskData ));
 	}
 	
 /*
@@ -1939,7 +2271,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_DrawMeshesIndirectCount (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::DrawMeshesIndirectCount>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::DrawMeshesIndirectCount>*>( taskData ));
 	}
 	
 /*
@@ -1954,7 +2286,7 @@ namespace FG
 
 	void  VTaskProcessor::Visit2_CustomDraw (void *visitor, void *taskData)
 	{
-		static_cast<DrawTaskCommands *>(visitor)->Visit( *static_cast<VFgDrawTask<FG::CustomDraw>*>( taskData ));
+		static_cast<DrawTaskCommands *>(visitor)->Process( *static_cast<VFgDrawTask<FG::CustomDraw>*>( taskData ));
 	}
 
 /*
@@ -2192,6 +2524,9 @@ namespace FG
 		
 		RawFramebufferID	fb_id = _fgThread.GetResourceManager().CreateFramebuffer( render_targets, rp_id, uint2(total_area->Size()), 1, "" );
 		CHECK_ERR( fb_id );
+
+		// framebuffer is used until command batch is complete, after that it may be evicted from cache
+		_fgThread.ReleaseResource( fb_id );
 		
 		uint	subpass = 0;
 		for (auto& pass : logicalPasses) {
@@ -2205,7 +2540,7 @@ namespace FG
 	_BeginRenderPass
 =================================================
 */
-	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginRenderPass (const VFgTask<SubmitRenderPass> &task, OUT bool &useSecondary)
 	{
 		ASSERT( not task.IsSubpass() );
 
@@ -2223,10 +2558,15 @@ namespace FG
 
 		for (auto& pass : logical_passes)
 		{
+			barrier_visitor.SetSortKeysEnabled( pass->IsDrawTaskSortingEnabled() );
+
 			for (auto& draw : pass->GetDrawTasks())
 			{
 				draw->Process1( &barrier_visitor );
 			}
+			
+			// sort key requires descriptor sets that are extracted in 'DrawTaskBarriers'
+			pass->SortDrawTasks();
 
 			for (auto& item : pass->GetMutableImages())
 			{
@@ -2250,6 +2590,8 @@ namespace FG
 		// create render pass and framebuffer
 		CHECK( _CreateRenderPass( logical_passes ));
 		
+		useSecondary = _PrepareSecondaryCmdbufs( task );
+
 
 		// begin render pass
 		VFramebuffer const*	framebuffer = _GetResource( task.GetLogicalPass()->GetFramebufferID() );
@@ -2267,9 +2609,10 @@ namespace FG
 		pass_info.pClearValues				= task.GetLogicalPass()->GetClearValues().data();
 		pass_info.framebuffer				= framebuffer->Handle();
 		
-		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, VK_SUBPASS_CONTENTS_INLINE );
+		vkCmdBeginRenderPass( _cmdBuffer, &pass_info, useSecondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
 
-		_BindShadingRateImage( sri_view );
+		if ( not useSecondary )
+			_BindShadingRateImage( sri_view );
 	}
 	
 /*
@@ -2277,13 +2620,15 @@ namespace FG
 	_BeginSubpass
 =================================================
 */
-	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task)
+	void  VTaskProcessor::_BeginSubpass (const VFgTask<SubmitRenderPass> &task, OUT bool &useSecondary)
 	{
 		ASSERT( task.IsSubpass() );
 
 		// TODO: barriers for attachments
 
-		vkCmdNextSubpass( _cmdBuffer, VK_SUBPASS_CONTENTS_INLINE );
+		useSecondary = _PrepareSecondaryCmdbufs( task );
+
+		vkCmdNextSubpass( _cmdBuffer, useSecondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
 		/*
 		// TODO
 		vkCmdClearAttachments( _cmdBuffer,
@@ -2307,25 +2652,34 @@ namespace FG
 		_isDefaultScissor		= false;
 		_perPassStatesUpdated	= false;
 
+		bool	use_secondary = false;
+
 		if ( not task.IsSubpass() )
 		{
 			_CmdPushDebugGroup( task.Name(), task.DebugColor() );
-			_BeginRenderPass( task );
+			_BeginRenderPass( task, OUT use_secondary );
 		}
 		else
 		{
 			_CmdPopDebugGroup();
 			_CmdPushDebugGroup( task.Name(), task.DebugColor() );
-			_BeginSubpass( task );
+			_BeginSubpass( task, OUT use_secondary );
 		}
 
 
 		// draw
-		DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
-		
-		for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+		if ( use_secondary )
 		{
-			draw->Process2( &command_builder );
+			_RecordSecondaryCmdbufs( task );
+		}
+		else
+		{
+			DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
+		
+			for (auto& draw : task.GetLogicalPass()->GetDrawTasks())
+			{
+				draw->Process2( &command_builder );
+			}
 		}
 
 		// end render pass
@@ -2334,8 +2688,174 @@ namespace FG
 			vkCmdEndRenderPass( _cmdBuffer );
 			_CmdPopDebugGroup();
 		}
+		_renderPassActive = not task.IsLastPass();
 	}
 	
+/*
+=================================================
+	_PrepareSecondaryCmdbufs
+----
+	returns 'true' if draw tasks can be recorded in parallel
+	into secondary command buffers.
+	Secondary command buffers are allocated and begun before the render pass,
+	so on failure draw tasks are recorded inline.
+=================================================
+*/
+	bool  VTaskProcessor::_PrepareSecondaryCmdbufs (const VFgTask<SubmitRenderPass> &task)
+	{
+		STATIC_ASSERT( MaxSecondaryCmdbufs == VCommandBuffer::MaxSecondaryPools );
+		ASSERT( _secondaryCmdbufs.empty() );
+
+		auto&	logical_pass = *task.GetLogicalPass();
+
+		// shading rate image must be bound in each secondary command buffer, it is not supported yet
+		if ( not logical_pass.UseSecondaryCmdbuf()	or
+			 logical_pass.HasShadingRateImage()		or
+			 logical_pass.GetDrawTasks().size() < MinDrawTasksPerCmdbuf * 2 )
+			return false;
+
+		DrawTaskCommands	prepare{ *this, &task, _cmdBuffer, true };
+
+		for (auto& draw : logical_pass.GetDrawTasks())
+		{
+			draw->Process2( &prepare );
+		}
+
+		if ( not prepare.CanRecordInParallel() )
+			return false;
+		
+		const uint			count		= Min( _fgThread.GetWorkerPool().ThreadCount() + 1, MaxSecondaryCmdbufs,
+											   uint(logical_pass.GetDrawTasks().size() / MinDrawTasksPerCmdbuf) );
+		VFramebuffer const*	framebuffer = _GetResource( logical_pass.GetFramebufferID() );
+		VRenderPass const*	render_pass = _GetResource( logical_pass.GetRenderPassID() );
+		CHECK_ERR( framebuffer and render_pass );
+
+		VkCommandBufferInheritanceInfo	inheritance = {};
+		inheritance.sType		= VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass	= render_pass->Handle();
+		inheritance.subpass		= logical_pass.GetSubpassIndex();
+		inheritance.framebuffer	= framebuffer->Handle();
+
+		VkCommandBufferBeginInfo	begin_info = {};
+		begin_info.sType			= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		begin_info.flags			= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		begin_info.pInheritanceInfo	= &inheritance;
+
+		// command pools must be externally synchronized, so each chunk uses separate pool
+		for (uint i = 0; i < count; ++i)
+		{
+			VkCommandBuffer	cmd = _fgThread.AllocSecondary( i );
+
+			if ( not cmd or vkBeginCommandBuffer( cmd, &begin_info ) != VK_SUCCESS )
+			{
+				// command buffers are freed when batch is complete, they are never executed
+				for (auto& sec : _secondaryCmdbufs) {
+					VK_CALL( vkEndCommandBuffer( sec ));
+				}
+				_secondaryCmdbufs.clear();
+
+				FG_LOGE( "failed to begin secondary command buffer, draw tasks will be recorded inline" );
+				return false;
+			}
+			_secondaryCmdbufs.push_back( cmd );
+		}
+		return true;
+	}
+	
+/*
+=================================================
+	_RecordSecondaryCmdbufs
+----
+	draw tasks are splitted into chunks, each chunk is recorded
+	into secondary command buffer on worker thread.
+	Current thread helps to process jobs while waiting.
+=================================================
+*/
+	void  VTaskProcessor::_RecordSecondaryCmdbufs (const VFgTask<SubmitRenderPass> &task)
+	{
+		using Statistics_t	= IFrameGraph::Statistics;
+		using ChunkStats_t	= StaticArray< Statistics_t, MaxSecondaryCmdbufs >;
+
+		auto			draw_tasks	= task.GetLogicalPass()->GetDrawTasks();
+		ThreadPool &	workers		= _fgThread.GetWorkerPool();
+		auto const&		cmdbufs		= _secondaryCmdbufs;
+		const uint		count		= uint(cmdbufs.size());
+		const size_t	chunk_size	= (draw_tasks.size() + count - 1) / count;
+		ChunkStats_t	chunk_stats;
+		Atomic<uint>	pending		{ count };
+
+		ASSERT( count > 0 );
+
+		for (uint i = 0; i < count; ++i)
+		{
+			workers.Enqueue( [this, &task, &cmdbufs, &chunk_stats, &pending, i, chunk = draw_tasks.section( i * chunk_size, chunk_size )] ()
+			{
+				VTaskProcessor	processor{ *this, cmdbufs[i], chunk_stats[i].renderer };
+				processor._RecordSecondary( task, chunk );
+
+				pending.fetch_sub( 1, memory_order_release );
+			});
+		}
+
+		for (; pending.load( memory_order_acquire ) > 0;)
+		{
+			if ( not workers.ProcessJob() )
+				std::this_thread::yield();
+		}
+
+		for (uint i = 0; i < count; ++i)
+		{
+			VK_CALL( vkEndCommandBuffer( cmdbufs[i] ));
+			_fgThread.EditStatistic().Merge( chunk_stats[i] );
+		}
+
+		vkCmdExecuteCommands( _cmdBuffer, count, cmdbufs.data() );
+		Stat().secondaryCommandBuffers += count;
+		_secondaryCmdbufs.clear();
+
+		// command buffer state is undefined after executing secondary command buffers
+		_ResetDrawContext();
+	}
+	
+/*
+=================================================
+	_RecordSecondary
+=================================================
+*/
+	void  VTaskProcessor::_RecordSecondary (const VFgTask<SubmitRenderPass> &task, ArrayView<IDrawTask *> drawTasks)
+	{
+		DrawTaskCommands	command_builder{ *this, &task, _cmdBuffer };
+		
+		for (auto& draw : drawTasks)
+		{
+			draw->Process2( &command_builder );
+		}
+	}
+	
+/*
+=================================================
+	_ResetDrawContext
+=================================================
+*/
+	void  VTaskProcessor::_ResetDrawContext ()
+	{
+		_graphicsPipeline.pipeline	= VK_NULL_HANDLE;
+		_isDefaultScissor			= false;
+		_perPassStatesUpdated		= false;
+
+		_indexBuffer				= VK_NULL_HANDLE;
+		_indexBufferOffset			= UMax;
+		_indexType					= VK_INDEX_TYPE_MAX_ENUM;
+
+		_shadingRateImage			= VK_NULL_HANDLE;
+
+		_vertexBuffers.fill( VK_NULL_HANDLE );
+
+		for (auto& state : _descriptorSets) {
+			state.layout = VK_NULL_HANDLE;
+		}
+	}
+
 /*
 =================================================
 	_ExtractDescriptorSets
@@ -2395,15 +2915,7 @@ namespace FG
 
 		if ( descriptor_sets.size() )
 		{
-			vkCmdBindDescriptorSets( _cmdBuffer,
-									  bindPoint,
-									  layout.Handle(),
-									  layout.GetFirstDescriptorSet(),
-									  uint(descriptor_sets.size()),
-									  descriptor_sets.data(),
-									  uint(resourceSet.dynamicOffsets.size()),
-									  resourceSet.dynamicOffsets.data() );
-			Stat().descriptorBinds ++;
+			_BindDescriptorSets( bindPoint, layout.Handle(), layout.GetFirstDescriptorSet(), descriptor_sets, resourceSet.dynamicOffsets );
 		}
 
 		if ( debugModeIndex != Default )
@@ -2414,6 +2926,7 @@ namespace FG
 
 			vkCmdBindDescriptorSets( _cmdBuffer, bindPoint, layout.Handle(), binding, 1, &desc_set, 1, &offset );
 			Stat().descriptorBinds ++;
+			_ResetDescriptorSets( bindPoint );
 		}
 	}
 
@@ -2422,11 +2935,11 @@ namespace FG
 	_PushConstants
 =================================================
 */
-	void  VTaskProcessor::_PushConstants (const VPipelineLayout &layout, const _fg_hidden_::PushConstants_t &pushConstants) const
+	void  VTaskProcessor::_PushConstants (const VPipelineLayout &layout, const _fg_hidden_::PushConstants_t &pushConstants, uint perDrawCount) const
 	{
 		auto const&		pc_map = layout.GetPushConstants();
 			
-		ASSERT( pushConstants.size() == pc_map.size() and
+		ASSERT( pushConstants.size() + perDrawCount == pc_map.size() and
 			    "will be used push constants from previous draw/dispatch calls or may contains undefined values" );
 
 		for (auto& pc : pushConstants)
@@ -2542,7 +3055,8 @@ namespace FG
 	_BindPipeline
 =================================================
 */
-	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, VPipelineLayout const* &pplnLayout)
+	inline bool  VTaskProcessor::_GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task,
+											   OUT VkPipeline &pipeline, OUT VPipelineLayout const* &pplnLayout)
 	{
 		RenderState				render_state;
 		EPipelineDynamicState	dynamic_states = EPipelineDynamicState::Viewport | EPipelineDynamicState::Scissor;
@@ -2561,18 +3075,41 @@ namespace FG
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
 
-		VkPipeline	ppln_id;
-		CHECK_ERR( _fgThread.GetPipelineCache().CreatePipelineInstance(
+		auto&						ppln_cache	= _fgThread.GetPipelineCache();
+		VGraphicsPipeline const*	gppln		= task.pipeline;
+
+		if ( _fgThread.IsAsyncPipelineCompilation() and task.debugModeIndex == Default )
+		{
+			CHECK_ERR( ppln_cache.CreatePipelineInstanceAsync(
 										_fgThread,
 										logicalRP,
+										task.pipelineId,
 										*task.pipeline,
 										task.vertexInput,
 										render_state,
 										dynamic_states,
+										OUT pipeline, OUT pplnLayout ));
+			if ( pipeline )
+				return true;
+
+			_fgThread.EditStatistic().resources.stalledPipelineInstances++;
+
+			// draw call will be skipped
+			if ( not task.fallbackPipeline )
+				return true;
+
+			gppln = task.fallbackPipeline;
+		}
+
+		CHECK_ERR( ppln_cache.CreatePipelineInstance(
+										_fgThread,
+										logicalRP,
+										*gppln,
+										task.vertexInput,
+										render_state,
+										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout ));
-		
-		_BindPipeline2( logicalRP, ppln_id );
+										OUT pipeline, OUT pplnLayout ));
 		return true;
 	}
 	
@@ -2581,7 +3118,8 @@ namespace FG
 	_BindPipeline
 =================================================
 */
-	inline bool  VTaskProcessor::_BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, VPipelineLayout const* &pplnLayout)
+	inline bool  VTaskProcessor::_GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task,
+											   OUT VkPipeline &pipeline, OUT VPipelineLayout const* &pplnLayout)
 	{
 	#ifdef VK_NV_mesh_shader
 		RenderState				render_state;
@@ -2598,7 +3136,6 @@ namespace FG
 									INOUT render_state.rasterization, INOUT dynamic_states, task.dynamicStates );
 		SetupExtensions( logicalRP, INOUT dynamic_states );
 
-		VkPipeline	ppln_id;
 		CHECK_ERR( _fgThread.GetPipelineCache().CreatePipelineInstance(
 										_fgThread,
 										logicalRP,
@@ -2606,16 +3143,14 @@ namespace FG
 										render_state,
 										dynamic_states,
 										task.debugModeIndex,
-										OUT ppln_id, OUT pplnLayout ));
-		
-		_BindPipeline2( logicalRP, ppln_id );
+										OUT pipeline, OUT pplnLayout ));
 		return true;
 	#else
-		Unused( logicalRP, task, pplnLayout );
+		Unused( logicalRP, task, pipeline, pplnLayout );
 		return false;
 	#endif
 	}
-
+	
 /*
 =================================================
 	_BindPipeline
@@ -3293,6 +3828,9 @@ namespace FG
 /*
 =================================================
 	Visit (BuildRayTracingGeometry)
+----
+	builds are deferred until the next task of another type,
+	so barriers for all builds are committed at once.
 =================================================
 */
 	void  VTaskProcessor::Visit (const VFgTask<BuildRayTracingGeometry> &task)
@@ -3300,8 +3838,28 @@ namespace FG
 	#ifdef VK_NV_ray_tracing
 		if ( _rayTracingNV )
 		{
-			_CmdDebugMarker( task.Name() );
-		
+			// previous build of the same geometry must be completed
+			for (auto* other : _deferredGeometryBuilds)
+			{
+				if ( other->RTGeometry() == task.RTGeometry() )
+				{
+					_FlushGeometryBuilds();
+					break;
+				}
+			}
+
+			if ( _deferredGeometryBuilds.size() == _deferredGeometryBuilds.capacity() )
+				_FlushGeometryBuilds();
+
+			// all builds in the run are recorded after a single barrier commit, so their states are
+			// added with the execution order of the first task, otherwise input buffers that are shared
+			// between builds will have uncommitted states from different tasks.
+			if ( _deferredGeometryBuilds.empty() )
+				_geometryBuildsTask = _currTask;
+
+			const VTask		curr_task = _currTask;
+			_currTask = _geometryBuildsTask;
+
 			_AddRTGeometry( task.RTGeometry(), EResourceState::BuildRayTracingStructWrite );
 			_AddBuffer( task.ScratchBuffer(), EResourceState::RTASBuildingBufferReadWrite, task.ScratchBufferOffset(), task.ScratchBufferSize() );
 
@@ -3311,31 +3869,62 @@ namespace FG
 				_AddBuffer( buf, EResourceState::TransferSrc, 0, VK_WHOLE_SIZE );
 			}
 
-			_CommitBarriers();
+			_currTask = curr_task;
+			_deferredGeometryBuilds.push_back( &task );
+
+			// split barrier event is set after each task
+			if ( _splitBarriers )
+				_FlushGeometryBuilds();
+		}
+	#else
+		Unused( task );
+	#endif
+	}
+	
+/*
+=================================================
+	_FlushGeometryBuilds
+=================================================
+*/
+	void  VTaskProcessor::_FlushGeometryBuilds ()
+	{
+	#ifdef VK_NV_ray_tracing
+		if ( _deferredGeometryBuilds.empty() )
+			return;
+
+		_CommitBarriers();
+
+		for (auto* task : _deferredGeometryBuilds)
+		{
+			_CmdDebugMarker( task->Name() );
 
 			VkAccelerationStructureInfoNV	info = {};
 			info.sType			= VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_INFO_NV;
 			info.type			= VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_NV;
-			info.geometryCount	= uint(task.GetGeometry().size());
-			info.pGeometries	= task.GetGeometry().data();
-			info.flags			= VEnumCast( task.RTGeometry()->GetFlags() );
+			info.geometryCount	= uint(task->GetGeometry().size());
+			info.pGeometries	= task->GetGeometry().data();
+			info.flags			= VEnumCast( task->RTGeometry()->GetFlags() );
 
 			vkCmdBuildAccelerationStructureNV( _cmdBuffer, &info,
 												VK_NULL_HANDLE, 0,
 												VK_FALSE,
-												task.RTGeometry()->Handle(), VK_NULL_HANDLE,
-												task.ScratchBuffer()->Handle(),
-												task.ScratchBufferOffset() );
+												task->RTGeometry()->Handle(), VK_NULL_HANDLE,
+												task->ScratchBuffer()->Handle(),
+												task->ScratchBufferOffset() );
 			Stat().buildASCalls ++;
 		}
-	#else
-		Unused( task );
+		_deferredGeometryBuilds.clear();
 	#endif
 	}
 	
 /*
 =================================================
 	Visit (BuildRayTracingScene)
+----
+	acceleration structure is updated if scene supports updates
+	and the instances and geometries are the same as in previous build.
+	Previous build is the last processed build, so it must be submitted,
+	otherwise update source is acceleration structure with undefined content.
 =================================================
 */
 	void  VTaskProcessor::Visit (const VFgTask<BuildRayTracingScene> &task)
@@ -3345,27 +3934,47 @@ namespace FG
 		{
 			_CmdDebugMarker( task.Name() );
 		
+			ArrayView<VFgTask<BuildRayTracingScene>::InstanceCopy>	copies = task.InstanceCopies();
+
+			// commit instance buffer content, upload all instances if dirty ranges are outdated
+			if ( task.VkInstances().size() and
+				 not task.RTScene()->ToGlobal()->CommitInstances( task.VkInstances(), task.InstanceGeneration() ))
+			{
+				copies = ArrayView{ &task.FullInstanceCopy(), 1 };
+			}
+
 			// copy instance data to GPU memory
-			_AddBuffer( task.InstanceStagingBuffer(), EResourceState::TransferSrc, task.InstanceStagingBufferOffset(), task.InstanceBufferSize() );
-			_AddBuffer( task.InstanceBuffer(), EResourceState::TransferDst, task.InstanceBufferOffset(), task.InstanceBufferSize() );
+			if ( copies.size() )
+			{
+				for (auto& copy : copies)
+				{
+					_AddBuffer( copy.srcBuffer, EResourceState::TransferSrc, copy.srcOffset, copy.size );
+					_AddBuffer( task.InstanceBuffer(), EResourceState::TransferDst, task.InstanceBufferOffset() + copy.dstOffset, copy.size );
+				}
 		
-			_CommitBarriers();
+				_CommitBarriers();
 
-			VkBufferCopy	region;
-			region.srcOffset	= task.InstanceStagingBufferOffset();
-			region.dstOffset	= task.InstanceBufferOffset();
-			region.size			= task.InstanceBufferSize();
+				for (auto& copy : copies)
+				{
+					VkBufferCopy	region;
+					region.srcOffset	= copy.srcOffset;
+					region.dstOffset	= task.InstanceBufferOffset() + copy.dstOffset;
+					region.size			= copy.size;
 
-			vkCmdCopyBuffer( _cmdBuffer, task.InstanceStagingBuffer()->Handle(), task.InstanceBuffer()->Handle(), 1, &region );
+					vkCmdCopyBuffer( _cmdBuffer, copy.srcBuffer->Handle(), task.InstanceBuffer()->Handle(), 1, &region );
+					Stat().rtInstanceUploads += uint(copy.size / sizeof(VkGeometryInstance));
+				}
 		
-			Stat().transferOps ++;
+				Stat().transferOps += uint(copies.size());
+			}
 
 
-			// build TLAS
-			task.RTScene()->ToGlobal()->SetGeometryInstances( _fgThread.GetResourceManager(), task.Instances(), task.InstanceCount(),
-															  task.HitShadersPerInstance(), task.MaxHitShaderCount() );
+			// build or update TLAS
+			const bool	is_same	= task.RTScene()->ToGlobal()->SetGeometryInstances( _fgThread.GetResourceManager(), task.Instances(), task.InstanceCount(),
+																					 task.HitShadersPerInstance(), task.MaxHitShaderCount() );
+			const bool	update	= is_same and AllBits( task.RTScene()->GetFlags(), ERayTracingFlags::AllowUpdate );
 
-			_AddRTScene( task.RTScene(), EResourceState::BuildRayTracingStructWrite );
+			_AddRTScene( task.RTScene(), update ? EResourceState::BuildRayTracingStructReadWrite : EResourceState::BuildRayTracingStructWrite );
 			_AddBuffer( task.ScratchBuffer(), EResourceState::RTASBuildingBufferReadWrite, task.ScratchBufferOffset(), task.ScratchBufferSize() );
 			_AddBuffer( task.InstanceBuffer(), EResourceState::RTASBuildingBufferRead, task.InstanceBufferOffset(), task.InstanceBufferSize() );
 
@@ -3383,11 +3992,13 @@ namespace FG
 
 			vkCmdBuildAccelerationStructureNV( _cmdBuffer, &info,
 												task.InstanceBuffer()->Handle(), task.InstanceBufferOffset(),
-												VK_FALSE,
-												task.RTScene()->Handle(), VK_NULL_HANDLE,
+												update ? VK_TRUE : VK_FALSE,
+												task.RTScene()->Handle(),
+												update ? task.RTScene()->Handle() : VK_NULL_HANDLE,
 												task.ScratchBuffer()->Handle(),
 												task.ScratchBufferOffset() );
 			Stat().buildASCalls ++;
+			Stat().rtSceneUpdates += uint(update);
 		}
 	#else
 		Unused( task );
@@ -3500,6 +4111,9 @@ namespace FG
 		ctx.commandBuffer		= BitCast<CommandBufferVk_t>(_cmdBuffer);
 
 		task.callback( ctx );
+
+		// bound state may be changed by user
+		_ResetDrawContext();
 	}
 
 /*
@@ -3516,6 +4130,9 @@ namespace FG
 
 		img->AddPendingState( state );
 
+		if ( _splitBarriers )
+			_currTaskStages |= EResourceState_ToPipelineStages( state.state );
+
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddImageUsage( img->ToGlobal(), state );
 	}
@@ -3582,6 +4199,9 @@ namespace FG
 		_pendingResourceBarriers.insert({ buf, &CommitResourceBarrier<VLocalBuffer> });
 
 		buf->AddPendingState( state );
+
+		if ( _splitBarriers )
+			_currTaskStages |= EResourceState_ToPipelineStages( state.state );
 		
 		if_unlikely( _fgThread.GetDebugger() )
 			_fgThread.GetDebugger()->AddBufferUsage( buf->ToGlobal(), state );
@@ -3693,6 +4313,13 @@ namespace FG
 
 		_pendingResourceBarriers.clear();
 
+		if_unlikely( _fgThread.GetDebugger() )
+		{
+			for (auto& ev : barrier_mngr.GetPendingEvents()) {
+				_fgThread.GetDebugger()->AddWaitEvent( ev.index, _currTask->ExecutionOrder() );
+			}
+		}
+
 		// only for debugging!
 	#ifdef FG_DEBUG
 		if ( _fgThread.IsDebugFullBarriers() )
@@ -3732,14 +4359,51 @@ namespace FG
 			barrier.dstAccessMask	= barrier.srcAccessMask;
 
 			barrier_mngr.AddMemoryBarrier( VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, barrier );
-			barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer );
+			barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer, INOUT Stat() );
 		}
 		else
 	#endif	// FG_DEBUG
 
-		barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer );
+		barrier_mngr.Commit( _fgThread.GetDevice(), _cmdBuffer, INOUT Stat() );
 	}
 	
+/*
+=================================================
+	_SetSplitEvent
+----
+	event is set only if one of dependent tasks is far enough,
+	so commands between producer and consumer can be executed
+	while producer is finishing.
+=================================================
+*/
+	void  VTaskProcessor::_SetSplitEvent ()
+	{
+		// host stage is not allowed in 'vkCmdSetEvent'
+		const VkPipelineStageFlags	stages = _currTaskStages & ~VK_PIPELINE_STAGE_HOST_BIT;
+
+		if ( stages == 0 )
+			return;
+
+		const ExeOrderIndex	index	= _currTask->ExecutionOrder();
+		bool				is_far	= false;
+
+		for (auto out : _currTask->Outputs()) {
+			is_far |= (uint(out->ExecutionOrder()) >= uint(index) + FG_SplitBarrierMinDistance);
+		}
+
+		if ( not is_far )
+			return;
+
+		VkEvent	event;
+		CHECK_ERRV( _fgThread.AcquireEvent( OUT event ));
+
+		vkCmdSetEvent( _cmdBuffer, event, stages );
+		_fgThread.GetBarrierManager().AddEvent( event, stages, index );
+
+		if_unlikely( _fgThread.GetDebugger() )
+			_fgThread.GetDebugger()->AddSetEvent( index, stages );
+	}
+
 /*
 =================================================
 	_BindIndexBuffer
@@ -3758,6 +4422,105 @@ namespace FG
 			vkCmdBindIndexBuffer( _cmdBuffer, _indexBuffer, _indexBufferOffset, _indexType );
 			Stat().indexBufferBindings ++;
 		}
+		else
+			Stat().skippedBinds ++;
+	}
+	
+/*
+=================================================
+	_BindVertexBuffers
+----
+	only changed range of bindings is updated
+=================================================
+*/
+	void  VTaskProcessor::_BindVertexBuffers (uint firstBinding, ArrayView<VkBuffer> buffers, ArrayView<VkDeviceSize> offsets)
+	{
+		ASSERT( buffers.size() == offsets.size() );
+		CHECK_ERRV( firstBinding + buffers.size() <= _vertexBuffers.size() );
+
+		size_t	first	= 0;
+		size_t	last	= buffers.size();
+
+		for (; first < last and _vertexBuffers[firstBinding + first] == buffers[first] and _vertexOffsets[firstBinding + first] == offsets[first]; ++first) {}
+		for (; last > first and _vertexBuffers[firstBinding + last-1] == buffers[last-1] and _vertexOffsets[firstBinding + last-1] == offsets[last-1]; --last) {}
+
+		if ( first == last )
+		{
+			Stat().skippedBinds ++;
+			return;
+		}
+
+		for (size_t i = first; i < last; ++i)
+		{
+			_vertexBuffers[firstBinding + i] = buffers[i];
+			_vertexOffsets[firstBinding + i] = offsets[i];
+		}
+
+		vkCmdBindVertexBuffers( _cmdBuffer, firstBinding + uint(first), uint(last - first), buffers.data() + first, offsets.data() + first );
+		Stat().vertexBufferBindings ++;
+	}
+	
+/*
+=================================================
+	_BindDescriptorSets
+----
+	descriptor sets are compared only with arguments of the previous call for the same bind point
+	and with the same pipeline layout, so bindings for other set numbers are never disturbed.
+	Dynamic offsets are not separated by sets, so partial update is used only without dynamic offsets.
+=================================================
+*/
+	void  VTaskProcessor::_BindDescriptorSets (VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint firstSet,
+											   ArrayView<VkDescriptorSet> descriptorSets, ArrayView<uint> dynamicOffsets)
+	{
+		auto&	state = _descriptorSets[ BindPointIndex( bindPoint )];
+
+		if ( state.layout				== layout					and
+			 state.firstSet				== firstSet					and
+			 state.sets.size()			== descriptorSets.size()	and
+			 state.dynamicOffsets		== dynamicOffsets )
+		{
+			size_t	first	= 0;
+			size_t	last	= descriptorSets.size();
+
+			for (; first < last and state.sets[first] == descriptorSets[first]; ++first) {}
+			for (; last > first and state.sets[last-1] == descriptorSets[last-1]; --last) {}
+
+			if ( first == last )
+			{
+				Stat().skippedBinds ++;
+				return;
+			}
+
+			if ( dynamicOffsets.empty() )
+			{
+				for (size_t i = first; i < last; ++i) {
+					state.sets[i] = descriptorSets[i];
+				}
+
+				vkCmdBindDescriptorSets( _cmdBuffer, bindPoint, layout, firstSet + uint(first), uint(last - first), descriptorSets.data() + first, 0, null );
+				Stat().descriptorBinds ++;
+				return;
+			}
+		}
+
+		state.layout	= layout;
+		state.firstSet	= firstSet;
+		state.sets.assign( descriptorSets.begin(), descriptorSets.end() );
+		state.dynamicOffsets.assign( dynamicOffsets.begin(), dynamicOffsets.end() );
+
+		vkCmdBindDescriptorSets( _cmdBuffer, bindPoint, layout, firstSet, uint(descriptorSets.size()), descriptorSets.data(),
+								 uint(dynamicOffsets.size()), dynamicOffsets.data() );
+		Stat().descriptorBinds ++;
+	}
+	
+/*
+=================================================
+	_ResetDescriptorSets
+=================================================
+*/
+	void  VTaskProcessor::_ResetDescriptorSets (VkPipelineBindPoint bindPoint)
+	{
+		_descriptorSets[ BindPointIndex( bindPoint )].layout = VK_NULL_HANDLE;
 	}
 	
 
@@ -54,11 +54,31 @@ namespace FG
 			VkPipeline		pipeline	= VK_NULL_HANDLE;
 		};
 
+		// arguments of last 'vkCmdBindDescriptorSets' call
+		struct DescriptorSetState
+		{
+			VkPipelineLayout										layout		= VK_NULL_HANDLE;
+			uint													firstSet	= 0;
+			FixedArray< VkDescriptorSet, FG_MaxDescriptorSets >		sets;
+			FixedArray< uint, FG_MaxBufferDynamicOffsets >			dynamicOffsets;
+		};
+		using DescriptorSetStates_t		= StaticArray< DescriptorSetState, 3 >;		// graphics, compute, ray tracing
+		using VertexBuffers_t			= StaticArray< VkBuffer, FG_MaxVertexBuffers >;
+		using VertexOffsets_t			= StaticArray< VkDeviceSize, FG_MaxVertexBuffers >;
+
+		static constexpr uint		MinDrawTasksPerCmdbuf	= 64;	// small passes are faster to record in single thread
+		static constexpr uint		MaxSecondaryCmdbufs		= 8;
+		using SecondaryCmdbufs_t		= FixedArray< VkCommandBuffer, MaxSecondaryCmdbufs >;
+
+		static constexpr uint		MaxDeferredGeometryBuilds	= 64;
+		using DeferredGeometryBuilds_t	= FixedArray< VFgTask<BuildRayTracingGeometry> const*, MaxDeferredGeometryBuilds >;
+
 
 	// variables
 	private:
 		VCommandBuffer &			_fgThread;
 		const VkCommandBuffer		_cmdBuffer;
+		Statistic_t *				_stat;
 		
 		VTask						_currTask;
 		bool						_enableDebugUtils		: 1;
@@ -68,6 +88,9 @@ namespace FG
 		const bool					_drawIndirectCount		: 1;
 		const bool					_meshShaderNV			: 1;
 		const bool					_rayTracingNV			: 1;
+		const bool					_splitBarriers			: 1;
+		bool						_renderPassActive		: 1;	// render pass is continued in next task
+		const bool					_isSecondary			: 1;	// records secondary command buffer in worker thread
 		const uint					_maxDrawIndirectCount;		
 		#ifdef VK_NV_mesh_shader
 		const uint					_maxMeshTaskCount;
@@ -86,10 +109,23 @@ namespace FG
 
 		VkImageView					_shadingRateImage	= VK_NULL_HANDLE;
 
+		// descriptor set & vertex buffer states
+		DescriptorSetStates_t		_descriptorSets;
+		VertexBuffers_t				_vertexBuffers		= {};
+		VertexOffsets_t				_vertexOffsets		= {};
+
+		VkPipelineStageFlags		_currTaskStages		= 0;	// all stages that are used in current task, for split barriers
+
+		DeferredGeometryBuilds_t	_deferredGeometryBuilds;		// BLAS builds are recorded with single barrier
+		VTask						_geometryBuildsTask;			// first task in '_deferredGeometryBuilds'
+
+		SecondaryCmdbufs_t			_secondaryCmdbufs;				// begun before render pass, executed in '_RecordSecondaryCmdbufs'
+
 
 	// methods
 	public:
 		explicit VTaskProcessor (VCommandBuffer &, VkCommandBuffer);
+		VTaskProcessor (const VTaskProcessor &primary, VkCommandBuffer secondary, Statistic_t &stat);
 		~VTaskProcessor ();
 
 		void  Visit (const VFgTask<SubmitRenderPass> &);
@@ -117,6 +153,8 @@ namespace FG
 		static void  Visit2_DrawVertices (void *, void *);
 		static void  Visit1_DrawIndexed (void *, void *);
 		static void  Visit2_DrawIndexed (void *, void *);
+		static void  Visit1_DrawIndexedBatch (void *, void *);
+		static void  Visit2_DrawIndexedBatch (void *, void *);
 		static void  Visit1_DrawMeshes (void *, void *);
 		static void  Visit2_DrawMeshes (void *, void *);
 		static void  Visit1_DrawVerticesIndirect (void *, void *);
@@ -135,6 +173,7 @@ namespace FG
 		static void  Visit2_CustomDraw (void *, void *);
 
 		void  Run (VTask);
+		void  Flush ();
 
 
 	private:
@@ -146,21 +185,26 @@ namespace FG
 		template <typename ID>	ND_ auto const*  _GetResource (ID id) const;
 		
 		void  _CommitBarriers ();
+		void  _SetSplitEvent ();
+		void  _FlushGeometryBuilds ();
 		
 		void  _AddRenderTargetBarriers (const VLogicalRenderPass &logicalRP, const DrawTaskBarriers &info);
 		void  _SetShadingRateImage (const VLogicalRenderPass &logicalRP, OUT VkImageView &view);
-		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task);
-		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task);
+		void  _BeginRenderPass (const VFgTask<SubmitRenderPass> &task, OUT bool &useSecondary);
+		void  _BeginSubpass (const VFgTask<SubmitRenderPass> &task, OUT bool &useSecondary);
 		bool  _CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses);
+		bool  _PrepareSecondaryCmdbufs (const VFgTask<SubmitRenderPass> &task);
+		void  _RecordSecondaryCmdbufs (const VFgTask<SubmitRenderPass> &task);
+		void  _RecordSecondary (const VFgTask<SubmitRenderPass> &task, ArrayView<IDrawTask *> drawTasks);
 
 		void  _ExtractDescriptorSets (const VPipelineLayout &, const VPipelineResourceSet &, OUT VkDescriptorSets_t &);
 		void  _BindPipelineResources (const VPipelineLayout &layout, const VPipelineResourceSet &resourceSet, VkPipelineBindPoint bindPoint, ShaderDbgIndex debugModeIndex);
-		bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VPipelineLayout const* &pplnLayout);
-		bool  _BindPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VPipelineLayout const* &pplnLayout);
+		bool  _GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawVerticesTask &task, OUT VkPipeline &pipeline, OUT VPipelineLayout const* &pplnLayout);
+		bool  _GetPipeline (const VLogicalRenderPass &logicalRP, const VBaseDrawMeshes &task, OUT VkPipeline &pipeline, OUT VPipelineLayout const* &pplnLayout);
 		void  _BindPipeline2 (const VLogicalRenderPass &logicalRP, VkPipeline pipelineId);
 		bool  _BindPipeline (const VComputePipeline* pipeline, const Optional<uint3> &localSize, ShaderDbgIndex debugModeIndex,
 							 VkPipelineCreateFlags flags, OUT VPipelineLayout const* &pplnLayout);
-		void  _PushConstants (const VPipelineLayout &layout, const _fg_hidden_::PushConstants_t &pc) const;
+		void  _PushConstants (const VPipelineLayout &layout, const _fg_hidden_::PushConstants_t &pc, uint perDrawCount = 0) const;
 		void  _SetScissor (const VLogicalRenderPass &, ArrayView<RectI>);
 		void  _SetDynamicStates (const _fg_hidden_::DynamicStates &) const;
 		void  _BindShadingRateImage (VkImageView view);
@@ -179,6 +223,10 @@ namespace FG
 		void  _AddRTScene (const VLocalRTScene *scene, EResourceState state);
 
 		void  _BindIndexBuffer (VkBuffer indexBuffer, VkDeviceSize indexOffset, VkIndexType indexType);
+		void  _BindVertexBuffers (uint firstBinding, ArrayView<VkBuffer> buffers, ArrayView<VkDeviceSize> offsets);
+		void  _BindDescriptorSets (VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint firstSet,
+								   ArrayView<VkDescriptorSet> descriptorSets, ArrayView<uint> dynamicOffsets);
+		void  _ResetDescriptorSets (VkPipelineBindPoint bindPoint);
 
 		ND_ Statistic_t&  Stat () const;
 	};
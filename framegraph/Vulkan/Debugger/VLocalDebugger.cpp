@@ -81,6 +81,38 @@ namespace {
 		_tasks[idx] = TaskInfo{task};
 	}
 	
+/*
+=================================================
+	AddSetEvent
+=================================================
+*/
+	void VLocalDebugger::AddSetEvent (ExeOrderIndex index, VkPipelineStageFlags stages)
+	{
+		if ( not AllBits( _flags, EDebugFlags::LogTasks | EDebugFlags::LogSplitBarriers ))
+			return;
+
+		const size_t	idx = size_t(index);
+		CHECK_ERRV( idx < _tasks.size() );
+
+		_tasks[idx].setEvent = stages;
+	}
+	
+/*
+=================================================
+	AddWaitEvent
+=================================================
+*/
+	void VLocalDebugger::AddWaitEvent (ExeOrderIndex srcIndex, ExeOrderIndex dstIndex)
+	{
+		if ( not AllBits( _flags, EDebugFlags::LogTasks | EDebugFlags::LogSplitBarriers ))
+			return;
+
+		const size_t	idx = size_t(dstIndex);
+		CHECK_ERRV( idx < _tasks.size() );
+
+		_tasks[idx].waitEvents.push_back( srcIndex );
+	}
+
 /*
 =================================================
 	AddHostWriteAccess
@@ -534,8 +566,24 @@ namespace {
 			}
 			str << " }\n";
 
+			if ( info.waitEvents.size() )
+			{
+				str << indent << "	waitEvents = { ";
+				for (auto& idx : info.waitEvents)
+				{
+					if ( &idx != info.waitEvents.data() )
+						str << ", ";
+
+					str << _GetTaskName( idx );
+				}
+				str << " }\n";
+			}
+
 			_DumpResourceUsage( info.resources, INOUT str );
 
+			if ( info.setEvent )
+				str << indent << "	setEvent: " << VkPipelineStage_ToString( info.setEvent ) << '\n';
+
 			//_DumpTaskData( info.task, INOUT str );
 			
 			str << indent << "}\n";
@@ -63,6 +63,8 @@ namespace FG
 		{
 			VTask					task		= null;
 			Array<ResourceUsage_t>	resources;
+			VkPipelineStageFlags	setEvent	= 0;		// stages that are used in 'vkCmdSetEvent' after task
+			Array<ExeOrderIndex>	waitEvents;				// tasks that set events which are waited before this task
 			mutable String			anyNode;
 
 			TaskInfo () {}
@@ -148,6 +150,9 @@ namespace FG
 
 		void AddTask (VTask task);
 
+		void AddSetEvent (ExeOrderIndex index, VkPipelineStageFlags stages);
+		void AddWaitEvent (ExeOrderIndex srcIndex, ExeOrderIndex dstIndex);
+
 
 	// dump to string
 	private:
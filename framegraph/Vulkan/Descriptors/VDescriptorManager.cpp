@@ -23,7 +23,10 @@ namespace FG
 */
 	VDescriptorManager::~VDescriptorManager ()
 	{
-		CHECK( _descriptorPools.empty() );
+		for (auto& chain : _chains) {
+			CHECK( chain.pools.empty() );
+		}
+		CHECK( _freeLocalPools.empty() );
 	}
 	
 /*
@@ -33,9 +36,13 @@ namespace FG
 */
 	bool VDescriptorManager::Initialize ()
 	{
-		EXLOCK( _guard );
+		auto&	chain = _chains[0];
+		EXLOCK( chain.guard );
+
+		VkDescriptorPool	pool;
+		CHECK_ERR( _CreateDescriptorPool( MaxDescriptorSets, MaxDescriptorPoolSize, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, OUT pool ));
 
-		CHECK_ERR( _CreateDescriptorPool() );
+		chain.pools.push_back( pool );
 		return true;
 	}
 	
@@ -46,19 +53,37 @@ namespace FG
 */
 	void VDescriptorManager::Deinitialize ()
 	{
-		EXLOCK( _guard );
-
-		for (auto& item : _descriptorPools)
+		for (auto& chain : _chains)
 		{
-			//EXLOCK( item.guard );
+			EXLOCK( chain.guard );
 
-			if ( item.pool )
-			{
-				_device.vkDestroyDescriptorPool( _device.GetVkDevice(), item.pool, null );
-				item.pool = VK_NULL_HANDLE;
+			for (auto& pool : chain.pools) {
+				_device.vkDestroyDescriptorPool( _device.GetVkDevice(), pool, null );
 			}
+			chain.pools.clear();
 		}
-		_descriptorPools.clear();
+
+		EXLOCK( _localGuard );
+		for (auto& pool : _freeLocalPools) {
+			_device.vkDestroyDescriptorPool( _device.GetVkDevice(), pool, null );
+		}
+		_freeLocalPools.clear();
+	}
+	
+/*
+=================================================
+	_CurrentChainIndex
+----
+	chain is assigned to the thread at first allocation in round-robin order,
+	so up to 'ChainCount' threads never wait each other.
+=================================================
+*/
+	uint  VDescriptorManager::_CurrentChainIndex ()
+	{
+		static Atomic<uint>			thread_counter	{0};
+		static thread_local uint	chain_index		= thread_counter.fetch_add( 1, memory_order_relaxed ) % ChainCount;
+
+		return chain_index;
 	}
 	
 /*
@@ -68,30 +93,35 @@ namespace FG
 */
 	bool  VDescriptorManager::AllocDescriptorSet (VkDescriptorSetLayout layout, OUT DescriptorSet &ds)
 	{
-		EXLOCK( _guard );
+		const uint	chain_idx	= _CurrentChainIndex();
+		auto&		chain		= _chains[ chain_idx ];
+		EXLOCK( chain.guard );
 
 		VkDescriptorSetAllocateInfo		info = {};
 		info.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		info.descriptorSetCount	= 1;
 		info.pSetLayouts		= &layout;
 
-		for (auto& item : _descriptorPools)
+		for (size_t i = 0; i < chain.pools.size(); ++i)
 		{
-			//EXLOCK( item.guard );
-			info.descriptorPool = item.pool;
+			info.descriptorPool = chain.pools[i];
 			
 			if ( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds.first ) == VK_SUCCESS )
 			{
-				ds.second = uint8_t(Distance( _descriptorPools.data(), &item ));
+				ds.second = uint8_t(chain_idx * MaxPoolsPerChain + i);
 				return true;
 			}
 		}
 
-		CHECK_ERR( _CreateDescriptorPool() );
-		
-		info.descriptorPool = _descriptorPools.back().pool;
+		CHECK_ERR( chain.pools.size() < chain.pools.capacity() );
+
+		VkDescriptorPool	pool;
+		CHECK_ERR( _CreateDescriptorPool( MaxDescriptorSets, MaxDescriptorPoolSize, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, OUT pool ));
+		chain.pools.push_back( pool );
+
+		info.descriptorPool = pool;
 		VK_CHECK( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds.first ));
-		ds.second = uint8_t(_descriptorPools.size() - 1);
+		ds.second = uint8_t(chain_idx * MaxPoolsPerChain + chain.pools.size() - 1);
 
 		return true;
 	}
@@ -103,11 +133,7 @@ namespace FG
 */
 	bool  VDescriptorManager::DeallocDescriptorSet (const DescriptorSet &ds)
 	{
-		EXLOCK( _guard );
-		CHECK_ERR( ds.second < _descriptorPools.size() );
-
-		VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[ds.second].pool, 1, &ds.first ));
-		return true;
+		return DeallocDescriptorSets({ ds });
 	}
 	
 /*
@@ -117,54 +143,139 @@ namespace FG
 */
 	bool  VDescriptorManager::DeallocDescriptorSets (ArrayView<DescriptorSet> descSets)
 	{
-		EXLOCK( _guard );
-
 		FixedArray< VkDescriptorSet, 32 >	temp;
-		uint8_t								last_idx = UMax;
+		uint8_t								last_idx	= UMax;
+		bool								result		= true;
 
-		for (auto& ds : descSets)
+		const auto	Flush = [this, &temp, &result] (uint8_t poolIdx)
 		{
-			if ( last_idx != ds.second and temp.size() )
-			{
-				VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[last_idx].pool, uint(temp.size()), temp.data() ));
-				temp.clear();
+			auto&	chain	= _chains[ poolIdx / MaxPoolsPerChain ];
+			uint	idx		= poolIdx % MaxPoolsPerChain;
+			EXLOCK( chain.guard );
+
+			if ( idx < chain.pools.size() ) {
+				VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), chain.pools[idx], uint(temp.size()), temp.data() ));
+			} else {
+				result = false;
 			}
+			temp.clear();
+		};
+
+		for (auto& ds : descSets)
+		{
+			if ( (last_idx != ds.second and temp.size()) or temp.size() == temp.capacity() )
+				Flush( last_idx );
 
 			last_idx = ds.second;
 			temp.push_back( ds.first );
 		}
 
 		if ( temp.size() )
+			Flush( last_idx );
+
+		CHECK_ERR( result );
+		return true;
+	}
+
+/*
+=================================================
+	AllocLocalDescriptorSet
+----
+	'pools' is owned by single thread, so allocation doesn't need synchronization,
+	only new pool is requested under lock.
+=================================================
+*/
+	bool  VDescriptorManager::AllocLocalDescriptorSet (VkDescriptorSetLayout layout, INOUT LocalPools_t &pools, OUT VkDescriptorSet &ds)
+	{
+		VkDescriptorSetAllocateInfo		info = {};
+		info.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		info.descriptorSetCount	= 1;
+		info.pSetLayouts		= &layout;
+
+		if ( pools.size() )
 		{
-			VK_CALL( _device.vkFreeDescriptorSets( _device.GetVkDevice(), _descriptorPools[last_idx].pool, uint(temp.size()), temp.data() ));
+			info.descriptorPool = pools.back();
+
+			if ( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds ) == VK_SUCCESS )
+				return true;
 		}
+
+		CHECK_ERR( _CreateLocalPool( INOUT pools ));
+
+		info.descriptorPool = pools.back();
+		VK_CHECK( _device.vkAllocateDescriptorSets( _device.GetVkDevice(), &info, OUT &ds ));
 		return true;
 	}
 
 /*
 =================================================
-	_CreateDescriptorPool
+	ReleaseLocalPools
+----
+	all descriptor sets are released at once by resetting the pool.
+=================================================
+*/
+	void  VDescriptorManager::ReleaseLocalPools (INOUT LocalPools_t &pools)
+	{
+		if ( pools.empty() )
+			return;
+
+		for (auto& pool : pools) {
+			VK_CALL( _device.vkResetDescriptorPool( _device.GetVkDevice(), pool, 0 ));
+		}
+
+		EXLOCK( _localGuard );
+		_freeLocalPools.insert( _freeLocalPools.end(), pools.begin(), pools.end() );
+		pools.clear();
+	}
+
+/*
+=================================================
+	_CreateLocalPool
 =================================================
 */
-	bool  VDescriptorManager::_CreateDescriptorPool ()
+	bool  VDescriptorManager::_CreateLocalPool (INOUT LocalPools_t &pools)
 	{
-		CHECK_ERR( _descriptorPools.size() < _descriptorPools.capacity() );
+		// reuse released pool
+		{
+			EXLOCK( _localGuard );
+
+			if ( _freeLocalPools.size() )
+			{
+				pools.push_back( _freeLocalPools.back() );
+				_freeLocalPools.pop_back();
+				return true;
+			}
+		}
+
+		VkDescriptorPool	pool;
+		CHECK_ERR( _CreateDescriptorPool( MaxDescriptorSets / LocalPoolSizeFactor, MaxDescriptorPoolSize / LocalPoolSizeFactor, 0, OUT pool ));
+
+		pools.push_back( pool );
+		return true;
+	}
 
+/*
+=================================================
+	_CreateDescriptorPool
+=================================================
+*/
+	bool  VDescriptorManager::_CreateDescriptorPool (uint maxSets, uint poolSize, VkDescriptorPoolCreateFlags flags, OUT VkDescriptorPool &pool) const
+	{
 		FixedArray< VkDescriptorPoolSize, 32 >	pool_sizes;
 
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLER,						MaxDescriptorPoolSize });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,		MaxDescriptorPoolSize * 4 });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,				MaxDescriptorPoolSize });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,				MaxDescriptorPoolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_SAMPLER,						poolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,		poolSize * 4 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,				poolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,				poolSize });
 
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,				MaxDescriptorPoolSize * 4 });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,				MaxDescriptorPoolSize * 2 });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,		MaxDescriptorPoolSize });
-		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,		MaxDescriptorPoolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,				poolSize * 4 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,				poolSize * 2 });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,		poolSize });
+		pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,		poolSize });
 		
 		#ifdef VK_NV_ray_tracing
 		if ( _device.GetFeatures().rayTracingNV ) {
-			pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV, MaxDescriptorPoolSize });
+			pool_sizes.push_back({ VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV, poolSize });
 		}
 		#endif
 
@@ -173,13 +284,10 @@ namespace FG
 		info.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		info.poolSizeCount	= uint(pool_sizes.size());
 		info.pPoolSizes		= pool_sizes.data();
-		info.maxSets		= MaxDescriptorSets;
-		info.flags			= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-
-		VkDescriptorPool	ds_pool;
-		VK_CHECK( _device.vkCreateDescriptorPool( _device.GetVkDevice(), &info, null, OUT &ds_pool ));
+		info.maxSets		= maxSets;
+		info.flags			= flags;
 
-		_descriptorPools.push_back({ ds_pool });
+		VK_CHECK( _device.vkCreateDescriptorPool( _device.GetVkDevice(), &info, null, OUT &pool ));
 		return true;
 	}
 
@@ -1,4 +1,12 @@
 // Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Descriptor sets of cached pipeline resources are allocated from global pools,
+	global pools are split into chains, each thread uses its own chain to avoid lock contention.
+
+	Descriptor sets that are used only by single command batch (shader debugger storage buffers)
+	are allocated from local pools, local pools are reset when batch execution is complete.
+	Cached pipeline resources are shared between batches and can't use local pools.
+*/
 
 #pragma once
 
@@ -14,16 +22,25 @@ namespace FG
 	class VDescriptorManager final
 	{
 	// types
+	public:
+		using LocalPools_t				= Array< VkDescriptorPool >;	// last pool is used for allocation
+
 	private:
 		static constexpr uint	MaxDescriptorPoolSize	= 1u << 11;
 		static constexpr uint	MaxDescriptorSets		= 1u << 10;
+		static constexpr uint	LocalPoolSizeFactor		= 8;		// local pool is 8 times smaller than global pool
+		static constexpr uint	ChainCount				= 8;		// max number of threads that don't share chain
+		static constexpr uint	MaxPoolsPerChain		= 8;
+
+		STATIC_ASSERT( ChainCount * MaxPoolsPerChain <= 0xFF );
 
-		struct DSPool
+		struct DSPoolChain
 		{
-			VkDescriptorPool	pool	= VK_NULL_HANDLE;
+			Mutex												guard;
+			FixedArray< VkDescriptorPool, MaxPoolsPerChain >	pools;
 		};
 
-		using DescriptorPoolArray_t		= FixedArray< DSPool, 8 >;
+		using DescriptorPoolChains_t	= StaticArray< DSPoolChain, ChainCount >;
 		using DescriptorSet				= VDescriptorSetLayout::DescriptorSet;
 
 
@@ -31,8 +48,10 @@ namespace FG
 	private:
 		VDevice const&				_device;
 
-		Mutex						_guard;
-		DescriptorPoolArray_t		_descriptorPools;
+		DescriptorPoolChains_t		_chains;
+
+		Mutex						_localGuard;
+		LocalPools_t				_freeLocalPools;
 
 
 	// methods
@@ -47,8 +66,14 @@ namespace FG
 		bool DeallocDescriptorSet (const DescriptorSet &ds);
 		bool DeallocDescriptorSets (ArrayView<DescriptorSet> ds);
 
+		bool AllocLocalDescriptorSet (VkDescriptorSetLayout layout, INOUT LocalPools_t &pools, OUT VkDescriptorSet &ds);
+		void ReleaseLocalPools (INOUT LocalPools_t &pools);
+
 	private:
-		bool _CreateDescriptorPool ();
+		ND_ static uint  _CurrentChainIndex ();
+
+		bool _CreateDescriptorPool (uint maxSets, uint poolSize, VkDescriptorPoolCreateFlags flags, OUT VkDescriptorPool &pool) const;
+		bool _CreateLocalPool (INOUT LocalPools_t &pools);
 	};
 
 
@@ -203,6 +203,17 @@ namespace FG
 		}
 	}
 
+/*
+=================================================
+	SetTransient
+=================================================
+*/
+	void VLocalImage::SetTransient () const
+	{
+		SetInitialState( false, true );
+		_isTransient = true;
+	}
+
 /*
 =================================================
 	AddPendingState
@@ -304,6 +315,13 @@ namespace FG
 	{
 		ASSERT( _pendingAccesses.empty() and "you must commit all pending states before reseting" );
 		
+		// memory may be reused by another transient resource, layout transition will corrupt its content
+		if ( _isTransient )
+		{
+			_accessForReadWrite.clear();
+			return;
+		}
+
 		// add full range barrier
 		{
 			ImageAccess		pending;
@@ -371,7 +389,7 @@ namespace FG
 					ASSERT( barrier.subresourceRange.layerCount > 0 );
 
 					dst_stages |= pending.stages;
-					barrierMngr.AddImageBarrier( iter->stages, pending.stages, 0, barrier );
+					barrierMngr.AddImageBarrier( iter->stages, pending.stages, 0, iter->index, barrier );
 
 					if ( debugger ) {
 						debugger->AddImageBarrier( _imageData.get(), iter->index, pending.index, iter->stages, pending.stages, 0, barrier );
@@ -70,6 +70,7 @@ namespace FG
 		mutable AccessRecords_t		_pendingAccesses;
 		mutable AccessRecords_t		_accessForReadWrite;
 		mutable bool				_isImmutable	= false;
+		mutable bool				_isTransient	= false;	// content is undefined before first use and discarded after last use
 
 
 	// methods
@@ -83,6 +84,7 @@ namespace FG
 		void Destroy ();
 
 		void SetInitialState (bool immutable, bool invalidate) const;
+		void SetTransient () const;
 		void AddPendingState (const ImageState &) const;
 		void ResetState (ExeOrderIndex index, VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
 		void CommitBarrier (VBarrierManager &barrierMngr, Ptr<VLocalDebugger> debugger) const;
@@ -24,7 +24,9 @@ namespace FG
 	VFrameGraph::VFrameGraph (const VulkanDeviceInfo &vdi) :
 		_state{ EState::Initial },	_device{ vdi },
 		_queueUsage{ Default },		_resourceMngr{ _device, vdi.maxStagingBufferMemory, vdi.stagingBufferSize },
-		_queryPool{ VK_NULL_HANDLE }
+		_queryPool{ VK_NULL_HANDLE },
+		_pplnCacheVersion{ 0 },
+		_pendingPipelines{ 0 },		_compiledPipelines{ 0 }
 	{
 	}
 	
@@ -81,6 +83,12 @@ namespace FG
 		}
 
 		CHECK_ERR( _resourceMngr.Initialize() );
+
+		// create pipeline cache
+		{
+			EXLOCK( _pplnCacheGuard );
+			CHECK_ERR( _pipelineCache.Initialize( _device ));
+		}
 		
 		CHECK_ERR( _SetState( EState::Initialization, EState::Idle ));
 		return true;
@@ -96,6 +104,17 @@ namespace FG
 		CHECK_ERRV( _SetState( EState::Idle, EState::Destroyed ));
 		CHECK_ERRV( WaitIdle( MaxTimeout ));
 
+		// complete pipeline compilation, remaining jobs will be processed in current thread
+		_compilerPool.Release();
+		{
+			EXLOCK( _compilerGuard );
+
+			for (auto& c : _compilerCaches) {
+				c->cache.Deinitialize( _device );
+			}
+			_compilerCaches.clear();
+		}
+
 		// delete command buffers
 		{
 			FG_LOGD( "Max command buffers "s << ToString(_cmdBufferPool.CreatedObjectsCount()) );
@@ -130,10 +149,168 @@ namespace FG
 			_queryPool = VK_NULL_HANDLE;
 		}
 
+		// command buffers are destroyed, so global cache can be destroyed too
+		{
+			EXLOCK( _pplnCacheGuard );
+			_pipelineCache.Deinitialize( _device );
+		}
+
+		// stop worker threads
+		{
+			EXLOCK( _workerGuard );
+			_workerPool.Release();
+		}
+
 		_shaderDebugCallback = {};
 		_resourceMngr.Deinitialize();
 	}
 	
+/*
+=================================================
+	GetWorkerPool
+=================================================
+*/
+	ThreadPool&  VFrameGraph::GetWorkerPool ()
+	{
+		EXLOCK( _workerGuard );
+
+		if ( not _workerPool.IsCreated() )
+		{
+			// main thread will help to process jobs, so one core is reserved for it
+			const uint	count = Max( std::thread::hardware_concurrency(), 2u ) - 1;
+
+			CHECK( _workerPool.Create( Min( count, VCommandBuffer::MaxSecondaryPools - 1 ), "FGWorker" ));
+		}
+		return _workerPool;
+	}
+	
+/*
+=================================================
+	InitPipelineCache
+----
+	recreate command buffer local cache if global cache was reloaded.
+	Local cache is used without synchronization and merged into global cache after command buffer baking.
+=================================================
+*/
+	bool  VFrameGraph::InitPipelineCache (INOUT VPipelineCache &localCache, INOUT uint &version)
+	{
+		if ( localCache.IsCreated() and version == _pplnCacheVersion.load( memory_order_relaxed ))
+			return true;
+
+		EXLOCK( _pplnCacheGuard );
+
+		if ( localCache.IsCreated() )
+		{
+			if ( localCache.IsChanged() )
+				CHECK( _pipelineCache.MergeCache( _device, localCache ));
+
+			localCache.Deinitialize( _device );
+		}
+
+		Array<uint8_t>	data;
+		CHECK( _pipelineCache.GetCacheData( _device, OUT data ));
+		CHECK_ERR( localCache.Initialize( _device, data ));
+
+		version = _pplnCacheVersion.load( memory_order_relaxed );
+		return true;
+	}
+	
+/*
+=================================================
+	MergePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::MergePipelineCache (VPipelineCache &localCache)
+	{
+		if ( not localCache.IsChanged() )
+			return true;
+
+		EXLOCK( _pplnCacheGuard );
+		return _pipelineCache.MergeCache( _device, localCache );
+	}
+	
+/*
+=================================================
+	EnqueuePipelineCompilation
+----
+	each compiler thread uses its own pipeline cache,
+	caches are merged into global cache after each compilation.
+=================================================
+*/
+	void  VFrameGraph::EnqueuePipelineCompilation (PipelineCompileJob_t &&job)
+	{
+		EXLOCK( _compilerGuard );
+
+		if ( not _compilerPool.IsCreated() )
+		{
+			// keep some cores for rendering
+			const uint	count = Max( std::thread::hardware_concurrency() / 4, 1u );
+
+			CHECK( _compilerPool.Create( count, "FGCompiler" ));
+		}
+
+		_pendingPipelines.fetch_add( 1, memory_order_relaxed );
+
+		_compilerPool.Enqueue( [this, job = std::move(job)] ()
+		{
+			UniquePtr<CompilerCache>	cc;
+			{
+				EXLOCK( _compilerGuard );
+				if ( _compilerCaches.size() ) {
+					cc = std::move( _compilerCaches.back() );
+					_compilerCaches.pop_back();
+				}
+			}
+			if ( not cc )
+				cc.reset( new CompilerCache{} );
+
+			// pipeline can be created without cache if something goes wrong
+			CHECK( InitPipelineCache( INOUT cc->cache, INOUT cc->version ));
+
+			const bool	stored = job( _resourceMngr, cc->cache );
+
+			CHECK( MergePipelineCache( cc->cache ));
+			{
+				EXLOCK( _compilerGuard );
+				_compilerCaches.push_back( std::move(cc) );
+			}
+
+			_pendingPipelines.fetch_sub( 1, memory_order_relaxed );
+
+			if ( stored )
+				_compiledPipelines.fetch_add( 1, memory_order_relaxed );
+		});
+	}
+
+/*
+=================================================
+	LoadPipelineCache
+=================================================
+*/
+	bool  VFrameGraph::LoadPipelineCache (RStream &stream)
+	{
+		CHECK_ERR( _IsInitialized() );
+		
+		EXLOCK( _pplnCacheGuard );
+		CHECK_ERR( _pipelineCache.Load( _device, stream ));
+
+		_pplnCacheVersion.fetch_add( 1, memory_order_relaxed );
+		return true;
+	}
+	
+/*
+=================================================
+	SavePipelineCache
+=================================================
+*/
+	bool  VFrameGraph::SavePipelineCache (WStream &stream)
+	{
+		CHECK_ERR( _IsInitialized() );
+		
+		EXLOCK( _pplnCacheGuard );
+		return _pipelineCache.Save( _device, stream );
+	}
+
 /*
 =================================================
 	AddPipelineCompiler
@@ -696,6 +873,17 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	SetCacheEvictionSubmits
+=================================================
+*/
+	void  VFrameGraph::SetCacheEvictionSubmits (uint submits)
+	{
+		ASSERT( _IsInitialized() );
+		_resourceMngr.SetCacheEvictionSubmits( submits );
+	}
+	
 /*
 =================================================
 	Begin
@@ -787,6 +975,34 @@ namespace FG
 		return true;
 	}
 	
+/*
+=================================================
+	EnqueueUpload
+=================================================
+*/
+	bool  VFrameGraph::EnqueueUpload (const UpdateBuffer &task, UploadCallback_t &&callback)
+	{
+		ASSERT( _IsInitialized() );
+		return _resourceMngr.EnqueueUpload( task, std::move(callback) );
+	}
+
+	bool  VFrameGraph::EnqueueUpload (const UpdateImage &task, UploadCallback_t &&callback)
+	{
+		ASSERT( _IsInitialized() );
+		return _resourceMngr.EnqueueUpload( task, std::move(callback) );
+	}
+	
+/*
+=================================================
+	SetUploadBudget
+=================================================
+*/
+	void  VFrameGraph::SetUploadBudget (BytesU bytesPerCommandBuffer, EQueueType queue)
+	{
+		ASSERT( _IsInitialized() );
+		_resourceMngr.SetUploadBudget( bytesPerCommandBuffer, queue );
+	}
+	
 /*
 =================================================
 	_CreateSemaphore
@@ -1247,6 +1463,12 @@ namespace FG
 		result = _lastStatistic;
 		result.renderer.submitingTime   = Nanoseconds{_submitingTime.exchange( 0, memory_order_relaxed )};
 		result.renderer.waitingTime	 = Nanoseconds{_waitingTime.exchange( 0, memory_order_relaxed )};
+
+		result.resources.pendingPipelineInstances	= _pendingPipelines.load( memory_order_relaxed );
+		result.resources.compiledPipelineInstances	= _compiledPipelines.exchange( 0, memory_order_relaxed );
+		result.resources.newGraphicsPipelineCount	+= result.resources.compiledPipelineInstances;
+
+		_resourceMngr.GetCacheStatistics( INOUT result.resources );
 		
 		_lastStatistic = Default;
 		return true;
@@ -7,7 +7,9 @@
 #include "VDevice.h"
 #include "VCmdBatch.h"
 #include "VDebugger.h"
+#include "VPipelineCache.h"
 #include "stl/ThreadSafe/LfIndexedPool.h"
+#include "stl/ThreadSafe/ThreadPool.h"
 
 namespace FG
 {
@@ -19,6 +21,9 @@ namespace FG
 	class VFrameGraph final : public IFrameGraph
 	{
 	// types
+	public:
+		using PipelineCompileJob_t	= Function< bool (VResourceManager &, VPipelineCache &) >;	// returns 'true' if new pipeline was stored
+
 	private:
 		enum class EState : uint
 		{
@@ -53,6 +58,13 @@ namespace FG
 		using Fences_t			= Array< VkFence >;
 		using Semaphores_t		= Array< VkSemaphore >;
 
+		struct CompilerCache
+		{
+			VPipelineCache			cache;
+			uint					version		= 0;
+		};
+		using CompilerCaches_t	= Array< UniquePtr< CompilerCache >>;
+
 
 	// variables
 	private:
@@ -74,6 +86,19 @@ namespace FG
 
 		ShaderDebugCallback_t	_shaderDebugCallback;
 
+		Mutex					_pplnCacheGuard;
+		VPipelineCache			_pipelineCache;		// all command buffer caches are merged into it
+		Atomic<uint>			_pplnCacheVersion;	// incremented when cache is loaded, command buffers must recreate local caches
+
+		Mutex					_workerGuard;
+		ThreadPool				_workerPool;		// for parallel command buffer recording, created on demand
+
+		Mutex					_compilerGuard;
+		ThreadPool				_compilerPool;		// for async pipeline compilation, created on demand
+		CompilerCaches_t		_compilerCaches;	// unused caches
+		Atomic<uint>			_pendingPipelines;
+		Atomic<uint>			_compiledPipelines;	// number of stored pipelines
+
 		mutable Mutex			_statisticGuard;
 		mutable Statistics		_lastStatistic;
 
@@ -189,11 +214,20 @@ namespace FG
 		
 		bool			UpdateHostBuffer (RawBufferID id, BytesU offset, BytesU size, const void *data) override;
 		bool			MapBufferRange (RawBufferID id, BytesU offset, INOUT BytesU &size, OUT void* &data) override;
+		void			SetCacheEvictionSubmits (uint submits) override;
+
+
+		// pipeline cache //
+		bool			LoadPipelineCache (RStream &stream) override;
+		bool			SavePipelineCache (WStream &stream) override;
 
 
 		// frame execution //
 		CommandBuffer	Begin (const CommandBufferDesc &, ArrayView<CommandBuffer> dependsOn) override;
 		bool			Execute (INOUT CommandBuffer &) override;
+		bool			EnqueueUpload (const UpdateBuffer &, UploadCallback_t &&) override;
+		bool			EnqueueUpload (const UpdateImage &, UploadCallback_t &&) override;
+		void			SetUploadBudget (BytesU bytesPerCommandBuffer, EQueueType queue) override;
 		bool			Wait (ArrayView<CommandBuffer> commands, Nanoseconds timeout) override;
 		bool			Flush (EQueueUsage queues) override;
 		bool			WaitIdle (Nanoseconds timeout) override;
@@ -213,6 +247,11 @@ namespace FG
 		ND_ VDevice const&		GetDevice ()				const	{ return _device; }
 		ND_ VResourceManager &	GetResourceManager ()				{ return _resourceMngr; }
 		ND_ VkQueryPool			GetQueryPool ()				const	{ return _queryPool; }
+		ND_ ThreadPool &		GetWorkerPool ();
+
+			bool				InitPipelineCache (INOUT VPipelineCache &localCache, INOUT uint &version);
+			bool				MergePipelineCache (VPipelineCache &localCache);
+			void				EnqueuePipelineCompilation (PipelineCompileJob_t &&job);
 
 
 	private:
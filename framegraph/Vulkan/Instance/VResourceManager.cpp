@@ -5,6 +5,7 @@
 #include "VEnumCast.h"
 #include "stl/Algorithms/StringUtils.h"
 #include "Shared/PipelineResourcesHelper.h"
+#include "Shared/EnumUtils.h"
 
 namespace FG
 {
@@ -101,6 +102,8 @@ namespace FG
 	void  VResourceManager::Deinitialize ()
 	{
 		_DestroyStagingBuffers();
+		_DestroyRayTracingBuffers();
+		_DestroyUploadQueue();
 		_DestroyShaderDebuggerResources();
 
 		_DestroyResourceCache( INOUT _samplerCache );
@@ -128,6 +131,16 @@ namespace FG
 			EXLOCK( _compilersGuard );
 			_compilers.clear();
 		}
+
+		// release events
+		{
+			EXLOCK( _eventGuard );
+
+			for (auto& ev : _freeEvents) {
+				_device.vkDestroyEvent( _device.GetVkDevice(), ev, null );
+			}
+			_freeEvents.clear();
+		}
 		
 		_descMngr.Deinitialize();
 		_memoryMngr.Deinitialize();
@@ -151,7 +164,80 @@ namespace FG
 */
 	void  VResourceManager::OnSubmit ()
 	{
-		_submissionCounter.fetch_add( 1, memory_order_relaxed );
+		const uint	submit_idx	= _submissionCounter.fetch_add( 1, memory_order_relaxed ) + 1;
+		const uint	max_unused	= _cacheStat.evictionSubmits.load( memory_order_relaxed );
+		
+		// render passes are not evicted: pipeline instances are searched by render pass ID
+		// and don't keep a reference to it, so recreated render pass will have new ID
+		// and all pipelines that was created for the previous render pass will be compiled again.
+		// Number of unique render passes is small compared to framebuffers and descriptor sets.
+		if ( max_unused > 0 )
+		{
+			_EvictUnusedResources( INOUT _cacheStat.lastCheckedFramebuffer, INOUT _framebufferCache, submit_idx, max_unused );
+			_EvictUnusedResources( INOUT _cacheStat.lastCheckedPipelineResource, INOUT _pplnResourcesCache, submit_idx, max_unused );
+		}
+	}
+	
+/*
+=================================================
+	_EvictUnusedResources
+----
+	cache holds one reference to framebuffers and descriptor sets,
+	if no one else uses resource during 'maxUnusedSubmits' submits then it will be destroyed.
+	Only part of the pool is checked per submit.
+=================================================
+*/
+	template <typename DataT, size_t CS, size_t MC>
+	void  VResourceManager::_EvictUnusedResources (INOUT Atomic<uint> &lastIndex, INOUT CachedPoolTmpl<DataT,CS,MC> &pool, uint submitIndex, uint maxUnusedSubmits)
+	{
+		static constexpr uint	max_iter = MaxCached / 8;
+
+		const uint	max_count = uint(pool.size());
+		if ( max_count == 0 )
+			return;
+
+		const uint	count	 = Min( max_iter, max_count );
+		const uint	last_idx = lastIndex.fetch_add( count, memory_order_relaxed ) % max_count;
+
+		for (uint i = 0; i < count; ++i)
+		{
+			uint	j		= last_idx + i;	j = (j >= max_count ? j - max_count : j);
+			Index_t	index	= Index_t(j);
+			auto&	res		= pool[ index ];
+
+			if ( not res.IsCreated() or submitIndex - res.GetLastUsage() < maxUnusedSubmits )
+				continue;
+
+			// resource may be removed from cache by 'RunValidation'
+			if ( res.TryReleaseLastRef() and pool.RemoveFromCache( index ))
+			{
+				res.Destroy( *this );
+				pool.Unassign( index );
+				_cacheStat.evictions.fetch_add( 1, memory_order_relaxed );
+			}
+		}
+	}
+	
+/*
+=================================================
+	GetCacheStatistics
+=================================================
+*/
+	void  VResourceManager::GetCacheStatistics (INOUT IFrameGraph::ResourceStatistics &result)
+	{
+		result.cacheHits		= _cacheStat.hits.exchange( 0, memory_order_relaxed );
+		result.cacheMisses		= _cacheStat.misses.exchange( 0, memory_order_relaxed );
+		result.cacheEvictions	= _cacheStat.evictions.exchange( 0, memory_order_relaxed );
+
+		result.rtBufferCreations	= _rtBuffers.creations.exchange( 0, memory_order_relaxed );
+		{
+			EXLOCK( _rtBuffers.guard );
+			result.rtBufferHighWaterMark = _rtBuffers.highWaterMark;
+		}
+		{
+			EXLOCK( _uploads.guard );
+			result.pendingUploadSize = _uploads.pendingSize;
+		}
 	}
 	
 /*
@@ -951,6 +1037,66 @@ namespace FG
 		return id;
 	}
 	
+/*
+=================================================
+	CreateMemory
+----
+	creates memory heap for transient resources
+=================================================
+*/
+	RawMemoryID  VResourceManager::CreateMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, StringView dbgName)
+	{
+		RawMemoryID					id;
+		ResourceBase<VMemoryObj>*	mem_obj	= null;
+		CHECK_ERR( _CreateMemory( OUT id, OUT mem_obj, desc, dbgName ));
+
+		if ( not mem_obj->Data().AllocateMemory( _memoryMngr, req ))
+		{
+			_Unassign( id );
+			RETURN_ERR( "failed when allocating memory" );
+		}
+
+		mem_obj->AddRef();
+		return id;
+	}
+	
+/*
+=================================================
+	BindAliasedMemory
+=================================================
+*/
+	bool  VResourceManager::BindAliasedMemory (RawImageID imageId, RawMemoryID heapId, BytesU offset, BytesU size)
+	{
+		VImage const*		image	= GetResource( imageId );
+		VMemoryObj const*	heap	= GetResource( heapId );
+		CHECK_ERR( image and heap );
+		
+		VMemoryObj::MemoryInfo	heap_info;
+		CHECK_ERR( heap->GetInfo( _memoryMngr, OUT heap_info ));
+
+		const RawMemoryID	mem_id	= image->GetMemoryID();
+		auto&				mem_obj	= _GetResourcePool( mem_id )[ mem_id.Index() ];
+		CHECK_ERR( mem_obj.IsCreated() and mem_obj.GetInstanceID() == mem_id.InstanceID() );
+
+		return mem_obj.Data().BindAliasedImage( _device, image->Handle(), heap_info, offset, size );
+	}
+	
+	bool  VResourceManager::BindAliasedMemory (RawBufferID bufferId, RawMemoryID heapId, BytesU offset, BytesU size)
+	{
+		VBuffer const*		buffer	= GetResource( bufferId );
+		VMemoryObj const*	heap	= GetResource( heapId );
+		CHECK_ERR( buffer and heap );
+		
+		VMemoryObj::MemoryInfo	heap_info;
+		CHECK_ERR( heap->GetInfo( _memoryMngr, OUT heap_info ));
+		
+		const RawMemoryID	mem_id	= buffer->GetMemoryID();
+		auto&				mem_obj	= _GetResourcePool( mem_id )[ mem_id.Index() ];
+		CHECK_ERR( mem_obj.IsCreated() and mem_obj.GetInstanceID() == mem_id.InstanceID() );
+
+		return mem_obj.Data().BindAliasedBuffer( _device, buffer->Handle(), heap_info, offset, size );
+	}
+	
 /*
 =================================================
 	CreateImage
@@ -1012,39 +1158,58 @@ namespace FG
 		auto&	data	= pool[ id.Index() ];
 		fnInit( INOUT data );
 		
-		// search in cache
-		Index_t	temp_id		= pool.Find( &data );
 		bool	is_created	= false;
 
-		if ( temp_id == UMax )
+		for (;;)
 		{
-			// create new
-			if ( not fnCreate( data ))
+			// search in cache
+			Index_t	temp_id = pool.Find( &data );
+
+			if ( temp_id == UMax )
 			{
-				_Unassign( id );
-				RETURN_ERR( errorStr );
-			}
+				// create new
+				if ( not is_created )
+				{
+					if ( not fnCreate( data ))
+					{
+						_Unassign( id );
+						RETURN_ERR( errorStr );
+					}
 
-			data.AddRef();
-			is_created = true;
+					data.AddRef();
+					is_created = true;
+				}
 			
-			// try to add to cache
-			temp_id = pool.AddToCache( id.Index() ).first;
-		}
+				// try to add to cache
+				temp_id = pool.AddToCache( id.Index() ).first;
+			}
 
-		if ( temp_id == id.Index() )
-			return id;
+			if ( temp_id == id.Index() )
+			{
+				data.SetLastUsage( GetSubmitIndex() );
+				_cacheStat.misses.fetch_add( 1, memory_order_relaxed );
+				return id;
+			}
 
-		// use already cached resource
-		auto&	temp = pool[ temp_id ];
-		temp.AddRef();
+			// use already cached resource
+			auto&	temp = pool[ temp_id ];
 
-		if ( is_created )
-			data.Destroy( *this );
+			if ( temp.TryAddRef() )
+			{
+				temp.SetLastUsage( GetSubmitIndex() );
+				_cacheStat.hits.fetch_add( 1, memory_order_relaxed );
+
+				if ( is_created )
+					data.Destroy( *this );
 		
-		_Unassign( id );
+				_Unassign( id );
 
-		return ID( temp_id, temp.GetInstanceID() );
+				return ID( temp_id, temp.GetInstanceID() );
+			}
+
+			// cached resource is destroying in another thread, wait until it is removed from cache
+			std::this_thread::yield();
+		}
 	}
 
 /*
@@ -1076,6 +1241,7 @@ namespace FG
 										},
 										[&] (auto& data) {
 											if ( data.Create( *this, dbgName )) {
+												data.AddRef();	// reference for cache, see '_EvictUnusedResources'
 												_validation.createdFramebuffers.fetch_add( 1, memory_order_relaxed );
 												return true;
 											}else{
@@ -1103,11 +1269,19 @@ namespace FG
 
 			if ( res.GetInstanceID() == id.InstanceID() )
 			{
-				if ( resourceMap.insert({ Resource_t{ id }, 1 }).second )
-					res.AddRef();
+				auto[iter, inserted] = resourceMap.insert({ Resource_t{ id }, 1 });
 				
-				ASSERT( res.Data().IsAllResourcesAlive( *this ));
-				return &res.Data();
+				if ( not inserted or res.TryAddRef() )
+				{
+					res.SetLastUsage( GetSubmitIndex() );
+					_cacheStat.hits.fetch_add( 1, memory_order_relaxed );
+
+					ASSERT( res.Data().IsAllResourcesAlive( *this ));
+					return &res.Data();
+				}
+
+				// descriptor set is destroying in another thread
+				resourceMap.erase( iter );
 			}
 		}
 	
@@ -1120,6 +1294,7 @@ namespace FG
 								   [&] (auto& data) { return Replace( data, desc ); },
 								   [&] (auto& data) {
 										if (data.Create( *this )) {
+											data.AddRef();	// reference for cache, see '_EvictUnusedResources'
 											layout.AddRef();
 											_validation.createdPplnResources.fetch_add( 1, memory_order_relaxed );
 											return true;
@@ -1133,8 +1308,8 @@ namespace FG
 
 			auto&	res = _GetResourcePool( id )[ id.Index() ];
 			
-			if ( resourceMap.insert({ Resource_t{ id }, 1 }).second )
-				res.AddRef();
+			// reference will be released when command batch is complete
+			resourceMap.insert({ Resource_t{ id }, 0 }).first->second++;
 
 			ASSERT( res.Data().IsAllResourcesAlive( *this ));
 			return &res.Data();
@@ -1168,7 +1343,7 @@ namespace FG
 
 		id = _CreateCachedResource<RawPipelineResourcesID>( "failed when creating descriptor set",
 								   [&] (auto& data) { return Replace( data, INOUT desc ); },
-								   [&] (auto& data) { if (data.Create( *this )) { layout.AddRef(); return true; }  return false; });
+								   [&] (auto& data) { if (data.Create( *this )) { data.AddRef(); layout.AddRef(); return true; }  return false; });
 
 		PipelineResourcesHelper::SetCache( desc, id );
 		return true;
@@ -1398,9 +1573,8 @@ namespace FG
 					Index_t	index	= Index_t(j);
 
 					auto&	res = pool [index];
-					if ( res.IsCreated() and not res.Data().IsAllResourcesAlive( *this ))
+					if ( res.IsCreated() and not res.Data().IsAllResourcesAlive( *this ) and pool.RemoveFromCache( index ))
 					{
-						pool.RemoveFromCache( index );
 						res.Destroy( *this );
 						pool.Unassign( index );
 					}
@@ -1609,6 +1783,515 @@ namespace FG
 		}
 	}
 	
+/*
+=================================================
+	AcquireEvent
+=================================================
+*/
+	bool  VResourceManager::AcquireEvent (OUT VkEvent &event)
+	{
+		{
+			EXLOCK( _eventGuard );
+
+			if ( _freeEvents.size() )
+			{
+				event = _freeEvents.back();
+				_freeEvents.pop_back();
+				return true;
+			}
+		}
+
+		VkEventCreateInfo	info = {};
+		info.sType	= VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+		info.flags	= 0;
+
+		VK_CHECK( _device.vkCreateEvent( _device.GetVkDevice(), &info, null, OUT &event ));
+		_device.SetObjectName( uint64_t(event), "SplitBarrierEvent", VK_OBJECT_TYPE_EVENT );
+		return true;
+	}
+	
+/*
+=================================================
+	ReleaseEvents
+----
+	events must not be used in pending command buffers
+=================================================
+*/
+	void  VResourceManager::ReleaseEvents (INOUT Array<VkEvent> &events)
+	{
+		if ( events.empty() )
+			return;
+
+		for (auto& ev : events) {
+			VK_CALL( _device.vkResetEvent( _device.GetVkDevice(), ev ));
+		}
+
+		EXLOCK( _eventGuard );
+		_freeEvents.insert( _freeEvents.end(), events.begin(), events.end() );
+		events.clear();
+	}
+	
+/*
+=================================================
+	AcquireRayTracingBuffer
+----
+	returns the smallest free buffer that fits, new buffer is created
+	with size of the high-water mark, so in most cases single buffer
+	is enough for all acceleration structures in command batch.
+=================================================
+*/
+	bool  VResourceManager::AcquireRayTracingBuffer (BytesU minSize, OUT RawBufferID &id, OUT BytesU &capacity)
+	{
+		{
+			EXLOCK( _rtBuffers.guard );
+
+			auto&	free_buffers	= _rtBuffers.freeBuffers;
+			size_t	best			= UMax;
+
+			for (size_t i = 0; i < free_buffers.size(); ++i)
+			{
+				if ( free_buffers[i].capacity >= minSize and (best == UMax or free_buffers[i].capacity < free_buffers[best].capacity) )
+					best = i;
+			}
+
+			if ( best != UMax )
+			{
+				id			= free_buffers[best].bufferId;
+				capacity	= free_buffers[best].capacity;
+				free_buffers.erase( free_buffers.begin() + best );
+				return true;
+			}
+
+			capacity = Max( minSize, _rtBuffers.highWaterMark, MinRTBufferSize );
+		}
+
+		id = CreateBuffer( BufferDesc{ capacity, EBufferUsage::TransferDst | EBufferUsage::RayTracing }, MemoryDesc{ EMemoryType::Default },
+						   EQueueFamilyMask::Unknown, "RayTracingBuffer" );
+		CHECK_ERR( id );
+
+		_rtBuffers.creations.fetch_add( 1, memory_order_relaxed );
+		return true;
+	}
+	
+/*
+=================================================
+	ReleaseRayTracingBuffers
+----
+	buffers must not be used in pending command buffers.
+	Buffers that are smaller than the high-water mark are destroyed,
+	they will be replaced by a single larger buffer.
+=================================================
+*/
+	void  VResourceManager::ReleaseRayTracingBuffers (INOUT RTBuffers_t &buffers)
+	{
+		if ( buffers.empty() )
+			return;
+
+		BytesU	used_size;
+		for (auto& buf : buffers) {
+			used_size += buf.size;
+		}
+
+		EXLOCK( _rtBuffers.guard );
+
+		_rtBuffers.highWaterMark = Max( _rtBuffers.highWaterMark, used_size );
+
+		for (auto& buf : buffers)
+		{
+			if ( buf.capacity < _rtBuffers.highWaterMark or _rtBuffers.freeBuffers.size() >= MaxFreeRTBuffers )
+			{
+				ReleaseResource( buf.bufferId );
+				continue;
+			}
+
+			buf.size = 0_b;
+			_rtBuffers.freeBuffers.push_back( buf );
+		}
+		buffers.clear();
+	}
+	
+/*
+=================================================
+	_DestroyRayTracingBuffers
+=================================================
+*/
+	void  VResourceManager::_DestroyRayTracingBuffers ()
+	{
+		EXLOCK( _rtBuffers.guard );
+
+		for (auto& buf : _rtBuffers.freeBuffers) {
+			ReleaseResource( buf.bufferId );
+		}
+		_rtBuffers.freeBuffers.clear();
+		_rtBuffers.highWaterMark = 0_b;
+	}
+
+/*
+=================================================
+	EnqueueUpload
+=================================================
+*/
+	bool  VResourceManager::EnqueueUpload (const UpdateBuffer &task, UploadCallback_t &&callback)
+	{
+		CHECK_ERR( task.dstBuffer );
+		CHECK_ERR( task.depends.empty() );	// tasks are local for command buffer
+
+		UploadRequest	req;
+		CHECK_ERR( _InitUploadRequest( task, OUT req ));
+		CHECK_ERR( AcquireResource( task.dstBuffer ));
+
+		req.task				= task;
+		req.state				= MakeShared<UploadState>();
+		req.state->callback		= std::move(callback);
+		req.state->buffer		= task.dstBuffer;
+
+		EXLOCK( _uploads.guard );
+		_uploads.pendingSize += req.totalSize;
+		_uploads.queue.push_back( std::move(req) );
+		return true;
+	}
+	
+	bool  VResourceManager::EnqueueUpload (const UpdateImage &task, UploadCallback_t &&callback)
+	{
+		CHECK_ERR( task.dstImage );
+		CHECK_ERR( task.depends.empty() );	// tasks are local for command buffer
+		CHECK_ERR( Any( task.imageSize > Zero ));
+
+		UpdateImage	img = task;
+		img.imageSize = Max( task.imageSize, 1u );
+
+		UploadRequest	req;
+		CHECK_ERR( _InitUploadRequest( img, OUT req ));
+		CHECK_ERR( AcquireResource( task.dstImage ));
+
+		req.task				= std::move(img);
+		req.state				= MakeShared<UploadState>();
+		req.state->callback		= std::move(callback);
+		req.state->image		= task.dstImage;
+
+		EXLOCK( _uploads.guard );
+		_uploads.pendingSize += req.totalSize;
+		_uploads.queue.push_back( std::move(req) );
+		return true;
+	}
+	
+/*
+=================================================
+	_InitUploadRequest (UpdateBuffer)
+=================================================
+*/
+	bool  VResourceManager::_InitUploadRequest (const UpdateBuffer &task, OUT UploadRequest &req) const
+	{
+		for (auto& reg : task.regions) {
+			req.totalSize += (reg.writer ? reg.size : ArraySizeOf(reg.data));
+		}
+		CHECK_ERR( req.totalSize > 0 );
+		return true;
+	}
+	
+/*
+=================================================
+	_InitUploadRequest (UpdateImage)
+----
+	same layout as in 'VCommandBuffer::_AddUpdateImageTask'
+=================================================
+*/
+	bool  VResourceManager::_InitUploadRequest (const UpdateImage &task, OUT UploadRequest &req) const
+	{
+		ImageDesc const&	img_desc	= GetDescription( task.dstImage );
+		const uint3			image_size	= task.imageSize;
+		const auto&			fmt_info	= EPixelFormat_GetInfo( img_desc.format );
+		const auto&			block_dim	= fmt_info.blockSize;
+		const uint			block_size	= task.aspectMask != EImageAspect::Stencil ? fmt_info.bitsPerBlock : fmt_info.bitsPerBlock2;
+
+		req.rowPitch	= Max( task.dataRowPitch, BytesU(image_size.x * block_size + block_dim.x-1) / (block_dim.x * 8) );
+		req.sliceSize	= (image_size.y * req.rowPitch + block_dim.y-1) / block_dim.y;
+		req.slicePitch	= Max( task.dataSlicePitch, req.sliceSize );
+		req.totalSize	= image_size.z > 1 ? req.slicePitch * image_size.z : req.sliceSize;
+		req.blockHeight	= block_dim.y;
+
+		CHECK_ERR( All( image_size > Zero ));
+		CHECK_ERR( task.writer or req.totalSize == ArraySizeOf(task.data) );
+
+		// single row must fit into staging buffer
+		CHECK_ERR( req.rowPitch <= _staging.writeBufPageSize );
+		return true;
+	}
+	
+/*
+=================================================
+	SetUploadBudget
+=================================================
+*/
+	void  VResourceManager::SetUploadBudget (BytesU bytesPerCommandBuffer, EQueueType queue)
+	{
+		EXLOCK( _uploads.guard );
+		_uploads.budget		= bytesPerCommandBuffer;
+		_uploads.queueType	= queue;
+	}
+	
+/*
+=================================================
+	AcquireUploads
+----
+	returns parts of the queued uploads that fit into the budget and
+	into staging memory that is not used by other tasks of the batch,
+	at least one part is returned if it fits into staging memory, even if it is larger than the budget.
+	Each part references the request state, so the request is completed only when
+	command batches of all parts are completed, even if they are executed in a different order.
+=================================================
+*/
+	void  VResourceManager::AcquireUploads (EQueueType queue, BytesU availableStaging, OUT UploadParts_t &parts)
+	{
+		EXLOCK( _uploads.guard );
+
+		if ( queue != _uploads.queueType )
+			return;
+
+		BytesU	budget = _uploads.budget > 0 ? _uploads.budget : _staging.writeBufPageSize * UploadBudgetPages;
+
+		while ( not _uploads.queue.empty() and budget > 0 )
+		{
+			auto&			req		= _uploads.queue.front();
+			const BytesU	min_size	= Max( req.rowPitch, 1_b );
+
+			if ( availableStaging < min_size or (not parts.empty() and budget < min_size) )
+				break;
+
+			auto&			part		= parts.emplace_back();
+			const BytesU	prev_offset	= req.uploaded;
+			const BytesU	max_size	= Min( Max( budget, min_size ), availableStaging );
+
+			part.state = req.state;
+			part.state->refCounter.fetch_add( 1, memory_order_relaxed );
+
+			part.size = Visit( req.task,
+						[&] (const UpdateBuffer &task)	{ return _GetUploadPart( INOUT req, task, max_size, OUT part.task ); },
+						[&] (const UpdateImage &task)	{ return _GetUploadPart( INOUT req, task, max_size, OUT part.task ); },
+						[] (const NullUnion &)			{ ASSERT(false);  return 0_b; });
+
+			budget				  = part.size < budget ? budget - part.size : 0_b;
+			availableStaging	  = part.size < availableStaging ? availableStaging - part.size : 0_b;
+			_uploads.pendingSize -= (req.uploaded - prev_offset);
+
+			// part holds a reference, so the counter can't reach zero here
+			if ( req.uploaded >= req.totalSize )
+			{
+				req.state->refCounter.fetch_sub( 1, memory_order_relaxed );
+				_uploads.queue.pop_front();
+			}
+		}
+	}
+	
+/*
+=================================================
+	ReturnUploads
+----
+	returns parts that was not recorded to the front of the queue,
+	each part becomes separate request, so they will be uploaded before other data.
+	Upload of the partially recorded part continues from the first unrecorded byte,
+	recorded data keeps the part reference until the command batch is completed,
+	so the new request takes another one.
+=================================================
+*/
+	void  VResourceManager::ReturnUploads (INOUT UploadParts_t &parts)
+	{
+		Array<UploadStatePtr>	completed;
+		{
+			EXLOCK( _uploads.guard );
+
+			for (auto iter = parts.rbegin(); iter != parts.rend(); ++iter)
+			{
+				UploadRequest	req;
+				const bool		valid = Visit( iter->task,
+											[&] (const UpdateBuffer &task)	{ return _InitUploadRequest( task, OUT req ); },
+											[&] (const UpdateImage &task)	{ return _InitUploadRequest( task, OUT req ); },
+											[] (const NullUnion &)			{ return false; });
+				if ( not valid )
+				{
+					if ( iter->recorded == 0 )
+						completed.push_back( std::move(iter->state) );
+					continue;
+				}
+
+				// upload part always contains single buffer region, see '_GetUploadPart'
+				ASSERT( not HoldsAlternative<UpdateBuffer>( iter->task ) or UnionGet<UpdateBuffer>( iter->task ).regions.size() == 1 );
+				ASSERT( iter->recorded < req.totalSize );
+
+				if ( iter->recorded > 0 )
+					iter->state->refCounter.fetch_add( 1, memory_order_relaxed );
+
+				req.task			= std::move(iter->task);
+				req.state			= std::move(iter->state);
+				req.uploaded		= iter->recorded;
+				req.regionOffset	= iter->recorded;
+
+				_uploads.pendingSize += req.totalSize - req.uploaded;
+				_uploads.queue.push_front( std::move(req) );
+			}
+			parts.clear();
+		}
+
+		// callback may enqueue new uploads, so it is called without lock
+		for (auto& state : completed) {
+			CompleteUpload( state );
+		}
+	}
+	
+/*
+=================================================
+	CompleteUpload
+----
+	called when command batch with recorded part is completed,
+	callback is called only once when all parts of the request are on the GPU side.
+=================================================
+*/
+	void  VResourceManager::CompleteUpload (const UploadStatePtr &state)
+	{
+		ASSERT( state );
+
+		if ( state->refCounter.fetch_sub( 1, memory_order_acq_rel ) != 1 )
+			return;
+
+		if ( state->callback )
+			state->callback();
+
+		_ReleaseUploadResource( *state );
+	}
+
+/*
+=================================================
+	_GetUploadPart (UpdateBuffer)
+=================================================
+*/
+	BytesU  VResourceManager::_GetUploadPart (INOUT UploadRequest &req, const UpdateBuffer &task, const BytesU budget, OUT UploadTask_t &part) const
+	{
+		const auto	RegionSize = [] (const UpdateBuffer::Region &reg) { return reg.writer ? reg.size : ArraySizeOf(reg.data); };
+
+		// skip empty regions
+		for (; RegionSize( task.regions[req.region] ) == 0; ++req.region) {}
+
+		auto&			reg			= task.regions[req.region];
+		const BytesU	reg_size	= RegionSize( reg );
+		const BytesU	size		= Min( reg_size - req.regionOffset, budget );
+		UpdateBuffer	dst;
+
+		dst.taskName	= task.taskName;
+		dst.debugColor	= task.debugColor;
+		dst.dstBuffer	= task.dstBuffer;
+
+		if ( reg.writer )
+		{
+			dst.AddDataWriter( [writer = reg.writer, base = req.regionOffset] (void* ptr, BytesU offset, BytesU partSize) { writer( ptr, base + offset, partSize ); },
+							   size, reg.offset + req.regionOffset );
+		}
+		else
+			dst.AddData( reg.data.section( size_t(req.regionOffset), size_t(size) ), reg.offset + req.regionOffset );
+
+		req.uploaded	 += size;
+		req.regionOffset += size;
+
+		if ( req.regionOffset >= reg_size )
+		{
+			++req.region;
+			req.regionOffset = 0_b;
+		}
+
+		part = std::move(dst);
+		return size;
+	}
+	
+/*
+=================================================
+	_GetUploadPart (UpdateImage)
+----
+	image is uploaded by whole slices if they fit into the budget,
+	otherwise by rows of blocks.
+=================================================
+*/
+	BytesU  VResourceManager::_GetUploadPart (INOUT UploadRequest &req, const UpdateImage &task, const BytesU budget, OUT UploadTask_t &part) const
+	{
+		const uint3		dim			= task.imageSize;
+		const uint		slice		= uint(req.uploaded / req.slicePitch);
+		const BytesU	in_slice	= req.uploaded - req.slicePitch * slice;
+		const BytesU	data_offset	= req.uploaded;
+		BytesU			size;
+		UpdateImage		dst;
+
+		dst.taskName		= task.taskName;
+		dst.debugColor		= task.debugColor;
+		dst.dstImage		= task.dstImage;
+		dst.arrayLayer		= task.arrayLayer;
+		dst.mipmapLevel		= task.mipmapLevel;
+		dst.aspectMask		= task.aspectMask;
+		dst.dataRowPitch	= req.rowPitch;
+
+		if ( in_slice == 0 and req.sliceSize <= budget )
+		{
+			const uint	count = Clamp( uint(budget / req.slicePitch), 1u, dim.z - slice );
+
+			size				= count > 1 ? req.slicePitch * count : req.sliceSize;
+			dst.imageOffset		= task.imageOffset + int3(0, 0, slice);
+			dst.imageSize		= uint3( dim.x, dim.y, count );
+			dst.dataSlicePitch	= count > 1 ? req.slicePitch : 0_b;
+			req.uploaded		= req.slicePitch * (slice + count);
+		}
+		else
+		{
+			const uint	rows	= Clamp( uint(budget / req.rowPitch), 1u, uint((req.sliceSize - in_slice) / req.rowPitch) );
+			const uint	y		= uint(in_slice / req.rowPitch) * req.blockHeight;
+
+			size			= req.rowPitch * rows;
+			dst.imageOffset	= task.imageOffset + int3(0, y, slice);
+			dst.imageSize	= uint3( dim.x, Min( rows * req.blockHeight, dim.y - y ), 1 );
+			req.uploaded	= in_slice + size < req.sliceSize ? req.uploaded + size : req.slicePitch * (slice + 1);
+		}
+
+		req.uploaded = Min( req.uploaded, req.totalSize );
+
+		if ( task.writer )
+			dst.writer = [writer = task.writer, data_offset] (void* ptr, BytesU offset, BytesU partSize) { writer( ptr, data_offset + offset, partSize ); };
+		else
+			dst.data = task.data.section( size_t(data_offset), size_t(size) );
+
+		part = std::move(dst);
+		return size;
+	}
+	
+/*
+=================================================
+	_DestroyUploadQueue
+----
+	callbacks of the pending uploads will not be called
+=================================================
+*/
+	void  VResourceManager::_DestroyUploadQueue ()
+	{
+		EXLOCK( _uploads.guard );
+
+		for (auto& req : _uploads.queue)
+		{
+			if ( req.state->refCounter.fetch_sub( 1, memory_order_acq_rel ) == 1 )
+				_ReleaseUploadResource( *req.state );
+		}
+		_uploads.queue.clear();
+		_uploads.pendingSize = 0_b;
+	}
+	
+/*
+=================================================
+	_ReleaseUploadResource
+=================================================
+*/
+	void  VResourceManager::_ReleaseUploadResource (const UploadState &state)
+	{
+		if ( state.buffer )
+			ReleaseResource( state.buffer );
+
+		if ( state.image )
+			ReleaseResource( state.image );
+	}
+
 /*
 =================================================
 	_DestroyStagingBuffers
@@ -46,14 +46,23 @@ namespace FG
 		template <typename T, size_t ChunkSize, size_t MaxChunks>
 		using CachedPoolTmpl	= CachedIndexedPool< T, Index_t, ChunkSize, MaxChunks, UntypedAlignedAllocator, AssignOpGuard_t, CacheGuard_t, AtomicPtr >;
 
+		// chunk sizes, pools grow by chunk on demand and indices are never invalidated,
+		// maximum number of chunks is limited by 16 bit index, 0xFFFF is reserved for invalid index
 		static constexpr uint	MaxImages		= 1u << 10;
 		static constexpr uint	MaxBuffers		= 1u << 10;
 		static constexpr uint	MaxMemoryObjs	= 1u << 10;
 		static constexpr uint	MaxCached		= 1u <<  9;
 		static constexpr uint	MaxRTObjects	= 1u <<  9;
 
-		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					MaxImages,		32 >;
-		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					MaxBuffers,		32 >;
+		// pooled scratch and instance buffers for acceleration structure building
+		static constexpr uint	MaxFreeRTBuffers	= 8;
+		static constexpr BytesU	MinRTBufferSize		= 64_Kb;
+
+		// default budget for queued uploads in staging buffer pages per command buffer
+		static constexpr uint	UploadBudgetPages	= 4;
+
+		using ImagePool_t			= PoolTmpl<			ResourceBase<VImage>,					MaxImages,		63 >;
+		using BufferPool_t			= PoolTmpl<			ResourceBase<VBuffer>,					MaxBuffers,		63 >;
 		using MemoryPool_t			= PoolTmpl<			ResourceBase<VMemoryObj>,				MaxMemoryObjs,	63 >;
 		using SamplerPool_t			= CachedPoolTmpl<	ResourceBase<VSampler>,					MaxCached,		 8 >;
 		using GPipelinePool_t		= PoolTmpl<			ResourceBase<VGraphicsPipeline>,		MaxCached,		 8 >;
@@ -64,7 +73,7 @@ namespace FG
 		using DSLayoutPool_t		= CachedPoolTmpl<	ResourceBase<VDescriptorSetLayout>,		MaxCached,		 8 >;
 		using RenderPassPool_t		= CachedPoolTmpl<	ResourceBase<VRenderPass>,				MaxCached,		 8 >;
 		using FramebufferPool_t		= CachedPoolTmpl<	ResourceBase<VFramebuffer>,				MaxCached,		 8 >;
-		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		MaxCached,		 8 >;
+		using PplnResourcesPool_t	= CachedPoolTmpl<	ResourceBase<VPipelineResources>,		MaxCached,		32 >;
 		using RTGeometryPool_t		= PoolTmpl<			ResourceBase<VRayTracingGeometry>,		MaxRTObjects,	16 >;
 		using RTScenePool_t			= PoolTmpl<			ResourceBase<VRayTracingScene>,			MaxRTObjects,	16 >;
 		using RTShaderTablePool_t	= PoolTmpl<			ResourceBase<VRayTracingShaderTable>,	MaxRTObjects,	16 >;
@@ -78,6 +87,45 @@ namespace FG
 		using DebugLayoutCache_t	= HashMap< uint, RawDescriptorSetLayoutID >;
 		
 		using StagingBufferfPool_t	= LfIndexedPool< BufferID, uint, 32, 2 >;
+		using RTBuffers_t			= Array< VCmdBatch::RayTracingBuffer >;
+
+		using UploadCallback_t		= IFrameGraph::UploadCallback_t;
+		using UploadTask_t			= Union< NullUnion, UpdateBuffer, UpdateImage >;
+
+		// shared between all parts of the single 'EnqueueUpload' request,
+		// callback is called and resource is released when the last reference is completed
+		struct UploadState
+		{
+			UploadCallback_t	callback;
+			RawBufferID			buffer;
+			RawImageID			image;
+			Atomic<uint>		refCounter	{1};	// queued requests and recorded parts that are not completed
+		};
+		using UploadStatePtr		= SharedPtr< UploadState >;
+
+		// part of queued upload that must be recorded into single command buffer
+		struct UploadPart
+		{
+			UploadTask_t		task;
+			BytesU				size;
+			UploadStatePtr		state;					// part holds one reference
+			BytesU				recorded;				// size of data that was recorded before staging memory is exhausted
+		};
+		using UploadParts_t			= Array< UploadPart >;
+
+		struct UploadRequest
+		{
+			UploadTask_t		task;
+			UploadStatePtr		state;			// request holds one reference
+			BytesU				totalSize;
+			BytesU				uploaded;		// for images it is offset in the source data
+			uint				region		= 0;	// in 'UpdateBuffer::regions'
+			BytesU				regionOffset;
+			BytesU				rowPitch;		// size of single row of blocks
+			BytesU				slicePitch;
+			BytesU				sliceSize;		// without padding
+			uint				blockHeight		= 1;
+		};
 
 
 	// variables
@@ -122,6 +170,9 @@ namespace FG
 
 		Atomic<uint>				_submissionCounter;
 
+		Mutex						_eventGuard;
+		Array<VkEvent>				_freeEvents;		// for split barriers, events are in unsignaled state
+
 		struct {
 			DebugLayoutCache_t			dsLayoutsCache;
 			CPipelineID					pplnFindMaxValue1;
@@ -140,6 +191,23 @@ namespace FG
 			Atomic<uint64_t>			currStagingBufferMemory		{0};
 		}							_staging;
 
+		// scratch and instance buffers for acceleration structure building
+		struct {
+			Mutex						guard;
+			RTBuffers_t					freeBuffers;				// buffers that are not used by any command batch
+			BytesU						highWaterMark;				// max memory size that was used by single command batch
+			Atomic<uint>				creations					{0};
+		}							_rtBuffers;
+
+		// uploads that are split between command buffers to limit staging memory usage per frame
+		struct {
+			Mutex						guard;
+			Deque< UploadRequest >		queue;
+			BytesU						budget;						// if zero then 'UploadBudgetPages' is used
+			BytesU						pendingSize;
+			EQueueType					queueType					= EQueueType::Graphics;
+		}							_uploads;
+
 		// cached resources validation
 		struct {
 			Atomic<uint>				createdFramebuffers			{0};
@@ -149,6 +217,16 @@ namespace FG
 			Atomic<uint>				lastCheckedPipelineResource	{0};
 		}							_validation;
 
+		// cached resources eviction
+		struct {
+			Atomic<uint>				evictionSubmits				{FG_CacheEvictionSubmits};
+			Atomic<uint>				lastCheckedFramebuffer		{0};
+			Atomic<uint>				lastCheckedPipelineResource	{0};
+			Atomic<uint>				hits						{0};
+			Atomic<uint>				misses						{0};
+			Atomic<uint>				evictions					{0};
+		}							_cacheStat;
+
 		// dummy resource descriptions
 		const BufferDesc			_dummyBufferDesc;
 		const ImageDesc				_dummyImageDesc;
@@ -182,6 +260,10 @@ namespace FG
 		
 		ND_ RawImageID			CreateImage (const VulkanImageDesc &desc, IFrameGraph::OnExternalImageReleased_t &&onRelease, StringView dbgName);
 		ND_ RawBufferID			CreateBuffer (const VulkanBufferDesc &desc, IFrameGraph::OnExternalBufferReleased_t &&onRelease, StringView dbgName);
+		
+		ND_ RawMemoryID			CreateMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, StringView dbgName);
+			bool				BindAliasedMemory (RawImageID image, RawMemoryID heap, BytesU offset, BytesU size);
+			bool				BindAliasedMemory (RawBufferID buffer, RawMemoryID heap, BytesU offset, BytesU size);
 
 		ND_ RawRenderPassID		CreateRenderPass (ArrayView<VLogicalRenderPass*> logicalPasses, StringView dbgName);
 		ND_ RawFramebufferID	CreateFramebuffer (ArrayView<Pair<RawImageID, ImageViewDesc>> attachments, RawRenderPassID rp, uint2 dim, uint layers, StringView dbgName);
@@ -235,10 +317,25 @@ namespace FG
 		void  CheckTask (const BuildRayTracingScene &);
 
 		void  RunValidation (uint maxIter);
+		void  GetCacheStatistics (INOUT IFrameGraph::ResourceStatistics &);
 		
 		bool  CreateStagingBuffer (EBufferUsage usage, OUT RawBufferID &id, OUT StagingBufferIdx &index);
 		void  ReleaseStagingBuffer (StagingBufferIdx index);
 
+		bool  AcquireEvent (OUT VkEvent &event);
+		void  ReleaseEvents (INOUT Array<VkEvent> &events);
+
+		bool  AcquireRayTracingBuffer (BytesU minSize, OUT RawBufferID &id, OUT BytesU &capacity);
+		void  ReleaseRayTracingBuffers (INOUT RTBuffers_t &buffers);
+
+		bool  EnqueueUpload (const UpdateBuffer &task, UploadCallback_t &&callback);
+		bool  EnqueueUpload (const UpdateImage &task, UploadCallback_t &&callback);
+		void  SetUploadBudget (BytesU bytesPerCommandBuffer, EQueueType queue);
+		void  SetCacheEvictionSubmits (uint submits)	{ _cacheStat.evictionSubmits.store( submits, memory_order_relaxed ); }
+		void  AcquireUploads (EQueueType queue, BytesU availableStaging, OUT UploadParts_t &parts);
+		void  ReturnUploads (INOUT UploadParts_t &parts);
+		void  CompleteUpload (const UploadStatePtr &state);
+
 
 	private:
 		bool  _CheckHostVisibleMemory ();
@@ -264,6 +361,9 @@ namespace FG
 
 		template <typename DataT, size_t CS, size_t MC>
 		void  _DestroyResourceCache (INOUT CachedPoolTmpl<DataT,CS,MC> &pool);
+
+		template <typename DataT, size_t CS, size_t MC>
+		void  _EvictUnusedResources (INOUT Atomic<uint> &lastIndex, INOUT CachedPoolTmpl<DataT,CS,MC> &pool, uint submitIndex, uint maxUnusedSubmits);
 		
 		template <typename DataT, size_t CS, size_t MC>
 		bool  _ReleaseResource (PoolTmpl<DataT,CS,MC> &pool, DataT& data, Index_t index, uint refCount);
@@ -272,6 +372,14 @@ namespace FG
 		bool  _ReleaseResource (CachedPoolTmpl<DataT,CS,MC> &pool, DataT& data, Index_t index, uint refCount);
 
 		void  _DestroyStagingBuffers ();
+		void  _DestroyRayTracingBuffers ();
+		void  _DestroyUploadQueue ();
+		void  _ReleaseUploadResource (const UploadState &state);
+
+		ND_ bool    _InitUploadRequest (const UpdateBuffer &task, OUT UploadRequest &req) const;
+		ND_ bool    _InitUploadRequest (const UpdateImage &task, OUT UploadRequest &req) const;
+		ND_ BytesU  _GetUploadPart (INOUT UploadRequest &req, const UpdateBuffer &task, BytesU budget, OUT UploadTask_t &part) const;
+		ND_ BytesU  _GetUploadPart (INOUT UploadRequest &req, const UpdateImage &task, BytesU budget, OUT UploadTask_t &part) const;
 
 
 	// resource pool
@@ -130,6 +130,34 @@ namespace FG
 		RETURN_ERR( "unsupported memory type" );
 	}
 #endif
+	
+/*
+=================================================
+	AllocateMemory
+----
+	allocates memory block without binding,
+	used as heap for transient resources.
+=================================================
+*/
+	bool VMemoryManager::AllocateMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, OUT Storage_t &data)
+	{
+		SHAREDLOCK( _drCheck );
+		ASSERT( not _allocators.empty() );
+
+		for (size_t i = 0; i < _allocators.size(); ++i)
+		{
+			auto&	alloc = _allocators[i];
+
+			if ( alloc->IsSupported( desc.type ))
+			{
+				CHECK_ERR( alloc->AllocMemory( req, desc, OUT data ));
+				
+				*data.Cast<uint>() = uint(i);
+				return true;
+			}
+		}
+		RETURN_ERR( "unsupported memory type" );
+	}
 
 /*
 =================================================
@@ -39,6 +39,8 @@ namespace FG
 			#ifdef VK_NV_ray_tracing
 			virtual bool AllocForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data) = 0;
 			#endif
+			
+			virtual bool AllocMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, OUT Storage_t &data) = 0;
 
 			virtual bool Dealloc (INOUT Storage_t &data) = 0;
 			
@@ -71,6 +73,8 @@ namespace FG
 		#ifdef VK_NV_ray_tracing
 		virtual bool AllocateForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data);
 		#endif
+		
+		virtual bool AllocateMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, OUT Storage_t &data);
 
 		virtual bool Deallocate (INOUT Storage_t &data);
 
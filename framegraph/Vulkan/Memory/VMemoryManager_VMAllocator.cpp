@@ -91,6 +91,8 @@ namespace FG
 		#ifdef VK_NV_ray_tracing
 		bool AllocForAccelStruct (VkAccelerationStructureNV as, const MemoryDesc &desc, OUT Storage_t &data) override;
 		#endif
+		
+		bool AllocMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, OUT Storage_t &data) override;
 
 		bool Dealloc (INOUT Storage_t &data) override;
 		
@@ -316,6 +318,31 @@ namespace FG
 		return true;
 	}
 #endif
+	
+/*
+=================================================
+	AllocMemory
+=================================================
+*/
+	bool VMemoryManager::VulkanMemoryAllocator::AllocMemory (const VkMemoryRequirements &req, const MemoryDesc &desc, OUT Storage_t &data)
+	{
+		EXLOCK( _guard );
+		
+		VmaAllocationCreateInfo		info = {};
+		info.flags			= _ConvertToMemoryFlags( desc.type );
+		info.usage			= _ConvertToMemoryUsage( desc.type );
+		info.requiredFlags	= _ConvertToMemoryProperties( desc.type );
+		info.preferredFlags	= 0;
+		info.memoryTypeBits	= 0;
+		info.pool			= VK_NULL_HANDLE;
+		info.pUserData		= null;
+
+		VmaAllocation	mem = null;
+		VK_CHECK( vmaAllocateMemory( _allocator, &req, &info, OUT &mem, null ));
+		
+		_CastStorage( data )->allocation = mem;
+		return true;
+	}
 
 /*
 =================================================
@@ -418,7 +445,7 @@ namespace FG
 				case EMemoryTypeExt::HostCoherent :		flags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;	break;
 				case EMemoryTypeExt::HostCached :		flags |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;	break;
 				case EMemoryTypeExt::Dedicated :
-				//case EMemoryTypeExt::AllowAliasing :
+				case EMemoryTypeExt::AllowAliasing :
 				//case EMemoryTypeExt::Sparse :
 				case EMemoryTypeExt::ForBuffer :
 				case EMemoryTypeExt::ForImage :			break;
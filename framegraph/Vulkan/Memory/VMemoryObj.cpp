@@ -3,6 +3,7 @@
 #include "VMemoryObj.h"
 #include "VMemoryManager.h"
 #include "VResourceManager.h"
+#include "VDevice.h"
 
 namespace FG
 {
@@ -40,6 +41,10 @@ namespace FG
 	{
 		EXLOCK( _drCheck );
 
+		// memory will be bound later in 'BindAliasedBuffer'
+		if ( AllBits( _desc.type, EMemoryType::AllowAliasing ))
+			return true;
+
 		CHECK_ERR( memMngr.AllocateForBuffer( buf, _desc, INOUT _storage ));
 		return true;
 	}
@@ -52,6 +57,10 @@ namespace FG
 	bool VMemoryObj::AllocateForImage (VMemoryManager &memMngr, VkImage img)
 	{
 		EXLOCK( _drCheck );
+		
+		// memory will be bound later in 'BindAliasedImage'
+		if ( AllBits( _desc.type, EMemoryType::AllowAliasing ))
+			return true;
 
 		CHECK_ERR( memMngr.AllocateForImage( img, _desc, INOUT _storage ));
 		return true;
@@ -71,6 +80,60 @@ namespace FG
 		return true;
 	}
 #endif
+	
+/*
+=================================================
+	AllocateMemory
+=================================================
+*/
+	bool VMemoryObj::AllocateMemory (VMemoryManager &memMngr, const VkMemoryRequirements &req)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( not AllBits( _desc.type, EMemoryType::AllowAliasing ));
+
+		CHECK_ERR( memMngr.AllocateMemory( req, _desc, INOUT _storage ));
+		return true;
+	}
+	
+/*
+=================================================
+	BindAliasedImage
+=================================================
+*/
+	bool VMemoryObj::BindAliasedImage (const VDevice &dev, VkImage img, const MemoryInfo &heap, BytesU offset, BytesU size)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( AllBits( _desc.type, EMemoryType::AllowAliasing ));
+		CHECK_ERR( _aliased.mem == VK_NULL_HANDLE );
+		CHECK_ERR( offset + size <= heap.size );
+
+		VK_CHECK( dev.vkBindImageMemory( dev.GetVkDevice(), img, heap.mem, VkDeviceSize(heap.offset + offset) ));
+
+		_aliased		= heap;
+		_aliased.offset	= heap.offset + offset;
+		_aliased.size	= size;
+		return true;
+	}
+	
+/*
+=================================================
+	BindAliasedBuffer
+=================================================
+*/
+	bool VMemoryObj::BindAliasedBuffer (const VDevice &dev, VkBuffer buf, const MemoryInfo &heap, BytesU offset, BytesU size)
+	{
+		EXLOCK( _drCheck );
+		CHECK_ERR( AllBits( _desc.type, EMemoryType::AllowAliasing ));
+		CHECK_ERR( _aliased.mem == VK_NULL_HANDLE );
+		CHECK_ERR( offset + size <= heap.size );
+
+		VK_CHECK( dev.vkBindBufferMemory( dev.GetVkDevice(), buf, heap.mem, VkDeviceSize(heap.offset + offset) ));
+		
+		_aliased		= heap;
+		_aliased.offset	= heap.offset + offset;
+		_aliased.size	= size;
+		return true;
+	}
 
 /*
 =================================================
@@ -81,8 +144,11 @@ namespace FG
 	{
 		EXLOCK( _drCheck );
 
-		resMngr.GetMemoryManager().Deallocate( INOUT _storage );
+		// aliased memory is owned by heap memory object
+		if ( not AllBits( _desc.type, EMemoryType::AllowAliasing ))
+			resMngr.GetMemoryManager().Deallocate( INOUT _storage );
 
+		_aliased	= Default;
 		_debugName.clear();
 	}
 	
@@ -95,6 +161,12 @@ namespace FG
 	{
 		SHAREDLOCK( _drCheck );
 
+		if ( AllBits( _desc.type, EMemoryType::AllowAliasing ))
+		{
+			info = _aliased;
+			return _aliased.mem != VK_NULL_HANDLE;
+		}
+
 		return memMngr.GetMemoryInfo( _storage, OUT info );
 	}
 
@@ -32,6 +32,7 @@ namespace FG
 	// variables
 	private:
 		Storage_t				_storage;
+		MemoryInfo				_aliased;		// memory range in shared heap, only for 'EMemoryType::AllowAliasing'
 		MemoryDesc				_desc;
 		DebugName_t				_debugName;
 		
@@ -55,10 +56,16 @@ namespace FG
 		bool AllocateForAccelStruct (VMemoryManager &, VkAccelerationStructureNV);
 		#endif
 
+		bool AllocateMemory (VMemoryManager &, const VkMemoryRequirements &);
+
+		bool BindAliasedImage (const VDevice &, VkImage, const MemoryInfo &heap, BytesU offset, BytesU size);
+		bool BindAliasedBuffer (const VDevice &, VkBuffer, const MemoryInfo &heap, BytesU offset, BytesU size);
+
 		bool GetInfo (VMemoryManager &, OUT MemoryInfo &) const;
 
 		//ND_ MemoryDesc const&	Description ()	const	{ SHAREDLOCK( _drCheck );  return _desc; }
 		ND_ EMemoryTypeExt	MemoryType ()		const	{ SHAREDLOCK( _drCheck );  return EMemoryTypeExt(_desc.type); }
+		ND_ bool			IsAliased ()		const	{ SHAREDLOCK( _drCheck );  return AllBits( _desc.type, EMemoryType::AllowAliasing ); }
 	};
 
 
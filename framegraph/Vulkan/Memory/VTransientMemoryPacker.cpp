@@ -0,0 +1,137 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "VTransientMemoryPacker.h"
+
+namespace FG
+{
+
+/*
+=================================================
+	Clear
+=================================================
+*/
+	void VTransientMemoryPacker::Clear ()
+	{
+		_resources.clear();
+		_totalSize		= 0_b;
+		_requiredSize	= 0_b;
+		_maxAlign		= 1_b;
+	}
+
+/*
+=================================================
+	Add
+=================================================
+*/
+	uint  VTransientMemoryPacker::Add (BytesU size, BytesU align, ExeOrderIndex first, ExeOrderIndex last)
+	{
+		ASSERT( size > 0 );
+		ASSERT( first <= last );
+
+		Resource	res;
+		res.size	= size;
+		res.align	= Max( align, 1_b );
+		res.first	= first;
+		res.last	= last;
+
+		_resources.push_back( res );
+		return uint(_resources.size()-1);
+	}
+
+/*
+=================================================
+	_IsIntersects
+=================================================
+*/
+	inline bool  VTransientMemoryPacker::_IsIntersects (const Resource &lhs, const Resource &rhs)
+	{
+		return lhs.first <= rhs.last and rhs.first <= lhs.last;
+	}
+
+/*
+=================================================
+	Pack
+----
+	greedy first-fit: largest resources are placed first,
+	each resource is placed into the lowest gap between resources
+	that are alive at the same time.
+=================================================
+*/
+	void VTransientMemoryPacker::Pack ()
+	{
+		const uint	count = uint(_resources.size());
+
+		Array<uint>		order;
+		order.resize( count );
+		for (uint i = 0; i < count; ++i) { order[i] = i; }
+
+		std::sort( order.begin(), order.end(), [this] (uint lhs, uint rhs)
+				  {
+					  auto&	l = _resources[lhs];
+					  auto&	r = _resources[rhs];
+					  return	l.size  != r.size  ? l.size  > r.size  :
+								l.first != r.first ? l.first < r.first :
+													 lhs < rhs;
+				  });
+
+		Array<uint>		placed;		// sorted by offset
+		Array<uint>		alive;
+		placed.reserve( count );
+		alive.reserve( count );
+
+		_totalSize		= 0_b;
+		_requiredSize	= 0_b;
+		_maxAlign		= 1_b;
+
+		for (uint idx : order)
+		{
+			auto&	res = _resources[idx];
+
+			// 'placed' is sorted by offset, so 'alive' is sorted too
+			alive.clear();
+			for (uint j : placed)
+			{
+				if ( _IsIntersects( res, _resources[j] ))
+					alive.push_back( j );
+			}
+
+			BytesU	offset;
+			for (uint j : alive)
+			{
+				auto&	other = _resources[j];
+
+				if ( offset + res.size <= other.offset )
+					break;
+
+				offset = Max( offset, AlignToLarger( other.offset + other.size, res.align ));
+			}
+
+			res.offset = offset;
+			placed.insert( std::upper_bound( placed.begin(), placed.end(), idx,
+											 [this] (uint lhs, uint rhs) { return _resources[lhs].offset < _resources[rhs].offset; }),
+						   idx );
+
+			_totalSize		= Max( _totalSize, offset + res.size );
+			_requiredSize	+= res.size;
+			_maxAlign		= Max( _maxAlign, res.align );
+		}
+
+		// find resources that reuse memory of previously used resources
+		for (auto& res : _resources)
+		{
+			res.aliased = false;
+
+			for (auto& other : _resources)
+			{
+				if ( other.last < res.first and
+					 other.offset < res.offset + res.size and res.offset < other.offset + other.size )
+				{
+					res.aliased = true;
+					break;
+				}
+			}
+		}
+	}
+
+
+}	// FG
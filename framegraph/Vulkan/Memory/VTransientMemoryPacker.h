@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Packs transient resources into single memory heap.
+	Resources with non-overlapping lifetimes may share the same memory range.
+	Lifetime is a range of task execution indices where resource is used, bounds are inclusive.
+*/
+
+#pragma once
+
+#include "VCommon.h"
+
+namespace FG
+{
+
+	//
+	// Vulkan Transient Memory Packer
+	//
+
+	class VTransientMemoryPacker final
+	{
+	// types
+	private:
+		struct Resource
+		{
+			BytesU			size;
+			BytesU			align;
+			BytesU			offset;
+			ExeOrderIndex	first;
+			ExeOrderIndex	last;
+			bool			aliased	= false;	// memory range was used by another resource
+		};
+
+
+	// variables
+	private:
+		Array< Resource >	_resources;
+		BytesU				_totalSize;
+		BytesU				_requiredSize;
+		BytesU				_maxAlign		{1};
+
+
+	// methods
+	public:
+		VTransientMemoryPacker () {}
+
+		void Clear ();
+
+		ND_ uint  Add (BytesU size, BytesU align, ExeOrderIndex first, ExeOrderIndex last);
+
+		void Pack ();
+
+		ND_ BytesU	Offset (uint index)		const	{ return _resources[index].offset; }
+		ND_ BytesU	Size (uint index)		const	{ return _resources[index].size; }
+		ND_ bool	IsAliased (uint index)	const	{ return _resources[index].aliased; }
+
+		ND_ uint	Count ()				const	{ return uint(_resources.size()); }
+		ND_ BytesU	TotalSize ()			const	{ return _totalSize; }		// heap size
+		ND_ BytesU	RequiredSize ()			const	{ return _requiredSize; }	// heap size without aliasing
+		ND_ BytesU	MaxAlignment ()			const	{ return _maxAlign; }
+
+	private:
+		ND_ static bool  _IsIntersects (const Resource &lhs, const Resource &rhs);
+	};
+
+
+}	// FG
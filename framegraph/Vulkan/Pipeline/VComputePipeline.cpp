@@ -82,16 +82,19 @@ namespace FG
 
 		auto&	dev = resMngr.GetDevice();
 
-		for (auto& ppln : _instances) {
-			dev.vkDestroyPipeline( dev.GetVkDevice(), ppln.second, null );
-			resMngr.ReleaseResource( const_cast<PipelineInstance &>(ppln.first).layoutId );
-		}
+		_instances.ForEach( [&] (const PipelineInstance &inst, VkPipeline ppln)
+		{
+			if ( ppln )
+				dev.vkDestroyPipeline( dev.GetVkDevice(), ppln, null );
+
+			resMngr.ReleaseResource( inst.layoutId );
+		});
 		
 		if ( _baseLayoutId ) {
 			resMngr.ReleaseResource( _baseLayoutId.Release() );
 		}
 
-		_instances.clear();
+		_instances.Clear();
 		_debugName.clear();
 		_shaders.clear();
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "VPipelineLayout.h"
+#include "stl/ThreadSafe/LfHashMap.h"
 
 namespace FG
 {
@@ -44,15 +45,14 @@ namespace FG
 			EShaderDebugMode					debugMode	= Default;
 		};
 
-		using Instances_t			= HashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
+		using Instances_t			= LfHashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
 		using VkShaderPtr			= PipelineDescription::VkShaderPtr;
 		using ShaderModules_t		= FixedArray< ShaderModule, 4 >;
 
 
 	// variables
 	private:
-		mutable SharedMutex			_instanceGuard;
-		mutable Instances_t			_instances;
+		mutable Instances_t			_instances;		// lock-free search, used in draw/dispatch
 
 		PipelineLayoutID			_baseLayoutId;
 		ShaderModules_t				_shaders;
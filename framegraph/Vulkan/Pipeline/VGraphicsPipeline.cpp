@@ -65,7 +65,7 @@ namespace FG
 */
 	VGraphicsPipeline::~VGraphicsPipeline ()
 	{
-		CHECK( _instances.empty() );
+		CHECK( _instances.Empty() );
 	}
 	
 /*
@@ -112,17 +112,20 @@ namespace FG
 
 		auto&	dev = resMngr.GetDevice();
 
-		for (auto& ppln : _instances) {
-			dev.vkDestroyPipeline( dev.GetVkDevice(), ppln.second, null );
-			resMngr.ReleaseResource( const_cast<PipelineInstance &>(ppln.first).layoutId );
-		}
+		_instances.ForEach( [&] (const PipelineInstance &inst, VkPipeline ppln)
+		{
+			if ( ppln and ppln != _FailedInstance() )
+				dev.vkDestroyPipeline( dev.GetVkDevice(), ppln, null );
+
+			resMngr.ReleaseResource( inst.layoutId );
+		});
 		
 		if ( _baseLayoutId ) {
 			resMngr.ReleaseResource( _baseLayoutId.Release() );
 		}
 
 		_shaders.clear();
-		_instances.clear();
+		_instances.Clear();
 		_vertexAttribs.clear();
 		_debugName.clear();
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "VPipelineLayout.h"
+#include "stl/ThreadSafe/LfHashMap.h"
 
 namespace FG
 {
@@ -52,7 +53,7 @@ namespace FG
 			ND_ size_t	operator () (const PipelineInstance &value) const	{ return size_t(value._hash); }
 		};
 
-		using Instances_t			= HashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
+		using Instances_t			= LfHashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
 		using ShaderModules_t		= FixedArray< ShaderModule, 8 >;
 		using TopologyBits_t		= GraphicsPipelineDesc::TopologyBits_t;
 		using VertexAttrib			= VertexInputState::VertexAttrib;
@@ -61,8 +62,7 @@ namespace FG
 
 	// variables
 	private:
-		mutable SharedMutex			_instanceGuard;
-		mutable Instances_t			_instances;
+		mutable Instances_t			_instances;		// lock-free search, used in draw/dispatch
 
 		PipelineLayoutID			_baseLayoutId;
 		ShaderModules_t				_shaders;
@@ -94,6 +94,10 @@ namespace FG
 		ND_ bool					IsEarlyFragmentTests ()	const	{ SHAREDLOCK( _drCheck );  return _earlyFragmentTests; }
 		
 		ND_ StringView				GetDebugName ()			const	{ SHAREDLOCK( _drCheck );  return _debugName; }
+
+	private:
+		// value of instance that failed to compile in background, it will be created synchronously
+		ND_ static VkPipeline		_FailedInstance ()				{ return BitCast<VkPipeline>( ~uint64_t(0) ); }
 	};
 
 	
@@ -37,7 +37,7 @@ namespace FG
 */
 	VMeshPipeline::~VMeshPipeline ()
 	{
-		CHECK( _instances.empty() );
+		CHECK( _instances.Empty() );
 	}
 	
 /*
@@ -82,17 +82,20 @@ namespace FG
 
 		auto&	dev = resMngr.GetDevice();
 
-		for (auto& ppln : _instances) {
-			dev.vkDestroyPipeline( dev.GetVkDevice(), ppln.second, null );
-			resMngr.ReleaseResource( const_cast<PipelineInstance &>(ppln.first).layoutId );
-		}
+		_instances.ForEach( [&] (const PipelineInstance &inst, VkPipeline ppln)
+		{
+			if ( ppln )
+				dev.vkDestroyPipeline( dev.GetVkDevice(), ppln, null );
+
+			resMngr.ReleaseResource( inst.layoutId );
+		});
 
 		if ( _baseLayoutId ) {
 			resMngr.ReleaseResource( _baseLayoutId.Release() );
 		}
 
 		_shaders.clear();
-		_instances.clear();
+		_instances.Clear();
 		_debugName.clear();
 		_baseLayoutId		= Default;
 		_topology			= Default;
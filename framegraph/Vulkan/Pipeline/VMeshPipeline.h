@@ -44,7 +44,7 @@ namespace FG
 			ND_ size_t	operator () (const PipelineInstance &value) const	{ return size_t(value._hash); }
 		};
 
-		using Instances_t			= HashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
+		using Instances_t			= LfHashMap< PipelineInstance, VkPipeline, PipelineInstanceHash >;
 		using ShaderModule			= VGraphicsPipeline::ShaderModule;
 		using ShaderModules_t		= FixedArray< ShaderModule, 8 >;
 		using TopologyBits_t		= GraphicsPipelineDesc::TopologyBits_t;
@@ -52,8 +52,7 @@ namespace FG
 
 	// variables
 	private:
-		mutable SharedMutex			_instanceGuard;
-		mutable Instances_t			_instances;
+		mutable Instances_t			_instances;		// lock-free search, used in draw/dispatch
 
 		PipelineLayoutID			_baseLayoutId;
 		ShaderModules_t				_shaders;
@@ -6,6 +6,7 @@
 #include "VEnumCast.h"
 #include "VRenderPass.h"
 #include "VCommandBuffer.h"
+#include "stl/Algorithms/StringUtils.h"
 
 namespace FG
 {
@@ -16,7 +17,7 @@ namespace FG
 =================================================
 */
 	VPipelineCache::VPipelineCache () :
-		_pipelinesCache{ VK_NULL_HANDLE }
+		_pipelinesCache{ VK_NULL_HANDLE }, _changed{ false }
 	{
 		const uint	max_stages = 32;
 
@@ -46,9 +47,9 @@ namespace FG
 	Initialize
 =================================================
 */
-	bool VPipelineCache::Initialize (const VDevice &dev)
+	bool VPipelineCache::Initialize (const VDevice &dev, ArrayView<uint8_t> initialData)
 	{
-		CHECK_ERR( _CreatePipelineCache( dev ));
+		CHECK_ERR( _CreatePipelineCache( dev, initialData ));
 		return true;
 	}
 	
@@ -64,36 +65,207 @@ namespace FG
 			dev.vkDestroyPipelineCache( dev.GetVkDevice(), _pipelinesCache, null );
 			_pipelinesCache = VK_NULL_HANDLE;
 		}
+		_changed = false;
 	}
 
 /*
 =================================================
 	MergeCache
+----
+	merge 'src' into current cache
 =================================================
 */
-	bool VPipelineCache::MergeCache (VPipelineCache &)
+	bool VPipelineCache::MergeCache (const VDevice &dev, VPipelineCache &src)
 	{
-		// TODO
-		return false;
+		CHECK_ERR( _pipelinesCache and src._pipelinesCache );
+		CHECK_ERR( _pipelinesCache != src._pipelinesCache );
+
+		VK_CHECK( dev.vkMergePipelineCaches( dev.GetVkDevice(), _pipelinesCache, 1, &src._pipelinesCache ));
+
+		_changed	 |= src._changed;
+		src._changed  = false;
+		return true;
 	}
 	
+/*
+=================================================
+	GetCacheData
+=================================================
+*/
+	bool VPipelineCache::GetCacheData (const VDevice &dev, OUT Array<uint8_t> &result) const
+	{
+		CHECK_ERR( _pipelinesCache );
+
+		size_t	size = 0;
+		VK_CHECK( dev.vkGetPipelineCacheData( dev.GetVkDevice(), _pipelinesCache, OUT &size, null ));
+
+		result.resize( size );
+		if ( size == 0 )
+			return true;
+
+		// cache may grow between two calls, in this case driver returns 'VK_INCOMPLETE' and writes only part of the data that is still valid
+		VkResult	err = dev.vkGetPipelineCacheData( dev.GetVkDevice(), _pipelinesCache, INOUT &size, OUT result.data() );
+		CHECK_ERR( err == VK_SUCCESS or err == VK_INCOMPLETE );
+
+		result.resize( size );
+		return true;
+	}
+	
+/*
+=================================================
+	PipelineCacheFileHeader
+----
+	Vulkan cache header contains only vendor, device and cache UUID,
+	driver version is added to reject cache from previous driver before passing it to the driver.
+=================================================
+*/
+namespace {
+	struct PipelineCacheFileHeader
+	{
+		static constexpr uint	Magic	= 0x43504746;	// 'FGPC'
+		static constexpr uint	Version	= 1;
+
+		uint		magic;
+		uint		version;
+		uint		vendorID;
+		uint		deviceID;
+		uint		driverVersion;
+		uint8_t		uuid [VK_UUID_SIZE];
+		uint		_padding;
+		uint64_t	dataSize;
+		uint64_t	dataHash;
+	};
+
+	ND_ uint64_t  PipelineCacheHash (ArrayView<uint8_t> data)
+	{
+		return data.empty() ? 0 : uint64_t(size_t(HashOf( data.data(), data.size() )));
+	}
+}
+/*
+=================================================
+	Load
+----
+	merge data from stream into current cache
+=================================================
+*/
+	bool VPipelineCache::Load (const VDevice &dev, RStream &stream)
+	{
+		CHECK_ERR( _pipelinesCache );
+		CHECK_ERR( stream.IsOpen() );
+
+		const auto&				props = dev.GetProperties().properties;
+		PipelineCacheFileHeader	header = {};
+
+		CHECK_ERR( stream.Read( OUT header ));
+
+		if ( header.magic != PipelineCacheFileHeader::Magic or header.version != PipelineCacheFileHeader::Version )
+		{
+			FG_LOGI( "pipeline cache has unsupported format" );
+			return false;
+		}
+
+		if ( header.vendorID != props.vendorID or header.deviceID != props.deviceID or header.driverVersion != props.driverVersion or
+			 std::memcmp( header.uuid, props.pipelineCacheUUID, sizeof(header.uuid) ) != 0 )
+		{
+			FG_LOGI( "pipeline cache was created on another device or driver version" );
+			return false;
+		}
+
+		CHECK_ERR( BytesU{header.dataSize} <= stream.RemainingSize() );
+
+		Array<uint8_t>	data;
+		CHECK_ERR( stream.Read( size_t(header.dataSize), OUT data ));
+		CHECK_ERR( PipelineCacheHash( data ) == header.dataHash );
+		CHECK_ERR( IsCompatible( dev, data ));
+
+		VPipelineCache	temp;
+		CHECK_ERR( temp.Initialize( dev, data ));
+
+		bool	res = MergeCache( dev, temp );
+		temp.Deinitialize( dev );
+		return res;
+	}
+	
+/*
+=================================================
+	Save
+=================================================
+*/
+	bool VPipelineCache::Save (const VDevice &dev, WStream &stream) const
+	{
+		CHECK_ERR( stream.IsOpen() );
+
+		Array<uint8_t>	data;
+		CHECK_ERR( GetCacheData( dev, OUT data ));
+
+		const auto&				props = dev.GetProperties().properties;
+		PipelineCacheFileHeader	header = {};
+		header.magic			= PipelineCacheFileHeader::Magic;
+		header.version			= PipelineCacheFileHeader::Version;
+		header.vendorID			= props.vendorID;
+		header.deviceID			= props.deviceID;
+		header.driverVersion	= props.driverVersion;
+		header.dataSize			= data.size();
+		header.dataHash			= PipelineCacheHash( data );
+		std::memcpy( OUT header.uuid, props.pipelineCacheUUID, sizeof(header.uuid) );
+
+		CHECK_ERR( stream.Write( header ));
+		CHECK_ERR( stream.Write( ArrayView<uint8_t>{ data }));
+		return true;
+	}
+
+/*
+=================================================
+	IsCompatible
+----
+	validate header that is written by driver,
+	see 'VkPipelineCacheHeaderVersionOne' in specs.
+=================================================
+*/
+	bool VPipelineCache::IsCompatible (const VDevice &dev, ArrayView<uint8_t> data)
+	{
+		const size_t	header_size = sizeof(uint) * 4 + VK_UUID_SIZE;
+
+		if ( data.size() < header_size )
+			return false;
+
+		uint	fields[4];
+		std::memcpy( OUT fields, data.data(), sizeof(fields) );
+
+		const auto&	props = dev.GetProperties().properties;
+
+		return	fields[0] >= header_size								and
+				fields[0] <= data.size()								and
+				fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE		and
+				fields[2] == props.vendorID								and
+				fields[3] == props.deviceID								and
+				std::memcmp( data.data() + sizeof(fields), props.pipelineCacheUUID, VK_UUID_SIZE ) == 0;
+	}
+
 /*
 =================================================
 	_CreatePipelineCache
 =================================================
 */
-	bool  VPipelineCache::_CreatePipelineCache (const VDevice &dev)
+	bool  VPipelineCache::_CreatePipelineCache (const VDevice &dev, ArrayView<uint8_t> initialData)
 	{
 		CHECK_ERR( not _pipelinesCache );
 
+		if ( not initialData.empty() and not IsCompatible( dev, initialData ))
+		{
+			FG_LOGI( "incompatible pipeline cache data is ignored" );
+			initialData = Default;
+		}
+
 		VkPipelineCacheCreateInfo	info = {};
 		info.sType				= VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 		info.pNext				= null;
 		info.flags				= 0;
-		info.initialDataSize	= 0;
-		info.pInitialData		= null;
+		info.initialDataSize	= initialData.size();
+		info.pInitialData		= initialData.data();
 
 		VK_CHECK( dev.vkCreatePipelineCache( dev.GetVkDevice(), &info, null, OUT &_pipelinesCache ));
+		_changed = false;
 		return true;
 	}
 
@@ -170,32 +342,32 @@ namespace FG
 
 /*
 =================================================
-	CreatePipelineInstance
+	_InitPipelineInstance
 =================================================
 */
-	bool  VPipelineCache::CreatePipelineInstance (VCommandBuffer				&fgThread,
-												  const VLogicalRenderPass		&logicalRP,
-												  const VGraphicsPipeline		&gppln,
-												  const VertexInputState		&vertexInput,
-												  const RenderState				&renderState,
-												  const EPipelineDynamicState	 dynamicStates,
-												  const ShaderDbgIndex			 debugModeIndex,
-												  OUT VkPipeline				&outPipeline,
-												  OUT VPipelineLayout const*	&outLayout)
+	bool  VPipelineCache::_InitPipelineInstance (VCommandBuffer					&fgThread,
+												 const VLogicalRenderPass		&logicalRP,
+												 const VGraphicsPipeline		&gppln,
+												 const VertexInputState			&vertexInput,
+												 const RenderState				&renderState,
+												 const EPipelineDynamicState	 dynamicStates,
+												 const ShaderDbgIndex			 debugModeIndex,
+												 OUT GPipelineInstance			&inst,
+												 OUT EShaderDebugMode			&debugMode,
+												 OUT EShaderStages				&debuggableShaders)
 	{
 		CHECK_ERR( logicalRP.GetRenderPassID() );
 
 		VDevice const&			dev			= fgThread.GetDevice();
-		VRenderPass const*		render_pass	= fgThread.AcquireTemporary( logicalRP.GetRenderPassID() );
-		EShaderDebugMode		dbg_mode	= Default;
-		EShaderStages			dbg_stages	= Default;
 		RawPipelineLayoutID		layout_id	= gppln.GetLayoutID();
 
+		debugMode			= Default;
+		debuggableShaders	= Default;
+
 		if ( debugModeIndex != Default ) {
-			CHECK( _SetupShaderDebugging( fgThread, gppln, debugModeIndex, OUT dbg_mode, OUT dbg_stages, OUT layout_id ));
+			CHECK( _SetupShaderDebugging( fgThread, gppln, debugModeIndex, OUT debugMode, OUT debuggableShaders, OUT layout_id ));
 		}
 
-		VGraphicsPipeline::PipelineInstance		inst;
 		inst.layoutId		= layout_id;
 		inst.dynamicState	= dynamicStates;
 		inst.renderPassId	= logicalRP.GetRenderPassID();
@@ -203,7 +375,7 @@ namespace FG
 		inst.vertexInput	= vertexInput;
 		//inst.flags		= 0;	//pipelineFlags;	// TODO
 		inst.viewportCount	= uint8_t(logicalRP.GetViewports().size());
-		inst.debugMode		= GetDebugModeHash( dbg_mode, dbg_stages );
+		inst.debugMode		= GetDebugModeHash( debugMode, debuggableShaders );
 		inst.renderState	= renderState;
 
 		if ( gppln._patchControlPoints )
@@ -217,22 +389,23 @@ namespace FG
 					gppln._supportedTopology[uint(inst.renderState.inputAssembly.topology)] );
 
 		inst.UpdateHash();
-		
-		outLayout = fgThread.AcquireTemporary( layout_id );
-
-		// find existing instance
-		{
-			SHAREDLOCK( gppln._instanceGuard );
-
-			auto iter = gppln._instances.find( inst );
-			if ( iter != gppln._instances.end() ) {
-				outPipeline = iter->second;
-				return true;
-			}
-		}
-
-
-		// create new instance
+		return true;
+	}
+	
+/*
+=================================================
+	_CreateGraphicsPipeline
+=================================================
+*/
+	bool  VPipelineCache::_CreateGraphicsPipeline (const VDevice			&dev,
+												   const VGraphicsPipeline	&gppln,
+												   const GPipelineInstance	&inst,
+												   const VRenderPass		&renderPass,
+												   const VPipelineLayout	&layout,
+												   EShaderDebugMode			 debugMode,
+												   EShaderStages			 debuggableShaders,
+												   OUT VkPipeline			&outPipeline)
+	{
 		_ClearTemp();
 
 		VkGraphicsPipelineCreateInfo			pipeline_info		= {};
@@ -246,9 +419,9 @@ namespace FG
 		VkPipelineVertexInputStateCreateInfo	vertex_input_info	= {};
 		VkPipelineViewportStateCreateInfo		viewport_info		= {};
 
-		CHECK_ERR( _SetShaderStages( OUT _tempStages, INOUT _tempSpecialization, INOUT _tempSpecEntries, gppln._shaders, dbg_mode, dbg_stages ));
+		CHECK_ERR( _SetShaderStages( OUT _tempStages, INOUT _tempSpecialization, INOUT _tempSpecEntries, gppln._shaders, debugMode, debuggableShaders ));
 		_SetDynamicState( OUT dynamic_state_info, OUT _tempDynamicStates, inst.dynamicState );
-		_SetColorBlendState( OUT blend_info, OUT _tempAttachments, inst.renderState.color, *render_pass, inst.subpassIndex );
+		_SetColorBlendState( OUT blend_info, OUT _tempAttachments, inst.renderState.color, renderPass, inst.subpassIndex );
 		_SetMultisampleState( OUT multisample_info, inst.renderState.multisample );
 		_SetTessellationState( OUT tessellation_info, gppln._patchControlPoints );
 		_SetDepthStencilState( OUT depth_stencil_info, inst.renderState.depth, inst.renderState.stencil );
@@ -271,10 +444,10 @@ namespace FG
 		pipeline_info.pDynamicState			= (_tempDynamicStates.empty() ? null : &dynamic_state_info);
 		pipeline_info.basePipelineIndex		= -1;
 		pipeline_info.basePipelineHandle	= VK_NULL_HANDLE;
-		pipeline_info.layout				= outLayout->Handle();
+		pipeline_info.layout				= layout.Handle();
 		pipeline_info.stageCount			= uint(_tempStages.size());
 		pipeline_info.pStages				= _tempStages.data();
-		pipeline_info.renderPass			= render_pass->Handle();
+		pipeline_info.renderPass			= renderPass.Handle();
 		pipeline_info.subpass				= inst.subpassIndex;
 		
 		if ( not rasterization_info.rasterizerDiscardEnable )
@@ -289,27 +462,174 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_changed = true;
+		return true;
+	}
+	
+/*
+=================================================
+	_AddPipelineInstance
+----
+	returns pipeline that is stored in the instance map,
+	instance that is compiling or failed to compile in background is replaced by new pipeline.
+	Returns 'true' if new pipeline was stored.
+=================================================
+*/
+	bool  VPipelineCache::_AddPipelineInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const GPipelineInstance &inst, INOUT VkPipeline &pipeline)
+	{
+		VkPipeline	stored = VK_NULL_HANDLE;
 
-		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
-		
-		// try to insert new instance
+		if ( gppln._instances.Insert( inst, pipeline, OUT stored ))
 		{
-			EXLOCK( gppln._instanceGuard );
+			CHECK( resMngr.AcquireResource( inst.layoutId ));
+			return true;
+		}
+		
+		// replace placeholder, on failure 'stored' contains pipeline that was created in another thread
+		if ( (stored == VK_NULL_HANDLE or stored == VGraphicsPipeline::_FailedInstance()) and
+			 gppln._instances.CompareExchange( inst, INOUT stored, pipeline ))
+			return true;
+
+		auto&	dev = resMngr.GetDevice();
+		dev.vkDestroyPipeline( dev.GetVkDevice(), pipeline, null );
+
+		pipeline = stored;
+		return false;
+	}
 
-			auto[iter, inserted] = gppln._instances.insert({ std::move(inst), outPipeline });
+/*
+=================================================
+	CreatePipelineInstance
+=================================================
+*/
+	bool  VPipelineCache::CreatePipelineInstance (VCommandBuffer				&fgThread,
+												  const VLogicalRenderPass		&logicalRP,
+												  const VGraphicsPipeline		&gppln,
+												  const VertexInputState		&vertexInput,
+												  const RenderState				&renderState,
+												  const EPipelineDynamicState	 dynamicStates,
+												  const ShaderDbgIndex			 debugModeIndex,
+												  OUT VkPipeline				&outPipeline,
+												  OUT VPipelineLayout const*	&outLayout)
+	{
+		GPipelineInstance	inst;
+		EShaderDebugMode	dbg_mode	= Default;
+		EShaderStages		dbg_stages	= Default;
+
+		CHECK_ERR( _InitPipelineInstance( fgThread, logicalRP, gppln, vertexInput, renderState, dynamicStates, debugModeIndex,
+										  OUT inst, OUT dbg_mode, OUT dbg_stages ));
 		
-			if ( not inserted )
-			{
-				dev.vkDestroyPipeline( dev.GetVkDevice(), outPipeline, null );
+		outLayout = fgThread.AcquireTemporary( inst.layoutId );
+
+		// find existing instance
+		if ( gppln._instances.Find( inst, OUT outPipeline ) and outPipeline != VK_NULL_HANDLE and outPipeline != VGraphicsPipeline::_FailedInstance() )
+			return true;
 
-				outPipeline = iter->second;
+		// create new instance
+		VRenderPass const*	render_pass	= fgThread.AcquireTemporary( inst.renderPassId );
+		CHECK_ERR( render_pass and outLayout );
+
+		outPipeline = {};
+		CHECK_ERR( _CreateGraphicsPipeline( fgThread.GetDevice(), gppln, inst, *render_pass, *outLayout, dbg_mode, dbg_stages, OUT outPipeline ));
+
+		if ( _AddPipelineInstance( fgThread.GetResourceManager(), gppln, inst, INOUT outPipeline ))
+			fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
+
+		return true;
+	}
+	
+/*
+=================================================
+	CreatePipelineInstanceAsync
+----
+	returns VK_NULL_HANDLE if instance is compiling in background.
+	If background compilation failed then pipeline is created synchronously.
+	Compilation job keeps references to the pipeline and render pass,
+	pipeline layout is referenced by instance.
+=================================================
+*/
+	bool  VPipelineCache::CreatePipelineInstanceAsync (VCommandBuffer				&fgThread,
+													   const VLogicalRenderPass		&logicalRP,
+													   RawGPipelineID				 pplnId,
+													   const VGraphicsPipeline		&gppln,
+													   const VertexInputState		&vertexInput,
+													   const RenderState			&renderState,
+													   const EPipelineDynamicState	 dynamicStates,
+													   OUT VkPipeline				&outPipeline,
+													   OUT VPipelineLayout const*	&outLayout)
+	{
+		GPipelineInstance	inst;
+		EShaderDebugMode	dbg_mode	= Default;
+		EShaderStages		dbg_stages	= Default;
+
+		CHECK_ERR( _InitPipelineInstance( fgThread, logicalRP, gppln, vertexInput, renderState, dynamicStates, Default,
+										  OUT inst, OUT dbg_mode, OUT dbg_stages ));
+		
+		outLayout	= fgThread.AcquireTemporary( inst.layoutId );
+		outPipeline	= VK_NULL_HANDLE;
+
+		// find existing instance
+		if ( gppln._instances.Find( inst, OUT outPipeline ))
+		{
+			if ( outPipeline != VGraphicsPipeline::_FailedInstance() )
 				return true;
-			}
+
+			return CreatePipelineInstance( fgThread, logicalRP, gppln, vertexInput, renderState, dynamicStates, Default, OUT outPipeline, OUT outLayout );
 		}
-		
-		CHECK( fgThread.GetResourceManager().AcquireResource( layout_id ));
+
+		// add placeholder
+		if ( not gppln._instances.Insert( inst, VK_NULL_HANDLE, OUT outPipeline ))
+			return true;
+
+		auto&	res_mngr = fgThread.GetResourceManager();
+		CHECK( res_mngr.AcquireResource( inst.layoutId ));
+		CHECK( res_mngr.AcquireResource( inst.renderPassId ));
+		CHECK( res_mngr.AcquireResource( pplnId ));
+
+		fgThread.GetInstance().EnqueuePipelineCompilation(
+			[pplnId, inst = std::move(inst)] (VResourceManager &resMngr, VPipelineCache &cache)
+			{
+				auto&		dev			= resMngr.GetDevice();
+				auto*		ppln		= resMngr.GetResource( pplnId );
+				auto*		render_pass	= resMngr.GetResource( inst.renderPassId );
+				auto*		layout		= resMngr.GetResource( inst.layoutId );
+				VkPipeline	handle		= VK_NULL_HANDLE;
+				bool		stored		= false;
+
+				if ( ppln )
+				{
+					if ( not (render_pass and layout and
+							  cache._CreateGraphicsPipeline( dev, *ppln, inst, *render_pass, *layout, Default, Default, OUT handle )))
+					{
+						FG_LOGE( "failed to create pipeline '"s << ppln->GetDebugName() << "' in background" );
+						handle = VK_NULL_HANDLE;
+					}
+
+					// replace placeholder, on failure placeholder is marked as failed,
+					// so the next draw call will create pipeline synchronously
+					VkPipeline	expected = VK_NULL_HANDLE;
+					if ( handle == VK_NULL_HANDLE )
+						ppln->_instances.CompareExchange( inst, INOUT expected, VGraphicsPipeline::_FailedInstance() );
+					else
+					if ( ppln->_instances.CompareExchange( inst, INOUT expected, handle ))
+					{
+						handle = VK_NULL_HANDLE;
+						stored = true;
+					}
+				}
+
+				// pipeline is already created in another thread
+				if ( handle )
+					dev.vkDestroyPipeline( dev.GetVkDevice(), handle, null );
+
+				resMngr.ReleaseResource( inst.renderPassId );
+				resMngr.ReleaseResource( pplnId );
+				return stored;
+			});
+
 		return true;
 	}
+
 /*
 =================================================
 	CreatePipelineInstance
@@ -356,15 +676,8 @@ namespace FG
 		outLayout = fgThread.AcquireTemporary( layout_id );
 
 		// find existing instance
-		{
-			SHAREDLOCK( mppln._instanceGuard );
-
-			auto iter = mppln._instances.find( inst );
-			if ( iter != mppln._instances.end() ) {
-				outPipeline = iter->second;
-				return true;
-			}
-		}
+		if ( mppln._instances.Find( inst, OUT outPipeline ))
+			return true;
 
 
 		// create new instance
@@ -422,20 +735,19 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateGraphicsPipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_changed = true;
 		
 		fgThread.EditStatistic().resources.newGraphicsPipelineCount++;
 		
 		// try to insert new instance
 		{
-			EXLOCK( mppln._instanceGuard );
+			VkPipeline	stored = VK_NULL_HANDLE;
 
-			auto[iter, inserted] = mppln._instances.insert({ std::move(inst), outPipeline });
-		
-			if ( not inserted )
+			if ( not mppln._instances.Insert( inst, outPipeline, OUT stored ))
 			{
 				dev.vkDestroyPipeline( dev.GetVkDevice(), outPipeline, null );
 
-				outPipeline = iter->second;
+				outPipeline = stored;
 				return true;
 			}
 		}
@@ -492,15 +804,8 @@ namespace FG
 		outLayout = fgThread.AcquireTemporary( layout_id );
 
 		// find existing instance
-		{
-			SHAREDLOCK( cppln._instanceGuard );
-
-			auto iter = cppln._instances.find( inst );
-			if ( iter != cppln._instances.end() ) {
-				outPipeline = iter->second;
-				return true;
-			}
-		}
+		if ( cppln._instances.Find( inst, OUT outPipeline ))
+			return true;
 
 
 		// create new instance
@@ -544,20 +849,19 @@ namespace FG
 
 		outPipeline = {};
 		VK_CHECK( dev.vkCreateComputePipelines( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &outPipeline ));
+		_changed = true;
 		
 		fgThread.EditStatistic().resources.newComputePipelineCount++;
 		
 		// try to insert new instance
 		{
-			EXLOCK( cppln._instanceGuard );
+			VkPipeline	stored = VK_NULL_HANDLE;
 
-			auto[iter, inserted] = cppln._instances.insert({ std::move(inst), outPipeline });
-		
-			if ( not inserted )
+			if ( not cppln._instances.Insert( inst, outPipeline, OUT stored ))
 			{
 				dev.vkDestroyPipeline( dev.GetVkDevice(), outPipeline, null );
 
-				outPipeline = iter->second;
+				outPipeline = stored;
 				return true;
 			}
 		}
@@ -752,6 +1056,7 @@ namespace FG
 			pipeline_info.basePipelineHandle	= VK_NULL_HANDLE;
 
 			VK_CHECK( dev.vkCreateRayTracingPipelinesNV( dev.GetVkDevice(), _pipelinesCache, 1, &pipeline_info, null, OUT &table.pipeline ));
+			_changed = true;
 			fgThread.EditStatistic().resources.newRayTracingPipelineCount++;
 			
 			CHECK( res_mngr.AcquireResource( layout_id ));
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "framegraph/Public/FrameGraphTask.h"
+#include "stl/Stream/Stream.h"
 #include "VDescriptorSetLayout.h"
 #include "VPipelineLayout.h"
 #include "VGraphicsPipeline.h"
@@ -61,6 +62,7 @@ namespace FG
 		using RTShaderSpecializations_t	= FixedArray< RTShaderSpec, 32 >;
 		
 		using ShaderModule_t			= VGraphicsPipeline::ShaderModule;
+		using GPipelineInstance			= VGraphicsPipeline::PipelineInstance;
 
 	public:
 		struct BufferCopyRegion
@@ -75,6 +77,7 @@ namespace FG
 	// variables
 	private:
 		VkPipelineCache				_pipelinesCache;
+		bool						_changed;				// 'true' if new pipelines was added since last merge
 
 		// temporary arrays
 		ShaderStages_t				_tempStages;			// TODO: use custom allocator?
@@ -99,10 +102,19 @@ namespace FG
 		VPipelineCache ();
 		~VPipelineCache ();
 		
-		bool Initialize (const VDevice &dev);
+		bool Initialize (const VDevice &dev, ArrayView<uint8_t> initialData = Default);
 		void Deinitialize (const VDevice &dev);
 
-		bool MergeCache (VPipelineCache &);
+		bool MergeCache (const VDevice &dev, VPipelineCache &src);
+		bool GetCacheData (const VDevice &dev, OUT Array<uint8_t> &result) const;
+
+		bool Load (const VDevice &dev, RStream &stream);
+		bool Save (const VDevice &dev, WStream &stream) const;
+
+		ND_ static bool  IsCompatible (const VDevice &dev, ArrayView<uint8_t> data);
+
+		ND_ bool  IsCreated ()	const	{ return _pipelinesCache != VK_NULL_HANDLE; }
+		ND_ bool  IsChanged ()	const	{ return _changed; }
 
 		bool CreatePipelineInstance (VCommandBuffer					&fgThread,
 									 const VLogicalRenderPass		&logicalRP,
@@ -113,6 +125,16 @@ namespace FG
 									 const ShaderDbgIndex			 debugModeIndex,
 									 OUT VkPipeline					&outPipeline,
 									 OUT VPipelineLayout const*		&outLayout);
+
+		bool CreatePipelineInstanceAsync (VCommandBuffer				&fgThread,
+										  const VLogicalRenderPass		&logicalRP,
+										  RawGPipelineID				 pplnId,
+										  const VGraphicsPipeline		&gpipeline,
+										  const VertexInputState		&vertexInput,
+										  const RenderState				&renderState,
+										  const EPipelineDynamicState	 dynamicStates,
+										  OUT VkPipeline				&outPipeline,
+										  OUT VPipelineLayout const*	&outLayout);
 		
 		bool CreatePipelineInstance (VCommandBuffer					&fgThread,
 									 const VLogicalRenderPass		&logicalRP,
@@ -142,7 +164,7 @@ namespace FG
 
 
 	private:
-		bool _CreatePipelineCache (const VDevice &dev);
+		bool _CreatePipelineCache (const VDevice &dev, ArrayView<uint8_t> initialData);
 
 		template <typename Pipeline>
 		bool _SetupShaderDebugging (VCommandBuffer &fgThread, const Pipeline &ppln, ShaderDbgIndex debugModeIndex,
@@ -150,6 +172,17 @@ namespace FG
 
 		void _ClearTemp ();
 
+		bool _InitPipelineInstance (VCommandBuffer &fgThread, const VLogicalRenderPass &logicalRP, const VGraphicsPipeline &gppln,
+									const VertexInputState &vertexInput, const RenderState &renderState, EPipelineDynamicState dynamicStates,
+									ShaderDbgIndex debugModeIndex, OUT GPipelineInstance &inst, OUT EShaderDebugMode &debugMode,
+									OUT EShaderStages &debuggableShaders);
+
+		bool _CreateGraphicsPipeline (const VDevice &dev, const VGraphicsPipeline &gppln, const GPipelineInstance &inst,
+									  const VRenderPass &renderPass, const VPipelineLayout &layout, EShaderDebugMode debugMode,
+									  EShaderStages debuggableShaders, OUT VkPipeline &outPipeline);
+
+		static bool _AddPipelineInstance (VResourceManager &resMngr, const VGraphicsPipeline &gppln, const GPipelineInstance &inst, INOUT VkPipeline &pipeline);
+
 		void _SetColorBlendState (OUT VkPipelineColorBlendStateCreateInfo &outState,
 								  OUT ColorAttachments_t &attachments,
 								  const RenderState::ColorBuffersState &inState,
@@ -50,6 +50,15 @@ namespace FG
 			dev.SetObjectName( BitCast<uint64_t>(_topLevelAS), dbgName, VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_NV );
 		}
 		
+		if ( AllBits( desc.flags, ERayTracingFlags::AllowUpdate ))
+		{
+			EXLOCK( _instanceBuffer.guard );
+
+			_instanceBuffer.buffer = BufferID{ resMngr.CreateBuffer( BufferDesc{ SizeOf<VkGeometryInstance> * desc.maxInstanceCount, EBufferUsage::TransferDst | EBufferUsage::RayTracing },
+																	 MemoryDesc{ EMemoryType::Default }, EQueueFamilyMask::Unknown, "InstanceBuffer" )};
+			CHECK_ERR( _instanceBuffer.buffer );
+		}
+
 		_maxInstanceCount	= desc.maxInstanceCount;
 		_memoryId			= MemoryID{ memId };
 		_debugName			= dbgName;
@@ -87,6 +96,15 @@ namespace FG
 			}
 		}
 
+		{
+			EXLOCK( _instanceBuffer.guard );
+
+			if ( _instanceBuffer.buffer ) {
+				resMngr.ReleaseResource( _instanceBuffer.buffer.Release() );
+			}
+			_instanceBuffer.instances.clear();
+		}
+
 		_topLevelAS			= VK_NULL_HANDLE;
 		_memoryId			= Default;
 		_flags				= Default;
@@ -99,14 +117,45 @@ namespace FG
 =================================================
 	SetGeometryInstances
 ----
-	'instances' is sorted by instance ID and contains the strong references for geometries
+	'instances' is sorted by instance ID and contains the strong references for geometries.
+	Returns 'true' if instances and geometries are the same as in previous build,
+	in this case acceleration structure can be updated instead of rebuilding.
 =================================================
 */
-	void VRayTracingScene::SetGeometryInstances (VResourceManager &resMngr, Tuple<InstanceID, RTGeometryID, uint> *instances, uint instanceCount, uint hitShadersPerInstance, uint maxHitShaders) const
+	bool VRayTracingScene::SetGeometryInstances (VResourceManager &resMngr, Tuple<InstanceID, RTGeometryID, uint> *instances, uint instanceCount, uint hitShadersPerInstance, uint maxHitShaders) const
 	{
 		EXLOCK( _drCheck );
 		EXLOCK( _instanceData.guard );
 		
+		const auto	IsSameInstances = [&] ()
+		{
+			if ( _instanceData.geometryInstances.empty()							or
+				 _instanceData.geometryInstances.size() != instanceCount			or
+				 _instanceData.hitShadersPerInstance	!= hitShadersPerInstance	or
+				 _instanceData.maxHitShaderCount		!= maxHitShaders )
+				return false;
+
+			for (uint i = 0; i < instanceCount; ++i)
+			{
+				auto&	lhs = _instanceData.geometryInstances[i];
+
+				if ( lhs.id			 != std::get<0>(instances[i])			or
+					 lhs.geometry	 != std::get<1>(instances[i])			or
+					 lhs.indexOffset != std::get<2>(instances[i]) )
+					return false;
+			}
+			return true;
+		};
+
+		// geometries are already referenced by the scene
+		if ( IsSameInstances() )
+		{
+			for (uint i = 0; i < instanceCount; ++i) {
+				Unused( std::get<1>(instances[i]).Release() );
+			}
+			return true;
+		}
+
 		// release previous geometries
 		for (auto& geom : _instanceData.geometryInstances) {
 			resMngr.ReleaseResource( geom.geometry.Release() );
@@ -123,6 +172,72 @@ namespace FG
 
 		_instanceData.hitShadersPerInstance	= hitShadersPerInstance;
 		_instanceData.maxHitShaderCount		= maxHitShaders;
+		return false;
+	}
+	
+/*
+=================================================
+	FindDirtyInstances
+----
+	compares instances with the instance buffer content and returns ranges of changed instances,
+	close ranges are merged to reduce the number of copy commands.
+	Returns generation of the instance buffer content that was used for comparison.
+=================================================
+*/
+	uint  VRayTracingScene::FindDirtyInstances (ArrayView<VkGeometryInstance> instances, OUT Appendable<uint2> dirtyRanges) const
+	{
+		static constexpr uint	max_gap = 4;
+
+		SHAREDLOCK( _drCheck );
+		EXLOCK( _instanceBuffer.guard );
+		ASSERT( _instanceBuffer.buffer );
+
+		auto&		prev	= _instanceBuffer.instances;
+		const uint	count	= uint(instances.size());
+		uint2		range	{ UMax, 0 };
+
+		for (uint i = 0; i < count; ++i)
+		{
+			if ( i < prev.size() and std::memcmp( &prev[i], &instances[i], sizeof(VkGeometryInstance) ) == 0 )
+				continue;
+
+			if ( range.x != UMax and i > range.y + max_gap )
+			{
+				dirtyRanges.push_back( range );
+				range.x = UMax;
+			}
+
+			range.x = Min( range.x, i );
+			range.y = i + 1;
+		}
+
+		if ( range.x != UMax )
+			dirtyRanges.push_back( range );
+
+		return _instanceBuffer.generation;
+	}
+	
+/*
+=================================================
+	CommitInstances
+----
+	called when build task is processed.
+	Returns 'false' if instance buffer content was changed after 'FindDirtyInstances',
+	in this case dirty ranges are not valid and all instances must be uploaded.
+	Builds must be submitted in the same order as they are processed.
+=================================================
+*/
+	bool  VRayTracingScene::CommitInstances (ArrayView<VkGeometryInstance> instances, uint generation) const
+	{
+		SHAREDLOCK( _drCheck );
+		EXLOCK( _instanceBuffer.guard );
+
+		const bool	valid = (generation == _instanceBuffer.generation);
+
+		_instanceBuffer.instances.assign( instances.begin(), instances.end() );
+		++_instanceBuffer.generation;
+
+		return valid;
 	}
 
 
@@ -40,6 +40,16 @@ namespace FG
 			uint				maxHitShaderCount		= 0;
 		};
 
+		// instance buffer is created only if scene supports updates,
+		// it keeps instances between builds, so only changed instances are uploaded
+		struct InstanceBufferData
+		{
+			Mutex						guard;
+			BufferID					buffer;
+			Array<VkGeometryInstance>	instances;		// buffer content after all processed builds
+			uint						generation	= 0;	// incremented when build is processed
+		};
+
 
 	// variables
 	private:
@@ -50,6 +60,7 @@ namespace FG
 		ERayTracingFlags			_flags				= Default;
 
 		mutable InstancesData		_instanceData;
+		mutable InstanceBufferData	_instanceBuffer;
 
 		DebugName_t					_debugName;
 
@@ -66,11 +77,15 @@ namespace FG
 		bool Create (VResourceManager &, const RayTracingSceneDesc &desc, RawMemoryID memId, VMemoryObj &memObj, StringView dbgName);
 		void Destroy (VResourceManager &);
 
-		void SetGeometryInstances (VResourceManager &, Tuple<InstanceID, RTGeometryID, uint> *instances, uint instanceCount, uint hitShadersPerInstance, uint maxHitShaders) const;
+		bool SetGeometryInstances (VResourceManager &, Tuple<InstanceID, RTGeometryID, uint> *instances, uint instanceCount, uint hitShadersPerInstance, uint maxHitShaders) const;
+
+		ND_ uint FindDirtyInstances (ArrayView<VkGeometryInstance> instances, OUT Appendable<uint2> dirtyRanges) const;
+		ND_ bool CommitInstances (ArrayView<VkGeometryInstance> instances, uint generation) const;
 
 		ND_ VkAccelerationStructureNV	Handle ()				const	{ SHAREDLOCK( _drCheck );  return _topLevelAS; }
 		ND_ uint						MaxInstanceCount ()		const	{ SHAREDLOCK( _drCheck );  return _maxInstanceCount; }
 		ND_ InstancesData &				CurrentData ()			const	{ SHAREDLOCK( _drCheck );  return _instanceData; }
+		ND_ RawBufferID					InstanceBuffer ()		const	{ SHAREDLOCK( _drCheck );  return _instanceBuffer.buffer.Get(); }
 
 		ND_ ERayTracingFlags			GetFlags ()				const	{ SHAREDLOCK( _drCheck );  return _flags; }
 		ND_ StringView					GetDebugName ()			const	{ SHAREDLOCK( _drCheck );  return _debugName; }
@@ -3,16 +3,83 @@
 #include "VLogicalRenderPass.h"
 #include "VCommandBuffer.h"
 #include "VEnumCast.h"
+#include "stl/Algorithms/RadixSort.h"
 
 namespace FG
 {
 				
-#ifdef VK_NV_shading_rate_image
 namespace {
+#ifdef VK_NV_shading_rate_image
 	static const VkShadingRatePaletteEntryNV	shadingRateDefaultEntry	= VK_SHADING_RATE_PALETTE_ENTRY_1_INVOCATION_PER_PIXEL_NV;
-}
 #endif
 
+/*
+=================================================
+	HasBlending
+=================================================
+*/
+	ND_ inline bool  HasBlending (const _fg_hidden_::ColorBuffers_t &colorBuffers)
+	{
+		for (auto& cb : colorBuffers) {
+			if ( cb.second.blend )
+				return true;
+		}
+		return false;
+	}
+
+	ND_ inline bool  HasBlending (const RenderState::ColorBuffersState &state)
+	{
+		if ( state.logicOp != ELogicOp::None )
+			return true;
+
+		for (auto& cb : state.buffers) {
+			if ( cb.blend )
+				return true;
+		}
+		return false;
+	}
+	
+/*
+=================================================
+	IsOrderIndependent
+----
+	same rules as in 'OverrideDepthStencilStates' are used to get
+	depth and stencil states for draw task.
+	Result of the draw call doesn't depend on order only if each fragment
+	is replaced by the closest one and stencil buffer is not modified.
+	Depth values may be equal for different draw calls,
+	so only strict compare ops are allowed.
+=================================================
+*/
+	ND_ inline bool  IsOrderIndependent (RenderState::DepthBufferState depth, RenderState::StencilBufferState stencil,
+										 const _fg_hidden_::DynamicStates &states)
+	{
+		depth.test		= states.hasDepthTest ? states.depthTest : depth.test;
+		depth.write		= states.hasDepthWrite ? states.depthWrite : depth.write;
+		stencil.enabled	= states.hasStencilTest ? states.stencilTest : stencil.enabled;
+
+		if ( depth.test and states.hasDepthCompareOp )
+			depth.compareOp = states.depthCompareOp;
+
+		if ( stencil.enabled )
+		{
+			if ( states.hasStencilFailOp )
+				stencil.front.failOp = stencil.back.failOp = states.stencilFailOp;
+
+			if ( states.hasStencilDepthFailOp )
+				stencil.front.depthFailOp = stencil.back.depthFailOp = states.stencilDepthFailOp;
+
+			if ( states.hasStencilPassOp )
+				stencil.front.passOp = stencil.back.passOp = states.stencilPassOp;
+		}
+
+		return	depth.test	and
+				depth.write	and
+				(depth.compareOp == ECompareOp::Less or depth.compareOp == ECompareOp::Greater) and
+				stencil.IsReadOnly();
+	}
+}	// namespace
+
 /*
 =================================================
 	constructor
@@ -53,7 +120,8 @@ namespace {
 		_area				= desc.area;
 		//_parallelExecution= desc.parallelExecution;
 		//_canBeMerged		= desc.canBeMerged;
-		//_useSecondaryCmdbuf	= desc.useSecondaryCmdbuf;
+		_useSecondaryCmdbuf	= desc.useSecondaryCmdbuf;
+		_sortDrawTasks		= desc.sortDrawTasks and not HasBlending( _colorState );
 		
 		Optional<MultiSamples>	samples;
 
@@ -64,8 +132,8 @@ namespace {
 		{
 			auto	offsets = src.second->GetDynamicOffsets();
 
-			_perPassResources.resources.emplace_back( src.first, fgThread.CreateDescriptorSet( *src.second ),
-													  uint(offset_count), uint(offsets.size()) );
+			_perPassResources.resources.emplace_back( src.first, null, uint(offset_count), uint(offsets.size()) );
+			fgThread.CreateDescriptorSet( *src.second, OUT _perPassResources.resources.back().pplnRes );
 			
 			for (size_t i = 0; i < offsets.size(); ++i, ++offset_count) {
 				_perPassResources.dynamicOffsets.push_back( offsets[i] );
@@ -140,6 +208,9 @@ namespace {
 			}
 		}
 
+		// without depth buffer result depends on draw order
+		_sortDrawTasks &= (_depthStencilTarget.IsDefined() and EPixelFormat_HasDepth( _depthStencilTarget.desc.format ));
+
 		// validate image samples
 		if ( samples.has_value() )
 		{
@@ -312,6 +383,43 @@ namespace {
 		return true;
 	}
 	
+/*
+=================================================
+	SortDrawTasks
+----
+	draw tasks are sorted by key that is calculated in 'VTaskProcessor::DrawTaskBarriers',
+	radix sort is stable so tasks with the same key keep insertion order.
+=================================================
+*/
+	void VLogicalRenderPass::SortDrawTasks ()
+	{
+		if ( not _sortDrawTasks or _drawTasks.size() < 2 )
+			return;
+
+		auto*	temp = _allocator->Alloc< IDrawTask* >( _drawTasks.size() );
+
+		RadixSort( _drawTasks.data(), temp, _drawTasks.size(), [] (const IDrawTask* task) { return task->sortKey; });
+	}
+	
+/*
+=================================================
+	_CanBeReordered
+----
+	result of blending, stencil writes and depth test without strict compare op depends on draw order
+=================================================
+*/
+	bool VLogicalRenderPass::_CanBeReordered (const VBaseDrawVerticesTask &task) const
+	{
+		return	not HasBlending( task.colorBuffers ) and
+				IsOrderIndependent( _depthState, _stencilState, task.dynamicStates );
+	}
+
+	bool VLogicalRenderPass::_CanBeReordered (const VBaseDrawMeshes &task) const
+	{
+		return	not HasBlending( task.colorBuffers ) and
+				IsOrderIndependent( _depthState, _stencilState, task.dynamicStates );
+	}
+
 /*
 =================================================
 	_SetRenderPass
@@ -84,7 +84,8 @@ namespace FG
 		RectI						_area;
 		//bool						_parallelExecution		= true;
 		//bool						_canBeMerged			= true;
-		//bool						_useSecondaryCmdbuf		= false;
+		bool						_useSecondaryCmdbuf		= false;
+		bool						_sortDrawTasks			= false;	// disabled if one of draw tasks depends on order
 		bool						_isSubmited				= false;
 		
 		VPipelineResourceSet		_perPassResources;
@@ -114,11 +115,16 @@ namespace FG
 		template <typename DrawTaskType, typename ...Args>
 		bool AddTask (Args&& ...args)
 		{
-			auto*	ptr = _allocator->Alloc<DrawTaskType>();
-			_drawTasks.push_back( PlacementNew<DrawTaskType>( ptr, *this, std::forward<Args&&>(args)... ));
+			auto*	ptr		= _allocator->Alloc<DrawTaskType>();
+			auto*	task	= PlacementNew<DrawTaskType>( ptr, *this, std::forward<Args&&>(args)... );
+			
+			_drawTasks.push_back( task );
+			_sortDrawTasks &= _CanBeReordered( *task );
 			return true;
 		}
 
+		void SortDrawTasks ();
+
 
 		bool Submit (VCommandBuffer &, ArrayView<Pair<RawImageID, EResourceState>>, ArrayView<Pair<RawBufferID, EResourceState>>);
 
@@ -136,6 +142,8 @@ namespace FG
 		ND_ RectI const&						GetArea ()					const	{ return _area; }
 
 		ND_ bool								IsSubmited ()				const	{ return _isSubmited; }
+		ND_ bool								UseSecondaryCmdbuf ()		const	{ return _useSecondaryCmdbuf; }
+		ND_ bool								IsDrawTaskSortingEnabled ()	const	{ return _sortDrawTasks; }
 		
 		ND_ RawFramebufferID					GetFramebufferID ()			const	{ return _framebufferId; }
 		ND_ RawRenderPassID						GetRenderPassID ()			const	{ return _renderPassId; }
@@ -161,6 +169,11 @@ namespace FG
 
 		ND_ MutableImages_t						GetMutableImages ()			const	{ return _mutableImages; }
 		ND_ MutableBuffers_t					GetMutableBuffers ()		const	{ return _mutableBuffers; }
+
+	private:
+		ND_ bool  _CanBeReordered (const VBaseDrawVerticesTask &) const;
+		ND_ bool  _CanBeReordered (const VBaseDrawMeshes &) const;
+		ND_ bool  _CanBeReordered (const VFgDrawTask<CustomDraw> &) const	{ return false; }
 	};
 
 
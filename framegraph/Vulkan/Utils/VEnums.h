@@ -13,7 +13,7 @@ namespace FG
 		HostRead		= uint(EMemoryType::HostRead),
 		HostWrite		= uint(EMemoryType::HostWrite),
 		Dedicated		= uint(EMemoryType::Dedicated),
-		//AllowAliasing	= uint(EMemoryType::AllowAliasing),
+		AllowAliasing	= uint(EMemoryType::AllowAliasing),
 		//Sparse		= uint(EMemoryType::Sparse),
 		_Offset			= uint(EMemoryType::_Last)-1,
 
@@ -79,6 +79,7 @@ namespace FG
 	class VLocalRTGeometry;
 	class VLocalRTScene;
 	class VRenderPassCache;
+	class IDrawTask;
 	class VBaseDrawVerticesTask;
 	class VBaseDrawMeshes;
 	class VComputePipeline;
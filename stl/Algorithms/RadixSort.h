@@ -0,0 +1,84 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	LSD radix sort for 64-bit keys, 8 bits per pass.
+	Sort is stable, passes where all keys have the same byte are skipped,
+	so cost depends on number of significant bytes in the keys.
+*/
+
+#pragma once
+
+#include "stl/Math/Math.h"
+
+namespace FGC
+{
+
+/*
+=================================================
+	RadixSort
+----
+	'temp' must have the same size as 'items'.
+	'keyFn' must return 'uint64_t' for each item, it is called many times
+	so it should be fast, for example returns precalculated key.
+=================================================
+*/
+	template <typename T, typename KeyFn>
+	inline void  RadixSort (INOUT T* items, INOUT T* temp, const size_t count, KeyFn &&keyFn)
+	{
+		static constexpr uint	BitsPerPass	= 8;
+		static constexpr uint	PassCount	= 64 / BitsPerPass;
+		static constexpr uint	BucketCount	= 1u << BitsPerPass;
+
+		if ( count < 2 )
+			return;
+
+		using Histogram_t = StaticArray< StaticArray< size_t, BucketCount >, PassCount >;
+
+		Histogram_t		histograms = {};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint64_t	key = keyFn( items[i] );
+
+			for (uint p = 0; p < PassCount; ++p) {
+				++histograms[p][ (key >> (p * BitsPerPass)) & (BucketCount-1) ];
+			}
+		}
+
+		T*	src = items;
+		T*	dst = temp;
+
+		for (uint p = 0; p < PassCount; ++p)
+		{
+			auto&	hist = histograms[p];
+
+			// all keys have same byte
+			if ( hist[ (keyFn( src[0] ) >> (p * BitsPerPass)) & (BucketCount-1) ] == count )
+				continue;
+
+			// exclusive prefix sum
+			size_t	offset = 0;
+			for (auto& h : hist)
+			{
+				size_t	c = h;
+				h		= offset;
+				offset += c;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const uint64_t	key = keyFn( src[i] );
+				dst[ hist[ (key >> (p * BitsPerPass)) & (BucketCount-1) ]++ ] = std::move( src[i] );
+			}
+			std::swap( src, dst );
+		}
+
+		if ( src != items )
+		{
+			for (size_t i = 0; i < count; ++i) {
+				items[i] = std::move( src[i] );
+			}
+		}
+	}
+
+
+}	// FGC
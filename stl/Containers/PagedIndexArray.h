@@ -0,0 +1,116 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Sparse array of indices, used to remap indices from a large range into a small range.
+	Memory for pages is allocated only when index in this page is written,
+	'Clear' resets only modified pages, so cost is proportional to number of used indices.
+*/
+
+#pragma once
+
+#include "stl/Math/BitMath.h"
+#include "stl/Math/Math.h"
+
+namespace FGC
+{
+
+	//
+	// Paged Index Array
+	//
+
+	template <typename IndexType,
+			  size_t Capacity,
+			  size_t PageSize = 256
+			 >
+	struct PagedIndexArray final
+	{
+		STATIC_ASSERT( IsPowerOfTwo( PageSize ));
+		STATIC_ASSERT( std::is_unsigned_v<IndexType> );
+
+	// types
+	public:
+		using Self		= PagedIndexArray< IndexType, Capacity, PageSize >;
+		using Index_t	= IndexType;
+
+	private:
+		static constexpr size_t		PageCount		= (Capacity + PageSize - 1) / PageSize;
+		static constexpr Index_t	InvalidIndex	= Index_t(~Index_t(0));
+
+		using Page_t	= StaticArray< Index_t, PageSize >;
+		using Pages_t	= StaticArray< UniquePtr<Page_t>, PageCount >;
+		using PageIdx_t	= Conditional< (PageCount <= 0xFFFF), uint16_t, uint32_t >;
+
+
+	// variables
+	private:
+		Pages_t				_pages;
+		Array<PageIdx_t>	_modified;		// pages that must be reset in 'Clear'
+		BitSet<PageCount>	_isModified;
+
+
+	// methods
+	public:
+		PagedIndexArray () {}
+		PagedIndexArray (const Self &) = delete;
+		PagedIndexArray (Self &&) = default;
+
+		Self& operator = (const Self &) = delete;
+		Self& operator = (Self &&) = default;
+
+
+		// returns 'InvalidIndex' if value was not written
+		ND_ Index_t  operator [] (size_t index) const
+		{
+			ASSERT( index < Capacity );
+			auto&	page = _pages[ index / PageSize ];
+			return page ? (*page)[ index % PageSize ] : InvalidIndex;
+		}
+
+
+		// allocates page if needed
+		ND_ Index_t&  operator () (size_t index)
+		{
+			ASSERT( index < Capacity );
+			const size_t	page_idx = index / PageSize;
+			auto&			page	 = _pages[ page_idx ];
+
+			if ( not page )
+			{
+				page.reset( new Page_t{} );
+				page->fill( InvalidIndex );
+			}
+
+			if ( not _isModified[ page_idx ])
+			{
+				_isModified.set( page_idx );
+				_modified.push_back( PageIdx_t(page_idx) );
+			}
+			return (*page)[ index % PageSize ];
+		}
+
+
+		// pages are not released to avoid reallocation in next frame
+		void  Clear ()
+		{
+			for (auto idx : _modified) {
+				_pages[ idx ]->fill( InvalidIndex );
+			}
+			_modified.clear();
+			_isModified.reset();
+		}
+
+
+		ND_ static constexpr size_t  capacity ()		{ return Capacity; }
+		ND_ static constexpr Index_t  Invalid ()		{ return InvalidIndex; }
+
+		ND_ size_t  AllocatedPages () const
+		{
+			size_t	count = 0;
+			for (auto& page : _pages) {
+				count += (page ? 1 : 0);
+			}
+			return count;
+		}
+	};
+
+
+}	// FGC
@@ -139,6 +139,15 @@ namespace FGC
 			}
 			return size;
 		}
+
+		ND_ BytesU  UsedSize () const
+		{
+			BytesU	size;
+			for (auto& block : _blocks) {
+				size += block.size;
+			}
+			return size;
+		}
 	};
 
 
@@ -0,0 +1,243 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Read-mostly concurrent hash map with open addressing.
+
+	'Find' and 'CompareExchange' are lock-free, 'Insert' is serialized by mutex.
+	Elements can't be removed, only value can be changed.
+	When table grows the previous table is retired and released only in 'Clear' or destructor,
+	so lock-free readers never access released memory, total size of retired tables is less than size of current table.
+*/
+
+#pragma once
+
+#include "stl/Common.h"
+#include "stl/Math/BitMath.h"
+#include "stl/Algorithms/Cast.h"
+#include <atomic>
+
+namespace FGC
+{
+
+	//
+	// Lock-free Hash Map
+	//
+
+	template <typename KeyType,
+			  typename ValueType,
+			  typename Hasher = std::hash<KeyType>,
+			  typename KeyEq = std::equal_to<KeyType>
+			 >
+	class LfHashMap final
+	{
+		STATIC_ASSERT( std::is_trivially_copyable_v<ValueType> );
+
+	// types
+	public:
+		using Self		= LfHashMap< KeyType, ValueType, Hasher, KeyEq >;
+		using Key_t		= KeyType;
+		using Value_t	= ValueType;
+
+	private:
+		struct Node
+		{
+			const size_t		hash;
+			const Key_t			key;
+			Atomic<Value_t>		value;
+
+			Node (size_t h, const Key_t &k, const Value_t &v) : hash{h}, key{k}, value{v} {}
+		};
+
+		struct Table
+		{
+			UniquePtr< Atomic<Node *>[] >	slots;
+			size_t							mask	= 0;	// capacity - 1
+			UniquePtr< Table >				retired;		// previous table, may be used by readers
+		};
+
+		static constexpr size_t		InitialCapacity	= 16;
+
+		STATIC_ASSERT( Atomic<Node *>::is_always_lock_free );
+		STATIC_ASSERT( Atomic<Table *>::is_always_lock_free );
+
+
+	// variables
+	private:
+		Atomic< Table *>	_table		{null};
+		mutable Mutex		_writeGuard;
+		size_t				_count		= 0;	// protected by '_writeGuard'
+
+
+	// methods
+	public:
+		LfHashMap () {}
+		LfHashMap (const Self &) = delete;
+		LfHashMap (Self &&) = delete;
+		~LfHashMap ()	{ Clear(); }
+
+		Self& operator = (const Self &) = delete;
+		Self& operator = (Self &&) = delete;
+
+
+		// lock-free search
+		ND_ bool  Find (const Key_t &key, OUT Value_t &value) const
+		{
+			Node const*	node = _Find( key, Hasher{}( key ));
+			if ( node ) {
+				value = node->value.load( memory_order_acquire );
+				return true;
+			}
+			return false;
+		}
+
+
+		// returns 'true' if new element was inserted, 'stored' contains value that is stored in the map
+		bool  Insert (const Key_t &key, const Value_t &value, OUT Value_t &stored)
+		{
+			const size_t	hash = Hasher{}( key );
+			EXLOCK( _writeGuard );
+
+			Table*	table = _table.load( memory_order_relaxed );
+
+			if ( Node const* node = _Find( table, key, hash ))
+			{
+				stored = node->value.load( memory_order_acquire );
+				return false;
+			}
+
+			// keep load factor less than 0.5 to reduce probe sequence length
+			if ( table == null or (_count + 1) * 2 > table->mask + 1 )
+				table = _Grow( table );
+
+			_InsertNode( *table, new Node{ hash, key, value });
+			++_count;
+
+			stored = value;
+			return true;
+		}
+
+
+		// lock-free value replacement, returns 'false' if element is not exists or value is not equal to 'expected'
+		bool  CompareExchange (const Key_t &key, INOUT Value_t &expected, const Value_t &desired)
+		{
+			Node*	node = const_cast<Node *>( _Find( key, Hasher{}( key )));
+			if ( node == null )
+				return false;
+
+			return node->value.compare_exchange_strong( INOUT expected, desired, memory_order_acq_rel, memory_order_acquire );
+		}
+
+
+		// not thread safe, all readers must be finished
+		template <typename FN>
+		void  ForEach (FN &&fn) const
+		{
+			std::atomic_thread_fence( memory_order_acquire );
+
+			Table const*	table = _table.load( memory_order_relaxed );
+			if ( table == null )
+				return;
+
+			for (size_t i = 0; i <= table->mask; ++i)
+			{
+				if ( Node const* node = table->slots[i].load( memory_order_relaxed ))
+					fn( node->key, node->value.load( memory_order_relaxed ));
+			}
+		}
+
+
+		// not thread safe, all readers must be finished
+		void  Clear ()
+		{
+			EXLOCK( _writeGuard );
+
+			UniquePtr<Table>	table{ _table.exchange( null, memory_order_acquire )};
+			if ( not table )
+				return;
+
+			for (size_t i = 0; i <= table->mask; ++i)
+			{
+				delete table->slots[i].load( memory_order_relaxed );
+			}
+			_count = 0;
+		}
+
+
+		ND_ size_t  Count () const
+		{
+			EXLOCK( _writeGuard );
+			return _count;
+		}
+
+		ND_ bool  Empty () const	{ return Count() == 0; }
+
+
+	private:
+		ND_ Node const*  _Find (const Key_t &key, size_t hash) const
+		{
+			return _Find( _table.load( memory_order_acquire ), key, hash );
+		}
+
+		ND_ static Node const*  _Find (Table const* table, const Key_t &key, size_t hash)
+		{
+			if ( table == null )
+				return null;
+
+			for (size_t i = (hash & table->mask), j = 0; j <= table->mask; i = ((i + 1) & table->mask), ++j)
+			{
+				Node const*	node = table->slots[i].load( memory_order_acquire );
+
+				if ( node == null )
+					return null;
+
+				if ( node->hash == hash and KeyEq{}( node->key, key ))
+					return node;
+			}
+			return null;
+		}
+
+
+		static void  _InsertNode (Table &table, Node* node)
+		{
+			for (size_t i = (node->hash & table.mask);; i = ((i + 1) & table.mask))
+			{
+				if ( table.slots[i].load( memory_order_relaxed ) == null )
+				{
+					table.slots[i].store( node, memory_order_release );
+					return;
+				}
+			}
+		}
+
+
+		ND_ Table*  _Grow (Table* oldTable)
+		{
+			const size_t	capacity = oldTable ? (oldTable->mask + 1) * 2 : InitialCapacity;
+			ASSERT( IsPowerOfTwo( capacity ));
+
+			auto	table = MakeUnique<Table>();
+			table->slots.reset( new Atomic<Node *>[ capacity ] );
+			table->mask = capacity - 1;
+
+			for (size_t i = 0; i < capacity; ++i) {
+				table->slots[i].store( null, memory_order_relaxed );
+			}
+
+			if ( oldTable )
+			{
+				for (size_t i = 0; i <= oldTable->mask; ++i)
+				{
+					if ( Node* node = oldTable->slots[i].load( memory_order_relaxed ))
+						_InsertNode( *table, node );
+				}
+				table->retired.reset( oldTable );
+			}
+
+			// publish new table, readers may still use the retired table
+			Table*	result = table.release();
+			_table.store( result, memory_order_release );
+			return result;
+		}
+	};
+
+
+}	// FGC
@@ -0,0 +1,124 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/ThreadPool.h"
+#include "stl/Platforms/ThreadName.h"
+#include "stl/Algorithms/StringUtils.h"
+
+namespace FGC
+{
+
+/*
+=================================================
+	destructor
+=================================================
+*/
+	ThreadPool::~ThreadPool ()
+	{
+		Release();
+	}
+
+/*
+=================================================
+	Create
+=================================================
+*/
+	bool  ThreadPool::Create (uint threadCount, StringView name)
+	{
+		CHECK_ERR( threadCount > 0 );
+		CHECK_ERR( _threads.empty() );
+
+		_looping = true;
+		_threads.reserve( threadCount );
+
+		for (uint i = 0; i < threadCount; ++i)
+		{
+			_threads.emplace_back( [this, thread_name = String(name) << '_' << ToString(i)] ()
+			{
+				SetCurrentThreadName( thread_name );
+				_Loop();
+			});
+		}
+		return true;
+	}
+
+/*
+=================================================
+	Release
+=================================================
+*/
+	void  ThreadPool::Release ()
+	{
+		{
+			EXLOCK( _guard );
+			_looping = false;
+		}
+		_cv.notify_all();
+
+		for (auto& t : _threads) {
+			t.join();
+		}
+		_threads.clear();
+
+		// process remaining jobs in current thread
+		for (; ProcessJob();) {}
+	}
+
+/*
+=================================================
+	Enqueue
+=================================================
+*/
+	void  ThreadPool::Enqueue (Job_t &&job)
+	{
+		{
+			EXLOCK( _guard );
+			_jobs.push_back( std::move(job) );
+		}
+		_cv.notify_one();
+	}
+
+/*
+=================================================
+	ProcessJob
+=================================================
+*/
+	bool  ThreadPool::ProcessJob ()
+	{
+		Job_t	job;
+		{
+			EXLOCK( _guard );
+			if ( _jobs.empty() )
+				return false;
+
+			job = std::move( _jobs.front() );
+			_jobs.pop_front();
+		}
+		job();
+		return true;
+	}
+
+/*
+=================================================
+	_Loop
+=================================================
+*/
+	void  ThreadPool::_Loop ()
+	{
+		for (;;)
+		{
+			Job_t	job;
+			{
+				std::unique_lock	lock{ _guard };
+				_cv.wait( lock, [this] () { return not _jobs.empty() or not _looping; });
+
+				if ( _jobs.empty() )
+					return;
+
+				job = std::move( _jobs.front() );
+				_jobs.pop_front();
+			}
+			job();
+		}
+	}
+
+}	// FGC
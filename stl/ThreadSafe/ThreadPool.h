@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Simple thread pool with shared job queue.
+	Thread that waits for results may call 'ProcessJob' to help worker threads.
+*/
+
+#pragma once
+
+#include "stl/Common.h"
+#include <thread>
+#include <condition_variable>
+
+namespace FGC
+{
+
+	//
+	// Thread Pool
+	//
+
+	class ThreadPool final
+	{
+	// types
+	public:
+		using Job_t		= Function< void () >;
+
+	private:
+		using Threads_t	= Array< std::thread >;
+		using Jobs_t	= Deque< Job_t >;
+
+
+	// variables
+	private:
+		Mutex						_guard;
+		std::condition_variable		_cv;
+		Jobs_t						_jobs;
+		Threads_t					_threads;
+		bool						_looping	= false;
+
+
+	// methods
+	public:
+		ThreadPool () {}
+		~ThreadPool ();
+
+		ThreadPool (ThreadPool &&) = delete;
+		ThreadPool (const ThreadPool &) = delete;
+
+		ThreadPool& operator = (const ThreadPool &) = delete;
+		ThreadPool& operator = (ThreadPool &&) = delete;
+
+		bool  Create (uint threadCount, StringView name);
+		void  Release ();
+
+		void  Enqueue (Job_t &&job);
+
+		// executes one job in current thread, returns 'false' if queue is empty
+		bool  ProcessJob ();
+
+		ND_ uint  ThreadCount ()	const	{ return uint(_threads.size()); }
+		ND_ bool  IsCreated ()		const	{ return not _threads.empty(); }
+
+	private:
+		void  _Loop ();
+	};
+
+}	// FGC
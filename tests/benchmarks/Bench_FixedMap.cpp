@@ -0,0 +1,58 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Containers/FixedMap.h"
+#include "Benchmark.h"
+
+
+namespace
+{
+	template <size_t Size>
+	void  FixedMapLookup (Benchmark &bench)
+	{
+		constexpr uint	count = 100'000;
+
+		FixedMap< uint, uint, Size >	map;
+		for (uint i = 0; i < Size; ++i) {
+			map.insert({ i * 7919u, i });
+		}
+
+		bench.Run( "FixedMap<"s << ToString( Size ) << ">.Find", count, [&] ()
+		{
+			uint	sum = 0;
+			for (uint i = 0; i < count; ++i)
+			{
+				// 3/4 of keys are exists in map
+				auto	iter = map.find( (i % (Size + Size/3)) * 7919u );
+				sum += (iter != map.end() ? iter->second : 0);
+			}
+			DoNotOptimize( sum );
+		});
+
+		// compare with hash map of the same size
+		HashMap< uint, uint >	hash_map;
+		for (uint i = 0; i < Size; ++i) {
+			hash_map.insert({ i * 7919u, i });
+		}
+
+		bench.Run( "HashMap<"s << ToString( Size ) << ">.Find", count, [&] ()
+		{
+			uint	sum = 0;
+			for (uint i = 0; i < count; ++i)
+			{
+				auto	iter = hash_map.find( (i % (Size + Size/3)) * 7919u );
+				sum += (iter != hash_map.end() ? iter->second : 0);
+			}
+			DoNotOptimize( sum );
+		});
+	}
+}	// namespace
+
+
+extern void Bench_FixedMap (Benchmark &bench)
+{
+	FixedMapLookup< 8 >( bench );
+	FixedMapLookup< 32 >( bench );
+	FixedMapLookup< 128 >( bench );
+
+	FG_LOGI( "Bench_FixedMap - finished" );
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Benchmark.h"
+
+#ifdef FG_ENABLE_GLM
+# include "scene/Math/Frustum.h"
+
+namespace
+{
+	void  FrustumCulling (Benchmark &bench)
+	{
+		constexpr uint	count = 100'000;
+
+		Camera		camera;
+		Frustum		frustum;
+		camera.SetPerspective( 60.0_deg, 1.5f, vec2(0.1f, 500.0f) );
+		frustum.Setup( camera );
+
+		// instances are placed on the grid around camera, about 1/6 of them are visible
+		Array<AABB>		boxes;
+		boxes.reserve( count );
+		for (uint i = 0; i < count; ++i)
+		{
+			const float	x = float(int(i % 100) - 50) * 10.0f;
+			const float	z = float(int(i / 100) % 100 - 50) * 10.0f;
+			const float	y = float(int(i / 10'000) - 5) * 10.0f;
+			boxes.push_back( AABB{}.SetExtent( vec3{float(i % 5) + 1.0f} ).SetCenter( vec3{x, y, z} ));
+		}
+
+		bench.Run( "Frustum.IsVisible(AABB) x100k", count, [&] ()
+		{
+			uint	visible = 0;
+			for (auto& bbox : boxes) {
+				visible += uint(frustum.IsVisible( bbox ));
+			}
+			DoNotOptimize( visible );
+		});
+
+		Array<uint64_t>	bits;
+		bench.Run( "Frustum.GetVisibility(AABB) x100k", count, [&] ()
+		{
+			frustum.GetVisibility( boxes, vec3{0.0f}, OUT bits );
+			DoNotOptimize( bits.data() );
+		});
+	}
+}	// namespace
+
+
+extern void Bench_FrustumCulling (Benchmark &bench)
+{
+	FrustumCulling( bench );
+
+	FG_LOGI( "Bench_FrustumCulling - finished" );
+}
+
+#endif	// FG_ENABLE_GLM
@@ -0,0 +1,68 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Common.h"
+#include "Benchmark.h"
+
+
+extern void Bench_Hash (Benchmark &bench)
+{
+	constexpr uint	count = 1'000'000;
+
+	bench.Run( "HashVal.Combine.Integer", count, [&] ()
+	{
+		HashVal	h;
+		for (uint i = 0; i < count; ++i) {
+			h << HashOf( i );
+		}
+		DoNotOptimize( h );
+	});
+
+	bench.Run( "HashVal.Combine.Float", count, [&] ()
+	{
+		HashVal	h;
+		for (uint i = 0; i < count; ++i) {
+			h << HashOf( float(i) * 0.5f );
+		}
+		DoNotOptimize( h );
+	});
+
+	// typical structure, like 'ImageDesc' or 'SamplerDesc'
+	struct Desc
+	{
+		uint		a, b, c, d;
+		float		e, f;
+		uint64_t	g;
+	};
+
+	bench.Run( "HashVal.Combine.Struct", count, [&] ()
+	{
+		HashVal	h;
+		Desc	desc = { 1, 2, 3, 4, 0.5f, 1.5f, 7 };
+
+		for (uint i = 0; i < count; ++i)
+		{
+			desc.a = i;
+			h << (HashOf( desc.a ) + HashOf( desc.b ) + HashOf( desc.c ) + HashOf( desc.d ) +
+				  HashOf( desc.e ) + HashOf( desc.f ) + HashOf( desc.g ));
+		}
+		DoNotOptimize( h );
+	});
+
+	Array<uint8_t>	data;	data.resize( 256 );
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = uint8_t(i * 31);
+	}
+
+	bench.Run( "HashOf.Buffer256", count / 16, [&] ()
+	{
+		HashVal	h;
+		for (uint i = 0; i < count / 16; ++i)
+		{
+			data[0] = uint8_t(i);
+			h << HashOf( data.data(), data.size() );
+		}
+		DoNotOptimize( h );
+	});
+
+	FG_LOGI( "Bench_Hash - finished" );
+}
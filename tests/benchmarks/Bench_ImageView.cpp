@@ -0,0 +1,67 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Benchmark.h"
+#include "framegraph/Public/ImageView.h"
+
+using namespace FG;
+
+namespace
+{
+	void  ImageViewLoad (Benchmark &bench, StringView name, EPixelFormat format, EImageAspect aspect, BytesU bytesPerPixel)
+	{
+		const uint3		dim			{ 3840, 2160, 1 };
+		const BytesU	row_pitch	= bytesPerPixel * dim.x;
+		const uint64_t	count		= uint64_t(dim.x) * dim.y;
+
+		// values are limited to avoid nan and inf in float formats
+		Array<uint8_t>	data;
+		data.resize( size_t(row_pitch * dim.y) );
+
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = uint8_t((i * 37) & 0x3F);
+		}
+
+		const ArrayView<uint8_t>	part	{ data };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, dim, row_pitch, row_pitch * dim.y, format, aspect };
+
+		bench.Run( "ImageView.Load("s << name << ") 4K", count, [&] ()
+		{
+			RGBA32f		sum;
+			for (uint y = 0; y < dim.y; ++y)
+			for (uint x = 0; x < dim.x; ++x)
+			{
+				RGBA32f		col;
+				view.Load( uint3{x, y, 0}, OUT col );
+				sum.r += col.r;
+			}
+			DoNotOptimize( sum );
+		});
+
+		Array<RGBA32f>	pixels;
+		bench.Run( "ImageView.ConvertTo<RGBA32f>("s << name << ") 4K", count, [&] ()
+		{
+			CHECK( view.ConvertTo( OUT pixels ));
+			DoNotOptimize( pixels.data() );
+		});
+
+		Array<RGBA8u>	pixels8;
+		bench.Run( "ImageView.ConvertTo<RGBA8u>("s << name << ") 4K", count, [&] ()
+		{
+			CHECK( view.ConvertTo( OUT pixels8 ));
+			DoNotOptimize( pixels8.data() );
+		});
+	}
+}	// namespace
+
+
+extern void Bench_ImageView (Benchmark &bench)
+{
+	ImageViewLoad( bench, "RGBA8",		EPixelFormat::RGBA8_UNorm,		EImageAspect::Color,	4_b );
+	ImageViewLoad( bench, "BGRA8",		EPixelFormat::BGRA8_UNorm,		EImageAspect::Color,	4_b );
+	ImageViewLoad( bench, "RGBA16F",	EPixelFormat::RGBA16F,			EImageAspect::Color,	8_b );
+	ImageViewLoad( bench, "R11G11B10F",	EPixelFormat::RGB_11_11_10F,	EImageAspect::Color,	4_b );
+	ImageViewLoad( bench, "Depth24",	EPixelFormat::Depth24,			EImageAspect::Depth,	4_b );
+	ImageViewLoad( bench, "Depth32F",	EPixelFormat::Depth32F,			EImageAspect::Depth,	4_b );
+
+	FG_LOGI( "Bench_ImageView - finished" );
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Containers/ChunkedIndexedPool.h"
+#include "stl/ThreadSafe/LfIndexedPool.h"
+#include "Benchmark.h"
+#include <mutex>
+
+
+namespace
+{
+	// same settings as in 'VResourceManager'
+	using ChunkedPool_t	= ChunkedIndexedPool< uint64_t, uint16_t, 1u << 10, 63, UntypedAlignedAllocator, Mutex, AtomicPtr >;
+
+	// same settings as in 'VFrameGraph'
+	using LfPool_t		= LfIndexedPool< uint64_t, uint, 32, 16 >;
+
+	static constexpr uint	HeldPerThread	= 8;
+
+
+	template <typename PoolType>
+	void  AssignUnassign (PoolType &pool, uint count)
+	{
+		using Index_t = typename PoolType::Index_t;
+
+		// keep some indices to emulate resources with different lifetime
+		Index_t		held [HeldPerThread];
+
+		for (uint i = 0; i < count; i += HeldPerThread)
+		{
+			for (uint j = 0; j < HeldPerThread; ++j)
+			{
+				TEST( pool.Assign( OUT held[j] ));
+				pool[ held[j] ] = i + j;
+			}
+			for (uint j = 0; j < HeldPerThread; ++j)
+			{
+				pool.Unassign( held[j] );
+			}
+		}
+	}
+
+
+	template <typename PoolType>
+	void  RunPoolBenchmarks (Benchmark &bench, StringView name, PoolType &pool)
+	{
+		constexpr uint	count		= 64'000;
+		const uint		max_threads	= Clamp( std::thread::hardware_concurrency(), 2u, 8u );
+
+		bench.Run( String{name} << ".AssignUnassign", count, [&] () { AssignUnassign( pool, count ); });
+
+		for (uint threads = 2; threads <= max_threads; threads *= 2)
+		{
+			bench.RunParallel( String{name} << ".AssignUnassign.Contention", threads, count,
+							   [&] (uint) { AssignUnassign( pool, count ); });
+		}
+	}
+}	// namespace
+
+
+extern void Bench_IndexedPool (Benchmark &bench)
+{
+	{
+		ChunkedPool_t	pool;
+		RunPoolBenchmarks( bench, "ChunkedIndexedPool", pool );
+	}
+	{
+		LfPool_t	pool;
+		RunPoolBenchmarks( bench, "LfIndexedPool", pool );
+		pool.Release();
+	}
+
+	FG_LOGI( "Bench_IndexedPool - finished" );
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Memory/LinearAllocator.h"
+#include "Benchmark.h"
+
+
+extern void Bench_LinearAllocator (Benchmark &bench)
+{
+	constexpr uint	count = 100'000;
+
+	// small allocations with different alignment, memory is reused after 'Discard'
+	{
+		LinearAllocator<>	alloc;
+		alloc.SetBlockSize( 4_Mb );
+
+		bench.Run( "LinearAllocator.Alloc.Small", count, [&] ()
+		{
+			for (uint i = 0; i < count; ++i)
+			{
+				void*	ptr = alloc.Alloc( BytesU{ 8 + (i & 63) }, BytesU{ 1u << (i & 3) });
+				DoNotOptimize( ptr );
+			}
+			alloc.Discard();
+		});
+	}
+
+	// new blocks are allocated on each iteration
+	{
+		bench.Run( "LinearAllocator.Alloc.NewBlocks", count, [&] ()
+		{
+			LinearAllocator<>	alloc;
+			alloc.SetBlockSize( 64_Kb );
+
+			for (uint i = 0; i < count; ++i)
+			{
+				void*	ptr = alloc.Alloc( 48_b, 16_b );
+				DoNotOptimize( ptr );
+			}
+		});
+	}
+
+	// typical usage in task graph: std containers with linear allocator
+	{
+		LinearAllocator<>	alloc;
+		alloc.SetBlockSize( 4_Mb );
+
+		bench.Run( "LinearAllocator.StdVector", count, [&] ()
+		{
+			std::vector< uint, StdLinearAllocator<uint> >	vec{ StdLinearAllocator<uint>{ alloc }};
+
+			for (uint i = 0; i < count; ++i) {
+				vec.push_back( i );
+			}
+			DoNotOptimize( vec.data() );
+			alloc.Discard();
+		});
+	}
+
+	FG_LOGI( "Bench_LinearAllocator - finished" );
+}
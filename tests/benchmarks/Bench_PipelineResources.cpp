@@ -0,0 +1,158 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VPipelineResources.h"
+#include "VResourceManager.h"
+#include "framegraph/Shared/PipelineResourcesHelper.h"
+#include "Benchmark.h"
+
+using namespace FG;
+
+
+namespace
+{
+	// same settings as in 'VResourceManager'
+	using PplnResourcesPool_t	= VResourceManager::PplnResourcesPool_t;
+	using Index_t				= VResourceManager::Index_t;
+
+	static constexpr uint	BufferCount		= 4;
+	static constexpr uint	TextureCount	= 4;
+
+
+	// destroy previous resource instance and construct new instance
+	template <typename ResType, typename ...Args>
+	void  Replace (INOUT ResourceBase<ResType> &target, Args&& ...args)
+	{
+		target.Data().~ResType();
+		new (&target.Data()) ResType{ std::forward<Args &&>(args)... };
+	}
+
+
+	ND_ UniformID  BufferName (uint i)		{ return UniformID{ "un_Buffer"s << ToString(i) }; }
+	ND_ UniformID  TextureName (uint i)		{ return UniformID{ "un_Texture"s << ToString(i) }; }
+
+
+	// creates resources with layout similar to typical material
+	void  CreateResources (OUT PipelineResources &res)
+	{
+		auto	uniforms = MakeShared< PipelineDescription::UniformMap_t >();
+
+		for (uint i = 0; i < BufferCount; ++i)
+		{
+			PipelineDescription::UniformBuffer	ub;
+			ub.state	= EResourceState::UniformRead | EResourceState::_FragmentShader;
+			ub.size		= 256_b;
+
+			uniforms->insert({ BufferName(i), PipelineDescription::Uniform{ ub, BindingIndex{ i, i }, 1, EShaderStages::Fragment }});
+		}
+
+		for (uint i = 0; i < TextureCount; ++i)
+		{
+			PipelineDescription::Texture	tex;
+			tex.state		= EResourceState::ShaderSample | EResourceState::_FragmentShader;
+			tex.textureType	= EImageSampler::Float2D;
+
+			uniforms->insert({ TextureName(i), PipelineDescription::Uniform{ tex, BindingIndex{ i, BufferCount + i }, 1, EShaderStages::Fragment }});
+		}
+
+		auto	data = PipelineResourcesHelper::CreateDynamicData( uniforms, BufferCount + TextureCount, BufferCount + TextureCount, 0 );
+		TEST( PipelineResourcesHelper::Initialize( OUT res, RawDescriptorSetLayoutID{ 0, 0 }, data ));
+	}
+
+
+	// images and buffers are allocated from different pools, so indices are unrelated
+	void  BindResources (INOUT PipelineResources &res, uint seed)
+	{
+		for (uint i = 0; i < BufferCount; ++i) {
+			res.BindBuffer( BufferName(i), RawBufferID{ Index_t(seed + i), 0 }, 0_b, 256_b );
+		}
+		for (uint i = 0; i < TextureCount; ++i) {
+			res.BindTexture( TextureName(i), RawImageID{ Index_t((seed * 7 + i * 3) % 0xFFFF), 0 }, RawSamplerID{ 0, 0 });
+		}
+	}
+}	// namespace
+
+
+extern void Bench_PipelineResources (Benchmark &bench)
+{
+	PipelineResources			res;
+	PipelineResources const&	cres = res;		// non-const reference will be moved into 'VPipelineResources'
+
+	CreateResources( OUT res );
+	BindResources( INOUT res, 1 );
+
+	// hashing
+	{
+		constexpr uint	count	= 100'000;
+		auto			data	= PipelineResourcesHelper::CloneDynamicData( res );
+
+		bench.Run( "PipelineResources.CalcHash", count, [&] ()
+		{
+			HashVal	h;
+			for (uint i = 0; i < count; ++i) {
+				h << data->CalcHash();
+			}
+			DoNotOptimize( h );
+		});
+
+		// clone + hash, executed for each new descriptor set in 'VResourceManager::CreateDescriptorSet'
+		bench.Run( "VPipelineResources.Create", count, [&] ()
+		{
+			for (uint i = 0; i < count; ++i)
+			{
+				VPipelineResources	temp{ cres };
+				DoNotOptimize( temp.GetHash() );
+			}
+		});
+	}
+
+	// cache lookup
+	{
+		constexpr uint		cached_count	= 1000;
+		constexpr uint		query_count		= 256;
+		constexpr uint		count			= 10'000;
+		PplnResourcesPool_t	pool;
+		Array<Index_t>		indices;
+
+		for (uint i = 0; i < cached_count; ++i)
+		{
+			Index_t	idx;
+			TEST( pool.Assign( OUT idx ));
+
+			BindResources( INOUT res, i * 2 );
+			Replace( pool[idx], cres );
+			TEST( pool.AddToCache( idx ).second );
+
+			indices.push_back( idx );
+		}
+
+		// half of queries will be found in cache
+		Array<UniquePtr< ResourceBase<VPipelineResources> >>	queries;
+		for (uint i = 0; i < query_count; ++i)
+		{
+			queries.push_back( MakeUnique< ResourceBase<VPipelineResources> >() );
+			BindResources( INOUT res, (i & 1 ? i : cached_count + i) * 2 );
+			Replace( *queries.back(), cres );
+		}
+
+		bench.Run( "CachedIndexedPool<VPipelineResources>.Find", count, [&] ()
+		{
+			uint	found = 0;
+			for (uint i = 0; i < count; ++i) {
+				found += uint(pool.Find( queries[ i % query_count ].get() ) != UMax);
+			}
+			TEST( found == count / 2 );
+		});
+
+		for (auto idx : indices)
+		{
+			pool.RemoveFromCache( idx );
+			pool.Unassign( idx );
+		}
+	}
+
+	FG_LOGI( "Bench_PipelineResources - finished" );
+}
+
+#endif	// FG_ENABLE_VULKAN
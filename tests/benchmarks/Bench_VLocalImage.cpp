@@ -0,0 +1,120 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VLocalImage.h"
+#include "VBarrierManager.h"
+#include "VTaskGraph.h"
+#include "Benchmark.h"
+
+namespace FG
+{
+	class VImageUnitTest
+	{
+	public:
+		static bool Create (VImage &img, const ImageDesc &desc)
+		{
+			img._desc	= desc;
+			img._desc.Validate();
+
+			img._defaultLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			return true;
+		}
+	};
+
+	class VFgDummyTask final : public VFrameGraphTask
+	{
+	};
+}	// FG
+
+using namespace FG;
+
+
+namespace
+{
+	using ImageState	= VLocalImage::ImageState;
+	using ImageRange	= VLocalImage::ImageRange;
+
+
+	ND_ Array<UniquePtr<VFgDummyTask>>  GenDummyTasks (size_t count)
+	{
+		Array<UniquePtr<VFgDummyTask>>	result;		result.reserve( count );
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			UniquePtr<VFgDummyTask>		task{ new VFgDummyTask()};
+			task->SetExecutionOrder( ExeOrderIndex(size_t(ExeOrderIndex::First) + i) );
+			result.push_back( std::move(task) );
+		}
+		return result;
+	}
+}	// namespace
+
+
+extern void Bench_VLocalImage (Benchmark &bench)
+{
+	constexpr uint		frame_count	= 100;
+	VBarrierManager		barrier_mngr;
+	VImage				global_image;
+	VLocalImage			local_image;
+	VLocalImage const*	img			= &local_image;
+
+	TEST( VImageUnitTest::Create( global_image,
+								  ImageDesc{}.SetDimension({ 1024, 1024 }).SetFormat( EPixelFormat::RGBA8_UNorm )
+											.SetUsage( EImageUsage::ColorAttachment | EImageUsage::Transfer | EImageUsage::Storage | EImageUsage::Sampled )
+											.SetAllMipmaps().SetArrayLayers( 6 )));
+	TEST( local_image.Create( &global_image ));
+
+	const uint	mipmaps		= img->MipmapLevels();
+	const uint	layers		= img->ArrayLayers();
+	const auto	tasks		= GenDummyTasks( 4 + mipmaps * (layers + 1) );
+	uint		state_count	= 0;
+
+	// mipmap generation per layer, then sampling of whole image:
+	// each access covers part of the image, so access records are splitted and merged
+	const auto	Frame = [&] ()
+	{
+		auto	task_iter = tasks.begin();
+
+		img->AddPendingState( ImageState{ EResourceState::TransferDst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+										  ImageRange{ 0_layer, layers, 0_mipmap, 1 }, VK_IMAGE_ASPECT_COLOR_BIT, (task_iter++)->get() });
+		img->CommitBarrier( barrier_mngr, null );
+
+		for (uint layer = 0; layer < layers; ++layer)
+		{
+			for (uint mip = 1; mip < mipmaps; ++mip)
+			{
+				VTask	task = (task_iter++)->get();
+				img->AddPendingState( ImageState{ EResourceState::TransferSrc, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+												  ImageRange{ ImageLayer(layer), 1, MipmapLevel(mip-1), 1 }, VK_IMAGE_ASPECT_COLOR_BIT, task });
+				img->AddPendingState( ImageState{ EResourceState::TransferDst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+												  ImageRange{ ImageLayer(layer), 1, MipmapLevel(mip), 1 }, VK_IMAGE_ASPECT_COLOR_BIT, task });
+				img->CommitBarrier( barrier_mngr, null );
+			}
+		}
+
+		img->AddPendingState( ImageState{ EResourceState::ShaderSample | EResourceState::_FragmentShader, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+										  ImageRange{ 0_layer, layers, 0_mipmap, mipmaps }, VK_IMAGE_ASPECT_COLOR_BIT, (task_iter++)->get() });
+		img->CommitBarrier( barrier_mngr, null );
+
+		img->ResetState( ExeOrderIndex::Final, barrier_mngr, null );
+		barrier_mngr.ClearBarriers();
+
+		state_count = uint(task_iter - tasks.begin());
+	};
+
+	Frame();
+
+	bench.Run( "VLocalImage.AddPendingState.CommitBarrier", frame_count * state_count, [&] ()
+	{
+		for (uint i = 0; i < frame_count; ++i) {
+			Frame();
+		}
+	});
+
+	local_image.Destroy();
+
+	FG_LOGI( "Bench_VLocalImage - finished" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,97 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Benchmark.h"
+
+namespace
+{
+/*
+=================================================
+	EscapeJSON
+=================================================
+*/
+	ND_ String  EscapeJSON (StringView str)
+	{
+		String	result;
+		result.reserve( str.size() );
+
+		for (char c : str)
+		{
+			switch ( c )
+			{
+				case '"' :	result << "\\\"";	break;
+				case '\\' :	result << "\\\\";	break;
+				case '\n' :	result << "\\n";	break;
+				case '\t' :	result << "\\t";	break;
+				default :	result << c;		break;
+			}
+		}
+		return result;
+	}
+}	// namespace
+
+/*
+=================================================
+	_AddResult
+=================================================
+*/
+	void  Benchmark::_AddResult (StringView name, uint threads, uint64_t operations, INOUT Array<double> &samples)
+	{
+		CHECK_ERRV( not samples.empty() and operations > 0 );
+
+		std::sort( samples.begin(), samples.end() );
+
+		const double	scale	= 1.0 / double(operations);
+		double			sum		= 0.0;
+
+		for (auto& s : samples) {
+			sum += s;
+		}
+
+		Result	res;
+		res.name		= String{name};
+		res.threads		= threads;
+		res.repeats		= uint(samples.size());
+		res.operations	= operations;
+		res.minNs		= samples.front() * scale;
+		res.maxNs		= samples.back() * scale;
+		res.medianNs	= samples[ samples.size()/2 ] * scale;
+		res.meanNs		= (sum / double(samples.size())) * scale;
+
+		FG_LOGI( String{res.name} << ": " << ToString( res.medianNs, 2 ) << " ns/op (min " << ToString( res.minNs, 2 )
+				 << ", max " << ToString( res.maxNs, 2 ) << "), threads: " << ToString( threads ) );
+
+		_results.push_back( std::move(res) );
+	}
+
+/*
+=================================================
+	ToJSON
+=================================================
+*/
+	String  Benchmark::ToJSON (StringView version, StringView buildType) const
+	{
+		String	str;
+		str << "{\n"
+			<< "\t\"version\": \"" << EscapeJSON( version ) << "\",\n"
+			<< "\t\"build\": \"" << EscapeJSON( buildType ) << "\",\n"
+			<< "\t\"repeats\": " << ToString( _repeats ) << ",\n"
+			<< "\t\"benchmarks\": [";
+
+		for (size_t i = 0; i < _results.size(); ++i)
+		{
+			auto&	res = _results[i];
+
+			str << (i ? "," : "") << "\n\t\t{"
+				<< "\"name\": \"" << EscapeJSON( res.name ) << "\", "
+				<< "\"threads\": " << ToString( res.threads ) << ", "
+				<< "\"repeats\": " << ToString( res.repeats ) << ", "
+				<< "\"operations\": " << ToString( res.operations ) << ", "
+				<< "\"min_ns\": " << ToString( res.minNs, 3 ) << ", "
+				<< "\"median_ns\": " << ToString( res.medianNs, 3 ) << ", "
+				<< "\"mean_ns\": " << ToString( res.meanNs, 3 ) << ", "
+				<< "\"max_ns\": " << ToString( res.maxNs, 3 ) << "}";
+		}
+
+		str << "\n\t]\n}\n";
+		return str;
+	}
@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Simple timing harness for CPU micro-benchmarks.
+
+	Each benchmark is executed 'repeats' times after warm-up,
+	time is measured per operation, results are printed to log and
+	can be saved as JSON to track regressions between versions.
+*/
+
+#pragma once
+
+#include "stl/Algorithms/StringUtils.h"
+#include "stl/Algorithms/ArrayUtils.h"
+#include "stl/ThreadSafe/Barrier.h"
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+using namespace FGC;
+
+#define TEST	CHECK_FATAL
+
+
+	//
+	// Do Not Optimize
+	//
+	template <typename T>
+	forceinline void  DoNotOptimize (const T &value)
+	{
+	#if defined(COMPILER_GCC) or defined(COMPILER_CLANG)
+		asm volatile( "" : : "r,m"(value) : "memory" );
+	#else
+		static volatile uint8_t	sink;
+		sink = *reinterpret_cast<volatile const uint8_t *>( &value );
+	#endif
+	}
+
+
+
+	//
+	// Benchmark
+	//
+	class Benchmark final
+	{
+	// types
+	public:
+		using Clock_t		= std::chrono::high_resolution_clock;
+		using TimePoint_t	= Clock_t::time_point;
+		using Nanosec_t		= std::chrono::duration<double, std::nano>;
+
+		struct Result
+		{
+			String		name;
+			uint		threads		= 1;
+			uint		repeats		= 0;
+			uint64_t	operations	= 0;	// per repeat
+			double		minNs		= 0.0;	// per operation
+			double		medianNs	= 0.0;
+			double		meanNs		= 0.0;
+			double		maxNs		= 0.0;
+		};
+
+
+	// variables
+	private:
+		Array<Result>	_results;
+		uint			_repeats;
+		StringView		_filter;
+
+
+	// methods
+	public:
+		explicit Benchmark (uint repeats = 15, StringView filter = Default) : _repeats{ Max( 1u, repeats )}, _filter{ filter } {}
+
+
+		// 'fn' must execute 'operations' operations
+		template <typename Fn>
+		void  Run (StringView name, uint64_t operations, Fn &&fn)
+		{
+			if ( _IsSkipped( name ))
+				return;
+
+			Array<double>	samples;
+			samples.reserve( _repeats );
+
+			fn();	// warm-up
+
+			for (uint i = 0; i < _repeats; ++i)
+			{
+				const TimePoint_t	start = Clock_t::now();
+				fn();
+				samples.push_back( Nanosec_t{ Clock_t::now() - start }.count() );
+			}
+
+			_AddResult( name, 1, operations, samples );
+		}
+
+
+		// 'fn' is called in each thread with thread index and must execute 'operationsPerThread' operations,
+		// time is measured from the moment when all threads are started until the last thread finishes
+		template <typename Fn>
+		void  RunParallel (StringView name, uint threadCount, uint64_t operationsPerThread, Fn &&fn)
+		{
+			if ( _IsSkipped( name ))
+				return;
+
+			Array<double>		samples;
+			Array<std::thread>	threads;
+			Array<TimePoint_t>	start_time;		start_time.resize( threadCount );
+			Array<TimePoint_t>	end_time;		end_time.resize( threadCount );
+
+			samples.reserve( _repeats );
+
+			for (uint i = 0; i <= _repeats; ++i)
+			{
+				Barrier		sync{ threadCount };
+
+				for (uint t = 0; t < threadCount; ++t)
+				{
+					threads.emplace_back( [&fn, &sync, &start_time, &end_time, t] ()
+										  {
+											sync.wait();
+											start_time[t] = Clock_t::now();
+											fn( t );
+											end_time[t] = Clock_t::now();
+										  });
+				}
+
+				for (auto& t : threads) {
+					t.join();
+				}
+				threads.clear();
+
+				// first pass is warm-up
+				if ( i > 0 )
+				{
+					const TimePoint_t	start	= *std::min_element( start_time.begin(), start_time.end() );
+					const TimePoint_t	end		= *std::max_element( end_time.begin(), end_time.end() );
+					samples.push_back( Nanosec_t{ end - start }.count() );
+				}
+			}
+
+			_AddResult( name, threadCount, operationsPerThread * threadCount, samples );
+		}
+
+
+		ND_ ArrayView<Result>  GetResults () const	{ return _results; }
+
+		ND_ String  ToJSON (StringView version, StringView buildType) const;
+
+
+	private:
+		ND_ bool  _IsSkipped (StringView name) const
+		{
+			return not _filter.empty() and name.find( _filter ) == StringView::npos;
+		}
+
+		void  _AddResult (StringView name, uint threads, uint64_t operations, INOUT Array<double> &samples);
+	};
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Usage: Tests.Benchmarks [output.json] [name filter]
+*/
+
+#include "Benchmark.h"
+#include "framegraph/Public/FrameGraph.h"
+#include "stl/Stream/FileStream.h"
+
+extern void Bench_LinearAllocator (Benchmark &);
+extern void Bench_IndexedPool (Benchmark &);
+extern void Bench_FixedMap (Benchmark &);
+extern void Bench_Hash (Benchmark &);
+extern void Bench_ImageView (Benchmark &);
+
+#ifdef FG_ENABLE_GLM
+extern void Bench_FrustumCulling (Benchmark &);
+#endif
+
+#ifdef FG_ENABLE_VULKAN
+extern void Bench_PipelineResources (Benchmark &);
+extern void Bench_VLocalImage (Benchmark &);
+#endif
+
+
+int main (int argc, char** argv)
+{
+	const StringView	output	= (argc > 1 ? StringView{argv[1]} : "benchmarks.json");
+	const StringView	filter	= (argc > 2 ? StringView{argv[2]} : StringView{});
+
+	#ifdef FG_DEBUG
+	FG_LOGI( "Benchmarks are running in debug build, results are not representative" );
+	const StringView	build_type	= "debug";
+	#else
+	const StringView	build_type	= "release";
+	#endif
+
+	Benchmark	bench{ 15, filter };
+
+	// stl
+	Bench_LinearAllocator( bench );
+	Bench_IndexedPool( bench );
+	Bench_FixedMap( bench );
+	Bench_Hash( bench );
+
+	// scene
+	#ifdef FG_ENABLE_GLM
+	Bench_FrustumCulling( bench );
+	#endif
+
+	// frame graph
+	Bench_ImageView( bench );
+
+	#ifdef FG_ENABLE_VULKAN
+	Bench_PipelineResources( bench );
+	Bench_VLocalImage( bench );
+	#endif
+
+	{
+		FileWStream		file{ NtStringView{output} };
+		CHECK_FATAL( file.IsOpen() );
+		CHECK_FATAL( file.Write( StringView{ bench.ToJSON( FG::IFrameGraph::GetVersion(), build_type )}));
+	}
+
+	CHECK_FATAL( FG_DUMP_MEMLEAKS() );
+
+	FG_LOGI( "Tests.Benchmarks finished, results saved to '"s << output << "'" );
+	return 0;
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::Test_Draw8 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		GraphicsPipelineDesc	ppln;
+
+		ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (push_constant, std140) uniform PushConst {
+	vec4	rect;
+	vec4	color;
+} pc;
+
+layout(location=0) out vec4  v_Color;
+
+const vec2	g_Positions[4] = vec2[](
+	vec2(0.0, 0.0),
+	vec2(0.0, 1.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 1.0)
+);
+
+void main() {
+	gl_Position	= vec4( mix( pc.rect.xy, pc.rect.zw, g_Positions[gl_VertexIndex] ), 0.0, 1.0 );
+	v_Color		= pc.color;
+}
+)#" );
+
+		ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+layout(location=0) in  vec4  v_Color;
+
+void main() {
+	out_Color = v_Color;
+}
+)#" );
+
+		struct PushConst {
+			RGBA32f		rect;
+			RGBA32f		color;
+		};
+
+		// each cell is drawn by separate draw task, so draw tasks will be splitted into several secondary command buffers
+		const uint		grid_size	= 32;
+		const uint2		view_size	= {512, 512};
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+															    Default, "RenderTarget" );
+
+		GPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image and pipeline );
+
+		const auto	CellColor = [] (uint x, uint y) {
+			return RGBA32f{ float(x & 1), float(y & 1), float((x + y) & 1), 1.0f };
+		};
+
+
+		bool		data_is_correct = false;
+
+		const auto	OnLoaded =	[&CellColor, grid_size, OUT &data_is_correct] (const ImageView &imageData)
+		{
+			const uint	cell_size = imageData.Dimension().x / grid_size;
+
+			data_is_correct = true;
+
+			for (uint y = 0; y < grid_size; ++y)
+			for (uint x = 0; x < grid_size; ++x)
+			{
+				RGBA32f	col;
+				imageData.Load( uint3(x * cell_size + cell_size/2, y * cell_size + cell_size/2, 0), OUT col );
+
+				bool	is_equal = All(Equals( col, CellColor( x, y ), 0.1f ));
+				ASSERT( is_equal );
+				data_is_correct &= is_equal;
+			}
+		};
+
+
+		IFrameGraph::Statistics		stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));	// reset counters
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+											.AddTarget( RenderTargetID::Color_0, image, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+											.AddViewport( view_size )
+											.SetSecondaryCmdbufEnabled( true ));
+
+		for (uint y = 0; y < grid_size; ++y)
+		for (uint x = 0; x < grid_size; ++x)
+		{
+			const float	size = 2.0f / grid_size;
+			PushConst	pc;
+			pc.rect		= RGBA32f{ x * size - 1.0f, y * size - 1.0f, (x+1) * size - 1.0f, (y+1) * size - 1.0f };
+			pc.color	= CellColor( x, y );
+
+			cmd->AddTask( render_pass, DrawVertices().Draw( 4 ).SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleStrip )
+												.AddPushConstant( PushConstantID("PushConst"), pc ));
+		}
+
+		Task	t_draw	= cmd->AddTask( SubmitRenderPass{ render_pass });
+		Task	t_read	= cmd->AddTask( ReadImage().SetImage( image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_draw ));
+		Unused( t_read );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( data_is_correct );
+
+		// draw tasks must not be silently recorded into the primary command buffer
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.secondaryCommandBuffers > 0 );
+
+		DeleteResources( image, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
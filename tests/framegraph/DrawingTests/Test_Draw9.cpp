@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::Test_Draw9 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		GraphicsPipelineDesc	ppln;
+
+		ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (push_constant, std140) uniform PushConst {
+	vec4	rect;
+	vec4	color;
+} pc;
+
+layout(location=0) out vec4  v_Color;
+
+const vec2	g_Positions[4] = vec2[](
+	vec2(0.0, 0.0),
+	vec2(0.0, 1.0),
+	vec2(1.0, 0.0),
+	vec2(1.0, 1.0)
+);
+
+void main() {
+	gl_Position	= vec4( mix( pc.rect.xy, pc.rect.zw, g_Positions[gl_VertexIndex] ), 0.0, 1.0 );
+	v_Color		= pc.color;
+}
+)#" );
+
+		ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+layout(location=0) in  vec4  v_Color;
+
+void main() {
+	out_Color = v_Color;
+}
+)#" );
+
+		struct PushConst {
+			RGBA32f		rect;
+			RGBA32f		color;
+		};
+		// same grid is drawn by separate draw tasks and by single batch
+		const uint			grid_size	= 32;
+		const uint2			view_size	= {512, 512};
+		const uint16_t		indices[]	= { 0, 1, 2, 3 };
+		ImageID				image1		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																			.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+																	Default, "RenderTarget1" );
+		ImageID				image2		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																			.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+																	Default, "RenderTarget2" );
+		BufferID			ibuffer		= _frameGraph->CreateBuffer( BufferDesc{ SizeOf<uint16_t> * CountOf(indices), EBufferUsage::Index | EBufferUsage::TransferDst },
+																	 Default, "IndexBuffer" );
+
+		GPipelineID			pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image1 and image2 and ibuffer and pipeline );
+
+		const auto	CellColor = [] (uint x, uint y) {
+			return RGBA32f{ float(x & 1), float(y & 1), float((x + y) & 1), 1.0f };
+		};
+
+		Array< DrawIndexedBatch::DrawCmd >	commands;
+		Array< PushConst >					push_constants;
+
+		for (uint y = 0; y < grid_size; ++y)
+		for (uint x = 0; x < grid_size; ++x)
+		{
+			const float	size = 2.0f / grid_size;
+			PushConst	pc;
+			pc.rect		= RGBA32f{ x * size - 1.0f, y * size - 1.0f, (x+1) * size - 1.0f, (y+1) * size - 1.0f };
+			pc.color	= CellColor( x, y );
+
+			push_constants.push_back( pc );
+			commands.emplace_back().indexCount = uint(CountOf(indices));
+		}
+
+
+		bool		data_is_correct = true;
+
+		const auto	OnLoaded =	[&CellColor, grid_size, OUT &data_is_correct] (const ImageView &imageData)
+		{
+			const uint	cell_size = imageData.Dimension().x / grid_size;
+
+			for (uint y = 0; y < grid_size; ++y)
+			for (uint x = 0; x < grid_size; ++x)
+			{
+				RGBA32f	col;
+				imageData.Load( uint3(x * cell_size + cell_size/2, y * cell_size + cell_size/2, 0), OUT col );
+
+				bool	is_equal = All(Equals( col, CellColor( x, y ), 0.1f ));
+				ASSERT( is_equal );
+				data_is_correct &= is_equal;
+			}
+		};
+
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		LogicalPassID	render_pass1	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image1, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+												.AddViewport( view_size ));
+		LogicalPassID	render_pass2	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image2, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+												.AddViewport( view_size ));
+
+		// separate draw tasks
+		for (size_t i = 0; i < commands.size(); ++i)
+		{
+			cmd->AddTask( render_pass1, DrawIndexed().SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleStrip )
+												.SetIndexBuffer( ibuffer, 0_b, EIndex::UShort )
+												.Draw( commands[i].indexCount )
+												.AddPushConstant( PushConstantID("PushConst"), push_constants[i] ));
+		}
+
+		// single batch
+		cmd->AddTask( render_pass2, DrawIndexedBatch().SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleStrip )
+												.SetIndexBuffer( ibuffer, 0_b, EIndex::UShort )
+												.SetCommands( commands )
+												.SetPerDrawPushConstants( PushConstantID("PushConst"), ArrayView<PushConst>{ push_constants }));
+
+		Task	t_update	= cmd->AddTask( UpdateBuffer().SetBuffer( ibuffer ).AddData( indices, CountOf(indices) ));
+		Task	t_draw1		= cmd->AddTask( SubmitRenderPass{ render_pass1 }.DependsOn( t_update ));
+		Task	t_draw2		= cmd->AddTask( SubmitRenderPass{ render_pass2 }.DependsOn( t_draw1 ));
+		Task	t_read1		= cmd->AddTask( ReadImage().SetImage( image1, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_draw2 ));
+		Task	t_read2		= cmd->AddTask( ReadImage().SetImage( image2, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_read1 ));
+		Unused( t_read2 );
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( data_is_correct );
+
+		DeleteResources( image1, image2, ibuffer, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,183 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Two bottom level acceleration structures are built in the same batch
+	from shared vertex and index buffers.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::Test_TraceRays4 ()
+	{
+		if ( not _properties.rayTracingNV or not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		RayTracingPipelineDesc	ppln;
+
+		ppln.AddShader( RTShaderID("Main"), EShader::RayGen, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(set=0, binding=0) uniform accelerationStructureNV  un_RtScene;
+layout(set=0, binding=1, rgba8) writeonly uniform image2D  un_Output;
+layout(location=0) rayPayloadNV vec4  payload;
+
+void main ()
+{
+	const vec2 uv = vec2(gl_LaunchIDNV.xy) / vec2(gl_LaunchSizeNV.xy - 1);
+
+	const vec3 origin = vec3(uv.x, 1.0f - uv.y, -1.0f);
+	const vec3 direction = vec3(0.0f, 0.0f, 1.0f);
+
+	traceNV( /*topLevel*/un_RtScene, /*rayFlags*/gl_RayFlagsNoneNV, /*cullMask*/0xFF,
+			 /*sbtRecordOffset*/0, /*sbtRecordStride*/1, /*missIndex*/0,
+			 /*origin*/origin, /*Tmin*/0.0f, /*direction*/direction, /*Tmax*/10.0f,
+			 /*payload*/0 );
+
+	imageStore( un_Output, ivec2(gl_LaunchIDNV), payload );
+}
+)#");
+		
+		ppln.AddShader( RTShaderID("PrimaryMiss"), EShader::RayMiss, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(location=0) rayPayloadInNV vec4  payload;
+
+void main ()
+{
+	payload = vec4(0.0f);
+}
+)#");
+		
+		ppln.AddShader( RTShaderID("PrimaryHit"), EShader::RayClosestHit, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(location=0) rayPayloadInNV vec4  payload;
+
+void main ()
+{
+	payload = vec4(float(gl_InstanceCustomIndexNV), 1.0f, 0.0f, 1.0f);
+}
+)#");
+
+		const uint2		view_size	= {800, 600};
+		ImageID			dst_image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::Storage | EImageUsage::TransferSrc ),
+																Default, "OutputImage" );
+		
+		RTPipelineID	pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( dst_image and pipeline );
+		
+		// left and right triangles in the same buffer
+		const float3	vertices[]	= { { 0.10f, 0.25f, 0.0f }, { 0.40f, 0.25f, 0.0f }, { 0.25f, 0.75f, 0.0f },
+										{ 0.60f, 0.25f, 0.0f }, { 0.90f, 0.25f, 0.0f }, { 0.75f, 0.75f, 0.0f } };
+		const uint		indices[]	= { 0, 1, 2 };
+		const BytesU	vb_offset	= SizeOf<float3> * 3;
+
+		BufferID		vertex_buf	= _frameGraph->CreateBuffer( BufferDesc{ SizeOf<float3> * CountOf(vertices), EBufferUsage::TransferDst | EBufferUsage::RayTracing },
+																 Default, "Vertices" );
+		BufferID		index_buf	= _frameGraph->CreateBuffer( BufferDesc{ SizeOf<uint> * CountOf(indices), EBufferUsage::TransferDst | EBufferUsage::RayTracing },
+																 Default, "Indices" );
+		CHECK_ERR( vertex_buf and index_buf );
+		
+		BuildRayTracingGeometry::Triangles	left_triangle;
+		left_triangle.SetID( GeometryID{"Triangle"} ).SetVertexBuffer( vertex_buf ).SetVertices<float3>( 3 )
+					 .SetIndexBuffer( index_buf ).SetIndices( CountOf(indices), EIndex::UInt );
+		
+		BuildRayTracingGeometry::Triangles	right_triangle;
+		right_triangle.SetID( GeometryID{"Triangle"} ).SetVertexBuffer( vertex_buf, vb_offset ).SetVertices<float3>( 3 )
+					  .SetIndexBuffer( index_buf ).SetIndices( CountOf(indices), EIndex::UInt );
+
+		RayTracingGeometryDesc::Triangles	triangles_info;
+		triangles_info.SetID( GeometryID{"Triangle"} ).SetVertices< float3 >( 3 )
+					.SetIndices( CountOf(indices), EIndex::UInt ).AddFlags( ERayTracingGeometryFlags::Opaque );
+
+		RTGeometryID		rt_geometry1	= _frameGraph->CreateRayTracingGeometry( RayTracingGeometryDesc{{ triangles_info }}, Default, "Left" );
+		RTGeometryID		rt_geometry2	= _frameGraph->CreateRayTracingGeometry( RayTracingGeometryDesc{{ triangles_info }}, Default, "Right" );
+		RTSceneID			rt_scene		= _frameGraph->CreateRayTracingScene( RayTracingSceneDesc{ 2 });
+		RTShaderTableID		rt_shaders		= _frameGraph->CreateRayTracingShaderTable();
+		CHECK_ERR( rt_geometry1 and rt_geometry2 and rt_scene and rt_shaders );
+
+		PipelineResources	resources;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+		
+		
+		bool	data_is_correct = false;
+		
+		const auto	OnLoaded =	[OUT &data_is_correct] (const ImageView &imageData)
+		{
+			const auto	TestPixel = [&imageData] (float x, float y, const RGBA32f &color)
+			{
+				uint	ix	 = uint( x * float(imageData.Dimension().x - 1) + 0.5f );
+				uint	iy	 = uint( (1.0f - y) * float(imageData.Dimension().y - 1) + 0.5f );
+
+				RGBA32f	col;
+				imageData.Load( uint3(ix, iy, 0), OUT col );
+
+				bool	is_equal	= Equals( col.r, color.r, 0.1f ) and
+									  Equals( col.g, color.g, 0.1f ) and
+									  Equals( col.b, color.b, 0.1f ) and
+									  Equals( col.a, color.a, 0.1f );
+				ASSERT( is_equal );
+				return is_equal;
+			};
+
+			data_is_correct  = true;
+			data_is_correct &= TestPixel( 0.25f, 0.40f, RGBA32f{0.0f, 1.0f, 0.0f, 1.0f} );
+			data_is_correct &= TestPixel( 0.75f, 0.40f, RGBA32f{1.0f, 1.0f, 0.0f, 1.0f} );
+			
+			data_is_correct &= TestPixel( 0.50f, 0.40f, RGBA32f{0.0f} );
+			data_is_correct &= TestPixel( 0.25f, 0.90f, RGBA32f{0.0f} );
+			data_is_correct &= TestPixel( 0.75f, 0.10f, RGBA32f{0.0f} );
+		};
+
+		
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+		CHECK_ERR( cmd );
+
+		resources.BindImage( UniformID("un_Output"), dst_image );
+		resources.BindRayTracingScene( UniformID("un_RtScene"), rt_scene );
+		
+		BuildRayTracingScene::Instance		instance1;
+		instance1.SetID( InstanceID{"0"} ).SetGeometry( rt_geometry1 ).SetInstanceIndex( 0 );
+		
+		BuildRayTracingScene::Instance		instance2;
+		instance2.SetID( InstanceID{"1"} ).SetGeometry( rt_geometry2 ).SetInstanceIndex( 1 );
+		
+		Task	t_update_vb		= cmd->AddTask( UpdateBuffer{}.SetBuffer( vertex_buf ).AddData( vertices, CountOf(vertices) ));
+		Task	t_update_ib		= cmd->AddTask( UpdateBuffer{}.SetBuffer( index_buf ).AddData( indices, CountOf(indices) ));
+
+		// builds don't depend on each other, so they are recorded with single barrier
+		Task	t_build_geom1	= cmd->AddTask( BuildRayTracingGeometry{}.SetTarget( rt_geometry1 ).Add( left_triangle ).DependsOn( t_update_vb, t_update_ib ));
+		Task	t_build_geom2	= cmd->AddTask( BuildRayTracingGeometry{}.SetTarget( rt_geometry2 ).Add( right_triangle ).DependsOn( t_update_vb, t_update_ib ));
+		Task	t_build_scene	= cmd->AddTask( BuildRayTracingScene{}.SetTarget( rt_scene ).Add( instance1 ).Add( instance2 ).DependsOn( t_build_geom1, t_build_geom2 ));
+
+		Task	t_update_table	= cmd->AddTask( UpdateRayTracingShaderTable{}
+															.SetTarget( rt_shaders ).SetPipeline( pipeline ).SetScene( rt_scene )
+															.SetRayGenShader( RTShaderID{"Main"} )
+															.AddMissShader( RTShaderID{"PrimaryMiss"}, 0 )
+															.AddHitShader( InstanceID{"0"}, GeometryID{"Triangle"}, 0, RTShaderID{"PrimaryHit"} )
+															.AddHitShader( InstanceID{"1"}, GeometryID{"Triangle"}, 0, RTShaderID{"PrimaryHit"} )
+															.DependsOn( t_build_scene ));
+		Task	t_trace			= cmd->AddTask( TraceRays{}.AddResources( DescriptorSetID("0"), resources ).SetShaderTable( rt_shaders )
+															.SetGroupCount( view_size.x, view_size.y ).DependsOn( t_update_table ));
+		Task	t_read			= cmd->AddTask( ReadImage{}.SetImage( dst_image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_trace ));
+		Unused( t_read );
+			
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+		CHECK_ERR( _frameGraph->Flush() );
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		CHECK_ERR( data_is_correct );
+		
+		DeleteResources( pipeline, dst_image, vertex_buf, index_buf, rt_geometry1, rt_geometry2, rt_scene, rt_shaders );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
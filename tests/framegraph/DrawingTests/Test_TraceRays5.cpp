@@ -0,0 +1,234 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Top level acceleration structure with 'AllowUpdate' flag is built,
+	then transformations of some instances are changed and the scene is updated in place,
+	only changed instances are copied to the instance buffer.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::Test_TraceRays5 ()
+	{
+		if ( not _properties.rayTracingNV or not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		RayTracingPipelineDesc	ppln;
+
+		ppln.AddShader( RTShaderID("Main"), EShader::RayGen, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(set=0, binding=0) uniform accelerationStructureNV  un_RtScene;
+layout(set=0, binding=1, rgba8) writeonly uniform image2D  un_Output;
+layout(location=0) rayPayloadNV vec4  payload;
+
+void main ()
+{
+	const vec2 uv = vec2(gl_LaunchIDNV.xy) / vec2(gl_LaunchSizeNV.xy - 1);
+
+	const vec3 origin = vec3(uv.x, 1.0f - uv.y, -1.0f);
+	const vec3 direction = vec3(0.0f, 0.0f, 1.0f);
+
+	traceNV( /*topLevel*/un_RtScene, /*rayFlags*/gl_RayFlagsNoneNV, /*cullMask*/0xFF,
+			 /*sbtRecordOffset*/0, /*sbtRecordStride*/1, /*missIndex*/0,
+			 /*origin*/origin, /*Tmin*/0.0f, /*direction*/direction, /*Tmax*/10.0f,
+			 /*payload*/0 );
+
+	imageStore( un_Output, ivec2(gl_LaunchIDNV), payload );
+}
+)#");
+		
+		ppln.AddShader( RTShaderID("PrimaryMiss"), EShader::RayMiss, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(location=0) rayPayloadInNV vec4  payload;
+
+void main ()
+{
+	payload = vec4(0.0f);
+}
+)#");
+		
+		ppln.AddShader( RTShaderID("PrimaryHit"), EShader::RayClosestHit, EShaderLangFormat::VKSL_110, "main", R"#(
+#version 460 core
+#extension GL_NV_ray_tracing : require
+layout(location=0) rayPayloadInNV vec4  payload;
+
+void main ()
+{
+	payload = vec4(float(gl_InstanceCustomIndexNV) * 0.25f, 1.0f, 0.0f, 1.0f);
+}
+)#");
+
+		const uint2		view_size	= {800, 600};
+		ImageID			dst_image	= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::Storage | EImageUsage::TransferSrc ),
+																Default, "OutputImage" );
+		
+		RTPipelineID	pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( dst_image and pipeline );
+		
+		const float3	vertices[]	= { { -0.1f, -0.1f, 0.0f }, { 0.1f, -0.1f, 0.0f }, { 0.0f, 0.1f, 0.0f } };
+		const uint		indices[]	= { 0, 1, 2 };
+
+		BufferID		vertex_buf	= _frameGraph->CreateBuffer( BufferDesc{ SizeOf<float3> * CountOf(vertices), EBufferUsage::TransferDst | EBufferUsage::RayTracing },
+																 Default, "Vertices" );
+		BufferID		index_buf	= _frameGraph->CreateBuffer( BufferDesc{ SizeOf<uint> * CountOf(indices), EBufferUsage::TransferDst | EBufferUsage::RayTracing },
+																 Default, "Indices" );
+		CHECK_ERR( vertex_buf and index_buf );
+		
+		BuildRayTracingGeometry::Triangles	triangle;
+		triangle.SetID( GeometryID{"Triangle"} ).SetVertexBuffer( vertex_buf ).SetVertices<float3>( 3 )
+				.SetIndexBuffer( index_buf ).SetIndices( CountOf(indices), EIndex::UInt );
+
+		RayTracingGeometryDesc::Triangles	triangles_info;
+		triangles_info.SetID( GeometryID{"Triangle"} ).SetVertices< float3 >( 3 )
+					.SetIndices( CountOf(indices), EIndex::UInt ).AddFlags( ERayTracingGeometryFlags::Opaque );
+
+		static constexpr uint	instance_count	= 4;
+
+		RTGeometryID		rt_geometry		= _frameGraph->CreateRayTracingGeometry( RayTracingGeometryDesc{{ triangles_info }}, Default, "Triangle" );
+		RTSceneID			rt_scene		= _frameGraph->CreateRayTracingScene( RayTracingSceneDesc{ instance_count, ERayTracingFlags::AllowUpdate });
+		RTShaderTableID		rt_shaders		= _frameGraph->CreateRayTracingShaderTable();
+		CHECK_ERR( rt_geometry and rt_scene and rt_shaders );
+
+		PipelineResources	resources;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+		
+		resources.BindImage( UniformID("un_Output"), dst_image );
+		resources.BindRayTracingScene( UniformID("un_RtScene"), rt_scene );
+
+		// instances are placed in a row, odd instances are moved up in the second build
+		float2		positions [instance_count];
+		for (uint i = 0; i < instance_count; ++i) {
+			positions[i] = float2{ 0.125f + 0.25f * float(i), 0.3f };
+		}
+		
+		bool	data_is_correct = false;
+		
+		const auto	OnLoaded =	[&positions, OUT &data_is_correct] (const ImageView &imageData)
+		{
+			const auto	TestPixel = [&imageData] (float x, float y, const RGBA32f &color)
+			{
+				uint	ix	 = uint( x * float(imageData.Dimension().x - 1) + 0.5f );
+				uint	iy	 = uint( (1.0f - y) * float(imageData.Dimension().y - 1) + 0.5f );
+
+				RGBA32f	col;
+				imageData.Load( uint3(ix, iy, 0), OUT col );
+
+				bool	is_equal	= Equals( col.r, color.r, 0.1f ) and
+									  Equals( col.g, color.g, 0.1f ) and
+									  Equals( col.b, color.b, 0.1f ) and
+									  Equals( col.a, color.a, 0.1f );
+				ASSERT( is_equal );
+				return is_equal;
+			};
+
+			data_is_correct = true;
+
+			for (uint i = 0; i < instance_count; ++i)
+			{
+				const float	other_y = (positions[i].y < 0.5f ? 0.7f : 0.3f);
+
+				data_is_correct &= TestPixel( positions[i].x, positions[i].y, RGBA32f{float(i) * 0.25f, 1.0f, 0.0f, 1.0f} );
+				data_is_correct &= TestPixel( positions[i].x, other_y, RGBA32f{0.0f} );
+			}
+		};
+
+		const auto	BuildAndTrace = [&] (bool buildGeometry) -> bool
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetDebugFlags( EDebugFlags::Default ));
+			CHECK_ERR( cmd );
+
+			BuildRayTracingScene	build_scene;
+			build_scene.SetTarget( rt_scene );
+
+			for (uint i = 0; i < instance_count; ++i)
+			{
+				BuildRayTracingScene::Matrix4x3		transform = BuildRayTracingScene::Matrix4x3::Identity();
+				transform[0].w = positions[i].x;
+				transform[1].w = positions[i].y;
+
+				build_scene.Add( BuildRayTracingScene::Instance{ InstanceID{ToString(i)} }
+									.SetGeometry( rt_geometry ).SetInstanceIndex( i ).SetTransfrom( transform ));
+			}
+
+			Task	t_build_scene;
+			if ( buildGeometry )
+			{
+				Task	t_update_vb		= cmd->AddTask( UpdateBuffer{}.SetBuffer( vertex_buf ).AddData( vertices, CountOf(vertices) ));
+				Task	t_update_ib		= cmd->AddTask( UpdateBuffer{}.SetBuffer( index_buf ).AddData( indices, CountOf(indices) ));
+				Task	t_build_geom	= cmd->AddTask( BuildRayTracingGeometry{}.SetTarget( rt_geometry ).Add( triangle ).DependsOn( t_update_vb, t_update_ib ));
+				t_build_scene = cmd->AddTask( build_scene.DependsOn( t_build_geom ));
+			}
+			else
+				t_build_scene = cmd->AddTask( build_scene );
+
+			UpdateRayTracingShaderTable		update_table;
+			update_table.SetTarget( rt_shaders ).SetPipeline( pipeline ).SetScene( rt_scene )
+						.SetRayGenShader( RTShaderID{"Main"} )
+						.AddMissShader( RTShaderID{"PrimaryMiss"}, 0 );
+			
+			for (uint i = 0; i < instance_count; ++i) {
+				update_table.AddHitShader( InstanceID{ToString(i)}, GeometryID{"Triangle"}, 0, RTShaderID{"PrimaryHit"} );
+			}
+
+			Task	t_update_table	= cmd->AddTask( update_table.DependsOn( t_build_scene ));
+			Task	t_trace			= cmd->AddTask( TraceRays{}.AddResources( DescriptorSetID("0"), resources ).SetShaderTable( rt_shaders )
+																.SetGroupCount( view_size.x, view_size.y ).DependsOn( t_update_table ));
+			Task	t_read			= cmd->AddTask( ReadImage{}.SetImage( dst_image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_trace ));
+			Unused( t_read );
+
+			// previous build of the scene must be submitted before update
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->Flush() );
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			return true;
+		};
+		
+		IFrameGraph::Statistics		stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+
+		// build, all instances are uploaded
+		data_is_correct = false;
+		CHECK_ERR( BuildAndTrace( true ));
+		CHECK_ERR( data_is_correct );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.rtSceneUpdates == 0 );
+		CHECK_ERR( stat.renderer.rtInstanceUploads == instance_count );
+		
+		// move odd instances, scene must be updated and only changed instances are uploaded
+		for (uint i = 1; i < instance_count; i += 2) {
+			positions[i].y = 0.7f;
+		}
+
+		data_is_correct = false;
+		CHECK_ERR( BuildAndTrace( false ));
+		CHECK_ERR( data_is_correct );
+		
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.rtSceneUpdates == 1 );
+		CHECK_ERR( stat.renderer.rtInstanceUploads == instance_count / 2 );
+
+		// nothing is changed, scene is updated without uploading
+		data_is_correct = false;
+		CHECK_ERR( BuildAndTrace( false ));
+		CHECK_ERR( data_is_correct );
+		
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.renderer.rtSceneUpdates == 1 );
+		CHECK_ERR( stat.renderer.rtInstanceUploads == 0 );
+		
+		DeleteResources( pipeline, dst_image, vertex_buf, index_buf, rt_geometry, rt_scene, rt_shaders );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
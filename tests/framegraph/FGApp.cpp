@@ -46,6 +46,8 @@ namespace {
 		_tests.push_back({ &FGApp::Test_Draw5,			1 });
 		_tests.push_back({ &FGApp::Test_Draw6,			1 });
 		_tests.push_back({ &FGApp::Test_Draw7,			1 });
+		_tests.push_back({ &FGApp::Test_Draw8,			1 });
+		_tests.push_back({ &FGApp::Test_Draw9,			1 });
 		_tests.push_back({ &FGApp::Test_RawDraw1,			1 });
 		_tests.push_back({ &FGApp::Test_ExternalCmdBuf1,	1 });
 		_tests.push_back({ &FGApp::Test_ReadAttachment1,	1 });
@@ -62,12 +64,17 @@ namespace {
 		_tests.push_back({ &FGApp::ImplTest_Multithreading2, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading3, 1 });
 		_tests.push_back({ &FGApp::ImplTest_Multithreading4, 1 });
+		_tests.push_back({ &FGApp::ImplTest_TaskGraph1,		 1 });
+		_tests.push_back({ &FGApp::ImplTest_PipelineCache1,	 1 });
+		_tests.push_back({ &FGApp::ImplTest_AsyncPipeline1,	 1 });
 		
 		// RTX only
 		_tests.push_back({ &FGApp::Test_DrawMeshes1,		1 });
 		_tests.push_back({ &FGApp::Test_TraceRays1,			1 });
 		_tests.push_back({ &FGApp::Test_TraceRays2,			1 });
 		_tests.push_back({ &FGApp::Test_TraceRays3,			1 });
+		_tests.push_back({ &FGApp::Test_TraceRays4,			1 });
+		_tests.push_back({ &FGApp::Test_TraceRays5,			1 });
 		_tests.push_back({ &FGApp::Test_ShadingRate1,		1 });
 		_tests.push_back({ &FGApp::Test_RayTracingDebugger1, 1 });
 		
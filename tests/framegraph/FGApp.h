@@ -89,6 +89,9 @@ namespace FG
 		bool ImplTest_Multithreading2 ();
 		bool ImplTest_Multithreading3 ();
 		bool ImplTest_Multithreading4 ();
+		bool ImplTest_TaskGraph1 ();
+		bool ImplTest_PipelineCache1 ();
+		bool ImplTest_AsyncPipeline1 ();
 
 
 	// drawing tests
@@ -108,6 +111,8 @@ namespace FG
 		bool Test_Draw5 ();
 		bool Test_Draw6 ();
 		bool Test_Draw7 ();				// multi render target
+		bool Test_Draw8 ();				// with secondary command buffers
+		bool Test_Draw9 ();				// batched indexed draw calls
 		bool Test_RawDraw1 ();			// with vulkan api calls
 		bool Test_ExternalCmdBuf1 ();	// with vulkan api calls
 		bool Test_InvalidID ();
@@ -124,6 +129,8 @@ namespace FG
 		bool Test_TraceRays1 ();
 		bool Test_TraceRays2 ();
 		bool Test_TraceRays3 ();
+		bool Test_TraceRays4 ();
+		bool Test_TraceRays5 ();
 		bool Test_ShadingRate1 ();
 		bool Test_RayTracingDebugger1 ();
 	};
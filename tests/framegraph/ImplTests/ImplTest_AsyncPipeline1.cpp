@@ -0,0 +1,115 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+#include <thread>
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_AsyncPipeline1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		const auto	CreatePipeline = [this] (StringView color)
+		{
+			GraphicsPipelineDesc	ppln;
+
+			ppln.AddShader( EShader::Vertex, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(vertex)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+const vec2	g_Positions[3] = vec2[](
+	vec2(-1.0, -1.0),
+	vec2(-1.0,  3.0),
+	vec2( 3.0, -1.0)
+);
+
+void main() {
+	gl_Position	= vec4( g_Positions[gl_VertexIndex], 0.0, 1.0 );
+}
+)#" );
+
+			ppln.AddShader( EShader::Fragment, EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(fragment)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+layout(location=0) out vec4  out_Color;
+
+void main() {
+	out_Color = )#"s << color << R"#(;
+}
+)#" );
+			return _frameGraph->CreatePipeline( ppln );
+		};
+
+		const uint2		view_size	= {64, 64};
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( view_size ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::ColorAttachment | EImageUsage::TransferSrc ),
+															    Default, "RenderTarget" );
+		GPipelineID		pipeline	= CreatePipeline( "vec4(1.0, 0.0, 0.0, 1.0)" );
+		GPipelineID		fallback	= CreatePipeline( "vec4(0.0, 1.0, 0.0, 1.0)" );
+		CHECK_ERR( image and pipeline and fallback );
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));	// reset counters
+
+		RGBA32f		color;
+		const auto	OnLoaded = [&color] (const ImageView &imageData)
+		{
+			imageData.Load( uint3(imageData.Dimension().x / 2, imageData.Dimension().y / 2, 0), OUT color );
+		};
+
+		const auto	DrawFrame = [&] () -> bool
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{}.SetAsyncPipelineCompilation( true ));
+			CHECK_ERR( cmd );
+
+			LogicalPassID	render_pass	= cmd->CreateRenderPass( RenderPassDesc( view_size )
+												.AddTarget( RenderTargetID::Color_0, image, RGBA32f(0.0f), EAttachmentStoreOp::Store )
+												.AddViewport( view_size ));
+
+			cmd->AddTask( render_pass, DrawVertices().Draw( 3 ).SetPipeline( pipeline ).SetFallbackPipeline( fallback ).SetTopology( EPrimitive::TriangleList ));
+
+			Task	t_draw	= cmd->AddTask( SubmitRenderPass{ render_pass });
+			Task	t_read	= cmd->AddTask( ReadImage().SetImage( image, int2(), view_size ).SetCallback( OnLoaded ).DependsOn( t_draw ));
+			Unused( t_read );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+			return true;
+		};
+
+		// first frame must use fallback pipeline
+		CHECK_ERR( DrawFrame() );
+		CHECK_ERR( All(Equals( color, RGBA32f{0.0f, 1.0f, 0.0f, 1.0f}, 0.1f )));
+
+		// wait for compilation
+		bool	compiled = false;
+		for (uint i = 0; i < 1000 and not compiled; ++i)
+		{
+			CHECK_ERR( DrawFrame() );
+			compiled = All(Equals( color, RGBA32f{1.0f, 0.0f, 0.0f, 1.0f}, 0.1f ));
+
+			if ( not compiled )
+				std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+		}
+		CHECK_ERR( compiled );
+
+		CHECK_ERR( _frameGraph->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.stalledPipelineInstances > 0 );
+		CHECK_ERR( stat.resources.compiledPipelineInstances == 1 );
+		CHECK_ERR( stat.resources.pendingPipelineInstances == 0 );
+
+		DeleteResources( image, pipeline, fallback );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,103 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "../FGApp.h"
+#include "stl/Stream/MemStream.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_PipelineCache1 ()
+	{
+		if ( not _pplnCompiler )
+		{
+			FG_LOGI( TEST_NAME << " - skipped" );
+			return true;
+		}
+
+		ComputePipelineDesc	ppln;
+
+		ppln.AddShader( EShaderLangFormat::VKSL_100, "main", R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_shading_language_420pack : enable
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(binding=0, rgba8) writeonly uniform image2D  un_OutImage;
+
+void main ()
+{
+	imageStore( un_OutImage, ivec2(gl_GlobalInvocationID.xy), vec4(1.0, 0.0, 1.0, 0.0) );
+}
+)#" );
+
+		const uint2		image_dim	= { 16, 16 };
+		ImageID			image		= _frameGraph->CreateImage( ImageDesc{}.SetDimension( image_dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+																		.SetUsage( EImageUsage::Storage ),
+															    Default, "MyImage" );
+		CPipelineID		pipeline	= _frameGraph->CreatePipeline( ppln );
+		CHECK_ERR( image and pipeline );
+
+		PipelineResources	resources;
+		CHECK_ERR( _frameGraph->InitPipelineResources( pipeline, DescriptorSetID("0"), OUT resources ));
+
+		// create pipeline instance, it will be merged into global cache
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{} );
+			CHECK_ERR( cmd );
+
+			resources.BindImage( UniformID("un_OutImage"), image );
+
+			Task	t_run	= cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), &resources ).Dispatch({ 2, 2 }));
+			Unused( t_run );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		// save & load
+		Array<uint8_t>	data;
+		{
+			MemWStream	wstream;
+			CHECK_ERR( _frameGraph->SavePipelineCache( wstream ));
+
+			data = wstream.MoveData();
+			CHECK_ERR( not data.empty() );
+
+			MemRStream	rstream{ ArrayView<uint8_t>{data} };
+			CHECK_ERR( _frameGraph->LoadPipelineCache( rstream ));
+		}
+
+		// cache from another device must be rejected
+		{
+			Array<uint8_t>	bad_data = data;
+			bad_data[12] ^= 0xFF;	// deviceID
+
+			MemRStream	rstream{ ArrayView<uint8_t>{bad_data} };
+			CHECK_ERR( not _frameGraph->LoadPipelineCache( rstream ));
+		}
+
+		// truncated cache must be rejected
+		{
+			MemRStream	rstream{ ArrayView<uint8_t>{data}.section( 0, data.size()/2 )};
+			CHECK_ERR( not _frameGraph->LoadPipelineCache( rstream ));
+		}
+
+		// command buffer must recreate local cache after loading
+		{
+			CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{} );
+			CHECK_ERR( cmd );
+
+			Task	t_run	= cmd->AddTask( DispatchCompute().SetPipeline( pipeline ).AddResources( DescriptorSetID("0"), &resources ).Dispatch({ 2, 2 }));
+			Unused( t_run );
+
+			CHECK_ERR( _frameGraph->Execute( cmd ));
+			CHECK_ERR( _frameGraph->WaitIdle() );
+		}
+
+		DeleteResources( image, pipeline );
+
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Records a large number of synthetic tasks and measures the time
+	that is required to compile the task graph into command buffer.
+*/
+
+#include "../FGApp.h"
+
+namespace FG
+{
+
+	bool FGApp::ImplTest_TaskGraph1 ()
+	{
+		using TimePoint_t = std::chrono::high_resolution_clock::time_point;
+
+		const uint		task_count	= 10'000;
+		const BytesU	part_size	= 16_b;
+
+		BufferID	buffer = _frameGraph->CreateBuffer( BufferDesc{ part_size * task_count, EBufferUsage::TransferDst }, Default, "Buffer" );
+		CHECK_ERR( buffer );
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{});
+		CHECK_ERR( cmd );
+
+		Array<Task>		tasks;
+		tasks.reserve( task_count );
+
+		// each task depends on previous task and on the task in the middle of the sequence,
+		// so the graph is both deep and wide
+		for (uint i = 0; i < task_count; ++i)
+		{
+			FillBuffer	task;
+			task.SetBuffer( buffer, part_size * i, part_size ).SetPattern( i );
+
+			if ( i > 0 )		task.DependsOn( tasks[i-1] );
+			if ( i > 1 )		task.DependsOn( tasks[i/2] );
+
+			tasks.push_back( cmd->AddTask( task ));
+			CHECK_ERR( tasks.back() );
+		}
+
+		const auto	start_time = TimePoint_t::clock::now();
+
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+
+		const auto	compile_time = TimePoint_t::clock::now() - start_time;
+
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		DeleteResources( buffer );
+
+		const auto	time_per_task = std::chrono::duration_cast<Nanoseconds>( compile_time ) / task_count;
+
+		FG_LOGI( TEST_NAME << " - compilation of " << ToString( task_count ) << " tasks takes " << ToString( compile_time )
+				 << ", " << ToString( time_per_task ) << " per task" );
+		FG_LOGI( TEST_NAME << " - passed" );
+		return true;
+	}
+
+}	// FG
@@ -0,0 +1,171 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Frame graph on top of the null Vulkan device.
+	Doesn't require GPU, used to measure CPU side of the frame graph.
+*/
+
+#pragma once
+
+#include "framegraph/FG.h"
+#include "stl/Algorithms/StringUtils.h"
+#include "vulkan_loader/VulkanNullDevice.h"
+#include "vulkan_loader/VulkanCheckError.h"
+#include <chrono>
+
+using namespace FG;
+
+#define TEST	CHECK_FATAL
+
+
+//
+// Null Device Frame Graph
+//
+
+class NullDeviceFrameGraph final
+{
+// types
+public:
+	using Clock_t		= std::chrono::high_resolution_clock;
+	using TimePoint_t	= Clock_t::time_point;
+
+	struct FrameTime
+	{
+		Nanoseconds		build		{0};	// add tasks to command buffer
+		Nanoseconds		execute		{0};	// task graph processing, barriers and command recording
+		Nanoseconds		submit		{0};	// flush and wait
+		uint64_t		vkCalls		= 0;
+		uint64_t		barriers	= 0;
+	};
+
+
+// variables
+private:
+	VkInstance				_instance		= VK_NULL_HANDLE;
+	VkPhysicalDevice		_physicalDevice	= VK_NULL_HANDLE;
+	VkDevice				_device			= VK_NULL_HANDLE;
+	VulkanDeviceFnTable		_deviceFnTable;
+	FrameGraph				_frameGraph;
+
+
+// methods
+public:
+	NullDeviceFrameGraph () {}
+	~NullDeviceFrameGraph ()	{ Destroy(); }
+
+	bool  Create ()
+	{
+		CHECK_ERR( VulkanLoader::Initialize( VulkanNullDevice::GetInstanceProcAddr() ));
+
+		VkInstanceCreateInfo	inst_info = {};
+		inst_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		VK_CHECK( vkCreateInstance( &inst_info, null, OUT &_instance ));
+		CHECK_ERR( VulkanLoader::LoadInstance( _instance ));
+
+		uint	count = 1;
+		VK_CHECK( vkEnumeratePhysicalDevices( _instance, INOUT &count, OUT &_physicalDevice ));
+
+		const float				priority	= 1.0f;
+		VkDeviceQueueCreateInfo	queue_info	= {};
+		queue_info.sType			= VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queue_info.queueFamilyIndex	= 0;
+		queue_info.queueCount		= 1;
+		queue_info.pQueuePriorities	= &priority;
+
+		VkDeviceCreateInfo		dev_info = {};
+		dev_info.sType					= VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		dev_info.queueCreateInfoCount	= 1;
+		dev_info.pQueueCreateInfos		= &queue_info;
+		VK_CHECK( vkCreateDevice( _physicalDevice, &dev_info, null, OUT &_device ));
+		CHECK_ERR( VulkanLoader::LoadDevice( _device, OUT _deviceFnTable ));
+
+		VkQueue		queue = VK_NULL_HANDLE;
+		VulkanDeviceFn{ &_deviceFnTable }.vkGetDeviceQueue( _device, 0, 0, OUT &queue );
+
+		VulkanDeviceInfo			vulkan_info;
+		VulkanDeviceInfo::QueueInfo	queue_info2;
+
+		queue_info2.handle		= BitCast<QueueVk_t>( queue );
+		queue_info2.familyFlags	= BitCast<QueueFlagsVk_t>( VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT );
+		queue_info2.familyIndex	= 0;
+		queue_info2.priority	= priority;
+		queue_info2.debugName	= "NullQueue";
+
+		vulkan_info.instance		= BitCast<InstanceVk_t>( _instance );
+		vulkan_info.physicalDevice	= BitCast<PhysicalDeviceVk_t>( _physicalDevice );
+		vulkan_info.device			= BitCast<DeviceVk_t>( _device );
+		vulkan_info.queues.push_back( queue_info2 );
+
+		_frameGraph = IFrameGraph::CreateFrameGraph( vulkan_info );
+		CHECK_ERR( _frameGraph );
+		return true;
+	}
+
+	void  Destroy ()
+	{
+		if ( _frameGraph )
+		{
+			_frameGraph->Deinitialize();
+			_frameGraph = null;
+
+			// released in 'CreateFrameGraph'
+			VulkanLoader::Unload();
+		}
+
+		if ( _device )
+		{
+			VulkanDeviceFn{ &_deviceFnTable }.vkDestroyDevice( _device, null );
+			VulkanLoader::ResetDevice( OUT _deviceFnTable );
+			_device = VK_NULL_HANDLE;
+		}
+
+		if ( _instance )
+		{
+			vkDestroyInstance( _instance, null );
+			VulkanLoader::Unload();
+			_instance = VK_NULL_HANDLE;
+		}
+	}
+
+	ND_ FrameGraph const&  operator -> () const		{ return _frameGraph; }
+	ND_ FrameGraph const&  Get () const				{ return _frameGraph; }
+
+
+	// measures one frame, 'buildFn' must add tasks to the command buffer
+	template <typename Fn>
+	bool  RunFrame (Fn &&buildFn, INOUT FrameTime &time)
+	{
+		const uint64_t		calls		= VulkanNullDevice::GetTotalCallCount();
+		const uint64_t		barriers	= VulkanNullDevice::GetCallCount( "vkCmdPipelineBarrier" );
+		const TimePoint_t	t0			= Clock_t::now();
+
+		CommandBuffer	cmd = _frameGraph->Begin( CommandBufferDesc{ EQueueType::Graphics });
+		CHECK_ERR( cmd );
+		CHECK_ERR( buildFn( cmd ));
+
+		const TimePoint_t	t1 = Clock_t::now();
+		CHECK_ERR( _frameGraph->Execute( cmd ));
+
+		const TimePoint_t	t2 = Clock_t::now();
+		CHECK_ERR( _frameGraph->Flush() );
+		CHECK_ERR( _frameGraph->WaitIdle() );
+
+		const TimePoint_t	t3 = Clock_t::now();
+
+		time.build		+= std::chrono::duration_cast<Nanoseconds>( t1 - t0 );
+		time.execute	+= std::chrono::duration_cast<Nanoseconds>( t2 - t1 );
+		time.submit		+= std::chrono::duration_cast<Nanoseconds>( t3 - t2 );
+		time.vkCalls	+= VulkanNullDevice::GetTotalCallCount() - calls;
+		time.barriers	+= VulkanNullDevice::GetCallCount( "vkCmdPipelineBarrier" ) - barriers;
+		return true;
+	}
+
+	static void  PrintResult (StringView name, uint frameCount, const FrameTime &time)
+	{
+		FG_LOGI( String{name} << ", frames: " << ToString( frameCount )
+				 << ", per frame - build: " << ToString( time.build / frameCount )
+				 << ", execute: " << ToString( time.execute / frameCount )
+				 << ", submit: " << ToString( time.submit / frameCount )
+				 << ", vk calls: " << ToString( time.vkCalls / frameCount )
+				 << ", barriers: " << ToString( time.barriers / frameCount ));
+	}
+};
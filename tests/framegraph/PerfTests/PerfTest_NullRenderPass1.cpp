@@ -0,0 +1,388 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Render passes with simple draw calls on null device.
+	Measures CPU time that is required to create render passes, framebuffers,
+	to record draw calls and to place layout transitions between passes.
+	Compares separate 'DrawIndexed' tasks with single 'DrawIndexedBatch'.
+	Checks order of recorded draw calls when draw task sorting is enabled.
+*/
+
+#include "PerfTest_Common.h"
+
+#ifdef FG_ENABLE_VULKAN
+
+// null device doesn't parse shaders, so only SPIR-V header is required
+static GPipelineID  CreateNullPipeline (NullDeviceFrameGraph &fg)
+{
+	const GraphicsPipelineDesc::FragmentOutput	frag_output[] = { {0, EFragOutput::Float4} };
+
+	GraphicsPipelineDesc	ppln;
+	ppln.AddShader( EShader::Vertex,   EShaderLangFormat::SPIRV_100, "main", Array<uint>{ 0x07230203, 0x00010000, 0, 1, 0 });
+	ppln.AddShader( EShader::Fragment, EShaderLangFormat::SPIRV_100, "main", Array<uint>{ 0x07230203, 0x00010000, 0, 1, 0 });
+	ppln.AddTopology( EPrimitive::TriangleList );
+	ppln.SetFragmentOutputs( frag_output );
+
+	return fg->CreatePipeline( ppln );
+}
+
+
+static bool  PerfTest_RenderPassChain (NullDeviceFrameGraph &fg)
+{
+	const uint		frame_count	= 100;
+	const uint		pass_count	= 32;
+	const uint		draw_count	= 64;
+	const uint2		dim			= {1024, 1024};
+
+	ImageID		color	= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::ColorAttachment | EImageUsage::Sampled | EImageUsage::TransferSrc ), Default, "Color" );
+	ImageID		depth	= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::Depth32F )
+												.SetUsage( EImageUsage::DepthStencilAttachment ), Default, "Depth" );
+	BufferID	buffer	= fg->CreateBuffer( BufferDesc{ 4_b * dim.x * dim.y, EBufferUsage::TransferDst }, Default, "ReadBack" );
+	GPipelineID	pipeline = CreateNullPipeline( fg );
+	CHECK_ERR( color and depth and buffer and pipeline );
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		Task	last;
+		for (uint i = 0; i < pass_count; ++i)
+		{
+			LogicalPassID	pass = cmd->CreateRenderPass( RenderPassDesc{ dim }
+											.AddTarget( RenderTargetID::Color_0, color, RGBA32f{ float(i) / pass_count }, EAttachmentStoreOp::Store )
+											.AddTarget( RenderTargetID::Depth, depth, DepthStencil{ 1.0f }, EAttachmentStoreOp::Store )
+											.AddViewport( dim ));
+			CHECK_ERR( pass );
+
+			for (uint j = 0; j < draw_count; ++j) {
+				cmd->AddTask( pass, DrawVertices{}.SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ).Draw( 3 ));
+			}
+
+			last = cmd->AddTask( SubmitRenderPass{ pass }.DependsOn( last ));
+			CHECK_ERR( last );
+
+			// switch layout between render passes
+			if ( (i & 7) == 7 )
+			{
+				last = cmd->AddTask( CopyImageToBuffer{}.From( color ).To( buffer ).AddRegion( {}, int3(), uint3{ dim, 1 }, 0_b, dim.x, dim.y ).DependsOn( last ));
+				CHECK_ERR( last );
+			}
+		}
+		return true;
+	};
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (uint i = 0; i < frame_count; ++i) {
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	}
+	NullDeviceFrameGraph::PrintResult( "RenderPassChain", frame_count, time );
+
+	fg->ReleaseResource( INOUT pipeline );
+	fg->ReleaseResource( INOUT color );
+	fg->ReleaseResource( INOUT depth );
+	fg->ReleaseResource( INOUT buffer );
+	return true;
+}
+
+
+static bool  PerfTest_CacheEviction (NullDeviceFrameGraph &fg)
+{
+	const uint		eviction_submits	= 8;
+	const uint2		dim					= {256, 256};
+
+	ImageID		color	 = fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::ColorAttachment ), Default, "Color" );
+	GPipelineID	pipeline = CreateNullPipeline( fg );
+	CHECK_ERR( color and pipeline );
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		LogicalPassID	pass = cmd->CreateRenderPass( RenderPassDesc{ dim }
+										.AddTarget( RenderTargetID::Color_0, color, RGBA32f{ 0.0f }, EAttachmentStoreOp::Store )
+										.AddViewport( dim ));
+		CHECK_ERR( pass );
+
+		cmd->AddTask( pass, DrawVertices{}.SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList ).Draw( 3 ));
+		CHECK_ERR( cmd->AddTask( SubmitRenderPass{ pass }));
+		return true;
+	};
+	const auto	Idle = [] (const CommandBuffer &) { return true; };
+
+	fg->SetCacheEvictionSubmits( eviction_submits );
+
+	IFrameGraph::Statistics			stat;
+	NullDeviceFrameGraph::FrameTime	time;
+
+	// create framebuffer
+	CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	CHECK_ERR( fg->GetStatistics( OUT stat ));
+
+	// framebuffer is used, so it must stay in cache
+	CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	CHECK_ERR( fg->GetStatistics( OUT stat ));
+	CHECK_ERR( stat.resources.cacheMisses == 0 );
+	CHECK_ERR( stat.resources.cacheEvictions == 0 );
+
+	// framebuffer is not used during 'eviction_submits' submits and must be destroyed,
+	// only part of the cache is checked per submit, so it may take some more submits
+	uint	evictions = 0;
+	for (uint i = 0; i < eviction_submits + 64 and evictions == 0; ++i)
+	{
+		CHECK_ERR( fg.RunFrame( Idle, INOUT time ));
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+		CHECK_ERR( i >= eviction_submits-1 or stat.resources.cacheEvictions == 0 );
+		evictions += stat.resources.cacheEvictions;
+	}
+	CHECK_ERR( evictions > 0 );
+
+	// framebuffer must be recreated
+	CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	CHECK_ERR( fg->GetStatistics( OUT stat ));
+	CHECK_ERR( stat.resources.cacheMisses > 0 );
+	CHECK_ERR( stat.resources.cacheEvictions == 0 );
+
+	fg->SetCacheEvictionSubmits( FG_CacheEvictionSubmits );
+	fg->ReleaseResource( INOUT pipeline );
+	fg->ReleaseResource( INOUT color );
+	return true;
+}
+
+
+static bool  PerfTest_DrawBatch (NullDeviceFrameGraph &fg)
+{
+	using DrawCmd = DrawIndexedBatch::DrawCmd;
+
+	const uint		frame_count	= 100;
+	const uint		draw_count	= 4096;
+	const uint2		dim			= {1024, 1024};
+
+	ImageID		color	 = fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::ColorAttachment ), Default, "Color" );
+	BufferID	ibuffer	 = fg->CreateBuffer( BufferDesc{ 6_b * draw_count, EBufferUsage::Index }, Default, "IndexBuffer" );
+	GPipelineID	pipeline = CreateNullPipeline( fg );
+	CHECK_ERR( color and ibuffer and pipeline );
+
+	Array<DrawCmd>	commands;
+	for (uint i = 0; i < draw_count; ++i) {
+		commands.push_back( DrawCmd{ 3, 1, i*3, 0, 0 });
+	}
+
+	const auto	CreatePass = [&] (const CommandBuffer &cmd)
+	{
+		return cmd->CreateRenderPass( RenderPassDesc{ dim }
+									.AddTarget( RenderTargetID::Color_0, color, RGBA32f{ 0.0f }, EAttachmentStoreOp::Store )
+									.AddViewport( dim ));
+	};
+
+	const auto	BuildDraws = [&] (const CommandBuffer &cmd) -> bool
+	{
+		LogicalPassID	pass = CreatePass( cmd );
+		CHECK_ERR( pass );
+
+		for (auto& dc : commands) {
+			cmd->AddTask( pass, DrawIndexed{}.SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList )
+									.SetIndexBuffer( ibuffer, 0_b, EIndex::UShort )
+									.Draw( dc.indexCount, dc.instanceCount, dc.firstIndex, dc.vertexOffset, dc.firstInstance ));
+		}
+		CHECK_ERR( cmd->AddTask( SubmitRenderPass{ pass }));
+		return true;
+	};
+
+	const auto	BuildBatch = [&] (const CommandBuffer &cmd) -> bool
+	{
+		LogicalPassID	pass = CreatePass( cmd );
+		CHECK_ERR( pass );
+
+		cmd->AddTask( pass, DrawIndexedBatch{}.SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList )
+								.SetIndexBuffer( ibuffer, 0_b, EIndex::UShort )
+								.SetCommands( commands ));
+		CHECK_ERR( cmd->AddTask( SubmitRenderPass{ pass }));
+		return true;
+	};
+
+	// single render pass per frame, so all task memory is used by this pass
+	const auto	Run = [&] (StringView name, auto &&build, OUT BytesU &passMemory) -> bool
+	{
+		IFrameGraph::Statistics			stat;
+		NullDeviceFrameGraph::FrameTime	time;
+		uint							draw_calls	= 0;
+
+		CHECK_ERR( fg->GetStatistics( OUT stat ));	// reset
+		passMemory = 0_b;
+
+		for (uint i = 0; i < frame_count; ++i)
+		{
+			CHECK_ERR( fg.RunFrame( build, INOUT time ));
+			CHECK_ERR( fg->GetStatistics( OUT stat ));
+
+			passMemory	+= stat.renderer.taskMemory;
+			draw_calls	+= stat.renderer.drawCalls;
+		}
+		CHECK_ERR( draw_calls == draw_count * frame_count );
+
+		passMemory /= uint64_t(frame_count);
+		NullDeviceFrameGraph::PrintResult( name, frame_count, time );
+		return true;
+	};
+
+	BytesU	draws_memory, batch_memory;
+	CHECK_ERR( Run( "DrawIndexed x "s << ToString( draw_count ), BuildDraws, OUT draws_memory ));
+	CHECK_ERR( Run( "DrawIndexedBatch x "s << ToString( draw_count ), BuildBatch, OUT batch_memory ));
+
+	FG_LOGI( "render pass memory - DrawIndexed: "s << ToString( draws_memory ) << ", DrawIndexedBatch: " << ToString( batch_memory ));
+	CHECK_ERR( batch_memory < draws_memory );
+
+	fg->ReleaseResource( INOUT pipeline );
+	fg->ReleaseResource( INOUT color );
+	fg->ReleaseResource( INOUT ibuffer );
+	return true;
+}
+
+
+static bool  PerfTest_DrawTaskSorting (NullDeviceFrameGraph &fg)
+{
+	using DrawLog_t = VulkanNullDevice::DrawLog_t;
+
+	const uint		draw_count	= 8;
+	const uint2		dim			= {256, 256};
+
+	ImageID		color		= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::ColorAttachment ), Default, "Color" );
+	ImageID		depth		= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::Depth32F )
+												.SetUsage( EImageUsage::DepthStencilAttachment ), Default, "Depth" );
+	GPipelineID	pipeline0	= CreateNullPipeline( fg );
+	GPipelineID	pipeline1	= CreateNullPipeline( fg );
+	CHECK_ERR( color and depth and pipeline0 and pipeline1 );
+
+	// draws with alternating pipelines, 'firstInstance' is used to identify draw call,
+	// 'modify' changes render states of the single draw task
+	const auto	Run = [&] (bool withDepth, auto &&modify, OUT DrawLog_t &log) -> bool
+	{
+		const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+		{
+			RenderPassDesc	rp_desc{ dim };
+			rp_desc.AddTarget( RenderTargetID::Color_0, color, RGBA32f{ 0.0f }, EAttachmentStoreOp::Store )
+					.AddViewport( dim )
+					.SetDrawTaskSortingEnabled( true );
+
+			if ( withDepth )
+			{
+				rp_desc.AddTarget( RenderTargetID::Depth, depth, DepthStencil{ 1.0f }, EAttachmentStoreOp::Store )
+						.SetDepthTestEnabled( true ).SetDepthWriteEnabled( true ).SetDepthCompareOp( ECompareOp::Less );
+			}
+
+			LogicalPassID	pass = cmd->CreateRenderPass( rp_desc );
+			CHECK_ERR( pass );
+
+			for (uint i = 0; i < draw_count; ++i)
+			{
+				DrawVertices	draw;
+				draw.SetPipeline( (i & 1) ? pipeline1 : pipeline0 ).SetTopology( EPrimitive::TriangleList ).Draw( 3, 1, 0, i );
+
+				if ( i == draw_count/2 )
+					modify( draw );
+
+				cmd->AddTask( pass, draw );
+			}
+			CHECK_ERR( cmd->AddTask( SubmitRenderPass{ pass }));
+			return true;
+		};
+
+		NullDeviceFrameGraph::FrameTime	time;
+
+		VulkanNullDevice::SetDrawLogEnabled( true );
+		const bool	ok = fg.RunFrame( Build, INOUT time );
+		VulkanNullDevice::GetDrawLog( OUT log );
+		VulkanNullDevice::SetDrawLogEnabled( false );
+
+		CHECK_ERR( ok );
+		CHECK_ERR( log.size() == draw_count );
+		return true;
+	};
+
+	const auto	IsInitialOrder = [&] (const DrawLog_t &log)
+	{
+		for (uint i = 0; i < draw_count; ++i) {
+			if ( log[i].firstInstance != i )
+				return false;
+		}
+		return true;
+	};
+
+	// draws must be grouped by pipeline and keep insertion order inside group
+	const auto	IsGroupedByPipeline = [&] (const DrawLog_t &log)
+	{
+		const uint	first = log[0].firstInstance & 1;
+
+		for (uint i = 0; i < draw_count; ++i) {
+			if ( log[i].firstInstance != (i < draw_count/2 ? first : 1-first) + (i % (draw_count/2)) * 2 )
+				return false;
+		}
+		return true;
+	};
+
+	DrawLog_t	log;
+
+	// result doesn't depend on draw order
+	CHECK_ERR( Run( true, [] (DrawVertices &) {}, OUT log ));
+	CHECK_ERR( IsGroupedByPipeline( log ));
+
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.SetDepthCompareOp( ECompareOp::Greater ); }, OUT log ));
+	CHECK_ERR( IsGroupedByPipeline( log ));
+
+	// equal depth values
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.SetDepthCompareOp( ECompareOp::LEqual ); }, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.SetDepthWriteEnabled( false ); }, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.SetDepthTestEnabled( false ); }, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.SetStencilTestEnabled( true ).SetStencilPassOp( EStencilOp::Replace ); }, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	CHECK_ERR( Run( true, [] (DrawVertices &draw) { draw.AddColorBuffer( RenderTargetID::Color_0, EBlendFactor::SrcAlpha, EBlendFactor::OneMinusSrcAlpha, EBlendOp::Add ); }, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	// without depth buffer
+	CHECK_ERR( Run( false, [] (DrawVertices &) {}, OUT log ));
+	CHECK_ERR( IsInitialOrder( log ));
+
+	fg->ReleaseResource( INOUT pipeline0 );
+	fg->ReleaseResource( INOUT pipeline1 );
+	fg->ReleaseResource( INOUT color );
+	fg->ReleaseResource( INOUT depth );
+	return true;
+}
+
+
+extern void PerfTest_NullRenderPass1 ()
+{
+	NullDeviceFrameGraph	fg;
+	TEST( fg.Create() );
+
+	VulkanNullDevice::ResetCallCounts();
+
+	TEST( PerfTest_RenderPassChain( fg ));
+	TEST( PerfTest_CacheEviction( fg ));
+	TEST( PerfTest_DrawBatch( fg ));
+	TEST( PerfTest_DrawTaskSorting( fg ));
+
+	// print the most frequent calls
+	VulkanNullDevice::CallCounts_t	counts;
+	VulkanNullDevice::GetCallCounts( OUT counts );
+
+	std::sort( counts.begin(), counts.end(), [] (auto& lhs, auto& rhs) { return lhs.second > rhs.second; });
+
+	String	str = "Vulkan calls:";
+	for (size_t i = 0, cnt = Min( counts.size(), size_t(8) ); i < cnt; ++i) {
+		str << "\n  " << counts[i].first << ": " << ToString( counts[i].second );
+	}
+	FG_LOGI( str );
+
+	fg.Destroy();
+
+	FG_LOGI( "PerfTest_NullRenderPass1 - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,209 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Internal resource pools on null device.
+	Checks that scratch and instance buffers for acceleration structures
+	are reused between command batches and trimmed to the high-water mark.
+	Compares memory of transient resources with memory of shared heaps.
+*/
+
+#include "PerfTest_Common.h"
+
+#ifdef FG_ENABLE_VULKAN
+#include "VCmdBatch.h"
+
+static bool  PerfTest_RayTracingBuffers (NullDeviceFrameGraph &fg)
+{
+	const uint		frame_count	= 16;
+	const BytesU	align		= 256_b;
+	const BytesU	min_size	= 64_Kb;	// 'VResourceManager::MinRTBufferSize'
+
+	// sub-allocates scratch memory like 'BuildRayTracingGeometry' and 'BuildRayTracingScene' tasks do
+	const auto	Run = [&] (ArrayView<BytesU> sizes, OUT IFrameGraph::Statistics &stat) -> bool
+	{
+		const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+		{
+			VCmdBatch &	batch = *static_cast<VCmdBatch *>( cmd.GetBatch() );
+
+			for (auto& size : sizes)
+			{
+				RawBufferID	buf;
+				BytesU		offset;
+				CHECK_ERR( batch.AllocRayTracingBuffer( size, align, OUT buf, OUT offset ));
+				CHECK_ERR( buf );
+			}
+			return true;
+		};
+
+		NullDeviceFrameGraph::FrameTime	time;
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+		return true;
+	};
+
+	IFrameGraph::Statistics	stat;
+	CHECK_ERR( fg->GetStatistics( OUT stat ));	// reset counters
+
+	// all allocations fit into single buffer that is reused in each batch
+	const BytesU	small_sizes[] = { min_size / 4, min_size / 4, min_size / 4, min_size / 4 };
+	uint			allocations	= 0;
+	uint			creations	= 0;
+
+	for (uint i = 0; i < frame_count; ++i)
+	{
+		CHECK_ERR( Run( small_sizes, OUT stat ));
+		allocations	+= stat.resources.rtBufferAllocations;
+		creations	+= stat.resources.rtBufferCreations;
+	}
+	CHECK_ERR( allocations == CountOf(small_sizes) * frame_count );
+	CHECK_ERR( creations == 1 );
+	CHECK_ERR( creations < allocations );
+	CHECK_ERR( stat.resources.rtBufferHighWaterMark == min_size );
+
+	// batch requires more memory than single buffer has,
+	// both buffers are smaller than the new high-water mark and must be destroyed
+	const BytesU	large_sizes[]	= { min_size * 3 / 4, min_size * 3 / 4 };
+	const uint64_t	destroyed		= VulkanNullDevice::GetCallCount( "vkDestroyBuffer" );
+
+	CHECK_ERR( Run( large_sizes, OUT stat ));
+	CHECK_ERR( stat.resources.rtBufferCreations == 1 );
+	CHECK_ERR( stat.resources.rtBufferHighWaterMark == min_size * 3 / 2 );
+
+	// single buffer with size of the high-water mark is created instead of released buffers
+	CHECK_ERR( Run( large_sizes, OUT stat ));
+	CHECK_ERR( stat.resources.rtBufferCreations == 1 );
+	CHECK_ERR( VulkanNullDevice::GetCallCount( "vkDestroyBuffer" ) - destroyed >= 2 );
+
+	for (uint i = 0; i < frame_count; ++i)
+	{
+		CHECK_ERR( Run( large_sizes, OUT stat ));
+		CHECK_ERR( stat.resources.rtBufferAllocations == CountOf(large_sizes) );
+		CHECK_ERR( stat.resources.rtBufferCreations == 0 );
+	}
+	return true;
+}
+
+
+static bool  PerfTest_TransientResources (NullDeviceFrameGraph &fg)
+{
+	using DrawCmd = DrawIndexedBatch::DrawCmd;
+
+	const uint		frame_count	= 100;
+	const uint		image_count	= 8;
+	const uint		draw_count	= 4;
+	const uint2		dim			= {1024, 1024};
+	const auto		per_draw	= DescriptorSetID{"PerDraw"};
+	const auto		un_texture	= UniformID{"un_Texture"};
+
+	// null device doesn't parse shaders, so pipeline layout must be specified explicitly
+	const GraphicsPipelineDesc::FragmentOutput	frag_output[] = { {0, EFragOutput::Float4} };
+
+	GraphicsPipelineDesc	ppln;
+	ppln.AddShader( EShader::Vertex,   EShaderLangFormat::SPIRV_100, "main", Array<uint>{ 0x07230203, 0x00010000, 0, 1, 0 });
+	ppln.AddShader( EShader::Fragment, EShaderLangFormat::SPIRV_100, "main", Array<uint>{ 0x07230203, 0x00010000, 0, 1, 0 });
+	ppln.AddTopology( EPrimitive::TriangleList );
+	ppln.SetFragmentOutputs( frag_output );
+	ppln.AddDescriptorSet( per_draw, 0, {{ un_texture, EImageSampler::Float2D, BindingIndex{UMax, 0u}, 1, EShaderStages::Fragment }}, {}, {}, {}, {}, {} );
+
+	ImageID		color	 = fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::ColorAttachment ), Default, "Color" );
+	BufferID	ibuffer	 = fg->CreateBuffer( BufferDesc{ 6_b * draw_count, EBufferUsage::Index }, Default, "IndexBuffer" );
+	SamplerID	sampler	 = fg->CreateSampler( SamplerDesc{} );
+	GPipelineID	pipeline = fg->CreatePipeline( ppln );
+	CHECK_ERR( color and ibuffer and sampler and pipeline );
+
+	PipelineResources				resources [draw_count];
+	PipelineResources const*		res_ptrs  [draw_count];
+	DrawCmd							commands  [draw_count];
+
+	for (uint i = 0; i < draw_count; ++i)
+	{
+		CHECK_ERR( fg->InitPipelineResources( pipeline, per_draw, OUT resources[i] ));
+		res_ptrs[i] = &resources[i];
+		commands[i] = DrawCmd{ 3, 1, i*3, 0, 0 };
+	}
+
+	// each image is filled by the previous one, so only two images are alive at the same time,
+	// per draw descriptor sets use the last image and they are created after memory binding
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		const ImageDesc	desc = ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+										.SetUsage( EImageUsage::Transfer | EImageUsage::Sampled );
+		RawImageID	images [image_count];
+		Task		last;
+
+		for (uint i = 0; i < image_count; ++i)
+		{
+			images[i] = cmd->CreateTransientImage( desc, "Transient" );
+			CHECK_ERR( images[i] );
+
+			if ( i == 0 )
+				last = cmd->AddTask( ClearColorImage{}.SetImage( images[i] ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{ 1.0f }));
+			else
+				last = cmd->AddTask( CopyImage{}.From( images[i-1] ).To( images[i] ).AddRegion( {}, int2(), {}, int2(), dim ).DependsOn( last ));
+			CHECK_ERR( last );
+		}
+
+		for (auto& res : resources) {
+			res.BindTexture( un_texture, images[image_count-1], sampler );
+		}
+
+		LogicalPassID	pass = cmd->CreateRenderPass( RenderPassDesc{ dim }
+										.AddTarget( RenderTargetID::Color_0, color, RGBA32f{ 0.0f }, EAttachmentStoreOp::Store )
+										.AddViewport( dim ));
+		CHECK_ERR( pass );
+
+		cmd->AddTask( pass, DrawIndexedBatch{}.SetPipeline( pipeline ).SetTopology( EPrimitive::TriangleList )
+								.SetIndexBuffer( ibuffer, 0_b, EIndex::UShort )
+								.SetCommands( commands )
+								.SetPerDrawResources( per_draw, res_ptrs ));
+		CHECK_ERR( cmd->AddTask( SubmitRenderPass{ pass }.DependsOn( last )));
+		return true;
+	};
+
+	IFrameGraph::Statistics			stat;
+	NullDeviceFrameGraph::FrameTime	time;
+	BytesU							resource_memory;
+	BytesU							heap_memory;
+
+	CHECK_ERR( fg->GetStatistics( OUT stat ));	// reset counters
+
+	for (uint i = 0; i < frame_count; ++i)
+	{
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+
+		CHECK_ERR( stat.renderer.drawCalls == draw_count );
+		resource_memory	+= stat.resources.transientResourceMemory;
+		heap_memory		+= stat.resources.transientHeapMemory;
+	}
+
+	resource_memory	/= uint64_t(frame_count);
+	heap_memory		/= uint64_t(frame_count);
+	NullDeviceFrameGraph::PrintResult( "TransientImageChain x "s << ToString( image_count ), frame_count, time );
+
+	FG_LOGI( "transient memory - resources: "s << ToString( resource_memory ) << ", heaps: " << ToString( heap_memory ));
+	CHECK_ERR( heap_memory > 0_b );
+	CHECK_ERR( heap_memory * 2 <= resource_memory );
+
+	fg->ReleaseResource( INOUT pipeline );
+	fg->ReleaseResource( INOUT sampler );
+	fg->ReleaseResource( INOUT color );
+	fg->ReleaseResource( INOUT ibuffer );
+	return true;
+}
+
+
+extern void PerfTest_NullResources1 ()
+{
+	NullDeviceFrameGraph	fg;
+	TEST( fg.Create() );
+
+	TEST( PerfTest_RayTracingBuffers( fg ));
+	TEST( PerfTest_TransientResources( fg ));
+
+	fg.Destroy();
+
+	FG_LOGI( "PerfTest_NullResources1 - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -0,0 +1,508 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Transfer tasks on null device.
+	Measures CPU time that is required to build task graph, place barriers and record commands.
+*/
+
+#include "PerfTest_Common.h"
+#include <thread>
+
+#ifdef FG_ENABLE_VULKAN
+
+static bool  PerfTest_BufferChain (NullDeviceFrameGraph &fg)
+{
+	const uint		frame_count	= 100;
+	const uint		chain_count	= 64;
+	const BytesU	buf_size	= 4_Kb;
+
+	Array<BufferID>	buffers;
+	for (uint i = 0; i < chain_count; ++i)
+	{
+		buffers.push_back( fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::Transfer }, Default, "Buffer" ));
+		CHECK_ERR( buffers.back() );
+	}
+
+	Array<uint8_t>	data;	data.resize( 256, uint8_t(0x1F) );
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		for (uint i = 0; i+1 < chain_count; i += 2)
+		{
+			Task	t_update	= cmd->AddTask( UpdateBuffer{}.SetBuffer( buffers[i] ).AddData( data ));
+			Task	t_copy		= cmd->AddTask( CopyBuffer{}.From( buffers[i] ).To( buffers[i+1] ).AddRegion( 0_b, 1_Kb, 256_b ).DependsOn( t_update ));
+			Task	t_fill		= cmd->AddTask( FillBuffer{}.SetBuffer( buffers[i+1], 2_Kb, 1_Kb ).SetPattern( i ).DependsOn( t_copy ));
+			CHECK_ERR( t_update and t_copy and t_fill );
+		}
+		return true;
+	};
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (uint i = 0; i < frame_count; ++i) {
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	}
+	NullDeviceFrameGraph::PrintResult( "BufferChain", frame_count, time );
+
+	for (auto& buf : buffers) {
+		fg->ReleaseResource( INOUT buf );
+	}
+	return true;
+}
+
+
+static bool  PerfTest_ImageChain (NullDeviceFrameGraph &fg)
+{
+	const uint		frame_count	= 100;
+	const uint		image_count	= 32;
+	const uint2		dim			= {256, 256};
+
+	Array<ImageID>	images;
+	for (uint i = 0; i < image_count; ++i)
+	{
+		images.push_back( fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm ).SetAllMipmaps()
+												.SetUsage( EImageUsage::Transfer | EImageUsage::Sampled ), Default, "Image" ));
+		CHECK_ERR( images.back() );
+	}
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		for (uint i = 0; i+1 < image_count; i += 2)
+		{
+			Task	t_clear	= cmd->AddTask( ClearColorImage{}.SetImage( images[i] ).AddRange( 0_mipmap, 1, 0_layer, 1 ).Clear( RGBA32f{ 1.0f }));
+			Task	t_copy	= cmd->AddTask( CopyImage{}.From( images[i] ).To( images[i+1] ).AddRegion( {}, int2(), {}, int2(), dim / 2 ).DependsOn( t_clear ));
+			Task	t_blit	= cmd->AddTask( BlitImage{}.From( images[i] ).To( images[i+1] ).SetFilter( EFilter::Linear )
+													.AddRegion( {}, int2(), int2(dim), {}, int2(dim/2), int2(dim) ).DependsOn( t_copy ));
+			Task	t_mips	= cmd->AddTask( GenerateMipmaps{}.SetImage( images[i+1] ).SetMipmaps( 0, UMax ).SetArrayLayers( 0, 1 ).DependsOn( t_blit ));
+			CHECK_ERR( t_clear and t_copy and t_blit and t_mips );
+		}
+		return true;
+	};
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (uint i = 0; i < frame_count; ++i) {
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	}
+	NullDeviceFrameGraph::PrintResult( "ImageChain", frame_count, time );
+
+	for (auto& img : images) {
+		fg->ReleaseResource( INOUT img );
+	}
+	return true;
+}
+
+
+static bool  PerfTest_StreamingUpload (NullDeviceFrameGraph &fg)
+{
+	const uint		frame_count	= 20;
+	const uint2		dim			= {1024, 1024};
+	const BytesU	img_size	= 4_b * dim.x * dim.y;
+	const BytesU	buf_size	= 4_Mb;
+
+	ImageID		image	= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::TransferDst | EImageUsage::Sampled ), Default, "Image" );
+	BufferID	buffer	= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::TransferDst }, Default, "Buffer" );
+	CHECK_ERR( image and buffer );
+
+	BytesU	img_written, buf_written;
+	bool	is_sequential = true;
+
+	// source data is generated part by part directly in the staging memory
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		img_written = buf_written = 0_b;
+
+		Task	t_image	= cmd->AddTask( UpdateImage{}.SetImage( image ).SetDataWriter(
+									[&] (void* dst, BytesU offset, BytesU size)
+									{
+										is_sequential &= (offset == img_written);
+										std::memset( dst, int(offset / (4_b * dim.x)), size_t(size) );
+										img_written += size;
+									}, dim ));
+		Task	t_buffer = cmd->AddTask( UpdateBuffer{}.SetBuffer( buffer ).AddDataWriter(
+									[&] (void* dst, BytesU offset, BytesU size)
+									{
+										is_sequential &= (offset == buf_written);
+										std::memset( dst, 0x1F, size_t(size) );
+										buf_written += size;
+									}, buf_size ));
+		CHECK_ERR( t_image and t_buffer );
+		CHECK_ERR( img_written == img_size and buf_written == buf_size );
+		return true;
+	};
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (uint i = 0; i < frame_count; ++i) {
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	}
+	NullDeviceFrameGraph::PrintResult( "StreamingUpload", frame_count, time );
+
+	CHECK_ERR( is_sequential );
+
+	fg->ReleaseResource( INOUT image );
+	fg->ReleaseResource( INOUT buffer );
+	return true;
+}
+
+
+static bool  PerfTest_UploadQueue (NullDeviceFrameGraph &fg)
+{
+	const uint2		dim			= {2048, 2048};
+	const BytesU	buf_size	= 8_Mb;
+	const BytesU	budget		= 1_Mb;
+
+	ImageID		image	= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::TransferDst | EImageUsage::Sampled ), Default, "Image" );
+	BufferID	buffer	= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::TransferDst }, Default, "Buffer" );
+	CHECK_ERR( image and buffer );
+
+	Array<uint8_t>	pixels;		pixels.resize( 4 * dim.x * dim.y, uint8_t(0x7F) );
+	BytesU			buf_written;
+	bool			image_uploaded	= false;
+	bool			buffer_uploaded	= false;
+
+	// single frame can't upload more than 8 staging buffers, so it must be split between frames
+	fg->SetUploadBudget( budget );
+
+	CHECK_ERR( fg->EnqueueUpload( UpdateImage{}.SetImage( image ).SetData( pixels, dim ), [&image_uploaded] () { image_uploaded = true; }));
+	CHECK_ERR( fg->EnqueueUpload( UpdateBuffer{}.SetBuffer( buffer ).AddDataWriter(
+									[&buf_written] (void* dst, BytesU offset, BytesU size)
+									{
+										CHECK( offset == buf_written );
+										std::memset( dst, 0x1F, size_t(size) );
+										buf_written += size;
+									}, buf_size ),
+								   [&buffer_uploaded] () { buffer_uploaded = true; }));
+
+	const uint	expected_frames	= uint((ArraySizeOf(pixels) + buf_size + budget - 1) / budget);
+	uint		frame_count		= 0;
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (; not buffer_uploaded and frame_count < expected_frames * 2; ++frame_count)
+	{
+		CHECK_ERR( fg.RunFrame( [] (const CommandBuffer &) { return true; }, INOUT time ));
+
+		IFrameGraph::Statistics	stat;
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.uploadedSize <= budget );
+	}
+	NullDeviceFrameGraph::PrintResult( "UploadQueue", frame_count, time );
+
+	CHECK_ERR( image_uploaded and buffer_uploaded );
+	CHECK_ERR( buf_written == buf_size );
+	CHECK_ERR( frame_count == expected_frames );
+
+	fg->ReleaseResource( INOUT image );
+	fg->ReleaseResource( INOUT buffer );
+	return true;
+}
+
+
+static bool  PerfTest_UploadQueueStagingLimit (NullDeviceFrameGraph &fg)
+{
+	const BytesU	buf_size	= 320_Mb;	// more than 8 staging buffers of default size
+	const BytesU	frame_size	= 1_Mb;
+
+	BufferID	buffer		= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::TransferDst }, Default, "Buffer" );
+	BufferID	frame_buf	= fg->CreateBuffer( BufferDesc{ frame_size, EBufferUsage::TransferDst }, Default, "FrameBuffer" );
+	CHECK_ERR( buffer and frame_buf );
+
+	Array<uint8_t>	frame_data;		frame_data.resize( size_t(frame_size), uint8_t(0x3F) );
+	BytesU			buf_written;
+	bool			uploaded	= false;
+
+	// budget is larger than staging memory, uploads must be limited by staging memory that is not used by the command buffer
+	fg->SetUploadBudget( buf_size );
+
+	CHECK_ERR( fg->EnqueueUpload( UpdateBuffer{}.SetBuffer( buffer ).AddDataWriter(
+									[&buf_written] (void* dst, BytesU, BytesU size)
+									{
+										std::memset( dst, 0x1F, size_t(size) );
+										buf_written += size;
+									}, buf_size ),
+								   [&uploaded] () { uploaded = true; }));
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		CHECK_ERR( cmd->AddTask( UpdateBuffer{}.SetBuffer( frame_buf ).AddData( frame_data )));
+		return true;
+	};
+
+	uint	frame_count	= 0;
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (; not uploaded and frame_count < 10; ++frame_count)
+	{
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+	}
+	NullDeviceFrameGraph::PrintResult( "UploadQueueStagingLimit", frame_count, time );
+
+	CHECK_ERR( uploaded );
+	CHECK_ERR( buf_written == buf_size );
+	CHECK_ERR( frame_count > 1 );
+
+	fg->SetUploadBudget( 0_b );
+	fg->ReleaseResource( INOUT buffer );
+	fg->ReleaseResource( INOUT frame_buf );
+	return true;
+}
+
+
+static bool  PerfTest_UploadQueuePartialPart (NullDeviceFrameGraph &fg)
+{
+	const BytesU	page_size	= 32_Mb;	// default size of staging buffer
+	const BytesU	large_tail	= 8_Kb;
+	const BytesU	small_tail	= 2_Kb;		// less than minimal part of the buffer data, so it is skipped
+	const BytesU	buf_size	= 4 * (large_tail + small_tail);
+
+	BufferID	buffer	= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::TransferDst }, Default, "Buffer" );
+	CHECK_ERR( buffer );
+
+	BytesU		buf_written;
+	bool		is_sequential	= true;
+	bool		uploaded		= false;
+
+	fg->SetUploadBudget( buf_size );
+
+	CHECK_ERR( fg->EnqueueUpload( UpdateBuffer{}.SetBuffer( buffer ).AddDataWriter(
+									[&] (void* dst, BytesU offset, BytesU size)
+									{
+										is_sequential &= (offset == buf_written);
+										std::memset( dst, 0x1F, size_t(size) );
+										buf_written += size;
+									}, buf_size ),
+								   [&uploaded] () { uploaded = true; }));
+
+	// all staging buffers are filled by the first command buffer, upload part fits into free staging memory,
+	// but only tails of the first 4 buffers can be used, the rest of the part must be uploaded in the next frame
+	uint	frame_count = 0;
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		for (uint i = 0; (frame_count == 0) and (i < 8); ++i)
+		{
+			RawBufferID	id;
+			BytesU		offset;
+			void*		mapped	= null;
+			CHECK_ERR( cmd->AllocBuffer( page_size - (i < 4 ? large_tail : small_tail), 16_b, OUT id, OUT offset, OUT mapped ));
+		}
+		return true;
+	};
+
+	const BytesU	expected_size[] = { 4 * large_tail, 4 * small_tail };
+
+	IFrameGraph::Statistics	stat;
+	CHECK_ERR( fg->GetStatistics( OUT stat ));	// reset
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (; not uploaded and frame_count < CountOf(expected_size); ++frame_count)
+	{
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.uploadedSize == expected_size[frame_count] );
+	}
+	NullDeviceFrameGraph::PrintResult( "UploadQueuePartialPart", frame_count, time );
+
+	// each byte is written once
+	CHECK_ERR( uploaded );
+	CHECK_ERR( is_sequential );
+	CHECK_ERR( buf_written == buf_size );
+
+	fg->SetUploadBudget( 0_b );
+	fg->ReleaseResource( INOUT buffer );
+	return true;
+}
+
+
+static bool  PerfTest_UploadQueuePartialImage (NullDeviceFrameGraph &fg)
+{
+	const BytesU	page_size	= 32_Mb;	// default size of staging buffer
+	const BytesU	large_tail	= 4_Mb;
+	const BytesU	small_tail	= 1_Mb;		// less than 1/4 of the part, so it is skipped
+	const uint2		dim			= {1024, 3584};
+	const BytesU	row_pitch	= 4_b * dim.x;
+	const BytesU	img_size	= row_pitch * dim.y;
+	ImageID		image	= fg->CreateImage( ImageDesc{}.SetDimension( dim ).SetFormat( EPixelFormat::RGBA8_UNorm )
+												.SetUsage( EImageUsage::TransferDst | EImageUsage::Sampled ), Default, "Image" );
+	CHECK_ERR( image );
+
+	BytesU		img_written;
+	bool		is_sequential	= true;
+	bool		uploaded		= false;
+
+	fg->SetUploadBudget( img_size );
+
+	CHECK_ERR( fg->EnqueueUpload( UpdateImage{}.SetImage( image ).SetDataWriter(
+									[&] (void* dst, BytesU offset, BytesU size)
+									{
+										is_sequential &= (offset == img_written) and (offset % row_pitch == 0);
+										std::memset( dst, int(offset / row_pitch), size_t(size) );
+										img_written += size;
+									}, dim ),
+								   [&uploaded] () { uploaded = true; }));
+
+	// whole image fits into free staging memory and is acquired as single part, it is copied row by row,
+	// but only tails of the first 2 buffers can be used, the rest rows must be uploaded in the next frame
+	uint	frame_count = 0;
+
+	const auto	Build = [&] (const CommandBuffer &cmd) -> bool
+	{
+		for (uint i = 0; (frame_count == 0) and (i < 8); ++i)
+		{
+			RawBufferID	id;
+			BytesU		offset;
+			void*		mapped	= null;
+			CHECK_ERR( cmd->AllocBuffer( page_size - (i < 2 ? large_tail : small_tail), 16_b, OUT id, OUT offset, OUT mapped ));
+		}
+		return true;
+	};
+
+	const BytesU	expected_size[] = { 2 * large_tail, img_size - 2 * large_tail };
+
+	IFrameGraph::Statistics	stat;
+	CHECK_ERR( fg->GetStatistics( OUT stat ));	// reset
+
+	NullDeviceFrameGraph::FrameTime	time;
+	for (; not uploaded and frame_count < CountOf(expected_size); ++frame_count)
+	{
+		CHECK_ERR( fg.RunFrame( Build, INOUT time ));
+		CHECK_ERR( fg->GetStatistics( OUT stat ));
+		CHECK_ERR( stat.resources.uploadedSize == expected_size[frame_count] );
+		CHECK_ERR( uploaded == (frame_count+1 == CountOf(expected_size)) );
+	}
+	NullDeviceFrameGraph::PrintResult( "UploadQueuePartialImage", frame_count, time );
+
+	// each row is written once
+	CHECK_ERR( uploaded );
+	CHECK_ERR( is_sequential );
+	CHECK_ERR( img_written == img_size );
+
+	fg->SetUploadBudget( 0_b );
+	fg->ReleaseResource( INOUT image );
+	return true;
+}
+
+
+static bool  PerfTest_UploadQueueThreads (NullDeviceFrameGraph &fg)
+{
+	const BytesU	page_size	= 32_Mb;	// default size of staging buffer
+	const BytesU	large_tail	= 8_Kb;
+	const BytesU	small_tail	= 2_Kb;
+	const BytesU	part_size	= 4 * (large_tail + small_tail);
+	const BytesU	buf_size	= part_size * 2;
+
+	BufferID			buffer		= fg->CreateBuffer( BufferDesc{ buf_size, EBufferUsage::TransferDst }, Default, "Buffer" );
+	const RawBufferID	buffer_id	= buffer.Get();
+	CHECK_ERR( buffer );
+
+	Mutex			guard;
+	Array<uint>		write_count;		write_count.resize( size_t(buf_size) );
+	uint			callback_count	= 0;
+	bool			all_written		= false;
+	bool			is_alive		= false;
+	Atomic<bool>	first_recording	{false};
+	Atomic<bool>	second_executed	{false};
+
+	fg->SetUploadBudget( part_size );
+
+	// the first part is written after the second (last) part is recorded and executed in another thread
+	CHECK_ERR( fg->EnqueueUpload( UpdateBuffer{}.SetBuffer( buffer ).AddDataWriter(
+									[&] (void* dst, BytesU offset, BytesU size)
+									{
+										if ( offset < part_size )
+										{
+											first_recording.store( true );
+											while ( not second_executed.load() ) {
+												std::this_thread::yield();
+											}
+										}
+										std::memset( dst, 0x1F, size_t(size) );
+
+										EXLOCK( guard );
+										for (size_t i = size_t(offset), end = size_t(offset + size); i < end; ++i) {
+											++write_count[i];
+										}
+									}, buf_size ),
+								   [&] ()
+								   {
+										EXLOCK( guard );
+										++callback_count;
+										all_written	= std::all_of( write_count.begin(), write_count.end(), [] (uint count) { return count == 1; });
+										is_alive	= fg->IsResourceAlive( buffer_id );
+								   }));
+
+	// upload queue holds its own reference
+	fg->ReleaseResource( INOUT buffer );
+
+	// staging memory of the first command buffer is exhausted, so the first part is recorded partially
+	std::thread	first_thread( [&] ()
+		{
+			CommandBuffer	cmd = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK( cmd );
+
+			for (uint i = 0; i < 8; ++i)
+			{
+				RawBufferID	id;
+				BytesU		offset;
+				void*		mapped	= null;
+				CHECK( cmd->AllocBuffer( page_size - (i < 4 ? large_tail : small_tail), 16_b, OUT id, OUT offset, OUT mapped ));
+			}
+			CHECK( fg->Execute( cmd ));
+		});
+
+	std::thread	second_thread( [&] ()
+		{
+			while ( not first_recording.load() ) {
+				std::this_thread::yield();
+			}
+			CommandBuffer	cmd = fg->Begin( CommandBufferDesc{ EQueueType::Graphics });
+			CHECK( cmd );
+			CHECK( fg->Execute( cmd ));
+
+			second_executed.store( true );
+		});
+
+	first_thread.join();
+	second_thread.join();
+
+	CHECK_ERR( fg->Flush() );
+	CHECK_ERR( fg->WaitIdle() );
+
+	// both batches are completed, but the rest of the first part is not uploaded yet
+	CHECK_ERR( callback_count == 0 );
+
+	NullDeviceFrameGraph::FrameTime	time;
+	CHECK_ERR( fg.RunFrame( [] (const CommandBuffer &) { return true; }, INOUT time ));
+
+	CHECK_ERR( callback_count == 1 );
+	CHECK_ERR( all_written );
+	CHECK_ERR( is_alive );
+
+	CHECK_ERR( fg.RunFrame( [] (const CommandBuffer &) { return true; }, INOUT time ));
+	CHECK_ERR( not fg->IsResourceAlive( buffer_id ));
+
+	fg->SetUploadBudget( 0_b );
+	return true;
+}
+
+
+extern void PerfTest_NullTransfer1 ()
+{
+	NullDeviceFrameGraph	fg;
+	TEST( fg.Create() );
+
+	VulkanNullDevice::ResetCallCounts();
+
+	TEST( PerfTest_BufferChain( fg ));
+	TEST( PerfTest_ImageChain( fg ));
+	TEST( PerfTest_StreamingUpload( fg ));
+	TEST( PerfTest_UploadQueue( fg ));
+	TEST( PerfTest_UploadQueueStagingLimit( fg ));
+	TEST( PerfTest_UploadQueuePartialPart( fg ));
+	TEST( PerfTest_UploadQueuePartialImage( fg ));
+	TEST( PerfTest_UploadQueueThreads( fg ));
+
+	fg.Destroy();
+
+	FG_LOGI( "PerfTest_NullTransfer1 - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
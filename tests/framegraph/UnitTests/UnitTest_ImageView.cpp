@@ -0,0 +1,190 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "framegraph/Public/ImageView.h"
+#include "framegraph/Shared/EnumUtils.h"
+#include "UnitTest_Common.h"
+
+
+static bool  BitEquals (const RGBA32f &lhs, const RGBA32f &rhs)
+{
+	for (uint i = 0; i < 4; ++i)
+	{
+		// any nan is accepted
+		if ( lhs[i] != lhs[i] and rhs[i] != rhs[i] )
+			continue;
+
+		if ( BitCast<uint>(lhs[i]) != BitCast<uint>(rhs[i]) )
+			return false;
+	}
+	return true;
+}
+
+
+static void ImageView_Test1 ()
+{
+	const uint16_t		half_data[]	= { 0x0000, 0x8000, 0x3C00, 0x0001,		// 0, -0, 1, 2^-24
+										0x7C00, 0xC000, 0x3800, 0x03FF };	// inf, -2, 0.5, max denormal
+	const uint			rgb_data[]	= { (0x3C0) | (0 << 11) | (0x200u << 22),	// 1, 0, 2
+										(0x380) | (0x7C0 << 11) | (0x1u << 22) };	// 0.5, inf, 2^-19
+	const uint8_t		rgba8_data[] = { 0, 128, 255, 1 };
+	const uint16_t		rgba16_data[] = { 0, 0xFFFF, 0x8000, 1 };
+
+	RGBA32f		col;
+	{
+		const ArrayView<uint8_t>	part	{ Cast<uint8_t>(half_data), sizeof(half_data) };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{2, 1, 1}, 16_b, 16_b, EPixelFormat::RGBA16F, EImageAspect::Color };
+
+		view.Load( uint3{0, 0, 0}, OUT col );
+		TEST( BitCast<uint>(col.r) == 0 and BitCast<uint>(col.g) == 0x80000000u );
+		TEST( col.b == 1.0f and col.a == std::ldexp( 1.0f, -24 ));
+
+		view.Load( uint3{1, 0, 0}, OUT col );
+		TEST( col.r == std::numeric_limits<float>::infinity() and col.g == -2.0f and col.b == 0.5f );
+		TEST( col.a == std::ldexp( 1023.0f, -24 ));
+	}{
+		// red is in the lower bits, as in VK_FORMAT_B10G11R11_UFLOAT_PACK32
+		const ArrayView<uint8_t>	part	{ Cast<uint8_t>(rgb_data), sizeof(rgb_data) };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{2, 1, 1}, 8_b, 8_b, EPixelFormat::RGB_11_11_10F, EImageAspect::Color };
+
+		view.Load( uint3{0, 0, 0}, OUT col );
+		TEST( col == RGBA32f( 1.0f, 0.0f, 2.0f, 1.0f ));
+
+		view.Load( uint3{1, 0, 0}, OUT col );
+		TEST( col.r == 0.5f and col.g == std::numeric_limits<float>::infinity() );
+		TEST( col.b == std::ldexp( 1.0f, -19 ) and col.a == 1.0f );
+	}{
+		// max value is 1.0
+		const ArrayView<uint8_t>	part	{ rgba8_data };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{1, 1, 1}, 4_b, 4_b, EPixelFormat::RGBA8_UNorm, EImageAspect::Color };
+
+		view.Load( uint3{0, 0, 0}, OUT col );
+		TEST( col.r == 0.0f and col.b == 1.0f );
+		TEST( Equals( col.g, 128.0f / 255.0f, 1.0e-6f ) and Equals( col.a, 1.0f / 255.0f, 1.0e-6f ));
+	}{
+		const ArrayView<uint8_t>	part	{ Cast<uint8_t>(rgba16_data), sizeof(rgba16_data) };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{1, 1, 1}, 8_b, 8_b, EPixelFormat::RGBA16_UNorm, EImageAspect::Color };
+
+		view.Load( uint3{0, 0, 0}, OUT col );
+		TEST( col.r == 0.0f and col.g == 1.0f );
+		TEST( Equals( col.b, 32768.0f / 65535.0f, 1.0e-6f ) and Equals( col.a, 1.0f / 65535.0f, 1.0e-6f ));
+	}
+}
+
+
+static void ImageView_Test2 ()
+{
+	const EPixelFormat	formats[] = { EPixelFormat::RGBA8_UNorm, EPixelFormat::BGRA8_UNorm, EPixelFormat::RGBA16F, EPixelFormat::RGB_11_11_10F,
+									  EPixelFormat::Depth16, EPixelFormat::Depth24, EPixelFormat::Depth32F, EPixelFormat::RGBA16_UNorm };
+	const uint3			dim			{ 37, 5, 2 };	// width is not a multiple of vector size
+	uint				seed		= 0x12345678;
+
+	for (auto fmt : formats)
+	{
+		const auto		aspect		= (EPixelFormat_HasDepth( fmt ) ? EImageAspect::Depth : EImageAspect::Color);
+		const BytesU	bpp			= (fmt == EPixelFormat::Depth24 ? 4_b : BytesU(EPixelFormat_BitPerPixel( fmt, aspect )) / 8);	// D24 is copied as 32 bit value
+		const BytesU	row_pitch	= bpp * dim.x + 12_b;
+		const BytesU	slice_pitch	= row_pitch * dim.y;
+
+		Array<uint8_t>	data;	data.resize( size_t(slice_pitch * dim.z) );
+
+		for (auto& b : data)
+		{
+			seed = seed * 1103515245u + 12345u;
+			b	 = uint8_t(seed >> 16);
+		}
+
+		const ArrayView<uint8_t>	part	{ data };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, dim, row_pitch, slice_pitch, fmt, aspect };
+		Array<RGBA32f>				row;
+		Array<RGBA8u>				row8;
+
+		for (uint z = 0; z < dim.z; ++z)
+		for (uint y = 0; y < dim.y; ++y)
+		{
+			view.LoadRow( y, z, OUT row );
+			view.LoadRow( y, z, OUT row8 );
+			TEST( row.size() == dim.x and row8.size() == dim.x );
+
+			for (uint x = 0; x < dim.x; ++x)
+			{
+				RGBA32f		col;
+				view.Load( uint3{x, y, z}, OUT col );
+				TEST( BitEquals( row[x], col ));
+
+				for (uint c = 0; c < 4; ++c)
+				{
+					const float	v = (col[c] > 0.0f ? Min( col[c], 1.0f ) : 0.0f);
+					TEST( row8[x][c] == uint8_t(v * 255.0f + 0.5f) );
+				}
+			}
+		}
+
+		// region
+		Array<RGBA32f>	region;
+		TEST( view.ConvertTo( uint3{3, 1, 1}, uint3{29, 3, 1}, OUT region ));
+		TEST( region.size() == 29*3 );
+		
+		for (uint y = 0; y < 3; ++y)
+		for (uint x = 0; x < 29; ++x)
+		{
+			RGBA32f		col;
+			view.Load( uint3{x + 3, y + 1, 1}, OUT col );
+			TEST( BitEquals( region[x + y * 29], col ));
+		}
+	}
+}
+
+
+static void ImageView_Test3 ()
+{
+	const uint16_t		half_data[]	= { 0x0000, 0x8000, 0x3C00, 0x0001,		// 0, -0, 1, 2^-24
+										0x7C00, 0xC000, 0x3800, 0x03FF };	// inf, -2, 0.5, max denormal
+	const uint			rgb_data[]	= { (0x3C0) | (0 << 11) | (0x200u << 22),	// 1, 0, 2
+										(0x380) | (0x7C0 << 11) | (0x1u << 22) };	// 0.5, inf, 2^-19
+	const uint8_t		rgba8_data[] = { 0, 128, 255, 1 };
+
+	Array<RGBA32f>	f4;
+	Array<RGBA8u>	u8;
+	{
+		const ArrayView<uint8_t>	part	{ Cast<uint8_t>(half_data), sizeof(half_data) };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{2, 1, 1}, 16_b, 16_b, EPixelFormat::RGBA16F, EImageAspect::Color };
+
+		TEST( view.ConvertTo( OUT f4 ));
+		TEST( f4.size() == 2 );
+		TEST( BitCast<uint>(f4[0].r) == 0 and BitCast<uint>(f4[0].g) == 0x80000000u );
+		TEST( f4[0].b == 1.0f and f4[0].a == std::ldexp( 1.0f, -24 ));
+		TEST( f4[1].r == std::numeric_limits<float>::infinity() and f4[1].g == -2.0f and f4[1].b == 0.5f );
+		TEST( f4[1].a == std::ldexp( 1023.0f, -24 ));
+
+		TEST( view.ConvertTo( OUT u8 ));
+		TEST( u8.size() == 2 );
+		TEST( u8[0] == RGBA8u( 0, 0, 255, 0 ));
+		TEST( u8[1] == RGBA8u( 255, 0, 128, 0 ));
+	}{
+		const ArrayView<uint8_t>	part	{ Cast<uint8_t>(rgb_data), sizeof(rgb_data) };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{2, 1, 1}, 8_b, 8_b, EPixelFormat::RGB_11_11_10F, EImageAspect::Color };
+
+		TEST( view.ConvertTo( OUT f4 ));
+		TEST( f4[0] == RGBA32f( 1.0f, 0.0f, 2.0f, 1.0f ));
+		TEST( f4[1].r == 0.5f and f4[1].g == std::numeric_limits<float>::infinity() );
+		TEST( f4[1].b == std::ldexp( 1.0f, -19 ) and f4[1].a == 1.0f );
+	}{
+		const ArrayView<uint8_t>	part	{ rgba8_data };
+		const ImageView				view	{ ArrayView<ArrayView<uint8_t>>{ &part, 1 }, uint3{1, 1, 1}, 4_b, 4_b, EPixelFormat::BGRA8_UNorm, EImageAspect::Color };
+
+		TEST( view.ConvertTo( OUT f4 ));
+		TEST( f4[0].r == 0.0f and f4[0].b == 1.0f );
+
+		TEST( view.ConvertTo( OUT u8 ));
+		TEST( u8[0] == RGBA8u( 0, 128, 255, 1 ));		// BGRA is not swizzled
+	}
+}
+
+
+extern void UnitTest_ImageView ()
+{
+	ImageView_Test1();
+	ImageView_Test2();
+	ImageView_Test3();
+	FG_LOGI( "UnitTest_ImageView - passed" );
+}
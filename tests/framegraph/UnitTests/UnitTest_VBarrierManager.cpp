@@ -0,0 +1,224 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VBarrierManager.h"
+#include "UnitTest_Common.h"
+
+
+static VkImageMemoryBarrier  ImageBarrier (uint64_t image, VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+										   uint baseMip, uint mipCount, uint baseLayer, uint layerCount)
+{
+	VkImageMemoryBarrier	barrier = {};
+	barrier.sType				= VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.image				= BitCast<VkImage>( image );
+	barrier.oldLayout			= oldLayout;
+	barrier.newLayout			= newLayout;
+	barrier.srcAccessMask		= srcAccess;
+	barrier.dstAccessMask		= dstAccess;
+	barrier.srcQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+	barrier.subresourceRange	= { VK_IMAGE_ASPECT_COLOR_BIT, baseMip, mipCount, baseLayer, layerCount };
+	return barrier;
+}
+
+
+static VkBufferMemoryBarrier  BufferBarrier (uint64_t buffer, VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkDeviceSize offset, VkDeviceSize size)
+{
+	VkBufferMemoryBarrier	barrier = {};
+	barrier.sType				= VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.buffer				= BitCast<VkBuffer>( buffer );
+	barrier.srcAccessMask		= srcAccess;
+	barrier.dstAccessMask		= dstAccess;
+	barrier.srcQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+	barrier.offset				= offset;
+	barrier.size				= size;
+	return barrier;
+}
+
+
+static void VBarrierManager_Test1 ()
+{
+	VBarrierManager		mngr;
+	const auto			stages	= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	const auto			layout1	= VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	const auto			layout2	= VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	const auto			write	= VK_ACCESS_TRANSFER_WRITE_BIT;
+	const auto			read	= VK_ACCESS_SHADER_READ_BIT;
+
+	// contiguous array layers
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 1, layout1, layout2, write, read, 0, 1, 2, 2 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 1, layout1, layout2, write, read, 0, 1, 0, 2 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 1, layout1, layout2, write, read, 0, 1, 4, 1 ));
+
+	// contiguous mipmap levels
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 2, layout1, layout2, write, read, 1, 1, 0, 1 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 2, layout1, layout2, write, read, 0, 1, 0, 1 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 2, layout1, layout2, write, read, 2, 3, 0, 1 ));
+
+	// not contiguous, must not be merged
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 3, layout1, layout2, write, read, 0, 1, 0, 1 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 3, layout1, layout2, write, read, 0, 1, 2, 1 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 3, layout1, layout2, write, read, 1, 1, 1, 1 ));
+
+	// different layouts, must not be merged
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 4, layout1, layout2, write, read, 0, 1, 0, 1 ));
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 4, VK_IMAGE_LAYOUT_UNDEFINED, layout2, 0, read, 0, 1, 1, 1 ));
+
+	TEST( mngr.MergeBarriers() == 4 );
+
+	auto	barriers = mngr.GetImageBarriers();
+	TEST( barriers.size() == 7 );
+
+	TEST( barriers[0].image == BitCast<VkImage>( uint64_t(1) ));
+	TEST( barriers[0].subresourceRange.baseMipLevel == 0 and barriers[0].subresourceRange.levelCount == 1 );
+	TEST( barriers[0].subresourceRange.baseArrayLayer == 0 and barriers[0].subresourceRange.layerCount == 5 );
+
+	TEST( barriers[1].image == BitCast<VkImage>( uint64_t(2) ));
+	TEST( barriers[1].subresourceRange.baseMipLevel == 0 and barriers[1].subresourceRange.levelCount == 5 );
+	TEST( barriers[1].subresourceRange.baseArrayLayer == 0 and barriers[1].subresourceRange.layerCount == 1 );
+
+	TEST( barriers[2].image == BitCast<VkImage>( uint64_t(3) ));
+	TEST( barriers[3].image == BitCast<VkImage>( uint64_t(3) ));
+	TEST( barriers[4].image == BitCast<VkImage>( uint64_t(3) ));
+	TEST( barriers[5].image == BitCast<VkImage>( uint64_t(4) ));
+	TEST( barriers[6].image == BitCast<VkImage>( uint64_t(4) ));
+}
+
+
+static void VBarrierManager_Test2 ()
+{
+	VBarrierManager		mngr;
+	const auto			stages	= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	const auto			layout	= VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	const auto			read	= VK_ACCESS_SHADER_READ_BIT;
+	const auto			write	= VK_ACCESS_SHADER_WRITE_BIT;
+
+	// read after read without layout transition
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 1, layout, layout, read, read | VK_ACCESS_TRANSFER_READ_BIT, 0, 1, 0, 1 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 1, VK_ACCESS_UNIFORM_READ_BIT, read, 0, 256 ));
+
+	// write after read and read after write must not be removed
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 2, layout, layout, read, write, 0, 1, 0, 1 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 2, write, read, 0, 256 ));
+
+	// layout transition must not be removed
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 3, layout, VK_IMAGE_LAYOUT_GENERAL, read, read, 0, 1, 0, 1 ));
+
+	TEST( mngr.MergeBarriers() == 2 );
+	TEST( mngr.GetImageBarriers().size() == 2 );
+	TEST( mngr.GetBufferBarriers().size() == 1 );
+	TEST( mngr.GetImageBarriers()[0].image == BitCast<VkImage>( uint64_t(2) ));
+	TEST( mngr.GetImageBarriers()[1].image == BitCast<VkImage>( uint64_t(3) ));
+	TEST( mngr.GetBufferBarriers()[0].buffer == BitCast<VkBuffer>( uint64_t(2) ));
+
+	// all barriers are removed
+	mngr.ClearBarriers();
+	mngr.AddImageBarrier( stages, stages, 0, ImageBarrier( 1, layout, layout, read, read, 0, 1, 0, 1 ));
+	TEST( mngr.MergeBarriers() == 1 );
+	TEST( mngr.GetImageBarriers().empty() );
+}
+
+
+static void VBarrierManager_Test3 ()
+{
+	VBarrierManager		mngr;
+	const auto			stages	= VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	const auto			write	= VK_ACCESS_TRANSFER_WRITE_BIT;
+	const auto			read	= VK_ACCESS_UNIFORM_READ_BIT;
+
+	// contiguous and overlapped ranges
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 1, write, read, 256, 256 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 1, write, read, 0, 256 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 1, write, read, 400, 200 ));
+
+	// gap between ranges
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 2, write, read, 0, 100 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 2, write, read, 200, 100 ));
+
+	// whole size
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 3, write, read, 100, 100 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 3, write, read, 150, VK_WHOLE_SIZE ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 3, write, read, 1000, 100 ));
+
+	// different access
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 4, write, read, 0, 100 ));
+	mngr.AddBufferBarrier( stages, stages, BufferBarrier( 4, write, VK_ACCESS_SHADER_READ_BIT, 100, 100 ));
+
+	TEST( mngr.MergeBarriers() == 4 );
+
+	auto	barriers = mngr.GetBufferBarriers();
+	TEST( barriers.size() == 6 );
+
+	TEST( barriers[0].buffer == BitCast<VkBuffer>( uint64_t(1) ));
+	TEST( barriers[0].offset == 0 and barriers[0].size == 600 );
+
+	TEST( barriers[1].buffer == BitCast<VkBuffer>( uint64_t(2) ));
+	TEST( barriers[1].offset == 0 and barriers[1].size == 100 );
+	TEST( barriers[2].buffer == BitCast<VkBuffer>( uint64_t(2) ));
+	TEST( barriers[2].offset == 200 and barriers[2].size == 100 );
+
+	TEST( barriers[3].buffer == BitCast<VkBuffer>( uint64_t(3) ));
+	TEST( barriers[3].offset == 100 and barriers[3].size == VK_WHOLE_SIZE );
+
+	TEST( barriers[4].buffer == BitCast<VkBuffer>( uint64_t(4) ));
+	TEST( barriers[5].buffer == BitCast<VkBuffer>( uint64_t(4) ));
+}
+
+
+static void VBarrierManager_Test4 ()
+{
+	VBarrierManager		mngr;
+	const auto			stages		= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	const auto			write		= VK_ACCESS_SHADER_WRITE_BIT;
+	const auto			read		= VK_ACCESS_SHADER_READ_BIT;
+	const auto			event1		= BitCast<VkEvent>( uint64_t(1) );
+	const auto			event2		= BitCast<VkEvent>( uint64_t(2) );
+	const auto			Index		= [] (uint i) { return ExeOrderIndex(uint(ExeOrderIndex::First) + i); };
+	const uint			far_task	= FG_SplitBarrierMinDistance + 2;
+
+	mngr.AddEvent( event1, stages, Index(0) );
+	mngr.AddEvent( event2, stages | VK_PIPELINE_STAGE_TRANSFER_BIT, Index(1) );
+	mngr.SetExecutionOrder( Index(far_task) );
+
+	// producer is far enough, event is used
+	mngr.AddBufferBarrier( stages, stages, Index(0), BufferBarrier( 1, write, read, 0, 256 ));
+	mngr.AddImageBarrier( stages, stages, 0, Index(1), ImageBarrier( 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, write, read, 0, 1, 0, 1 ));
+
+	// producer is too close
+	mngr.AddBufferBarrier( stages, stages, Index(far_task - 1), BufferBarrier( 2, write, read, 0, 256 ));
+
+	// event was not set by producer
+	mngr.AddBufferBarrier( stages, stages, Index(2), BufferBarrier( 3, write, read, 0, 256 ));
+
+	// producer stages are not covered by event
+	mngr.AddBufferBarrier( VK_PIPELINE_STAGE_TRANSFER_BIT, stages, Index(0), BufferBarrier( 4, write, read, 0, 256 ));
+
+	// by-region dependency is not supported by 'vkCmdWaitEvents'
+	mngr.AddImageBarrier( stages, stages, VK_DEPENDENCY_BY_REGION_BIT, Index(1), ImageBarrier( 2, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, write, read, 0, 1, 0, 1 ));
+
+	TEST( mngr.GetPendingEvents().size() == 2 );
+	TEST( mngr.GetPendingEvents()[0].event == event1 );
+	TEST( mngr.GetPendingEvents()[1].event == event2 );
+
+	TEST( mngr.GetSplitBufferBarriers().size() == 1 );
+	TEST( mngr.GetSplitBufferBarriers()[0].buffer == BitCast<VkBuffer>( uint64_t(1) ));
+	TEST( mngr.GetSplitImageBarriers().size() == 1 );
+	TEST( mngr.GetSplitImageBarriers()[0].image == BitCast<VkImage>( uint64_t(1) ));
+
+	TEST( mngr.GetBufferBarriers().size() == 3 );
+	TEST( mngr.GetImageBarriers().size() == 1 );
+}
+
+
+extern void UnitTest_VBarrierManager ()
+{
+	VBarrierManager_Test1();
+	VBarrierManager_Test2();
+	VBarrierManager_Test3();
+	VBarrierManager_Test4();
+	FG_LOGI( "UnitTest_VBarrierManager - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
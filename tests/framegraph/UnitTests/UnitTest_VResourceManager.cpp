@@ -26,6 +26,31 @@ static void SamplerCache_Test1 (const FrameGraph &fg)
 }
 
 
+static void CacheStatistics_Test1 (const FrameGraph &fg)
+{
+	IFrameGraph::Statistics	stat;
+	TEST( fg->GetStatistics( OUT stat ));	// reset counters
+
+	SamplerDesc		desc;
+	desc.SetAddressMode( EAddressMode::MirrorRepeat );
+	desc.SetFilter( EFilter::Nearest, EFilter::Linear, EMipmapFilter::Nearest );
+
+	SamplerID	samp1 = fg->CreateSampler( desc );
+	SamplerID	samp2 = fg->CreateSampler( desc );
+	SamplerID	samp3 = fg->CreateSampler( desc );
+	TEST( samp1 == samp2 and samp2 == samp3 );
+
+	TEST( fg->GetStatistics( OUT stat ));
+	TEST( stat.resources.cacheMisses == 1 );
+	TEST( stat.resources.cacheHits == 2 );
+	TEST( stat.resources.cacheEvictions == 0 );
+
+	fg->ReleaseResource( samp1 );
+	fg->ReleaseResource( samp2 );
+	fg->ReleaseResource( samp3 );
+}
+
+
 static void PipelineResources_Test1 (const FrameGraph &fg)
 {
 	ComputePipelineDesc	desc;
@@ -99,6 +124,7 @@ static void PipelineResources_Test1 (const FrameGraph &fg)
 extern void UnitTest_VResourceManager (const FrameGraph &fg)
 {
 	SamplerCache_Test1( fg );
+	CacheStatistics_Test1( fg );
 	PipelineResources_Test1( fg );
 
 	FG_LOGI( "UnitTest_VResourceManager - passed" );
@@ -0,0 +1,145 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#ifdef FG_ENABLE_VULKAN
+
+#include "VTransientMemoryPacker.h"
+#include "UnitTest_Common.h"
+
+
+static void VTransientMemory_Test1 ()
+{
+	VTransientMemoryPacker	packer;
+
+	// non-overlapping lifetimes must share memory
+	const uint	a = packer.Add( 1_Mb, 256_b, ExeOrderIndex(1), ExeOrderIndex(2) );
+	const uint	b = packer.Add( 1_Mb, 256_b, ExeOrderIndex(3), ExeOrderIndex(4) );
+	const uint	c = packer.Add( 1_Mb, 256_b, ExeOrderIndex(5), ExeOrderIndex(6) );
+
+	packer.Pack();
+
+	TEST( packer.TotalSize() == 1_Mb );
+	TEST( packer.RequiredSize() == 3_Mb );
+	TEST( packer.Offset( a ) == 0_b );
+	TEST( packer.Offset( b ) == 0_b );
+	TEST( packer.Offset( c ) == 0_b );
+
+	TEST( not packer.IsAliased( a ));
+	TEST( packer.IsAliased( b ));
+	TEST( packer.IsAliased( c ));
+}
+
+
+static void VTransientMemory_Test2 ()
+{
+	VTransientMemoryPacker	packer;
+
+	// overlapping lifetimes, bounds are inclusive
+	const uint	a = packer.Add( 1_Mb, 256_b, ExeOrderIndex(1), ExeOrderIndex(3) );
+	const uint	b = packer.Add( 1_Mb, 256_b, ExeOrderIndex(3), ExeOrderIndex(4) );
+	const uint	c = packer.Add( 1_Mb, 256_b, ExeOrderIndex(2), ExeOrderIndex(2) );
+
+	packer.Pack();
+
+	TEST( packer.TotalSize() == 2_Mb );
+
+	// 'a' is alive together with 'b' and 'c', but 'b' and 'c' may share memory
+	TEST( packer.Offset( a ) != packer.Offset( b ));
+	TEST( packer.Offset( a ) != packer.Offset( c ));
+	TEST( packer.Offset( b ) == packer.Offset( c ));
+	TEST( not packer.IsAliased( a ));
+	TEST( packer.IsAliased( b ));
+	TEST( not packer.IsAliased( c ));
+}
+
+
+static void VTransientMemory_Test3 ()
+{
+	VTransientMemoryPacker	packer;
+
+	// small resource must be placed into the gap after big resource is released
+	const uint	a = packer.Add( 4_Mb,   1_Kb, ExeOrderIndex(1), ExeOrderIndex(2) );
+	const uint	b = packer.Add( 1_Mb,   1_Kb, ExeOrderIndex(1), ExeOrderIndex(8) );
+	const uint	c = packer.Add( 1_Mb,   4_Kb, ExeOrderIndex(3), ExeOrderIndex(4) );
+	const uint	d = packer.Add( 2_Mb,  64_Kb, ExeOrderIndex(3), ExeOrderIndex(5) );
+	const uint	e = packer.Add( 100_b, 256_b, ExeOrderIndex(6), ExeOrderIndex(6) );
+
+	packer.Pack();
+
+	TEST( packer.Offset( a ) == 0_b );
+	TEST( packer.Offset( b ) == 4_Mb );
+	TEST( packer.Offset( d ) == 0_b );
+	TEST( packer.Offset( c ) == 2_Mb );
+	TEST( packer.Offset( e ) == 0_b );
+	TEST( packer.TotalSize() == 5_Mb );
+	TEST( packer.MaxAlignment() == 64_Kb );
+
+	TEST( not packer.IsAliased( a ));
+	TEST( not packer.IsAliased( b ));
+	TEST( packer.IsAliased( c ));
+	TEST( packer.IsAliased( d ));
+	TEST( packer.IsAliased( e ));
+
+	// offsets must be aligned
+	for (uint i = 0; i < packer.Count(); ++i) {
+		TEST( packer.Offset( i ) % 1_Kb == 0_b );
+	}
+}
+
+
+static void VTransientMemory_Test4 ()
+{
+	VTransientMemoryPacker			packer;
+	const uint						count	= 200;
+	Array<Pair<uint, uint>>			lifetimes;
+	Array<BytesU>					alignments;
+
+	// randomized lifetimes, check that alive resources never share memory
+	uint	seed = 0x12345;
+	auto	Rand = [&seed] () { seed = seed * 1103515245u + 12345u;  return (seed >> 16) & 0x7FFF; };
+
+	for (uint i = 0; i < count; ++i)
+	{
+		uint	first	= 1 + Rand() % 64;
+		uint	last	= first + Rand() % 16;
+		BytesU	size	= BytesU(1 + Rand() % 1000) * 256;
+		BytesU	align	= BytesU(1u << (Rand() % 12));
+
+		lifetimes.push_back({ first, last });
+		alignments.push_back( align );
+		TEST( packer.Add( size, align, ExeOrderIndex(first), ExeOrderIndex(last) ) == i );
+	}
+
+	packer.Pack();
+	TEST( packer.TotalSize() <= packer.RequiredSize() );
+
+	for (uint i = 0; i < count; ++i)
+	{
+		TEST( packer.Offset( i ) + packer.Size( i ) <= packer.TotalSize() );
+		TEST( packer.Offset( i ) % alignments[i] == 0_b );
+
+		for (uint j = i+1; j < count; ++j)
+		{
+			bool	mem_intersects	= packer.Offset( i ) < packer.Offset( j ) + packer.Size( j ) and
+									  packer.Offset( j ) < packer.Offset( i ) + packer.Size( i );
+			bool	time_intersects	= lifetimes[i].first <= lifetimes[j].second and
+									  lifetimes[j].first <= lifetimes[i].second;
+			TEST( not (mem_intersects and time_intersects) );
+
+			// resource that is used later must be marked as aliased
+			if ( mem_intersects )
+				TEST( lifetimes[i].first < lifetimes[j].first ? packer.IsAliased( j ) : packer.IsAliased( i ));
+		}
+	}
+}
+
+
+extern void UnitTest_VTransientMemory ()
+{
+	VTransientMemory_Test1();
+	VTransientMemory_Test2();
+	VTransientMemory_Test3();
+	VTransientMemory_Test4();
+	FG_LOGI( "UnitTest_VTransientMemory - passed" );
+}
+
+#endif	// FG_ENABLE_VULKAN
@@ -7,10 +7,17 @@ using namespace FG;
 extern void UnitTest_VertexInput ();
 extern void UnitTest_ImageSwizzle ();
 extern void UnitTest_PixelFormat ();
+extern void UnitTest_ImageView ();
 extern void UnitTest_ID ();
 extern void UnitTest_VBuffer ();
 extern void UnitTest_VImage ();
 extern void UnitTest_ImageDesc ();
+extern void UnitTest_VTransientMemory ();
+extern void UnitTest_VBarrierManager ();
+
+extern void PerfTest_NullTransfer1 ();
+extern void PerfTest_NullRenderPass1 ();
+extern void PerfTest_NullResources1 ();
 
 
 #ifdef PLATFORM_ANDROID
@@ -27,15 +34,27 @@ int main () {
 		UnitTest_VertexInput();
 		UnitTest_ImageSwizzle();
 		UnitTest_PixelFormat();
+		UnitTest_ImageView();
 		UnitTest_ID();
 		UnitTest_ImageDesc();
 
 		#ifdef FG_ENABLE_VULKAN
 		UnitTest_VBuffer();
 		UnitTest_VImage();
+		UnitTest_VTransientMemory();
+		UnitTest_VBarrierManager();
 		#endif
 	}
 
+	// performance tests on null device
+	#ifdef FG_ENABLE_VULKAN
+	{
+		PerfTest_NullTransfer1();
+		PerfTest_NullRenderPass1();
+		PerfTest_NullResources1();
+	}
+	#endif
+
 	FGApp::Run( nativeHandle );
 
 	CHECK_FATAL( FG_DUMP_MEMLEAKS() );
@@ -0,0 +1,73 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+/*
+	Compiles test shaders on 1..N threads and measures speedup.
+	Only tests that doesn't change compilation flags are used,
+	otherwise result in other threads will be undefined.
+*/
+
+#include "Utils.h"
+#include "stl/Algorithms/StringUtils.h"
+#include <thread>
+#include <chrono>
+
+extern void Test_ComputeLocalSize1 (VPipelineCompiler* compiler);
+extern void Test_PushConst1 (VPipelineCompiler* compiler);
+extern void Test_PushConst3 (VPipelineCompiler* compiler);
+extern void Test_Reflection1 (VPipelineCompiler* compiler);
+extern void Test_Reflection2 (VPipelineCompiler* compiler);
+extern void Test_Reflection3 (VPipelineCompiler* compiler);
+extern void Test_Reflection4 (VPipelineCompiler* compiler);
+extern void Test_Reflection5 (VPipelineCompiler* compiler);
+extern void Test_UniformArrays1 (VPipelineCompiler* compiler);
+extern void Test_UniformArrays2 (VPipelineCompiler* compiler);
+
+
+extern void Test_ParallelCompilation1 (VPipelineCompiler* compiler)
+{
+	using TimePoint_t	= std::chrono::high_resolution_clock::time_point;
+	using Nanoseconds	= std::chrono::nanoseconds;
+	using TestFunc_t	= void (*) (VPipelineCompiler*);
+
+	static const TestFunc_t		tests[] = {
+		&Test_ComputeLocalSize1, &Test_PushConst1, &Test_PushConst3,
+		&Test_Reflection1, &Test_Reflection2, &Test_Reflection3, &Test_Reflection4, &Test_Reflection5,
+		&Test_UniformArrays1, &Test_UniformArrays2
+	};
+
+	// each thread compiles all tests, so total work is proportional to number of threads
+	const uint		max_threads = Clamp( std::thread::hardware_concurrency(), 1u, 8u );
+	Nanoseconds		single_thread_time;
+
+	for (uint thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+	{
+		Array<std::thread>	threads;
+		const TimePoint_t	start = std::chrono::high_resolution_clock::now();
+
+		for (uint i = 0; i < thread_count; ++i)
+		{
+			threads.emplace_back( [compiler] ()
+			{
+				for (auto* test : tests) {
+					test( compiler );
+				}
+			});
+		}
+
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		const Nanoseconds	dt = std::chrono::duration_cast<Nanoseconds>( std::chrono::high_resolution_clock::now() - start );
+
+		if ( thread_count == 1 )
+			single_thread_time = dt;
+
+		// ideal speedup is equal to number of threads
+		const double	speedup = double(single_thread_time.count()) * thread_count / Max( 1.0, double(dt.count()) );
+
+		FG_LOGI( "threads: "s << ToString( thread_count ) << ", pipelines: " << ToString( thread_count * CountOf(tests) )
+				 << ", time: " << ToString( dt ) << ", speedup: " << ToString( speedup, 2 ));
+	}
+
+	TEST_PASSED();
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "Utils.h"
+#include "stl/Stream/FileStream.h"
+
+#ifdef FS_HAS_FILESYSTEM
+
+static const char	shader_source[] = R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : require
+
+layout (local_size_x=8, local_size_y=8, local_size_z=1) in;
+
+#include "cache_test_header.glsl"
+
+void main ()
+{
+	Store( ivec2(gl_GlobalInvocationID.xy), vec4(1.0) );
+}
+)#";
+
+static const char	other_shader_source[] = R"#(
+#pragma shader_stage(compute)
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (local_size_x=4, local_size_y=4, local_size_z=1) in;
+
+layout(binding=0, r32f) writeonly uniform image2D  un_Output;
+
+void main ()
+{
+	imageStore( un_Output, ivec2(gl_GlobalInvocationID.xy), vec4(0.5) );
+}
+)#";
+
+static const char	header_source_1[] = R"#(
+layout(binding=0, rgba8) writeonly uniform image2D  un_Image1;
+void Store (ivec2 coord, vec4 color) { imageStore( un_Image1, coord, color ); }
+)#";
+
+static const char	header_source_2[] = R"#(
+layout(binding=0, rgba8) writeonly uniform image2D  un_Image2;
+void Store (ivec2 coord, vec4 color) { imageStore( un_Image2, coord, color ); }
+)#";
+
+
+static void  WriteHeader (const FS::path &path, StringView source)
+{
+	FileWStream		file{ path };
+	TEST( file.IsOpen() );
+	TEST( file.Write( source ));
+}
+
+static uint  CountCacheFiles (const FS::path &folder)
+{
+	uint	count = 0;
+	for (auto& entry : FS::directory_iterator{ folder }) {
+		count += uint(entry.path().extension() == ".spvc");
+	}
+	return count;
+}
+
+static Array<uint>  GetSpirv (const ComputePipelineDesc &ppln)
+{
+	auto	iter = ppln._shader.data.find( EShaderLangFormat::SPIRV_100 );
+	TEST( iter != ppln._shader.data.end() );
+
+	auto*	spirv = UnionGetIf< PipelineDescription::SpirvShaderPtr >( &iter->second );
+	TEST( spirv and *spirv );
+
+	return (*spirv)->GetData();
+}
+
+static bool  Compile (VPipelineCompiler &compiler, OUT ComputePipelineDesc &ppln, const char* source = shader_source)
+{
+	ppln = ComputePipelineDesc{};
+	ppln.AddShader( EShaderLangFormat::GLSL_450, "main", source );
+
+	return compiler.Compile( INOUT ppln, EShaderLangFormat::SPIRV_100 );
+}
+
+
+extern void Test_SpirvCache1 (VPipelineCompiler*)
+{
+	const FS::path	root		= FS::temp_directory_path() / "fg_spirv_cache_test";
+	const FS::path	shadow_folder= root / "include_shadow";
+	const FS::path	inc_folder	= root / "include";
+	const FS::path	cache_folder= root / "cache";
+
+	FS::remove_all( root );
+	TEST( FS::create_directories( inc_folder ));
+	TEST( FS::create_directories( shadow_folder ));
+	WriteHeader( inc_folder / "cache_test_header.glsl", header_source_1 );
+
+	{
+		VPipelineCompiler	compiler;
+		compiler.SetCompilationFlags( EShaderCompilationFlags::Unknown );
+		compiler.AddDirectory( shadow_folder.string() );	// empty, searched first
+		compiler.AddDirectory( inc_folder.string() );
+		TEST( compiler.SetCacheDirectory( cache_folder.string() ));
+
+		// cache miss
+		ComputePipelineDesc	ppln1;
+		TEST( Compile( compiler, OUT ppln1 ));
+		TEST( CountCacheFiles( cache_folder ) == 1 );
+
+		// other shader changes compiler state, key must not depend on it
+		ComputePipelineDesc	other_ppln;
+		TEST( Compile( compiler, OUT other_ppln, other_shader_source ));
+		TEST( CountCacheFiles( cache_folder ) == 2 );
+
+		// cache hit, result must be the same
+		ComputePipelineDesc	ppln2;
+		TEST( Compile( compiler, OUT ppln2 ));
+		TEST( CountCacheFiles( cache_folder ) == 2 );
+
+		TEST( GetSpirv( ppln1 ) == GetSpirv( ppln2 ));
+		TEST( All( ppln1._defaultLocalGroupSize == ppln2._defaultLocalGroupSize ));
+
+		auto	ds1 = FindDescriptorSet( ppln1, DescriptorSetID("0") );
+		auto	ds2 = FindDescriptorSet( ppln2, DescriptorSetID("0") );
+		TEST( ds1 and ds2 );
+		TEST( ds1->bindingIndex == ds2->bindingIndex );
+		TEST( *ds1->uniforms == *ds2->uniforms );
+		TEST( FindUniform< PipelineDescription::Image >( *ds2, UniformID("un_Image1") ).second );
+
+		// included file changed, cache entry must be invalidated
+		WriteHeader( inc_folder / "cache_test_header.glsl", header_source_2 );
+
+		ComputePipelineDesc	ppln3;
+		TEST( Compile( compiler, OUT ppln3 ));
+
+		auto	ds3 = FindDescriptorSet( ppln3, DescriptorSetID("0") );
+		TEST( ds3 );
+		TEST( not FindUniform< PipelineDescription::Image >( *ds3, UniformID("un_Image1") ).second );
+		TEST( FindUniform< PipelineDescription::Image >( *ds3, UniformID("un_Image2") ).second );
+
+		// new file in previous include directory shadows cached file, cache entry must be invalidated
+		WriteHeader( shadow_folder / "cache_test_header.glsl", header_source_1 );
+
+		ComputePipelineDesc	ppln4;
+		TEST( Compile( compiler, OUT ppln4 ));
+
+		auto	ds4 = FindDescriptorSet( ppln4, DescriptorSetID("0") );
+		TEST( ds4 );
+		TEST( FindUniform< PipelineDescription::Image >( *ds4, UniformID("un_Image1") ).second );
+		TEST( not FindUniform< PipelineDescription::Image >( *ds4, UniformID("un_Image2") ).second );
+	}
+
+	FS::remove_all( root );
+
+	TEST_PASSED();
+}
+
+#else
+
+extern void Test_SpirvCache1 (VPipelineCompiler*)
+{
+}
+
+#endif	// FS_HAS_FILESYSTEM
@@ -14,6 +14,8 @@ extern void Test_MRT1 (VPipelineCompiler* compiler);
 
 extern void Test_Optimization1 (VPipelineCompiler* compiler);
 
+extern void Test_ParallelCompilation1 (VPipelineCompiler* compiler);
+
 extern void Test_PushConst1 (VPipelineCompiler* compiler);
 extern void Test_PushConst2 (VPipelineCompiler* compiler);
 extern void Test_PushConst3 (VPipelineCompiler* compiler);
@@ -28,6 +30,8 @@ extern void Test_Reflection5 (VPipelineCompiler* compiler);
 
 extern void Test_ShaderTrace1 (VPipelineCompiler* compiler);
 
+extern void Test_SpirvCache1 (VPipelineCompiler* compiler);
+
 extern void Test_UniformArrays1 (VPipelineCompiler* compiler);
 extern void Test_UniformArrays2 (VPipelineCompiler* compiler);
 
@@ -69,11 +73,15 @@ int main ()
 		Test_Reflection5( &compiler );
 		
 		Test_ShaderTrace1( &compiler );
+
+		Test_SpirvCache1( &compiler );
 		
 		Test_UniformArrays1( &compiler );
 		Test_UniformArrays2( &compiler );
 		
 		Test_VersionSelector1( &compiler );
+
+		Test_ParallelCompilation1( &compiler );
 	}
 
 	CHECK_FATAL( FG_DUMP_MEMLEAKS() );
@@ -79,11 +79,54 @@ static void Frustum_Test3 ()
 }
 
 
+static void Frustum_Test4 ()
+{
+	Camera		camera;
+	Frustum		frustum;
+	
+	camera.SetPerspective( 60.0_deg, 1.5f, vec2(0.1f, 100.0f) );
+	frustum.Setup( camera );
+
+	// batch test must give the same result as test for single box
+	Array<AABB>		boxes;
+	for (uint i = 0; i < 1001; ++i)
+	{
+		const float	x = float(int(i % 11) - 5) * 4.0f;
+		const float	y = float(int((i / 11) % 7) - 3) * 4.0f;
+		const float	z = float(int(i / 77) - 2) * 9.0f;
+		boxes.push_back( AABB{}.SetExtent( vec3{float(i % 3) + 0.5f} ).SetCenter( vec3{x, y, z} ));
+	}
+
+	Array<uint64_t>	bits;
+	frustum.GetVisibility( boxes, vec3{0.0f}, OUT bits );
+	TEST( bits.size() == (boxes.size() + 63) / 64 );
+
+	size_t	visible_count = 0;
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		const bool	visible = !!(bits[i >> 6] & (1ull << (i & 63)));
+		TEST( visible == frustum.IsVisible( boxes[i] ));
+		visible_count += visible;
+	}
+	TEST( visible_count > 0 and visible_count < boxes.size() );
+
+	// with translation
+	boxes.clear();
+	boxes.push_back( AABB{}.SetExtent( vec3{2.0f} ).SetCenter( vec3{0.0f, 0.0f, -10.0f} ));
+	boxes.push_back( AABB{}.SetExtent( vec3{2.0f} ).SetCenter( vec3{0.0f, 0.0f, -30.0f} ));
+
+	frustum.GetVisibility( boxes, vec3{0.0f, 0.0f, 20.0f}, OUT bits );
+	TEST( bits.size() == 1 );
+	TEST( bits[0] == 1 );
+}
+
+
 extern void UnitTest_Frustum ()
 {
 	Frustum_Test1();
 	Frustum_Test2();
 	Frustum_Test3();
+	Frustum_Test4();
 
 	FG_LOGI( "UnitTest_Frustum - passed" );
 }
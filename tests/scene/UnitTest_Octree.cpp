@@ -0,0 +1,89 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "scene/SceneManager/Octree/LooseOctree.h"
+#include "UnitTest_Common.h"
+
+
+static void LooseOctree_Test1 ()
+{
+	LooseOctree		octree;
+	AABB			world;
+	world.min = vec3{-100.0f};
+	world.max = vec3{ 100.0f};
+
+	TEST( octree.Create( world, 6 ));
+
+	Camera		camera;
+	Frustum		frustum;
+	camera.SetPerspective( 60.0_deg, 1.5f, vec2(0.1f, 100.0f) );
+	frustum.Setup( camera );
+
+	Array<LooseOctree::ObjectID>	ids;
+	Array<AABB>						bounds;
+
+	// small and big objects, some of them are outside of the root bounds
+	for (uint i = 0; i < 2000; ++i)
+	{
+		const vec3	center	{ float(int(i * 37) % 260 - 130), float(int(i * 13) % 60 - 30), float(int(i * 71) % 260 - 130) };
+		const float	size	= (i % 10 == 0 ? 40.0f : float(i % 4) + 0.5f);
+
+		bounds.push_back( AABB{}.SetExtent( vec3{size} ).SetCenter( center ));
+		ids.push_back( octree.Insert( bounds.back() ));
+		TEST( ids.back() == i );
+	}
+	TEST( octree.ObjectCount() == 2000 );
+
+	const auto	CheckVisibility = [&] ()
+	{
+		Array<LooseOctree::ObjectID>	visible;
+		octree.Cull( frustum, vec3{0.0f}, OUT visible );
+
+		Array<bool>		is_visible;
+		is_visible.resize( bounds.size() );
+
+		for (auto id : visible) {
+			TEST( not is_visible[id] );
+			is_visible[id] = true;
+		}
+
+		for (size_t i = 0; i < bounds.size(); ++i) {
+			TEST( is_visible[i] == (octree.IsValid( uint(i) ) and frustum.IsVisible( bounds[i] )));
+		}
+		return visible.size();
+	};
+
+	TEST( CheckVisibility() > 0 );
+
+	// move
+	for (uint i = 0; i < 2000; i += 3)
+	{
+		bounds[i].Move( vec3{ 7.0f, -3.0f, -11.0f });
+		TEST( octree.Move( ids[i], bounds[i] ));
+	}
+	TEST( CheckVisibility() > 0 );
+
+	// remove
+	for (uint i = 0; i < 2000; i += 2) {
+		TEST( octree.Remove( ids[i] ));
+	}
+	TEST( octree.ObjectCount() == 1000 );
+	TEST( CheckVisibility() > 0 );
+
+	// removed slots are reused
+	TEST( octree.Insert( bounds[0] ) == ids[1998] );
+
+	for (uint i = 1; i < 2000; i += 2) {
+		TEST( octree.Remove( ids[i] ));
+	}
+	TEST( octree.Remove( ids[1998] ));
+	TEST( octree.ObjectCount() == 0 );
+	TEST( octree.NodeCount() == 1 );
+}
+
+
+extern void UnitTest_Octree ()
+{
+	LooseOctree_Test1();
+
+	FG_LOGI( "UnitTest_Octree - passed" );
+}
@@ -6,12 +6,14 @@ using namespace FG;
 
 extern void UnitTest_Transformation ();
 extern void UnitTest_Frustum ();
+extern void UnitTest_Octree ();
 
 
 int main ()
 {
 	UnitTest_Transformation();
 	UnitTest_Frustum();
+	UnitTest_Octree();
 
 	#ifndef FG_CI_BUILD
 	/*{
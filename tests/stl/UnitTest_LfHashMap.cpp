@@ -0,0 +1,170 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/LfHashMap.h"
+#include "UnitTest_Common.h"
+#include <thread>
+#include <chrono>
+
+
+static void LfHashMap_Test1 ()
+{
+	LfHashMap< uint, uint >	map;
+	uint					stored;
+	const uint				count = 1000;
+
+	TEST( map.Empty() );
+	TEST( not map.Find( 1, OUT stored ));
+
+	for (uint i = 0; i < count; ++i)
+	{
+		TEST( map.Insert( i, i*2, OUT stored ));
+		TEST( stored == i*2 );
+	}
+	TEST( map.Count() == count );
+
+	// insertion of existing key must return stored value
+	TEST( not map.Insert( 10, 0, OUT stored ));
+	TEST( stored == 20 );
+
+	for (uint i = 0; i < count; ++i)
+	{
+		TEST( map.Find( i, OUT stored ));
+		TEST( stored == i*2 );
+	}
+	TEST( not map.Find( count, OUT stored ));
+
+	uint	expected = 1;
+	TEST( not map.CompareExchange( 10, INOUT expected, 5 ));
+	TEST( expected == 20 );
+	TEST( map.CompareExchange( 10, INOUT expected, 5 ));
+	TEST( map.Find( 10, OUT stored ));
+	TEST( stored == 5 );
+	TEST( not map.CompareExchange( count, INOUT expected, 5 ));
+
+	uint	num = 0;
+	map.ForEach( [&num] (uint key, uint) { num += (key < count); });
+	TEST( num == count );
+
+	map.Clear();
+	TEST( map.Empty() );
+	TEST( not map.Find( 1, OUT stored ));
+}
+
+
+static void LfHashMap_Test2 ()
+{
+	LfHashMap< uint, uint >	map;
+	Atomic<uint>			inserted	{0};
+	Atomic<uint>			errors		{0};
+	const uint				count		= 1u << 14;
+
+	std::thread		writer{ [&] ()
+	{
+		for (uint i = 0; i < count; ++i)
+		{
+			uint	stored;
+			map.Insert( i, i + 1, OUT stored );
+			inserted.store( i + 1, memory_order_release );
+		}
+	}};
+
+	// readers must find all published elements while table grows
+	Array<std::thread>	readers;
+	for (uint t = 0; t < 3; ++t)
+	{
+		readers.emplace_back( [&] ()
+		{
+			for (uint last = 0; last < count;)
+			{
+				last = inserted.load( memory_order_acquire );
+
+				for (uint i = 0; i < last; ++i)
+				{
+					uint	value = 0;
+					if ( not map.Find( i, OUT value ) or value != i + 1 )
+						errors.fetch_add( 1, memory_order_relaxed );
+				}
+			}
+		});
+	}
+
+	writer.join();
+	for (auto& t : readers) { t.join(); }
+
+	TEST( errors.load() == 0 );
+	TEST( map.Count() == count );
+}
+
+
+static void LfHashMap_Test3 ()
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	const uint		key_count		= 1024;
+	const uint		lookup_count	= 1u << 20;
+	const uint		thread_count	= Clamp( std::thread::hardware_concurrency(), 2u, 8u );
+
+	LfHashMap< uint, uint >		lf_map;
+	HashMap< uint, uint >		map;
+	SharedMutex					map_guard;
+
+	for (uint i = 0; i < key_count; ++i)
+	{
+		uint	stored;
+		lf_map.Insert( i, i, OUT stored );
+		map.insert({ i, i });
+	}
+
+	const auto	Measure = [thread_count] (const auto &fn)
+	{
+		Array<std::thread>	threads;
+		auto				start = Clock::now();
+
+		for (uint t = 0; t < thread_count; ++t) {
+			threads.emplace_back( fn );
+		}
+		for (auto& t : threads) { t.join(); }
+
+		return std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - start ).count();
+	};
+
+	Atomic<uint>	sum {0};
+
+	const auto	lf_time = Measure( [&] ()
+	{
+		uint	local = 0;
+		for (uint i = 0; i < lookup_count; ++i)
+		{
+			uint	value = 0;
+			Unused( lf_map.Find( (i * 7) % key_count, OUT value ));
+			local += value;
+		}
+		sum.fetch_add( local, memory_order_relaxed );
+	});
+
+	const auto	locked_time = Measure( [&] ()
+	{
+		uint	local = 0;
+		for (uint i = 0; i < lookup_count; ++i)
+		{
+			SHAREDLOCK( map_guard );
+			auto	iter = map.find( (i * 7) % key_count );
+			local += (iter != map.end() ? iter->second : 0);
+		}
+		sum.fetch_add( local, memory_order_relaxed );
+	});
+
+	FG_LOGI( "LfHashMap lookups: "s << ToString(thread_count) << " threads x " << ToString(lookup_count)
+			 << ", lock-free: " << ToString(lf_time) << " us, shared mutex: " << ToString(locked_time) << " us" );
+	Unused( sum.load() );
+}
+
+
+extern void UnitTest_LfHashMap ()
+{
+	LfHashMap_Test1();
+	LfHashMap_Test2();
+	LfHashMap_Test3();
+
+	FG_LOGI( "UnitTest_LfHashMap - passed" );
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Containers/PagedIndexArray.h"
+#include "UnitTest_Common.h"
+
+
+static void PagedIndexArray_Test1 ()
+{
+	using Arr_t = PagedIndexArray< uint16_t, 64512, 256 >;
+
+	Arr_t	arr;
+
+	TEST( arr.AllocatedPages() == 0 );
+	TEST( arr[0] == Arr_t::Invalid() );
+	TEST( arr[64511] == Arr_t::Invalid() );
+
+	arr(10)		= 1;
+	arr(11)		= 2;
+	arr(64511)	= 3;
+
+	// only touched pages are allocated
+	TEST( arr.AllocatedPages() == 2 );
+	TEST( arr[10] == 1 );
+	TEST( arr[11] == 2 );
+	TEST( arr[12] == Arr_t::Invalid() );
+	TEST( arr[64511] == 3 );
+
+	arr.Clear();
+	TEST( arr.AllocatedPages() == 2 );
+	TEST( arr[10] == Arr_t::Invalid() );
+	TEST( arr[11] == Arr_t::Invalid() );
+	TEST( arr[64511] == Arr_t::Invalid() );
+
+	arr(300) = 4;
+	TEST( arr.AllocatedPages() == 3 );
+	TEST( arr[300] == 4 );
+}
+
+
+static void PagedIndexArray_Test2 ()
+{
+	using Arr_t = PagedIndexArray< uint, 1u << 16, 64 >;
+
+	Arr_t			arr;
+	Array<uint>		expected;
+
+	// sparse writes in many frames, some of the written indices are released
+	for (uint frame = 0; frame < 4; ++frame)
+	{
+		expected.assign( arr.capacity(), Arr_t::Invalid() );
+
+		for (uint i = frame; i < arr.capacity(); i += 997)
+		{
+			arr(i)		= i * 2 + frame;
+			expected[i]	= i * 2 + frame;
+		}
+		for (uint i = frame; i < arr.capacity(); i += 997*3)
+		{
+			arr(i)		= Arr_t::Invalid();
+			expected[i]	= Arr_t::Invalid();
+		}
+
+		for (uint i = 0; i < arr.capacity(); ++i) {
+			TEST( arr[i] == expected[i] );
+		}
+		arr.Clear();
+	}
+
+	for (uint i = 0; i < arr.capacity(); ++i) {
+		TEST( arr[i] == Arr_t::Invalid() );
+	}
+}
+
+
+extern void UnitTest_PagedIndexArray ()
+{
+	PagedIndexArray_Test1();
+	PagedIndexArray_Test2();
+
+	FG_LOGI( "UnitTest_PagedIndexArray - passed" );
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/Algorithms/RadixSort.h"
+#include "UnitTest_Common.h"
+#include <random>
+
+
+static void RadixSort_Test1 ()
+{
+	using Item_t = Pair< uint64_t, uint >;
+
+	std::mt19937_64			gen{ 0 };
+	Array< Item_t >			items;
+	Array< Item_t >			temp;
+
+	// few unique keys in high and low bits
+	for (uint i = 0; i < 1000; ++i) {
+		items.push_back({ ((gen() % 7) << 56) | (gen() % 5), i });
+	}
+	temp.resize( items.size() );
+
+	Array< Item_t >		ref = items;
+	std::stable_sort( ref.begin(), ref.end(), [] (auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+	RadixSort( items.data(), temp.data(), items.size(), [] (const Item_t &item) { return item.first; });
+
+	// must be stable
+	TEST( items == ref );
+}
+
+
+static void RadixSort_Test2 ()
+{
+	std::mt19937_64		gen{ 1 };
+	Array< uint64_t >	items;
+	Array< uint64_t >	temp;
+
+	for (uint i = 0; i < 4096; ++i) {
+		items.push_back( gen() );
+	}
+	temp.resize( items.size() );
+	
+	Array< uint64_t >	ref = items;
+	std::sort( ref.begin(), ref.end() );
+
+	RadixSort( items.data(), temp.data(), items.size(), [] (uint64_t key) { return key; });
+	TEST( items == ref );
+
+	// already sorted
+	RadixSort( items.data(), temp.data(), items.size(), [] (uint64_t key) { return key; });
+	TEST( items == ref );
+}
+
+
+extern void UnitTest_RadixSort ()
+{
+	RadixSort_Test1();
+	RadixSort_Test2();
+
+	FG_LOGI( "UnitTest_RadixSort - passed" );
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2018-2020,  Zhirnov Andrey. For more information see 'LICENSE'
+
+#include "stl/ThreadSafe/ThreadPool.h"
+#include "UnitTest_Common.h"
+
+
+static void ThreadPool_Test1 ()
+{
+	ThreadPool		pool;
+	Atomic<uint>	counter {0};
+	const uint		count = 1000;
+
+	TEST( pool.Create( 3, "Test" ));
+	TEST( pool.ThreadCount() == 3 );
+
+	for (uint i = 0; i < count; ++i)
+	{
+		pool.Enqueue( [&counter] () { counter.fetch_add( 1, memory_order_relaxed ); });
+	}
+
+	// help worker threads
+	for (; counter.load( memory_order_relaxed ) < count;)
+	{
+		if ( not pool.ProcessJob() )
+			std::this_thread::yield();
+	}
+
+	pool.Release();
+	TEST( counter.load() == count );
+	TEST( not pool.IsCreated() );
+}
+
+
+static void ThreadPool_Test2 ()
+{
+	ThreadPool		pool;
+	uint			counter	= 0;
+
+	// jobs that are not processed by workers must be processed in 'Release'
+	for (uint i = 0; i < 100; ++i)
+	{
+		pool.Enqueue( [&counter] () { ++counter; });
+	}
+
+	pool.Release();
+	TEST( counter == 100 );
+}
+
+
+extern void UnitTest_ThreadPool ()
+{
+	ThreadPool_Test1();
+	ThreadPool_Test2();
+
+	FG_LOGI( "UnitTest_ThreadPool - passed" );
+}
@@ -19,6 +19,10 @@ extern void UnitTest_LfIndexedPool ();
 extern void UnitTest_Rectangle ();
 extern void UnitTest_NtStringView ();
 extern void UnitTest_TypeList ();
+extern void UnitTest_ThreadPool ();
+extern void UnitTest_LfHashMap ();
+extern void UnitTest_PagedIndexArray ();
+extern void UnitTest_RadixSort ();
 
 
 #ifdef PLATFORM_ANDROID
@@ -44,6 +48,10 @@ int main ()
 	UnitTest_Rectangle();
 	UnitTest_NtStringView();
 	UnitTest_TypeList();
+	UnitTest_ThreadPool();
+	UnitTest_LfHashMap();
+	UnitTest_PagedIndexArray();
+	UnitTest_RadixSort();
 	
 	CHECK_FATAL( FG_DUMP_MEMLEAKS() );
 